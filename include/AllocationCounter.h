@@ -0,0 +1,41 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ *
+ * \brief The AllocationCounter class counts the allocations made from the
+ * global heap, by replacing the global operator new.  Each thread has its
+ * own count, so counting costs one increment and threads never share it.
+ * Built into the CrapSim library, with CRAPSIM_LIBRARY defined, it replaces
+ * nothing and counts nothing.
+ *
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+class AllocationCounter
+{
+    public:
+        // Return the number of allocations the calling thread has made
+        static unsigned long long Count();
+};
+
+#endif // ALLOCATIONCOUNTER_H
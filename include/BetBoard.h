@@ -0,0 +1,74 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ *
+ * \brief The BetBoard class holds the bets a Strategy has on the table, in
+ * the order they were made, in a fixed array rather than a list.  A
+ * Strategy's bets are bounded by the bets it may make, so the board never
+ * allocates, and copying it is a plain copy of its array.
+ *
+ */
+
+#ifndef BETBOARD_H
+#define BETBOARD_H
+
+#include <array>
+#include <string>
+#include "Bet.h"
+#include "CrapSimException.h"
+
+// Most bets a Strategy may have on the table at once
+const int BETBOARD_CAPACITY = 64;
+
+class BetBoard
+{
+    public:
+        typedef Bet       *iterator;
+        typedef const Bet *const_iterator;
+
+        iterator       begin()               { return (m_acBets.data()); }
+        iterator       end()                 { return (m_acBets.data() + m_nBets); }
+        const_iterator begin() const         { return (m_acBets.data()); }
+        const_iterator end() const           { return (m_acBets.data() + m_nBets); }
+
+        bool empty() const                   { return (m_nBets == 0); }
+        int  size() const                    { return (m_nBets); }
+
+        // Add a bet after the others
+        void push_back(const Bet &cBet)
+            { if (m_nBets < BETBOARD_CAPACITY) m_acBets[m_nBets++] = cBet;
+              else throw CrapSimException("BetBoard::push_back full at", std::to_string(BETBOARD_CAPACITY)); }
+
+        // Remove a bet, keeping the others in order, and return the bet after it
+        iterator erase(iterator it)
+            { for (iterator jt = it + 1; jt != end(); ++jt) *(jt - 1) = *jt;
+              --m_nBets;
+              return (it); }
+
+        // Remove all bets
+        void clear()                         { m_nBets = 0; }
+
+    private:
+        std::array<Bet, BETBOARD_CAPACITY> m_acBets;
+        int m_nBets {0};
+};
+
+#endif // BETBOARD_H
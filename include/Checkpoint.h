@@ -0,0 +1,107 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The Checkpoint class holds the state of a Simulation part way
+ * through its runs, so that a Simulation stopped before it is done can be
+ * resumed and give the same results as if it had not stopped.  Values are
+ * kept as the bytes of this build of CrapSim, so a checkpoint is read only
+ * by the same version of CrapSim built for the same memory layout; the
+ * byte order and the sizes of the basic types are recorded, and checked
+ * first.  The partial results of a shard are kept the same way.
+ *
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "CrapSimException.h"
+
+// Format of checkpoint files; changed whenever the state saved changes
+const int CHECKPOINT_FORMAT = 5;
+
+class Checkpoint
+{
+    public:
+        // Append a value, a vector of values, or a string
+        template <typename T> void Put(const T &x)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint::Put needs a trivially copyable type");
+            m_sBuffer.append(reinterpret_cast<const char *>(&x), sizeof(T));
+        }
+        template <typename T> void Put(const std::vector<T> &v)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint::Put needs a trivially copyable type");
+            Put(static_cast<unsigned long long>(v.size()));
+            m_sBuffer.append(reinterpret_cast<const char *>(v.data()), v.size() * sizeof(T));
+        }
+        void Put(const std::string &s)
+        {
+            Put(static_cast<unsigned long long>(s.size()));
+            m_sBuffer.append(s);
+        }
+
+        // Read the next value, vector of values, or string
+        template <typename T> void Get(T &x)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint::Get needs a trivially copyable type");
+            std::memcpy(&x, Next(sizeof(T)), sizeof(T));
+        }
+        template <typename T> void Get(std::vector<T> &v)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Checkpoint::Get needs a trivially copyable type");
+            unsigned long long nSize;
+            Get(nSize);
+            if (nSize > (m_sBuffer.size() - m_nPosition) / sizeof(T))
+                throw CrapSimException("Checkpoint::Get checkpoint is damaged");
+            v.resize(nSize);
+            if (nSize > 0) std::memcpy(v.data(), Next(nSize * sizeof(T)), nSize * sizeof(T));
+        }
+        void Get(std::string &s)
+        {
+            unsigned long long nSize;
+            Get(nSize);
+            s.assign(Next(nSize), nSize);
+        }
+
+        // Write the checkpoint of the Simulation described by sKey to sPath
+        void Write(const std::string &sPath, const std::string &sKey) const;
+        // Read the checkpoint at sPath; return false if there is none, and
+        // throw if it is damaged or of another Simulation
+        bool Read(const std::string &sPath, const std::string &sKey);
+
+        // Return the checkpoint as the bytes of a file, and read it from the
+        // bytes of a file, e.g., sent over a network, from sSource
+        std::string Bytes(const std::string &sKey) const;
+        void FromBytes(std::string sBytes, const std::string &sKey, const std::string &sSource);
+
+    private:
+        std::string            m_sBuffer;
+        std::string::size_type m_nPosition {0};
+
+        // Return the next nSize bytes and move past them
+        const char *Next(unsigned long long nSize);
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,125 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ *
+ * \brief The Configuration class reads a configuration file: the Table,
+ * DefaultStrategy and Simulation sections into SimulationSettings, the
+ * TableN sections into the settings of each table, and the Strategy
+ * sections into Strategies.  It is shared by the CrapSim program
+ * and the CrapSim library, which reads configuration text.
+ *
+ */
+
+#ifndef CONFIGURATION_H
+#define CONFIGURATION_H
+
+#include <cfloat>
+#include <climits>
+#include <map>
+#include <string>
+#include <vector>
+#include "CrapSimException.h"
+#include "DiceModel.h"
+#include "Simulation.h"
+#include "Strategy.h"
+#include "Table.h"
+#include "CDataFile.h"
+
+// Settings of the Table and Simulation sections, INT_MIN or FLT_MIN if not set
+struct SimulationSettings
+{
+    Table       m_cTable {5, 5000};
+    int         m_nRuns             = INT_MIN;
+    bool        m_bMuster           = false;
+    bool        m_bTally            = false;
+    bool        m_bCompare          = false;
+    std::string m_sBaseline;
+    std::string m_sSampling;
+    float       m_fTargetCIWidth    = FLT_MIN;
+    int         m_nMaxRuns          = INT_MIN;
+    bool        m_bDropOnTarget     = false;
+    bool        m_bRace             = false;
+    int         m_nRaceSurvivors    = INT_MIN;
+    bool        m_bLockstep         = false;
+    bool        m_bCountAllocations = false;
+    int         m_nSeed             = INT_MIN;
+    std::string m_sResultCache;
+    std::string m_sCheckpoint;
+    int         m_nCheckpointRuns   = INT_MIN;
+    int         m_nCheckpointSeconds = INT_MIN;
+    bool        m_bResume           = false;
+    int         m_nShard            = INT_MIN;
+    int         m_nShards           = INT_MIN;
+    std::string m_sPartialResults;
+    bool        m_bCoordinate       = false;
+    std::string m_sRecordRolls;
+    std::string m_sReplayRolls;
+    DiceModel   m_cDiceModel;
+    DiceModel   m_cSetterModel;
+    float       m_fSetterShare      = FLT_MIN;
+    std::string m_sSurvivalCurve;
+
+    // Set up a Simulation to play nRuns by these settings
+    void Apply(Simulation &cSim, int nRuns) const;
+};
+
+class Configuration
+{
+    public:
+        // Built in settings, as for an empty configuration file
+        Configuration() = default;
+        // Read the Table, DefaultStrategy and Simulation sections
+        explicit Configuration(CDataFile &cConfigFile);
+
+        // Return the Table and Simulation settings
+        const SimulationSettings& Settings() const { return (m_cSettings); }
+        SimulationSettings& Settings()             { return (m_cSettings); }
+
+        // Create the Strategy of a section, with the swept keys in mSwept
+        // at a grid point named sLabel; DefaultStrategy settings fill in
+        // what the section does not set
+        Strategy CreateStrategy(CDataFile &cConfigFile, const std::string &sSection,
+                                const std::map<std::string, std::string> &mSwept,
+                                const std::string &sLabel) const;
+        // Create a Strategy for each point of each StrategyN section's grid
+        std::vector<Strategy> CreateStrategies(CDataFile &cConfigFile) const;
+
+        // Return the TableN sections, none if there is only a Table section
+        static std::vector<std::string> TableSections(CDataFile &cConfigFile);
+        // Return the settings with the table and dice of a TableN section;
+        // keys the section does not set keep their Table section values
+        SimulationSettings TableSettings(CDataFile &cConfigFile, const std::string &sSection) const;
+
+        // Return the Strategy keys that may be swept with range or list syntax
+        static const std::vector<std::string>& SweepableKeys();
+
+    private:
+        SimulationSettings m_cSettings;
+
+        // DefaultStrategy settings
+        int   m_nDefaultInitBank             = INT_MIN;
+        int   m_nDefaultStdWager             = INT_MIN;
+        float m_fDefaultSWM                  = FLT_MIN;
+        int   m_nDefaultSigWin               = INT_MIN;
+        int   m_nDefaultPlayForNumberOfRolls = INT_MIN;
+};
+
+#endif // CONFIGURATION_H
@@ -0,0 +1,209 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ *
+ * \brief The plain C interface of the CrapSim library, libcrapsim.  A job
+ * holds a Table, Simulation settings and Strategies, read from
+ * configuration file text or set by the functions below.  A job is
+ * submitted to a pool of threads, split into parts that each play some of
+ * the runs on their own dice, and its results are merged once every part
+ * is done.  Many jobs may share one pool.  Nothing is printed; results are
+ * fetched as structures.
+ *
+ * Functions returning int return CRAPSIM_OK, or CRAPSIM_ERROR with the
+ * reason given by CrapSimJobError().  A job must not be changed while it
+ * is running, and functions on one job must not be called from several
+ * threads at once; different jobs may be used from different threads.
+ *
+ */
+
+#ifndef CRAPSIMLIBRARY_H
+#define CRAPSIMLIBRARY_H
+
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Functions are exported from a Windows DLL built with CRAPSIM_LIBRARY and
+   imported by programs built with CRAPSIM_DLL */
+#if defined(_WIN32) && defined(CRAPSIM_LIBRARY)
+#define CRAPSIM_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(CRAPSIM_DLL)
+#define CRAPSIM_API __declspec(dllimport)
+#else
+#define CRAPSIM_API
+#endif
+
+/* ABI version, returned by CrapSimLibraryAbi() */
+#define CRAPSIM_LIBRARY_ABI 2
+
+/* Return codes */
+#define CRAPSIM_OK     0
+#define CRAPSIM_ERROR  (-1)
+
+/* An int setting left at its default */
+#define CRAPSIM_UNSET  INT_MIN
+
+/* Number of buckets of a Strategy's histogram of rolls per run */
+#define CRAPSIM_HISTOGRAM_BUCKETS 32
+
+/* A pool of threads jobs run on */
+typedef struct CrapSimPool CrapSimPool;
+
+/* A job: a Table, Simulation settings, Strategies and their results */
+typedef struct CrapSimJob CrapSimJob;
+
+/* Settings of a Strategy, with the meaning of the Strategy keys of the
+   configuration file.  Strings are NULL, ints CRAPSIM_UNSET and doubles 0
+   if not set; flags are 0 or 1.  CrapSimStrategySettingsInit() leaves
+   every setting unset. */
+typedef struct CrapSimStrategySettings
+{
+    const char *pszName;                /* NULL names the Strategy StrategyN */
+    const char *pszDescription;
+    const char *pszPredefined;
+
+    int    nInitialBankroll;
+    int    nStandardWager;
+    int    nFullWager;
+    int    nSignificantWinnings;
+    double dSWM;
+    int    nPlayForNumberOfRolls;
+
+    int    nPassBet;
+    int    nDontPassBet;
+    int    nComeBets;
+    int    nDontComeBets;
+    int    nPlaceBets;
+    int    nPlaceBetsMadeAtOnce;
+    int    nPlaceBetUnits;
+    int    nPlaceWorking;
+    int    nPutBet;
+    int    nFieldBet;
+    int    nFieldBetUnits;
+
+    double dStandardOdds;
+    int    nComeOddsWorking;
+    const char *pszOddsProgressionMethod;
+    const char *pszWagerProgressionMethod;
+    const char *pszBetModificationMethod;
+    const char *pszQualifiedShooterMethod;
+    int    nQualifiedShooterMethodCount;
+
+    const char *pszRules;               /* Betting rules, one per line */
+    const char *pszRoutine;
+    const char *pszPlugin;
+    const char *pszPluginArguments;
+} CrapSimStrategySettings;
+
+/* Results of a Strategy over the runs of a job.  Rolls are counted over
+   runs played until broke or significant winnings, ending bankrolls over
+   runs played for a number of rolls; minimums, maximums and means are 0 if
+   there are no such runs. */
+typedef struct CrapSimStrategyResult
+{
+    const char *pszName;                /* Valid until the job is changed or destroyed */
+
+    long long nRuns;
+    long long nWins;
+    long long nLosses;
+
+    double dWinPercentage;
+    double dWinCIWidth;                 /* Full width of the 95% confidence interval */
+    double dMeanBankroll;
+    double dBankrollCIWidth;            /* As a percentage of the initial bankroll */
+
+    int    nWinRollsMin;
+    int    nWinRollsMax;
+    double dWinRollsMean;
+    int    nLossRollsMin;
+    int    nLossRollsMax;
+    double dLossRollsMean;
+
+    int    nWinBankrollMin;
+    int    nWinBankrollMax;
+    double dWinBankrollMean;
+    int    nLossBankrollMin;
+    int    nLossBankrollMax;
+    double dLossBankrollMean;
+
+    /* Runs by rolls played; bucket k counts 2^k up to 2^(k+1) - 1 rolls,
+       bucket 0 also counts runs of no rolls */
+    long long anRollsHistogram[CRAPSIM_HISTOGRAM_BUCKETS];
+} CrapSimStrategyResult;
+
+/* Return CRAPSIM_LIBRARY_ABI */
+CRAPSIM_API int  CrapSimLibraryAbi(void);
+
+/* Start a pool of nThreads threads, one per hardware thread if nThreads < 1 */
+CRAPSIM_API CrapSimPool *CrapSimPoolCreate(int nThreads);
+/* Finish the jobs submitted to the pool, then stop it */
+CRAPSIM_API void CrapSimPoolDestroy(CrapSimPool *pPool);
+
+/* Make a job with a craps table of 5 to 5000 and no Strategies */
+CRAPSIM_API CrapSimJob *CrapSimJobCreate(void);
+/* Wait for the job if it is running, then free it */
+CRAPSIM_API void CrapSimJobDestroy(CrapSimJob *pJob);
+
+/* Read configuration file text: the Table, DefaultStrategy and Simulation
+   sections replace the job's settings, and the Strategy sections its
+   Strategies */
+CRAPSIM_API int  CrapSimJobLoadIni(CrapSimJob *pJob, const char *pszIni);
+/* Set the Table; a NULL type or CRAPSIM_UNSET wager is left as it is */
+CRAPSIM_API int  CrapSimJobSetTable(CrapSimJob *pJob, const char *pszType, int nMinimumWager, int nMaximumWager);
+/* Seed the dice, so that the job can be repeated; CRAPSIM_UNSET to not seed */
+CRAPSIM_API int  CrapSimJobSetSeed(CrapSimJob *pJob, int nSeed);
+
+/* Leave every setting unset */
+CRAPSIM_API void CrapSimStrategySettingsInit(CrapSimStrategySettings *pSettings);
+/* Add a Strategy from settings */
+CRAPSIM_API int  CrapSimJobAddStrategy(CrapSimJob *pJob, const CrapSimStrategySettings *pSettings);
+/* Add a Strategy from the keys of a Strategy section, without its header */
+CRAPSIM_API int  CrapSimJobAddStrategyIni(CrapSimJob *pJob, const char *pszSection);
+
+/* Run the job on the pool, split into nParts parts, and return at once.
+   nRuns <= 0 plays the Runs of the Simulation section; nParts < 1 is one
+   part per thread of the pool.  With a seed, part p is seeded with the
+   seed plus p, so one part plays as the CrapSim program does.  A job that
+   records or replays rolls, or has a traced Strategy, plays as one part. */
+CRAPSIM_API int  CrapSimJobSubmit(CrapSimJob *pJob, CrapSimPool *pPool, int nRuns, int nParts);
+/* Wait for the job to finish */
+CRAPSIM_API int  CrapSimJobWait(CrapSimJob *pJob);
+/* Submit the job and wait for it */
+CRAPSIM_API int  CrapSimJobRun(CrapSimJob *pJob, CrapSimPool *pPool, int nRuns, int nParts);
+
+/* Return the number of Strategies */
+CRAPSIM_API int  CrapSimJobStrategies(const CrapSimJob *pJob);
+/* Fetch the results of Strategy iStrategy, counting from 0, of the job last finished */
+CRAPSIM_API int  CrapSimJobStrategyResult(const CrapSimJob *pJob, int iStrategy, CrapSimStrategyResult *pResult);
+/* Fetch the number of times each value 2 to 12 was rolled, indexed by
+   value, over every part; return the total number of rolls */
+CRAPSIM_API long long CrapSimJobDiceCounts(const CrapSimJob *pJob, long long anCounts[13]);
+/* Return why the last function failed, "" if it did not */
+CRAPSIM_API const char *CrapSimJobError(const CrapSimJob *pJob);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRAPSIMLIBRARY_H */
@@ -0,0 +1,124 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The plain C interface of Strategy plugins.  A plugin is a shared
+ * library, named by a Strategy's Plugin key, that exports the functions
+ * below with C linkage.  Before each roll, CrapSim passes the plugin the
+ * variables the betting rules read (see RuleProgram.h) as an array of int,
+ * and the plugin returns its orders for the roll all at once.  After the
+ * roll is resolved, CrapSim passes the variables again, with the roll
+ * value, bankroll, hits and bets still up updated; the come out and point
+ * are those the roll was made on.
+ *
+ * Each Strategy, and each copy of it, has its own plugin state, made by
+ * CrapSimPluginCreate(), so a plugin keeps no state of its own outside
+ * the state it is passed.
+ *
+ * Only CrapSimPluginAbi() and CrapSimPluginMakeBets() are required.  The
+ * numbers below never change within an ABI version.
+ *
+ */
+
+#ifndef CRAPSIMPLUGIN_H
+#define CRAPSIMPLUGIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ABI version, returned by CrapSimPluginAbi() */
+#define CRAPSIM_PLUGIN_ABI 1
+
+/* Index of each variable in the array passed to a plugin */
+enum CrapSimVariable
+{
+    CRAPSIM_VAR_COMEOUT   = 0,     /* 1 on the come out, else 0 */
+    CRAPSIM_VAR_POINT     = 1,     /* The point, 0 on the come out */
+    CRAPSIM_VAR_ROLL      = 2,     /* The last roll value */
+    CRAPSIM_VAR_BANKROLL  = 3,     /* The bankroll, not counting bets */
+    CRAPSIM_VAR_INITIAL   = 4,     /* The initial bankroll */
+    CRAPSIM_VAR_WAGER     = 5,     /* The standard wager */
+    CRAPSIM_VAR_ROLLS     = 6,     /* Rolls played in the run */
+    CRAPSIM_VAR_HITS      = 7,     /* Winning rolls in a row */
+    CRAPSIM_VAR_QUALIFIED = 8,     /* 1 if the shooter is qualified, else 0 */
+    CRAPSIM_VAR_FIRST_BET = 9      /* Followed by the wager on each bet */
+};
+
+/* Bets a plugin may order, and whose wagers it may read */
+enum CrapSimBet
+{
+    CRAPSIM_BET_PASS      = 0,
+    CRAPSIM_BET_DONT_PASS = 1,
+    CRAPSIM_BET_FIELD     = 2,
+    CRAPSIM_BET_PLACE4    = 3,
+    CRAPSIM_BET_PLACE5    = 4,
+    CRAPSIM_BET_PLACE6    = 5,
+    CRAPSIM_BET_PLACE8    = 6,
+    CRAPSIM_BET_PLACE9    = 7,
+    CRAPSIM_BET_PLACE10   = 8,
+    CRAPSIM_BET_HARD4     = 9,
+    CRAPSIM_BET_HARD6     = 10,
+    CRAPSIM_BET_HARD8     = 11,
+    CRAPSIM_BET_HARD10    = 12,
+    CRAPSIM_BET_COUNT     = 13
+};
+
+/* Number of variables passed to a plugin */
+#define CRAPSIM_VARIABLES (CRAPSIM_VAR_FIRST_BET + CRAPSIM_BET_COUNT)
+
+/* Orders a plugin may give, with the same meaning as in the betting rules */
+enum CrapSimAction
+{
+    CRAPSIM_ACTION_BET      = 0,
+    CRAPSIM_ACTION_PRESS    = 1,
+    CRAPSIM_ACTION_REGRESS  = 2,
+    CRAPSIM_ACTION_TAKEDOWN = 3
+};
+
+/* An order */
+typedef struct CrapSimOrder
+{
+    int nAction;                   /* A CrapSimAction */
+    int nBet;                      /* A CrapSimBet */
+    int nAmount;                   /* Wager, or amount to press or regress */
+} CrapSimOrder;
+
+/* Most orders a plugin may give for one roll */
+#define CRAPSIM_MAX_ORDERS 32
+
+/* Return CRAPSIM_PLUGIN_ABI */
+typedef int   (*CrapSimPluginAbiFunction)(void);
+/* Make the state of one Strategy from its PluginArguments key, "" if not set */
+typedef void *(*CrapSimPluginCreateFunction)(const char *pszArguments);
+/* Free the state */
+typedef void  (*CrapSimPluginDestroyFunction)(void *pState);
+/* Start a new simulation run */
+typedef void  (*CrapSimPluginResetFunction)(void *pState);
+/* Before a roll, write up to nMaxOrders orders and return how many */
+typedef int   (*CrapSimPluginMakeBetsFunction)(void *pState, const int *pnVariables, CrapSimOrder *pOrders, int nMaxOrders);
+/* After a roll is resolved */
+typedef void  (*CrapSimPluginResolveBetsFunction)(void *pState, const int *pnVariables);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRAPSIMPLUGIN_H */
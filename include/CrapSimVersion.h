@@ -9,7 +9,7 @@ namespace CrapSimVersion{
 	static const std::string DATE {"09"};
 	static const std::string MONTH {"12"};
 	static const std::string YEAR {"2014"};
-	std::string DateVersion() {return (YEAR+MONTH+DATE); }
+	inline std::string DateVersion() {return (YEAR+MONTH+DATE); }
 
 	//Software Status
 	// Pre-alpha = The software is still under active development and not
@@ -31,7 +31,7 @@ namespace CrapSimVersion{
 	static const int MAJOR = 0;
 	static const int MINOR = 7;
 	static const int PATCH = 0;
-	std::string SemanticVersion() { return (std::to_string(MAJOR) + "." + std::to_string(MINOR) + "." + std::to_string(PATCH)); }
+	inline std::string SemanticVersion() { return (std::to_string(MAJOR) + "." + std::to_string(MINOR) + "." + std::to_string(PATCH)); }
 }
 
 #endif // CRAPSIMVERSION_H_INCLUDED
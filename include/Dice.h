@@ -31,7 +31,24 @@
 #include <algorithm>
 #include <array>
 #include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Checkpoint.h"
+#include "DiceModel.h"
 #include "Die.h"
+#include "RollTape.h"
+
+// Number of distinct outcomes of two six-sided dice
+const int DICE_OUTCOMES = 36;
+
+// Used to identify how the Dice sample outcomes across simulation runs
+enum class DiceSampling
+{
+    PLAIN,          // Every roll is independent
+    ANTITHETIC,     // Odd runs replay the partners of the preceding run's outcomes
+    STRATIFIED      // Come out roll of each run cycles through all outcomes
+};
 
 class Dice
 {
@@ -48,6 +65,19 @@ class Dice
 
         // Roll the dice
         int   Roll();
+        // Seed the dice, so that a simulation can be repeated
+        void  Seed(unsigned nSeed);
+        // Seed the dice for one simulation run, so that the run's rolls
+        // depend only on the seed and the run, not on the runs before it
+        void  Seed(unsigned nSeed, unsigned nRun);
+        // Prepare the dice for a new simulation run
+        void  NewRun();
+        // Set and return the sampling method
+        bool  SetSampling(std::string sSampling);
+        std::string Sampling() const;
+        DiceSampling SamplingMethod() const    { return (m_ecDiceSampling); }
+        // Return the come out outcome (0..DICE_OUTCOMES-1) forced for this run when stratified
+        int   Stratum() const                  { return (m_nStratum); }
         // Return last roll value
         int   RollValue() const                { return (m_nRollValue); }
         // Set of Craps specific dice value checks
@@ -67,23 +97,84 @@ class Dice
         bool  IsAPointNumber() const           { return (std::count(m_anPointNumbers.begin(), m_anPointNumbers.end(), m_nRollValue)) ? true : false; }
         bool  IsHard() const                   { return (m_cDie1.RollValue() == m_cDie2.RollValue()); }
         // Return the number times a value has been rolled
-        int   RollValueCount(int i) const      { return (m_pnDiceRollValues[i - 1]); }
+        long long RollValueCount(int i) const  { return (m_pnDiceRollValues[i - 1]); }
         // Return the total number of rolls
-        int   TotalRolls() const               { return (m_nTotalDiceRolls); }
-        // Return the percentage of times a value is rolled
-        float RollValuePercentage(int i) const { return ((float)RollValueCount(i) / TotalRolls() * 100); }
+        long long TotalRolls() const           { return (m_nTotalDiceRolls); }
+        // Return the percentage of times a value is rolled, 0 if no rolls were made
+        float RollValuePercentage(int i) const { return (TotalRolls() > 0 ? (float)RollValueCount(i) / TotalRolls() * 100 : 0.0f); }
+        // Count rolls of a value made by other dice, e.g., lockstep lanes, in the history
+        void  CountRolls(int i, long long nTimes) { m_pnDiceRollValues[i - 1] += nTimes; m_nTotalDiceRolls += nTimes; }
+
+        // Roll by the model cTable in place of fair dice, and let a share
+        // dSetterShare of shooters, chosen as each comes out, roll by cSetter
+        void  SetModels(const DiceModel &cTable, const DiceModel &cSetter, double dSetterShare);
+        bool  Fair() const                     { return (!m_pcTableModel && !m_pcSetterModel); }
+        const DiceModel* TableModel() const    { return (m_pcTableModel.get()); }
+        const DiceModel* SetterModel() const   { return (m_pcSetterModel.get()); }
+        double SetterShare() const             { return (m_dSetterShare); }
+        // Return the models in text, e.g., for keys of results
+        std::string ModelFingerprint() const;
+
+        // Record the rolls to a roll tape at sPath, and finish the tape
+        void  RecordRolls(const std::string &sPath);
+        void  FinishRecording();
+        const RollTapeRecorder* Recorder() const { return (m_pcRecorder.get()); }
+        // Play the rolls of the roll tape at sPath in place of rolling, each
+        // run from the start of the run recorded
+        void  ReplayRolls(const std::string &sPath);
+        const RollTapePlayer* Player() const   { return (m_pcPlayer.get()); }
+
+        // Save and restore the dice, their counts and the sampling state
+        void  Save(Checkpoint &cCheckpoint) const;
+        void  Restore(Checkpoint &cCheckpoint);
 
     private:
         // Dice
         Die m_cDie1;
         Die m_cDie2;
 
-        // Set counters to zero
-        int  m_nTotalDiceRolls = 0;
-        int  m_nRollValue      = 0;
+        // Set counters to zero; roll counts are 64 bits as they are summed
+        // over the runs of every part of a simulation
+        long long  m_nTotalDiceRolls = 0;
+        int        m_nRollValue      = 0;
 
         // Pointer / array to roll values
-        int  *m_pnDiceRollValues;
+        long long *m_pnDiceRollValues;
+
+        // Roll both dice freely or force them to an outcome index
+        int   RollOutcome();
+        int   ForceOutcome(int nOutcome);
+
+        // Sampling method and its per run state
+        DiceSampling     m_ecDiceSampling = DiceSampling::PLAIN;
+        int              m_nRun           = 0;
+        int              m_nRunRolls      = 0;
+        int              m_nStratum       = 0;
+        bool             m_bMirrorRun     = false;
+        // Outcomes of the first run of an antithetic pair, replayed mirrored
+        std::vector<int> m_vnRunOutcomes;
+        // Antithetic partner of each outcome index
+        std::array<int, DICE_OUTCOMES> m_anAntitheticOutcome;
+
+        // Models the dice roll by, shared by copies of the Dice, nullptr for
+        // fair dice; the model of the shooter, and, with a share of dice
+        // setters, the point the shooter is on and the chance of a setter
+        std::shared_ptr<const DiceModel> m_pcTableModel;
+        std::shared_ptr<const DiceModel> m_pcSetterModel;
+        const DiceModel *m_pcShooterModel {nullptr};
+        double           m_dSetterShare     {0.0};
+        uint64_t         m_nSetterThreshold {0};
+        int              m_nShooterPoint    {0};
+        bool             m_bSetterShooting  {false};
+
+        // Choose whether the next shooter is a dice setter, and follow the
+        // shooter's point
+        void  NewShooter();
+        void  FollowShooter();
+
+        // Roll tapes recorded and played, shared by copies of the Dice
+        std::shared_ptr<RollTapeRecorder> m_pcRecorder;
+        std::shared_ptr<RollTapePlayer>   m_pcPlayer;
 
         // Array to hold field numbers
         std::array<int, 7> m_anFieldNumbers {{2, 3, 4, 9, 10, 11, 12}};  // Synchronize field numbers with Bet.cpp CalculatePayoff()
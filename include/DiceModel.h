@@ -0,0 +1,88 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The DiceModel class holds a distribution of the 36 outcomes of two
+ * dice that need not be fair: dice with weighted faces, or a dice setter
+ * who throws fewer sevens and favours some outcomes over others.  Outcomes
+ * are drawn with Walker's alias method: one draw picks one of 36 columns,
+ * and a second keeps the column's outcome or takes its alias, so a roll
+ * costs the same whatever the distribution.
+ *
+ */
+
+#ifndef DICEMODEL_H
+#define DICEMODEL_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "CrapSimException.h"
+
+// Number of outcomes of two six-sided dice, (die1 - 1) * 6 + (die2 - 1)
+const int DICE_MODEL_OUTCOMES = 36;
+
+class DiceModel
+{
+    public:
+        // Fair dice
+        DiceModel();
+
+        // Set the weight of each face, 1..6, of both dice
+        void SetFaceWeights(const std::vector<double> &vdWeights);
+        // Set the weight of each outcome, in place of the face weights
+        void SetOutcomeWeights(const std::vector<double> &vdWeights);
+        // Set the chance of a seven, scaling the other outcomes to match
+        void SetSevenRate(double dSevenRate);
+
+        // Return whether the dice are fair
+        bool   Fair() const                    { return (m_bFair); }
+        // Return the chance of an outcome, and of a roll value 2..12
+        double Probability(int nOutcome) const { return (m_adProbability[nOutcome]); }
+        double ValueProbability(int nValue) const;
+        // Return the distribution in text, exactly, e.g., for keys of results
+        std::string Fingerprint() const;
+
+        // Draw an outcome from two uniform 32 bit random numbers
+        int    Sample(uint32_t nColumn, uint32_t nCoin) const
+        {
+            const unsigned nIndex = static_cast<unsigned>((static_cast<uint64_t>(nColumn) * DICE_MODEL_OUTCOMES) >> 32);
+            return (nCoin < m_anThreshold[nIndex] ? static_cast<int>(nIndex) : m_anAlias[nIndex]);
+        }
+
+    private:
+        // Weights of the faces or of the outcomes, and the chance of a seven
+        std::vector<double> m_vdFaceWeights;
+        std::vector<double> m_vdOutcomeWeights;
+        double              m_dSevenRate {-1.0};
+
+        // The distribution and its alias table: a column keeps its own
+        // outcome if the coin is under the threshold, else takes its alias
+        bool                                         m_bFair {true};
+        std::array<double, DICE_MODEL_OUTCOMES>      m_adProbability;
+        std::array<uint64_t, DICE_MODEL_OUTCOMES>    m_anThreshold;
+        std::array<int, DICE_MODEL_OUTCOMES>         m_anAlias;
+
+        // Work out the distribution from the weights, and its alias table
+        void Build();
+};
+
+#endif // DICEMODEL_H
@@ -28,9 +28,12 @@
 #define DIE_H
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
+#include <random>
 #include <algorithm>
 #include <iterator>
+#include "Checkpoint.h"
 
 class Die
 {
@@ -44,31 +47,45 @@ class Die
         // Destructor
         ~Die();
 
+        // Seed the die, so that its rolls can be repeated
+        void Seed(std::seed_seq &cSeed);
+
         // Roll the die
         int Roll();
+        // Set the die to a face as if rolled, used by Dice sampling methods
+        int Force(int nValue);
+        // Return a uniform 32 bit random number from the die's generator,
+        // used by Dice models that draw the outcome of both dice at once
+        uint32_t Draw()                        { return (static_cast<uint32_t>(m_cGenerator())); }
 
         // Return the last rolled value
         int RollValue() const                  { return (m_nLastDieRollValue); }
 
         // Return the number of times a particular value is rolled
-        int   RollValueCount(int i) const      { return m_pnDieRollValues[i-1];}
+        long long RollValueCount(int i) const  { return m_pnDieRollValues[i-1];}
         // Return the total number of times the die has been rolled
-        int   TotalRolls() const               { return m_nTotalDieRolls; }
+        long long TotalRolls() const           { return m_nTotalDieRolls; }
         // Return the percentage of times a value is rolled
         float RollValuePercentage(int i) const { return (float)RollValueCount(i) / TotalRolls() * 100; }
 
         // Return the number of faces
         int Faces() const { return (m_nFaces); }
 
+        // Save and restore the random number generator and counts
+        void Save(Checkpoint &cCheckpoint) const;
+        void Restore(Checkpoint &cCheckpoint);
+
     private:
         // Set counters to zero
-        int m_nTotalDieRolls    = 0;
+        long long m_nTotalDieRolls = 0;
         int m_nLastDieRollValue = 0;
         int m_nFaces            = 0;
         // Pointer / array to capture roll values
-        int *m_pnDieRollValues;
+        long long *m_pnDieRollValues;
 
-        std::function<int()> rollDie;
+        // Random number generator and the distribution of its faces
+        std::mt19937                       m_cGenerator;
+        std::uniform_int_distribution<int> m_cDistribution;
 };
 
 #endif // DIE_H
@@ -0,0 +1,92 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The LockstepEngine class plays independent simulation runs of one
+ * Pass and Pass Odds Strategy side by side.  Each lane is a run with its
+ * own dice and table state, advanced a roll at a time with all other lanes
+ * by branch-free loops the compiler can vectorize.  When a lane's run ends
+ * it is recorded in the Strategy and the lane starts the next run.  The
+ * rules are those of the Strategy and every outcome of the dice is equally
+ * likely, so results agree in distribution with Simulation::Run(), though
+ * not roll for roll.
+ *
+ */
+
+#ifndef LOCKSTEPENGINE_H
+#define LOCKSTEPENGINE_H
+
+#include <array>
+#include <cstdint>
+#include "Dice.h"
+#include "Strategy.h"
+#include "Table.h"
+
+// Number of runs played side by side
+const int LOCKSTEP_LANES = 16;
+
+class LockstepEngine
+{
+    public:
+        // Constructor seeds the dice of every lane
+        LockstepEngine();
+
+        // Play nRuns runs of a Strategy, which must be IsPassLineOnly(), and
+        // count the rolls in the dice history
+        void Run(Strategy &cStrategy, const Table &cTable, int nRuns, Dice &cDice);
+
+    private:
+        // Start a new run in a lane
+        void StartLane(int nLane);
+        // Step a lane's generator, roll the dice of every lane, and play
+        // one roll in every lane
+        uint32_t NextRandom(int nLane);
+        void RollDice();
+        void PlayRoll();
+
+        // Strategy settings
+        int   m_nInitialBankroll       {0};
+        int   m_nStandardWager         {0};
+        float m_fOdds                  {0.0};
+        int   m_nFullWager             {0};
+        int   m_nSignificantBankroll   {0};
+        int   m_nPlayForNumberOfRolls  {0};
+
+        // Table limits, by point
+        int   m_nTableMaximum          {0};
+        std::array<float, 13> m_afMaxOdds {};
+
+        // Dice of each lane, xorshift128 generators
+        std::array<uint32_t, LOCKSTEP_LANES> m_anRandomX;
+        std::array<uint32_t, LOCKSTEP_LANES> m_anRandomY;
+        std::array<uint32_t, LOCKSTEP_LANES> m_anRandomZ;
+        std::array<uint32_t, LOCKSTEP_LANES> m_anRandomW;
+
+        // State of each lane's run; a point of zero is the come out
+        std::array<int, LOCKSTEP_LANES> m_anRollValue;
+        std::array<int, LOCKSTEP_LANES> m_anPoint;
+        std::array<int, LOCKSTEP_LANES> m_anBankroll;
+        std::array<int, LOCKSTEP_LANES> m_anPassWager;
+        std::array<int, LOCKSTEP_LANES> m_anOddsWager;
+        std::array<int, LOCKSTEP_LANES> m_anRolls;
+        std::array<int, LOCKSTEP_LANES> m_anPlaying;
+};
+
+#endif // LOCKSTEPENGINE_H
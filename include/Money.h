@@ -42,6 +42,8 @@ class Money
         int  Bankroll() const                        { return (m_nBankroll); }
         // Return the max bankroll attained
         int  MaxBankroll() const                     { return (m_nMaxBankroll); }
+        // Set the bankroll, e.g., to the result of a run played elsewhere
+        void SetBankroll(int n)                      { m_nBankroll = n; if (m_nMaxBankroll < m_nBankroll) m_nMaxBankroll = m_nBankroll; }
         // Decrement from the bankroll
         void Decrement(int w)                        { m_nBankroll -= w; }
         // Increment bankroll and update max bankroll attained
@@ -72,6 +74,8 @@ class Money
               else throw CrapSimException("Money::SetSignificantWinnings", std::to_string(i)); }
         // Return whether the significant winnings has been attained
         bool HasSignificantWinnings() const;
+        // Return the smallest bankroll that has significant winnings
+        int  SignificantBankroll() const;
 
         // Reset the class - meant to be called before a new Simulation run
         void Reset();
@@ -0,0 +1,142 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The Optimizer class searches Strategy settings for the best win
+ * percentage or ending bankroll with an evolutionary algorithm.  Each
+ * generation of candidates plays the same dice in one Simulation, fitness
+ * is averaged over every generation a candidate survives, and the best
+ * candidates are re-evaluated over more runs before they are reported as
+ * Strategy sections.
+ *
+ */
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <functional>
+#include <map>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Simulation.h"
+#include "Statistics.h"
+#include "Table.h"
+
+class Optimizer
+{
+    public:
+        // Creates a Strategy from key, value settings and adds it to a Simulation
+        typedef std::function<void(const std::map<std::string, std::string> &mSettings, Simulation &cSim)> StrategyFactory;
+
+        // Constructor sets the Table to play and how to create Strategies
+        Optimizer(const Table &cTable, StrategyFactory fCreateStrategy);
+
+        // Set the search effort
+        void SetGenerations(int n)       { m_nGenerations = n; }
+        void SetPopulation(int n)        { m_nPopulation = n; }
+        void SetRuns(int n)              { m_nRuns = n; }
+        void SetFinalRuns(int n)         { m_nFinalRuns = n; }
+        void SetTop(int n)               { m_nTop = n; }
+        // Set the objective, WIN or BANKROLL
+        bool SetObjective(std::string sObjective);
+        // Seed the search, and the dice the candidates play, so that a search
+        // can be repeated
+        void SetSeed(unsigned nSeed)     { m_cGenerator.seed(nSeed); }
+        // Set the name of the Strategies found
+        void SetName(const std::string &sName) { m_sName = sName; }
+        // Set settings shared by every candidate
+        void SetBase(const std::map<std::string, std::string> &mBase) { m_mBase = mBase; }
+        // Add a key to search over the given values
+        void AddParameter(const std::string &sKey, const std::vector<std::string> &vValues);
+
+        // Search for the best Strategies
+        void Optimize();
+        // Write the best Strategies as configuration file sections
+        void Report(std::ostream &os) const;
+
+    private:
+        // A point in the search space: an index into each parameter's values
+        typedef std::vector<int> Genome;
+
+        // A searched key and its values
+        struct Parameter
+        {
+            std::string              sKey;
+            std::vector<std::string> vValues;
+        };
+
+        // Results of a candidate over one evaluation
+        struct Evaluation
+        {
+            double dObjective;
+            double dWinPercentage;
+            double dWinHalfWidth;
+            double dMeanBankroll;
+        };
+
+        // A candidate re-evaluated at the end of the search
+        struct Result
+        {
+            Genome     vnGenes;
+            Evaluation stEvaluation;
+        };
+
+        // Return the settings of a candidate
+        std::map<std::string, std::string> Settings(const Genome &vnGenes) const;
+        // Play candidates on common dice seeded with nSeed and return their results
+        std::vector<Evaluation> Evaluate(const std::vector<Genome> &vGenomes, int nRuns, unsigned nSeed) const;
+        // Return a random candidate
+        Genome RandomGenome();
+        // Return a candidate bred from the survivors of a generation
+        Genome Offspring(const std::vector<Genome> &vSurvivors);
+        // Return the number of distinct candidates, capped at nCap
+        std::size_t SearchSpaceSize(std::size_t nCap) const;
+        // Return the candidates ranked by mean fitness, best first
+        std::vector<Genome> Ranked(const std::vector<Genome> &vGenomes) const;
+
+        // Table and Strategy factory
+        Table                             m_cTable;
+        StrategyFactory                   m_fCreateStrategy;
+
+        // Search effort and objective
+        int                               m_nGenerations {20};
+        int                               m_nPopulation  {32};
+        int                               m_nRuns        {200};
+        int                               m_nFinalRuns   {2000};
+        int                               m_nTop         {3};
+        bool                              m_bBankroll    {false};
+
+        // Settings shared by every candidate, and the searched parameters
+        std::string                       m_sName {"Optimized"};
+        std::map<std::string, std::string> m_mBase;
+        std::vector<Parameter>            m_vParameters;
+
+        // Fitness of every candidate evaluated, one observation per generation
+        std::map<Genome, RunningStatistics> m_mFitness;
+        // Best candidates after re-evaluation
+        std::vector<Result>               m_vResults;
+
+        // Random number generator for the search
+        std::mt19937                      m_cGenerator;
+};
+
+#endif // OPTIMIZER_H
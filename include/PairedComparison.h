@@ -0,0 +1,77 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The PairedComparison class compares Strategies run by run.  Because
+ * all Strategies at a Table play the same Dice, their outcomes are
+ * correlated and the difference between two Strategies can be estimated
+ * far more precisely than either Strategy alone (common random numbers).
+ *
+ */
+
+#ifndef PAIREDCOMPARISON_H
+#define PAIREDCOMPARISON_H
+
+#include <string>
+#include <vector>
+#include "Checkpoint.h"
+#include "Statistics.h"
+
+// The outcome of a single simulation run for one Strategy
+struct RunOutcome
+{
+    bool bPlayed;
+    bool bWon;
+    int  nBankroll;
+    int  nRolls;
+};
+
+class PairedComparison
+{
+    public:
+        // Set up the pairs to compare.  If sBaseline names a Strategy, every
+        // other Strategy is compared against it; otherwise all pairs are compared.
+        void Initialize(const std::vector<std::string> &vNames, const std::string &sBaseline);
+        // Accumulate the outcomes of one simulation run, one per Strategy
+        void Update(const std::vector<RunOutcome> &vOutcomes);
+        // Print the paired differences and their confidence intervals
+        void Report() const;
+        // Save and restore the accumulated differences
+        void Save(Checkpoint &cCheckpoint) const   { cCheckpoint.Put(m_vPairs); }
+        void Restore(Checkpoint &cCheckpoint)      { cCheckpoint.Get(m_vPairs); }
+
+    private:
+        // Accumulated differences for a pair of Strategies
+        struct Pair
+        {
+            int nFirst;
+            int nSecond;
+            RunningCovariance cWin;
+            RunningCovariance cBankroll;
+            RunningCovariance cRolls;
+        };
+
+        // Names of the Strategies, in Simulation order
+        std::vector<std::string> m_vNames;
+        // Container of compared pairs
+        std::vector<Pair>        m_vPairs;
+};
+
+#endif // PAIREDCOMPARISON_H
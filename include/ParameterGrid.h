@@ -0,0 +1,68 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The ParameterGrid class expands Strategy settings written with
+ * range syntax, e.g., StandardOdds=1..10:1, or list syntax, e.g.,
+ * SWM={1.5,2,3}, into the Cartesian product of their values.
+ *
+ */
+
+#ifndef PARAMETERGRID_H
+#define PARAMETERGRID_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// Largest number of Strategies a single section may expand to
+const std::size_t PARAMETER_GRID_MAX_POINTS = 1000000;
+
+class ParameterGrid
+{
+    public:
+        // Return whether a configuration value uses range or list syntax
+        static bool IsSweep(const std::string &sValue);
+        // Add a key whose value sweeps over a range or list
+        void AddAxis(const std::string &sKey, const std::string &sValue);
+        // Return the number of points in the grid, 1 if nothing sweeps
+        std::size_t Size() const;
+        // Return the key, value settings of a point
+        std::map<std::string, std::string> Point(std::size_t nPoint) const;
+        // Return a label for a point, e.g., "StandardOdds=2, SWM=1.5"
+        std::string Label(std::size_t nPoint) const;
+        // Expand range or list syntax into its values
+        static std::vector<std::string> Expand(const std::string &sKey, const std::string &sValue);
+
+    private:
+
+        // A swept key and its values
+        struct Axis
+        {
+            std::string              sKey;
+            std::vector<std::string> vValues;
+        };
+
+        // Container of swept keys, the first varying slowest
+        std::vector<Axis> m_vAxes;
+};
+
+#endif // PARAMETERGRID_H
@@ -0,0 +1,85 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The PassLineKernel class plays a family of Pass and Pass Odds
+ * Strategies that differ only in their numbers (wager, odds, bankroll,
+ * significant winnings) as lanes.  Bankrolls, wagers and roll counts are
+ * kept in contiguous arrays, and each roll is resolved across all lanes by
+ * branch-free loops the compiler can vectorize, instead of walking each
+ * Strategy's list of Bets.  The results are identical to the Strategies
+ * playing the same rolls themselves.
+ *
+ */
+
+#ifndef PASSLINEKERNEL_H
+#define PASSLINEKERNEL_H
+
+#include <vector>
+#include "Dice.h"
+#include "Strategy.h"
+#include "Table.h"
+
+// Fewest Strategies worth playing as lanes
+const std::vector<Strategy *>::size_type PASS_LINE_KERNEL_MIN_LANES = 8;
+
+class PassLineKernel
+{
+    public:
+        // Set up a lane for each Strategy, which must be IsPassLineOnly()
+        void Initialize(const std::vector<Strategy *> &vpStrategies, const Table &cTable);
+        // Return the number of lanes and the Strategies they play
+        std::vector<Strategy *>::size_type Lanes() const { return (m_vpStrategies.size()); }
+        const std::vector<Strategy *>& Strategies() const { return (m_vpStrategies); }
+
+        // Make Pass and Pass Odds bets in every lane still playing
+        void MakeBets(const Table &cTable);
+        // Resolve the roll in every lane.  Returns whether any lane is still playing.
+        bool PlayRoll(const Table &cTable, const Dice &cDice);
+        // Hand the outcome of the run to each lane's Strategy
+        void Store() const;
+        // Reset the lanes for a new simulation run
+        void Reset();
+
+    private:
+        // Strategy played by each lane
+        std::vector<Strategy *> m_vpStrategies;
+
+        // Settings, one per lane
+        std::vector<int>   m_vnInitialBankroll;
+        std::vector<int>   m_vnStandardWager;
+        std::vector<float> m_vfOdds;
+        std::vector<int>   m_vnFullWager;
+        std::vector<int>   m_vnSignificantBankroll;
+        std::vector<int>   m_vnPlayForNumberOfRolls;
+
+        // State of the run, one per lane
+        std::vector<int>   m_vnBankroll;
+        std::vector<int>   m_vnPassWager;
+        std::vector<int>   m_vnOddsWager;
+        std::vector<int>   m_vnRolls;
+        std::vector<int>   m_vnPlaying;
+
+        // Table limits
+        int                m_nTableMaximum {0};
+        float              m_afMaxOdds[13] {};
+};
+
+#endif // PASSLINEKERNEL_H
@@ -28,7 +28,6 @@
 #define QUALIFIEDSHOOTER_H
 
 #include <locale>
-#include <map>
 #include <string>
 #include "CrapSimException.h"
 #include "Dice.h"
@@ -61,11 +60,10 @@ enum class QualificationMethod
 class QualifiedShooter
 {
     public:
-        QualifiedShooter();
-
         // Set and return the qualification method
         void SetMethod(std::string sMethod);
         std::string Method() const;
+        bool MethodSet() const                  { return (m_ecQualificationMethod != QualificationMethod::QM_NO_METHOD); }
         // Set the count for the qualification method
         void SetCount(int i)
             { if (i >= 1) m_nQualificationCount = i;
@@ -93,9 +91,6 @@ class QualifiedShooter
         int  m_nCounter                             = 0;
         bool m_bWaitForNewQualification             = false;
 
-        // Map to associate the strings with the enum values
-        std::map<std::string, QualificationMethod> m_mQualificationMethod;
-
         // The 5 Count method
         bool Method5Count(const Table &cTable, const Dice &cDice);
 
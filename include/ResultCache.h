@@ -0,0 +1,62 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The ResultCache class keeps the results of Strategies on disk,
+ * one file per Strategy, named by a hash of everything the results depend
+ * on: the Strategy's settings, the Table, the seed, the number of runs and
+ * the version of CrapSim.  A Simulation with a result cache plays only the
+ * Strategies whose results are not in it.
+ *
+ */
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <string>
+#include "CrapSimException.h"
+#include "Strategy.h"
+
+// Format of the cache files; changed whenever a change to CrapSim changes
+// the results of the same settings, so that older results are not read
+const int RESULT_CACHE_FORMAT = 2;
+
+class ResultCache
+{
+    public:
+        // Keep the results in files in directory sDirectory
+        explicit ResultCache(const std::string &sDirectory) : m_sDirectory(sDirectory) {}
+
+        // Read the results stored for sKey, the text of everything they
+        // depend on; return false if there are none
+        bool Load(const std::string &sKey, StrategyResults &cResults) const;
+        // Store the results for sKey
+        void Store(const std::string &sKey, const StrategyResults &cResults) const;
+
+    private:
+        std::string m_sDirectory;
+
+        // Return the path of the file for sKey
+        std::string Path(const std::string &sKey) const;
+        // Return the first lines of the file for sKey
+        static std::string Header(const std::string &sKey);
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,159 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The RollTapeRecorder and RollTapePlayer classes record the rolls
+ * of the dice to a roll tape, and play them back, so that the same rolls can
+ * be fed to different strategies or builds of CrapSim, or rolls logged at a
+ * casino can be played.  A roll tape is a header followed by one 6 bit code
+ * per roll, four codes to three bytes, first code in the low bits.  Codes
+ * 0 to 35 are rolls, (die1 - 1) * 6 + (die2 - 1), and ROLLTAPE_RUN_END
+ * ends each run.  The header is the marker "CrapTape", the format, the
+ * number of runs and the number of rolls, all little endian, so a tape
+ * reads the same on every machine.
+ *
+ */
+
+#ifndef ROLLTAPE_H
+#define ROLLTAPE_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "CrapSimException.h"
+
+// Format of roll tapes
+const int ROLLTAPE_FORMAT       = 1;
+// Bytes in the header of a roll tape
+const int ROLLTAPE_HEADER_BYTES = 32;
+// Code that ends a run
+const unsigned ROLLTAPE_RUN_END = 63;
+
+class RollTapeRecorder
+{
+    public:
+        // Record to a new roll tape at sPath
+        explicit RollTapeRecorder(const std::string &sPath);
+        RollTapeRecorder(const RollTapeRecorder &) = delete;
+        RollTapeRecorder& operator=(const RollTapeRecorder &) = delete;
+        // Close the tape, if not closed, so that it holds the rolls recorded
+        ~RollTapeRecorder();
+
+        // Record a roll, given as its outcome 0..35
+        void Record(unsigned nOutcome)          { Put(nOutcome); ++m_nRolls; m_bInRun = true; }
+        // End the run being recorded, if it has rolls
+        void EndRun()                           { if (m_bInRun) { Put(ROLLTAPE_RUN_END); ++m_nRuns; m_bInRun = false; } }
+        // End the run and write the rest of the tape and its header
+        void Close();
+
+        // Record the rolls of the text roll log at sLogPath to a roll tape at
+        // sTapePath, and return the runs and rolls recorded
+        static void Import(const std::string &sLogPath, const std::string &sTapePath,
+                           unsigned long long &nRuns, unsigned long long &nRolls);
+
+        // Return the runs and rolls recorded
+        unsigned long long Runs() const         { return (m_nRuns); }
+        unsigned long long Rolls() const        { return (m_nRolls); }
+        const std::string& Path() const         { return (m_sPath); }
+
+    private:
+        std::string        m_sPath;
+        std::ofstream      m_ofsTape;
+        // Codes waiting for a whole three bytes, and bytes waiting to be written
+        unsigned           m_nCodeBits  {0};
+        int                m_nCodes     {0};
+        std::vector<char>  m_vcBuffer;
+        unsigned long long m_nRuns      {0};
+        unsigned long long m_nRolls     {0};
+        bool               m_bInRun     {false};
+
+        // Append a code
+        void Put(unsigned nCode)
+        {
+            m_nCodeBits |= nCode << (6 * m_nCodes);
+            if (++m_nCodes == 4) PutBytes();
+        }
+        // Move the codes waiting to the buffer, and write a full buffer
+        void PutBytes();
+};
+
+class RollTapePlayer
+{
+    public:
+        // Map the roll tape at sPath and find the start of each run
+        explicit RollTapePlayer(const std::string &sPath);
+        RollTapePlayer(const RollTapePlayer &) = delete;
+        RollTapePlayer& operator=(const RollTapePlayer &) = delete;
+        ~RollTapePlayer();
+
+        // Move to the start of run nRun
+        void StartRun(unsigned long long nRun)
+        {
+            if (nRun >= m_vnRunStarts.size())
+                throw CrapSimException("RollTapePlayer roll tape has no run", std::to_string(nRun + 1) + " in " + m_sPath);
+            m_nPosition = m_vnRunStarts[nRun];
+        }
+        // Return the next roll as its outcome 0..35.  A run longer than the
+        // run recorded carries on with the rolls of the runs after it.
+        unsigned Next()
+        {
+            unsigned nCode;
+            do
+            {
+                if (m_nPosition == m_nCodes)
+                    throw CrapSimException("RollTapePlayer ran out of rolls in", m_sPath);
+                nCode = Code(m_nPosition++);
+            }
+            while (nCode == ROLLTAPE_RUN_END);
+
+            return (nCode);
+        }
+
+        // Return the runs and rolls on the tape
+        unsigned long long Runs() const         { return (m_vnRunStarts.size()); }
+        unsigned long long Rolls() const        { return (m_nCodes - m_vnRunStarts.size()); }
+        const std::string& Path() const         { return (m_sPath); }
+
+    private:
+        std::string                     m_sPath;
+        // The mapped tape, and its codes
+        const unsigned char            *m_pnTape     {nullptr};
+        unsigned long long              m_nSize      {0};
+        const unsigned char            *m_pnCodes    {nullptr};
+        unsigned long long              m_nCodes     {0};
+        // The tape read into memory where it cannot be mapped
+        std::vector<unsigned char>      m_vnTape;
+        // The code of the next roll, and the first code of each run
+        unsigned long long              m_nPosition  {0};
+        std::vector<unsigned long long> m_vnRunStarts;
+
+        // Return code n
+        unsigned Code(unsigned long long n) const
+        {
+            const unsigned long long nBit = 6 * n;
+            const unsigned nShift = nBit & 7;
+            unsigned nCode = m_pnCodes[nBit >> 3] >> nShift;
+            if (nShift > 2) nCode |= m_pnCodes[(nBit >> 3) + 1] << (8 - nShift);
+
+            return (nCode & 63);
+        }
+};
+
+#endif // ROLLTAPE_H
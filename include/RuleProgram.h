@@ -0,0 +1,113 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The RuleProgram class compiles betting rules written in the
+ * configuration file, e.g., Rule1=IF POINT AND HITS >= 2 THEN PRESS PLACE6 6,
+ * into a compact stack machine bytecode, and runs them each roll.  A rule
+ * reads the table, bankroll and bets through variables filled in by the
+ * Strategy, and orders the Strategy to bet, press, regress or take down a
+ * bet.
+ *
+ */
+
+#ifndef RULEPROGRAM_H
+#define RULEPROGRAM_H
+
+#include <string>
+#include <vector>
+
+// Values a rule may read, filled in by the Strategy before each roll
+enum class RuleVariable
+{
+    RV_COMEOUT,                     // 1 on the come out, else 0
+    RV_POINT,                       // The point, 0 on the come out
+    RV_ROLL,                        // The last roll value
+    RV_BANKROLL,                    // The bankroll, not counting bets
+    RV_INITIAL,                     // The initial bankroll
+    RV_WAGER,                       // The standard wager
+    RV_ROLLS,                       // Rolls played in the run
+    RV_HITS,                        // Winning rolls in a row
+    RV_QUALIFIED,                   // 1 if the shooter is qualified, else 0
+    RV_FIRST_BET                    // Followed by the wager on each RuleBet
+};
+
+// Bets a rule may order, and whose wagers it may read
+enum class RuleBet
+{
+    RB_PASS,
+    RB_DONT_PASS,
+    RB_FIELD,
+    RB_PLACE4,
+    RB_PLACE5,
+    RB_PLACE6,
+    RB_PLACE8,
+    RB_PLACE9,
+    RB_PLACE10,
+    RB_HARD4,
+    RB_HARD6,
+    RB_HARD8,
+    RB_HARD10,
+    RB_COUNT
+};
+
+// Orders a rule may give
+enum class RuleAction
+{
+    RA_BET,
+    RA_PRESS,
+    RA_REGRESS,
+    RA_TAKEDOWN
+};
+
+// Number of variables a RuleProgram reads
+const int RULE_VARIABLES = static_cast<int>(RuleVariable::RV_FIRST_BET) + static_cast<int>(RuleBet::RB_COUNT);
+// Deepest evaluation stack a rule may need
+const int RULE_STACK_DEPTH = 32;
+
+// An order given by a rule that fired
+struct RuleOrder
+{
+    RuleAction ecAction;
+    RuleBet    ecBet;
+    int        nAmount;
+};
+
+class RuleProgram
+{
+    public:
+        // Compile a rule and append it to the program
+        void AddRule(const std::string &sRule);
+        // Return the number of rules and their text
+        std::vector<std::string>::size_type Rules() const { return (m_vsRules.size()); }
+        const std::vector<std::string>& RuleText() const  { return (m_vsRules); }
+
+        // Run the rules on the variables, in order, and append the orders of
+        // those that fire
+        void Execute(const int *pnVariables, std::vector<RuleOrder> &vOrders) const;
+
+    private:
+        // Bytecode of all rules
+        std::vector<int>         m_vnCode;
+        // Text of each rule
+        std::vector<std::string> m_vsRules;
+};
+
+#endif // RULEPROGRAM_H
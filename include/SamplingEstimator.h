@@ -0,0 +1,91 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The SamplingEstimator class estimates each Strategy's win
+ * percentage and ending bankroll when the Dice use a variance reduction
+ * sampling method.  Antithetic runs are averaged in pairs and stratified
+ * runs are weighted by stratum, so the confidence intervals account for
+ * the correlation the sampling method induces between runs.
+ *
+ */
+
+#ifndef SAMPLINGESTIMATOR_H
+#define SAMPLINGESTIMATOR_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include "Checkpoint.h"
+#include "Dice.h"
+#include "PairedComparison.h"
+#include "Statistics.h"
+
+class SamplingEstimator
+{
+    public:
+        // Set up an estimate for each Strategy under the sampling method
+        void Initialize(DiceSampling ecDiceSampling, const std::vector<std::string> &vNames);
+        // Accumulate the outcomes of one simulation run, one per Strategy,
+        // and the come out stratum of the run
+        void Update(const std::vector<RunOutcome> &vOutcomes, int nStratum);
+        // Print the estimates and their confidence intervals
+        void Report() const;
+        // Save and restore the estimates
+        void Save(Checkpoint &cCheckpoint) const   { cCheckpoint.Put(m_vEstimates); }
+        void Restore(Checkpoint &cCheckpoint)      { cCheckpoint.Get(m_vEstimates); }
+
+    private:
+        // Estimate of a single quantity under the sampling method
+        struct Estimate
+        {
+            // All runs, treated as independent
+            RunningStatistics cPlain;
+            // Antithetic pair averages
+            RunningStatistics cPairs;
+            double            dPending {0.0};
+            bool              bPending {false};
+            // Runs by come out stratum
+            std::array<RunningStatistics, DICE_OUTCOMES> acStrata;
+        };
+
+        // Estimates for a Strategy
+        struct StrategyEstimate
+        {
+            Estimate cWin;
+            Estimate cBankroll;
+        };
+
+        // Add an observation to an estimate
+        void   Add(Estimate &cEstimate, double x, int nStratum);
+        // Return the estimated mean and the half width of its 95% confidence interval
+        double Mean(const Estimate &cEstimate) const;
+        double HalfWidth(const Estimate &cEstimate) const;
+        // Return the number of plain runs needed per sampled run for the same confidence
+        double Efficiency(const Estimate &cEstimate) const;
+
+        DiceSampling                  m_ecDiceSampling {DiceSampling::PLAIN};
+        // Names of the Strategies, in Simulation order
+        std::vector<std::string>      m_vNames;
+        // Container of estimates, in Simulation order
+        std::vector<StrategyEstimate> m_vEstimates;
+};
+
+#endif // SAMPLINGESTIMATOR_H
@@ -27,11 +27,22 @@
 #ifndef SIMULATION_H
 #define SIMULATION_H
 
+#include "Checkpoint.h"
 #include "Dice.h"
 #include "Table.h"
 #include "Strategy.h"
+#include "LockstepEngine.h"
+#include "PairedComparison.h"
+#include "PassLineKernel.h"
+#include "SamplingEstimator.h"
+#include <iostream>
+#include <string>
+#include <utility>
 #include <vector>
 
+// Number of runs between tallies and confidence interval checks
+const int SIMULATION_BATCH_RUNS = 100;
+
 class Simulation
 {
     public:
@@ -40,12 +51,97 @@ class Simulation
 
         // Add classes to the Simulation
         void AddTable(Table cTable)          { this->m_cTable = cTable; }
-        void AddStrategy(Strategy cStrategy) { m_vStrategies.push_back(cStrategy); }
+        void AddStrategy(Strategy cStrategy) { m_vStrategies.push_back(std::move(cStrategy)); }
+        // Reserve room for the Strategies to be added
+        void ReserveStrategies(std::vector<Strategy>::size_type n) { m_vStrategies.reserve(n); }
+
+        // Compare Strategies run by run on the common dice, optionally against a baseline Strategy
+        void SetPairedComparison(bool b, std::string sBaseline) { m_bPairedComparison = b; m_sComparisonBaseline = sBaseline; }
+
+        // Seed the dice, so that the simulation can be repeated
+        void SetSeed(unsigned nSeed)         { m_cDice.Seed(nSeed); m_nSeed = nSeed; }
+
+        // Read the results of Strategies played before from a ResultCache
+        // in directory sDirectory, and store the results of those played.
+        // The dice are seeded anew for each run from the seed and the run,
+        // so that a Strategy's results do not depend on the other Strategies.
+        void SetResultCache(std::string sDirectory) { m_sResultCache = sDirectory; }
+
+        // Write the state of the runs to a Checkpoint file sPath every
+        // nEveryRuns runs or nEverySeconds seconds (0 for never), and with
+        // bResume, carry on from the file if it exists
+        void SetCheckpoint(std::string sPath, int nEveryRuns, int nEverySeconds, bool bResume)
+            { m_sCheckpoint = sPath; m_nCheckpointRuns = nEveryRuns; m_nCheckpointSeconds = nEverySeconds; m_bResume = bResume; }
+
+        // Play only shard nShard of nShards, a slice of the runs with each run
+        // seeded from the seed and its number, and write the results to the
+        // partial results file sPath
+        void SetShard(int nShard, int nShards, std::string sPath)
+            { m_nShard = nShard; m_nShards = nShards; m_sPartialResults = sPath; }
+        // Play only the nRuns runs from run nFirstRun on, each seeded from the
+        // seed and its number, e.g., a batch of the runs of a cluster
+        void SetSlice(int nFirstRun, int nRuns) { m_nSliceFirstRun = nFirstRun; m_nSliceRuns = nRuns; }
+        // Return the results of the slice played, of all nRuns runs, to be merged
+        std::string PartialResults(int nRuns) const;
+
+        // Record the rolls to the roll tape sRecordPath, and play the rolls of
+        // the roll tape sReplayPath in place of rolling, where not empty
+        void SetRollTapes(const std::string &sRecordPath, const std::string &sReplayPath);
+
+        // Roll the dice by the model cTable, and let a share dSetterShare of
+        // shooters roll by the model cSetter
+        void SetDiceModels(const DiceModel &cTable, const DiceModel &cSetter, double dSetterShare)
+            { m_cDice.SetModels(cTable, cSetter, dSetterShare); }
+
+        // Set the variance reduction sampling method of the dice
+        bool SetSampling(std::string sSampling) { return (m_cDice.SetSampling(sSampling)); }
+        DiceSampling Sampling() const        { return (m_cDice.SamplingMethod()); }
+
+        // Stop once every Strategy's 95% confidence intervals are no wider than
+        // dTargetCIWidth.  With bDropOnTarget, each Strategy stops playing as
+        // soon as it meets the target itself.
+        void SetStoppingRule(double dTargetCIWidth, bool bDropOnTarget)
+            { m_dTargetCIWidth = dTargetCIWidth; m_bDropOnTarget = bDropOnTarget; }
+        // Set the most runs a stopping rule or race may use
+        void SetMaxRuns(int nMaxRuns)        { m_nMaxRuns = nMaxRuns; }
+
+        // Race the Strategies, eliminating those that cannot be among the best
+        // nSurvivors by win percentage.  Each round doubles the runs of the last.
+        void SetRace(bool b, int nSurvivors) { m_bRace = b; m_nRaceSurvivors = nSurvivors; }
+
+        // Play the runs of each Strategy side by side on independent dice,
+        // where every Strategy makes only Pass and Pass Odds bets
+        void SetLockstep(bool b)             { m_bLockstep = b; }
+
+        // Count the heap allocations made per roll once the first run is over
+        void SetCountAllocations(bool b)     { m_bCountAllocations = b; }
+
+        // Write the survival curve of each Strategy, the chance of being
+        // solvent after each number of rolls, to the CSV file sPath with
+        // the report
+        void SetSurvivalCurve(std::string sPath) { m_sSurvivalCurve = sPath; }
+
+        // Write the progress Run() prints to osLog instead of std::cout
+        void SetLog(std::ostream &osLog)     { m_posLog = &osLog; }
 
         // Run number of nRuns simulations.  Flags to generate a muster and the working tally.
         void Run(int nRuns, bool bMusterReport, bool bTally);
+        // Merge the partial results of slices of nRuns runs in place of
+        // running them: start, merge each as it comes, and report the runs
+        // merged and any missing
+        void StartMerge(int nRuns);
+        void MergePartialResults(const std::string &sBytes, const std::string &sSource);
+        int  RunsMerged() const;
+        void FinishMerge();
+        // Merge the partial results files of the shards of nRuns runs
+        void MergePartialResults(const std::vector<std::string> &vsPaths, int nRuns);
         // End of simulation report.
         void Report();
+        // Return the Strategies and their results
+        const std::vector<Strategy>& Strategies() const { return (m_vStrategies); }
+        // Return the number of times a value was rolled, and the rolls made
+        long long RollValueCount(int i) const { return (m_cDice.RollValueCount(i)); }
+        long long TotalRolls() const          { return (m_cDice.TotalRolls()); }
 
     private:
         // Dice and Table
@@ -53,21 +149,97 @@ class Simulation
         Table                   m_cTable;
         // Container of Strategies
         std::vector<Strategy>   m_vStrategies;
+        // Strategies still playing, and whether each Strategy is still playing
+        std::vector<Strategy *> m_vpActiveStrategies;
+        std::vector<bool>       m_vbActive;
+        // Active Strategies played one by one, and those played as pass line lanes
+        std::vector<Strategy *> m_vpScalarStrategies;
+        PassLineKernel          m_cPassLineKernel;
+        // Independent runs played side by side
+        bool                    m_bLockstep      {false};
+        LockstepEngine          m_cLockstepEngine;
+        // Count heap allocations per roll
+        bool                    m_bCountAllocations {false};
+        // Where Run() prints its progress
+        std::ostream           *m_posLog         {&std::cout};
+        // The survival curves file, if any
+        std::string             m_sSurvivalCurve;
+        // The seed of the dice, and the directory of the result cache, if any
+        unsigned                m_nSeed          {0};
+        std::string             m_sResultCache;
+        // The checkpoint file, how often it is written, and whether to resume from it
+        std::string             m_sCheckpoint;
+        int                     m_nCheckpointRuns    {0};
+        int                     m_nCheckpointSeconds {0};
+        bool                    m_bResume            {false};
+        // The shard played, of how many, and its partial results file
+        int                     m_nShard             {0};
+        int                     m_nShards            {0};
+        std::string             m_sPartialResults;
+        // The slice of the runs played, -1 runs for all of them
+        int                     m_nSliceFirstRun     {0};
+        int                     m_nSliceRuns         {-1};
+        // The partial results merged: their key, the runs of all the slices,
+        // and the first run and runs of each slice merged
+        std::string             m_sMergeKey;
+        int                     m_nMergeRuns         {0};
+        std::vector<std::pair<int, int>> m_vMergedRuns;
+
+        // Sequential stopping rule
+        double                  m_dTargetCIWidth {0.0};
+        int                     m_nMaxRuns       {0};
+        bool                    m_bDropOnTarget  {false};
+
+        // Racing, and the round in which each Strategy was eliminated (0 if not)
+        bool                    m_bRace          {false};
+        int                     m_nRaceSurvivors {1};
+        std::vector<int>        m_vnEliminatedRound;
+
+        // Paired comparison of Strategies
+        bool                    m_bPairedComparison {false};
+        std::string             m_sComparisonBaseline;
+        PairedComparison        m_cPairedComparison;
+        // Estimates under the dice sampling method
+        SamplingEstimator       m_cSamplingEstimator;
+        std::vector<RunOutcome> m_vRunOutcomes;
 
+        // Ensure that each Strategy conforms to the Table
+        void SanityCheckStrategies();
         // Direct Strategies to make their bets
         void MakeBets();
-        // Direct Strategies to resolve their bets
-        void ResolveBets();
-        // Direct the Strategies to qualify the shooter
-        void QualifyTheShooter();
-        // Direct the Strategies to qualify the shooter
-        void ModifyBets();
-        // Direct the Strategies to qualify the shooter
-        void FinalizeBets();
-        // Check if Strategies (Players) are still playing
-        bool PlayersStillLeft();
+        // Direct Strategies to play the roll: qualify the shooter, resolve,
+        // modify and finalize bets.  Returns whether any are still playing.
+        bool PlayRoll();
         // Capture stats
         void UpdateStatisticsAndReset();
+        // Whether the runs can be played by the LockstepEngine
+        bool LockstepEligible() const;
+        // Check Strategies against the target confidence interval width
+        bool TargetMet();
+        // Eliminate Strategies at the end of a racing round
+        void RaceRound(int nRound);
+        // Rebuild the active Strategies after some have stopped playing, and
+        // choose those played as pass line lanes
+        void UpdateActiveStrategies();
+        // Return the text of everything a Strategy's results depend on
+        std::string ResultCacheKey(const Strategy &cStrategy, int nRuns) const;
+        // Return the text of everything the state of the runs depends on
+        std::string CheckpointKey(int nRuns) const;
+        // Write and read the state of the runs after nRuns runs
+        void WriteCheckpoint(const std::string &sKey, int nRuns, int nRound, int nRoundRuns, int nRoundEnd) const;
+        bool ReadCheckpoint(const std::string &sKey, int &nRuns, int &nRound, int &nRoundRuns, int &nRoundEnd);
+        // Return the text of everything the partial results of a shard depend on
+        std::string PartialResultsKey(int nRuns) const;
+        // Put the results of the slice played, and write them to the
+        // partial results file
+        void SavePartialResults(Checkpoint &cPartial) const;
+        void WritePartialResults(int nRuns) const;
+        // Write the survival curves of the Strategies
+        void WriteSurvivalCurves() const;
+        // Rank the Strategies at the end of a race
+        void RaceReport() const;
+        // Print the running tally
+        void Tally(int nRuns, int nMaxRuns) const;
         // Create a muster report before starting the simulation
         void Muster();
 };
@@ -0,0 +1,136 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The SimulationCluster class spreads the runs of one Simulation
+ * over worker processes on many machines.  The coordinator listens on a TCP
+ * port, of the loopback interface unless another address is given.  The
+ * coordinator and each worker that connects prove to each other that they
+ * hold the token shared in the CLUSTER_TOKEN_VARIABLE environment variable,
+ * without sending it.  The coordinator sends a line of random hex digits, a
+ * challenge; the worker answers with a challenge of its own and the
+ * HMAC-SHA-256, under the token, of "worker", the coordinator's challenge
+ * and its own, separated by spaces; and the coordinator answers with the
+ * same for "coordinator".  Either side drops the other on a wrong proof.
+ * The coordinator hands each worker a batch of runs at a time, as a job
+ * line like those of the SimulationServer:
+ *
+ *     {"id": "runs1-100", "config": "...", "runs": 100000, "seed": 42, "first": 0, "count": 100}
+ *
+ * The worker plays runs first up to first + count of the runs, each seeded
+ * from the seed and its number, and answers with the partial results of
+ * the batch (see Simulation::PartialResults()) in hex:
+ *
+ *     {"id": "runs1-100", "status": "done", "output": "4372..."}
+ *
+ * The coordinator merges the results as they arrive.  Batches are sized
+ * from each worker's speed so that a batch takes about
+ * CLUSTER_BATCH_SECONDS, and shrink toward the end of the runs so that the
+ * workers finish together.  A batch whose worker goes away, or takes far
+ * longer than expected, is handed to another worker; as every run is
+ * seeded from its number, the results are the same whichever worker plays
+ * it, and the same as those of CrapSim --shard 1/1.
+ *
+ */
+
+#ifndef SIMULATIONCLUSTER_H
+#define SIMULATIONCLUSTER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CrapSimException.h"
+#include "Simulation.h"
+#include "SimulationServer.h"
+
+// Seconds a batch of runs is sized to take
+const double CLUSTER_BATCH_SECONDS = 2.0;
+// Fewest runs in a batch, unless fewer are left
+const int    CLUSTER_MIN_BATCH_RUNS = 10;
+// Least seconds to wait for a batch before handing it to another worker,
+// and how many times longer than expected a batch may take
+const int    CLUSTER_TIMEOUT_SECONDS = 60;
+const int    CLUSTER_TIMEOUT_FACTOR  = 10;
+// Environment variable holding the token the coordinator and workers
+// share, and the longest line of the handshake proving they hold it
+const char * const CLUSTER_TOKEN_VARIABLE = "CRAPSIM_CLUSTER_TOKEN";
+const std::string::size_type CLUSTER_MAX_HANDSHAKE_LENGTH = 256;
+
+class SimulationCluster
+{
+    public:
+        // Plays the batch of runs of a job and returns their partial results,
+        // throwing CrapSimException on error
+        typedef std::function<std::string(const SimulationJob &cJob)> BatchFunction;
+
+        // Coordinate nRuns runs of cSim, set up from the configuration file
+        // text sConfig with seed nSeed, on sAddress, [address:]port
+        SimulationCluster(Simulation &cSim, std::string sConfig, int nRuns, int nSeed, const std::string &sAddress);
+
+        // Hand out the runs until all are merged into the Simulation
+        void Coordinate(bool bTally);
+
+        // Play batches for the coordinator at sAddress, host:port, joining
+        // it again whenever it goes, until the process is stopped
+        static int Work(const std::string &sAddress, const BatchFunction &fPlayBatch);
+
+    private:
+        // A batch of runs
+        struct Batch
+        {
+            int nFirstRun;
+            int nRuns;
+        };
+
+        // Hand batches to a worker connected on nFd and merge their results
+        void ServeWorker(int nFd, std::string sWorker);
+        // Wait for the next batch for a worker that plays a run in
+        // dSecondsPerRun, 0 if not known; false once there are no more
+        bool NextBatch(double dSecondsPerRun, Batch &cBatch);
+
+        Simulation  &m_cSim;
+        std::string  m_sConfig;
+        int          m_nRuns;
+        int          m_nSeed;
+        std::string  m_sHost;
+        std::string  m_sPort;
+        std::string  m_sToken;
+
+        // Runs not yet handed out, and batches to hand out again
+        int                     m_nNextRun   {0};
+        std::deque<Batch>       m_dqReissued;
+        // Workers connected, and whether the runs are done or failed
+        int                     m_nWorkers   {0};
+        bool                    m_bDone      {false};
+        bool                    m_bTally     {false};
+        std::string             m_sError;
+        std::mutex              m_mtxRuns;
+        std::condition_variable m_cvRuns;
+
+        // Threads serving the workers, and their connections
+        std::vector<std::thread> m_vThreads;
+        std::vector<int>         m_vnSockets;
+};
+
+#endif // SIMULATIONCLUSTER_H
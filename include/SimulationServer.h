@@ -0,0 +1,149 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ *
+ * \brief The SimulationServer class runs CrapSim as a long-lived server.  It
+ * listens on a Unix domain socket for jobs, one JSON object per line, e.g.
+ *
+ *     {"id": "job1", "config": "[Simulation]\nRuns=1000\n...", "runs": 5000, "seed": 42, "priority": 1}
+ *
+ * where config is the text of a configuration file and the other fields are
+ * optional: runs and seed replace the Runs and Seed keys, and jobs of higher
+ * priority start first.  Each job is answered with a "queued" line and later
+ * a "done" line carrying the report, or an "error" line, e.g.
+ *
+ *     {"id": "job1", "status": "done", "output": "..."}
+ *
+ * Results are streamed back as jobs finish, so one connection may submit a
+ * batch of jobs and read their results in the order they complete.
+ *
+ * Jobs run on a pool of worker processes started once, with the server.
+ * Each worker is CrapSim run with --worker: it reads jobs on its standard
+ * input, runs them one at a time and writes their results on its standard
+ * output.  Processes, rather than threads, keep the reports of jobs apart,
+ * as a simulation writes its report to std::cout.
+ *
+ */
+
+#ifndef SIMULATIONSERVER_H
+#define SIMULATIONSERVER_H
+
+#include <climits>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+#include "CrapSimException.h"
+
+// Longest job line read from a client
+const std::string::size_type SERVER_MAX_LINE_LENGTH = 1 << 20;
+
+// A job sent to the server
+struct SimulationJob
+{
+    std::string sId;
+    std::string sConfig;
+    int  nRuns     {INT_MIN};          // INT_MIN if not set
+    int  nSeed     {INT_MIN};          // INT_MIN if not set
+    int  nPriority {0};
+    long nSequence {0};                // Order of arrival
+    int  nFirstRun {INT_MIN};          // Slice of the runs, for a cluster's
+    int  nRunCount {INT_MIN};          //   workers; INT_MIN if not set
+};
+
+// A connection to the server
+struct ServerClient;
+
+class SimulationServer
+{
+    public:
+        // Runs one job from a configuration file, writing its report to
+        // std::cout and throwing CrapSimException on error
+        typedef std::function<void(const std::string &sINIFile, int nRuns, int nSeed)> JobFunction;
+
+        // Serve on sSocketPath with nWorkers workers, each started as
+        // sProgram --worker
+        SimulationServer(std::string sSocketPath, int nWorkers, std::string sProgram);
+
+        // Accept connections until the server is stopped
+        void Serve();
+
+        // Run jobs read on standard input as a worker, until it is closed
+        static int Work(const JobFunction &fRunJob);
+
+        // Read and write job lines
+        static SimulationJob ParseJob(const std::string &sLine);
+        static std::string   FormatJob(const SimulationJob &cJob);
+        static std::string   FormatResult(const std::string &sId, const std::string &sStatus,
+                                          const std::string &sField, const std::string &sText);
+        // Read a result line: its id, status, and the text of its output or error
+        static void          ParseResult(const std::string &sLine, std::string &sId, std::string &sStatus, std::string &sText);
+
+        // Write all of a string to a descriptor, false if the other end has
+        // gone, and read the next line, without its newline, false at the end
+        // or once nMaxLength bytes are read without one
+        static bool WriteAll(int nFd, const std::string &sText);
+        static bool ReadLine(int nFd, std::string &sBuffer, std::string &sLine,
+                             std::string::size_type nMaxLength = std::string::npos);
+
+    private:
+        // A worker process and the pipes to it
+        struct Worker
+        {
+            int         nPid    {-1};
+            int         nInput  {-1};      // Worker's standard input
+            int         nOutput {-1};      // Worker's standard output
+            std::string sBuffer;           // Read but not yet returned
+        };
+
+        // Start, or restart, a worker
+        void StartWorker(Worker &cWorker);
+        // Read job lines from a client and queue them
+        void ReadClient(std::shared_ptr<ServerClient> pcClient);
+        // Hand queued jobs to a worker and return their results
+        void Dispatch(Worker &cWorker);
+
+        std::string m_sSocketPath;
+        std::string m_sProgram;
+        std::vector<Worker> m_vWorkers;
+
+        // Jobs waiting for a worker, highest priority and then earliest first
+        struct QueuedJob
+        {
+            SimulationJob cJob;
+            std::shared_ptr<ServerClient> pcClient;
+        };
+        struct QueueOrder
+        {
+            bool operator()(const QueuedJob &cLeft, const QueuedJob &cRight) const
+                { return ((cLeft.cJob.nPriority < cRight.cJob.nPriority) ||
+                          ((cLeft.cJob.nPriority == cRight.cJob.nPriority) && (cLeft.cJob.nSequence > cRight.cJob.nSequence))); }
+        };
+        std::priority_queue<QueuedJob, std::vector<QueuedJob>, QueueOrder> m_qJobs;
+        std::mutex              m_mtxJobs;
+        std::condition_variable m_cvJobs;
+        long                    m_nSequence {0};
+};
+
+#endif // SIMULATIONSERVER_H
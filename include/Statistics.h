@@ -0,0 +1,168 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The RunningStatistics and RunningCovariance classes accumulate
+ * means, variances, and covariances one observation at a time, without
+ * storing the observations.  The LogHistogram class counts observations in
+ * buckets that double in width, and the SurvivalCurve class counts how and
+ * on which roll runs ended, in finer buckets.  Statistics accumulated
+ * apart, e.g., on different threads, can be merged.
+ *
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <array>
+#include <climits>
+#include <cmath>
+
+// Normal quantile used for 95% confidence intervals
+const double CONFIDENCE_Z95 = 1.96;
+
+class RunningStatistics
+{
+    public:
+        // Add an observation
+        void   Add(double x);
+        // Add the observations of another RunningStatistics
+        void   Merge(const RunningStatistics &cOther);
+        // Return the number of observations
+        long long Count() const               { return (m_nCount); }
+        // Return the mean of the observations
+        double Mean() const                   { return (m_dMean); }
+        // Return the sample variance of the observations
+        double Variance() const               { return (m_nCount > 1 ? m_dM2 / (m_nCount - 1) : 0.0); }
+        // Return the standard error of the mean
+        double StandardError() const          { return (m_nCount > 1 ? std::sqrt(Variance() / m_nCount) : 0.0); }
+        // Return the half width of the 95% confidence interval of the mean
+        double HalfWidth() const              { return (CONFIDENCE_Z95 * StandardError()); }
+        // Return the sum of squared differences from the mean
+        double SumOfSquares() const           { return (m_dM2); }
+        // Restore the statistics from their count, mean and sum of squares
+        void   Restore(long long nCount, double dMean, double dM2) { m_nCount = nCount; m_dMean = dMean; m_dM2 = dM2; }
+
+    private:
+        // Set counters to zero
+        long long m_nCount {0};
+        double    m_dMean  {0.0};
+        double    m_dM2    {0.0};
+};
+
+class RunningCovariance
+{
+    public:
+        // Add a pair of observations
+        void   Add(double x, double y);
+        // Return the number of observation pairs
+        long long Count() const               { return (m_nCount); }
+        // Return the means of each series
+        double MeanX() const                  { return (m_dMeanX); }
+        double MeanY() const                  { return (m_dMeanY); }
+        // Return the sample variances of each series
+        double VarianceX() const              { return (m_nCount > 1 ? m_dM2X / (m_nCount - 1) : 0.0); }
+        double VarianceY() const              { return (m_nCount > 1 ? m_dM2Y / (m_nCount - 1) : 0.0); }
+        // Return the sample covariance and correlation of the series
+        double Covariance() const             { return (m_nCount > 1 ? m_dCoMoment / (m_nCount - 1) : 0.0); }
+        double Correlation() const;
+        // Return the mean of the paired difference x - y
+        double MeanDifference() const         { return (m_dMeanX - m_dMeanY); }
+        // Return the half width of the 95% confidence interval of the mean
+        // difference, using the pairing (Var(x) + Var(y) - 2 Cov(x,y))
+        double PairedHalfWidth() const;
+        // Return the half width the confidence interval would have if the
+        // series had been sampled independently (Var(x) + Var(y))
+        double IndependentHalfWidth() const;
+
+    private:
+        // Set counters to zero
+        long long m_nCount     {0};
+        double    m_dMeanX     {0.0};
+        double    m_dMeanY     {0.0};
+        double    m_dM2X       {0.0};
+        double    m_dM2Y       {0.0};
+        double    m_dCoMoment  {0.0};
+};
+
+// Number of buckets of a LogHistogram, enough for any int
+const int LOG_HISTOGRAM_BUCKETS = 32;
+
+class LogHistogram
+{
+    public:
+        // Add an observation; bucket k counts 2^k up to 2^(k+1) - 1, and
+        // bucket 0 also counts 0 and less
+        void   Add(int n);
+        // Add the observations of another LogHistogram
+        void   Merge(const LogHistogram &cOther);
+        // Return the number of observations in a bucket
+        long long Count(int nBucket) const    { return (m_anCounts[nBucket]); }
+        // Restore the number of observations in a bucket
+        void   Restore(int nBucket, long long nCount) { m_anCounts[nBucket] = nCount; }
+        // Return the smallest value counted in a bucket
+        static int BucketStart(int nBucket)   { return (nBucket == 0 ? 0 : 1 << nBucket); }
+
+    private:
+        std::array<long long, LOG_HISTOGRAM_BUCKETS> m_anCounts {};
+};
+
+// Buckets of a SurvivalCurve per doubling of the rolls, and the number of
+// buckets, enough for any int
+const int SURVIVAL_CURVE_STEPS   = 8;
+const int SURVIVAL_CURVE_BUCKETS = 232;
+
+// How a run ended
+enum class SurvivalEvent
+{
+    SE_BUST,           // Out of money
+    SE_WON,            // Reached significant winnings
+    SE_STOPPED,        // Reached the roll limit with money left
+    SE_COUNT
+};
+
+class SurvivalCurve
+{
+    public:
+        // Add a run that ended on roll nRolls; rolls under 2 *
+        // SURVIVAL_CURVE_STEPS have a bucket each, and from there each
+        // doubling of the rolls is split into SURVIVAL_CURVE_STEPS buckets
+        void   Add(SurvivalEvent ecEvent, int nRolls)
+            { ++m_aanCounts[static_cast<int>(ecEvent)][Bucket(nRolls)]; }
+        // Add the runs of another SurvivalCurve
+        void   Merge(const SurvivalCurve &cOther);
+        // Return the number of runs that ended in a bucket
+        long long Count(SurvivalEvent ecEvent, int nBucket) const
+            { return (m_aanCounts[static_cast<int>(ecEvent)][nBucket]); }
+        // Restore the number of runs that ended in a bucket
+        void   Restore(SurvivalEvent ecEvent, int nBucket, long long nCount)
+            { m_aanCounts[static_cast<int>(ecEvent)][nBucket] = nCount; }
+        // Return the bucket of a number of rolls, and the fewest and most
+        // rolls counted in a bucket
+        static int Bucket(int nRolls);
+        static int BucketStart(int nBucket);
+        static int BucketEnd(int nBucket)
+            { return (nBucket + 1 < SURVIVAL_CURVE_BUCKETS ? BucketStart(nBucket + 1) - 1 : INT_MAX); }
+
+    private:
+        std::array<std::array<long long, SURVIVAL_CURVE_BUCKETS>, static_cast<int>(SurvivalEvent::SE_COUNT)> m_aanCounts {};
+};
+
+#endif // STATISTICS_H
@@ -27,16 +27,23 @@
 #define STRATEGY_H
 
 #include <algorithm>
+#include <array>
 #include <climits>
+#include <ostream>
 #include <string>
-#include <list>
+#include <type_traits>
 #include <vector>
 #include "CrapSimException.h"
 #include "Table.h"
 #include "Bet.h"
+#include "BetBoard.h"
 #include "Money.h"
 #include "Wager.h"
 #include "QualifiedShooter.h"
+#include "RuleProgram.h"
+#include "StrategyPlugin.h"
+#include "StrategyRoutine.h"
+#include "Statistics.h"
 
 class StrategyTracker;
 #include "StrategyTracker.h"
@@ -49,14 +56,125 @@ enum class OddsProgressionMethod
     OP_GEOMETRIC
 };
 
-class Strategy
+// Bet types and methods a Strategy uses, as bits of the bet mask its
+// MakeBets() and ResolveBets() are compiled for
+const unsigned STRATEGY_BET_PASS             = 0x001;
+const unsigned STRATEGY_BET_COME             = 0x002;
+const unsigned STRATEGY_BET_DONT_PASS        = 0x004;
+const unsigned STRATEGY_BET_DONT_COME        = 0x008;
+const unsigned STRATEGY_BET_ODDS             = 0x010;
+const unsigned STRATEGY_BET_PLACE            = 0x020;
+const unsigned STRATEGY_BET_PUT              = 0x040;
+const unsigned STRATEGY_BET_HARD             = 0x080;
+const unsigned STRATEGY_BET_BIG              = 0x100;
+const unsigned STRATEGY_BET_ONE_ROLL         = 0x200;
+const unsigned STRATEGY_BET_ODDS_PROGRESSION = 0x400;
+const unsigned STRATEGY_BET_RULES            = 0x800;
+const unsigned STRATEGY_BET_ALL              = 0xFFF;
+// Betting rules and the bets they may make
+const unsigned STRATEGY_BET_RULES_ANY        = STRATEGY_BET_RULES | STRATEGY_BET_PASS | STRATEGY_BET_DONT_PASS |
+                                               STRATEGY_BET_PLACE | STRATEGY_BET_HARD | STRATEGY_BET_ONE_ROLL;
+
+// The state of a Strategy that changes roll by roll within a simulation
+// run, kept together and apart from its settings, names and statistics so
+// that the bankroll, counters and bets of a run share a few cache lines and
+// a plain copy of it copies them all.
+struct StrategyState
+{
+    // Money class to track bankroll
+    Money m_cMoney;
+
+    // Wager class to generate wager amounts
+    Wager m_cWager;
+
+    // QualifiedShooter class to track qualified shooters
+    QualifiedShooter m_cQualifiedShooter;
+
+    // Betting routine, and the last roll value and winning rolls in a row
+    // the betting rules read
+    StrategyRoutine m_cRoutine;
+    int  m_nLastRoll                    = 0;
+    int  m_nHits                        = 0;
+
+    // Rolls played in the run and the current odds
+    int   m_nNumberOfRolls              = 0;
+    float m_fOdds                       = 1.0;
+
+    // Bet Counters
+    int  m_nNumberOfPassBetsMade        = 0;
+    int  m_nNumberOfComeBetsMade        = 0;
+    int  m_nNumberOfDontPassBetsMade    = 0;
+    int  m_nNumberOfDontComeBetsMade    = 0;
+    int  m_nNumberOfPlaceBetsMade       = 0;
+    bool m_bPutBetMade                  = false;
+    int  m_nNumberOfBig6BetsMade        = 0;
+    int  m_nNumberOfBig8BetsMade        = 0;
+    int  m_nNumberOfHard4BetsMade       = 0;
+    int  m_nNumberOfHard6BetsMade       = 0;
+    int  m_nNumberOfHard8BetsMade       = 0;
+    int  m_nNumberOfHard10BetsMade      = 0;
+
+    // Place bet numbers covered, indexed by number
+    std::array<bool, 11> m_abPlaceBets {};
+
+    // Container for bets
+    BetBoard m_cBetBoard;
+};
+
+static_assert(std::is_trivially_copyable<StrategyState>::value, "StrategyState must be trivially copyable");
+
+// The results of a Strategy over the runs it has played, kept apart from
+// its settings so that the results of copies of the Strategy played on
+// other dice can be merged.
+struct StrategyResults
+{
+    // Set counters to zero or defaults; counts and totals are 64 bits as
+    // they are summed over the runs of every part of a simulation
+    long long m_nTimesStrategyRun         = 0;
+    long long m_nTimesStrategyWon         = 0;
+    long long m_nTimesStrategyLost        = 0;
+    int       m_nWinRollsMin              = INT_MAX;
+    int       m_nWinRollsMax              = INT_MIN;
+    long long m_nWinRollsTotal            = 0;
+    int       m_nLossRollsMin             = INT_MAX;
+    int       m_nLossRollsMax             = INT_MIN;
+    long long m_nLossRollsTotal           = 0;
+    int       m_nWinBankrollMin           = INT_MAX;
+    int       m_nWinBankrollMax           = INT_MIN;
+    long long m_nWinBankrollTotal         = 0;
+    int       m_nLossBankrollMin          = INT_MAX;
+    int       m_nLossBankrollMax          = INT_MIN;
+    long long m_nLossBankrollTotal        = 0;
+
+    // Running win percentage and ending bankroll, for confidence intervals
+    RunningStatistics m_cWinStatistics;
+    RunningStatistics m_cBankrollStatistics;
+
+    // Runs by the number of rolls played
+    LogHistogram      m_cRollsHistogram;
+    // Runs by how and on which roll they ended
+    SurvivalCurve     m_cSurvivalCurve;
+
+    // Add the results of other runs
+    void Merge(const StrategyResults &cOther);
+};
+
+// Checkpoints keep the results as they are in memory
+static_assert(std::is_trivially_copyable<StrategyResults>::value, "StrategyResults must be trivially copyable");
+
+class Strategy : private StrategyState, private StrategyResults
 {
     public:
         Strategy(std::string sName, std::string sDesc, int nInitBank, int nStdWager, bool TrackeResults);
         ~Strategy();
+        // Strategies are copied and moved member by member
+        Strategy(const Strategy &) = default;
+        Strategy(Strategy &&) = default;
+        Strategy& operator=(const Strategy &) = default;
+        Strategy& operator=(Strategy &&) = default;
         // Set and return name and description
         void SetName(std::string sN)        { m_sName.assign(sN); }
-        std::string Name() const            { return (m_sName); }
+        const std::string& Name() const     { return (m_sName); }
         void SetDescription(std::string sD) { m_sDescription.assign(sD); }
         std::string Description() const     { return (m_sDescription); }
         // Used to flag use full payoff wager versus a wager that may not payoff fully
@@ -140,12 +258,19 @@ class Strategy
         bool ShooterQualified()             { return (m_cQualifiedShooter.ShooterQualified()); }
         // Bet Modification methods
         void SetBetModificationMethod(std::string sMethod) { m_cWager.SetBetModificationMethod(sMethod); }
-        // Used before simulations are run to ensure that Strategies fit to Table settings
-        void SanityCheck(const Table &cTable);
+        // Compile a betting rule (see RuleProgram.h)
+        void AddRule(const std::string &sRule) { m_cRuleProgram.AddRule(sRule); }
+        // Set a betting routine (see StrategyRoutine.h)
+        void SetRoutine(std::string sMethod) { m_cRoutine.SetMethod(sMethod); }
+        // Load a Strategy plugin (see CrapSimPlugin.h)
+        void SetPlugin(const std::string &sPath, const std::string &sArguments) { m_cPlugin.Load(sPath, sArguments); }
+        // Used before simulations are run to ensure that Strategies fit to
+        // Table settings; changes made are noted on osLog
+        void SanityCheck(const Table &cTable, std::ostream &osLog);
 
         // Main drivers of the Strategy
-        void MakeBets(const Table &cTable);
-        void ResolveBets(const Table &cTable, const Dice &cDice);
+        void MakeBets(const Table &cTable)                        { (this->*m_pfMakeBets)(cTable); }
+        void ResolveBets(const Table &cTable, const Dice &cDice)  { (this->*m_pfResolveBets)(cTable, cDice); }
         void ModifyBets(const Table &cTable);
         void FinalizeBets();
         bool StillPlaying() const;
@@ -153,12 +278,58 @@ class Strategy
         int   Bankroll() const      { return m_cMoney.Bankroll(); }
         // Return current odds
         float Odds() const          { return m_fOdds; }
+        // Return the number of rolls played in the current run
+        int   Rolls() const         { return m_nNumberOfRolls; }
+        // Return whether the current run counts as a win
+        bool  RunWon() const;
         // Update stats
         void  UpdateStatistics();
-        // Used before a new simulation run
+        // Return the number of runs played
+        long long Runs() const       { return (m_nTimesStrategyRun); }
+        // Return the results of the runs played, and add those of a copy
+        // of the Strategy played on other dice
+        const StrategyResults& Results() const { return (*this); }
+        void  MergeResults(const Strategy &cOther) { StrategyResults::Merge(cOther.Results()); }
+        void  MergeResults(const StrategyResults &cResults) { StrategyResults::Merge(cResults); }
+        // Replace the results with those of runs played before, e.g., read
+        // from a ResultCache
+        void  SetResults(const StrategyResults &cResults) { static_cast<StrategyResults &>(*this) = cResults; }
+        // Return the win percentage and mean ending bankroll over the runs played
+        double WinPercentage() const { return (m_cWinStatistics.Mean()); }
+        double MeanBankroll() const  { return (m_cBankrollStatistics.Mean()); }
+        // Return the full width of the 95% confidence interval of the win
+        // percentage, in percentage points, and of the mean ending bankroll,
+        // as a percentage of the initial bankroll
+        double WinCIWidth() const;
+        double BankrollCIWidth() const;
+        // Return whether both confidence intervals are no wider than the target
+        bool  MeetsTarget(double dTargetCIWidth) const;
+        // Used before a new simulation run, restores the state captured
+        // after SanityCheck()
         void  Reset();
+        // Return whether the Strategy makes only Pass and Pass Odds bets at
+        // its standard wager and odds, so that a PassLineKernel lane can play it
+        bool  IsPassLineOnly() const;
+        // Return the settings a PassLineKernel lane plays by
+        int   StandardWager() const                { return (m_cWager.StandardWager()); }
+        float StandardOdds() const                 { return (m_fStandardOdds); }
+        bool  FullWager() const                    { return (m_cWager.FullWager()); }
+        int   InitialBankroll() const              { return (m_cMoney.InitialBankroll()); }
+        int   SignificantBankroll() const          { return (m_cMoney.SignificantBankroll()); }
+        int   PlayForNumberOfRolls() const         { return (m_nPlayForNumberOfRolls); }
+        // Set the outcome of a run played on the Strategy's behalf
+        void  SetRunResult(int nBankroll, int nRolls);
         // Report a Strategy's basic settings
-        void  Muster() const;
+        void  Muster(std::ostream &osLog) const;
+        // Return every setting that bears on the Strategy's results, one
+        // Key=Value per line, the same for Strategies that play alike
+        std::string Fingerprint() const;
+        // Return whether the Strategy is traced
+        bool  Traced() const                       { return (m_bTrace); }
+        // Return whether the Strategy's results may be read from a
+        // ResultCache; traced Strategies and plugins of unknown version
+        // are always played
+        bool  Cacheable() const                    { return (!m_bTrace && (!m_cPlugin.Loaded() || !m_cPlugin.Version().empty())); }
         // Report summary of Strategy's results over the Simulation
         void  Report();
 
@@ -166,6 +337,29 @@ class Strategy
         static bool m_bReportHeaderPrinted;
 
     private:
+        // Return the bet types and methods the Strategy uses
+        unsigned BetMask() const;
+        // Choose the MakeBets() and ResolveBets() compiled for the bet mask
+        void SelectBetMask();
+        // MakeBets() and ResolveBets(), compiled for the bets in MASK
+        template <unsigned MASK> void MakeBetsFor(const Table &cTable);
+        template <unsigned MASK> void ResolveBetsFor(const Table &cTable, const Dice &cDice);
+        // Those chosen for the Strategy's bet mask, all bets until then
+        void (Strategy::*m_pfMakeBets)(const Table &)                  = &Strategy::MakeBetsFor<STRATEGY_BET_ALL>;
+        void (Strategy::*m_pfResolveBets)(const Table &, const Dice &) = &Strategy::ResolveBetsFor<STRATEGY_BET_ALL>;
+
+        // Whether the Strategy has betting rules, a routine or a plugin
+        bool HasRules() const { return ((m_cRuleProgram.Rules() > 0) || m_cRoutine.MethodSet() || m_cPlugin.Loaded()); }
+        // Fill in the variables the betting rules read
+        void RuleVariables(const Table &cTable, int *pnVariables);
+        // Run the betting rules, routine and plugin and carry out their orders
+        void PlayRules(const Table &cTable);
+        void CarryOut(const RuleOrder &cOrder, const Table &cTable);
+        // Return the RuleBet a bet is, or RuleBet::RB_COUNT if none
+        static RuleBet RuleBetOf(const Bet &cBet);
+        // Update the bet counters for a bet leaving the table
+        void ForgetBet(const Bet &cBet);
+
         // Make different types of bets
         void MakePassBet(const Table &cTable);
         void MakeComeBet(const Table &cTable);
@@ -183,26 +377,24 @@ class Strategy
         void MakePlaceBet();
         // Modify Place bet wager to create maximum payoff
         int  PlaceBetFullPayoffWager(const int nPlaceNumber);
-        // Container for Place bets
-        std::map<int, bool>  m_mPlaceBets { {4, false}, {5, false}, {6, false}, {8, false}, {9, false}, {10, false} };
         // Returns next Place bet number
         int  PlaceBetNumber();
 
         // Resolve bets
-        void ResolvePass(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolvePassOdds(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice);
-        void ResolveDontPass(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolveDontPassOdds(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice);
-        void ResolveCome(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolveComeOdds(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice);
-        void ResolveDontCome(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolveDontComeOdds(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolvePlace(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice);
-        void ResolvePut(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolvePutOdds(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolveHardWayBets(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolveBig(std::list<Bet>::iterator &it, const Dice &cDice);
-        void ResolveOneRollBets(std::list<Bet>::iterator &it, const Dice &cDice);
+        void ResolvePass(BetBoard::iterator &it, const Dice &cDice);
+        void ResolvePassOdds(BetBoard::iterator &it, const Table &cTable, const Dice &cDice);
+        void ResolveDontPass(BetBoard::iterator &it, const Dice &cDice);
+        void ResolveDontPassOdds(BetBoard::iterator &it, const Table &cTable, const Dice &cDice);
+        void ResolveCome(BetBoard::iterator &it, const Dice &cDice);
+        void ResolveComeOdds(BetBoard::iterator &it, const Table &cTable, const Dice &cDice);
+        void ResolveDontCome(BetBoard::iterator &it, const Dice &cDice);
+        void ResolveDontComeOdds(BetBoard::iterator &it, const Dice &cDice);
+        void ResolvePlace(BetBoard::iterator &it, const Table &cTable, const Dice &cDice);
+        void ResolvePut(BetBoard::iterator &it, const Dice &cDice);
+        void ResolvePutOdds(BetBoard::iterator &it, const Dice &cDice);
+        void ResolveHardWayBets(BetBoard::iterator &it, const Dice &cDice);
+        void ResolveBig(BetBoard::iterator &it, const Dice &cDice);
+        void ResolveOneRollBets(BetBoard::iterator &it, const Dice &cDice);
 
         // Check to see if a current bet covers 6 or 8
         bool SixOrEightCovered();
@@ -217,14 +409,10 @@ class Strategy
         std::string m_sName;
         std::string m_sDescription;
 
-        // Money class to track bankroll
-        Money m_cMoney;
-
-        // Wager class to generate wager amounts
-        Wager m_cWager;
-
-        // QualifiedShooter class to track qualified shooters
-        QualifiedShooter m_cQualifiedShooter;
+        // Betting rules and plugin, and the orders they and the routine give
+        RuleProgram            m_cRuleProgram;
+        StrategyPlugin         m_cPlugin;
+        std::vector<RuleOrder> m_vRuleOrders;
 
         // StrategyTracker class to provide detailed (roll-by-roll) records of
         // a Strategy.  Used for debugging.  Recommend to a use in conjunction
@@ -251,20 +439,6 @@ class Strategy
         bool m_bYo11BetAllowed               = false;
         bool m_bCraps12BetAllowed            = false;
 
-        // Bet Counters - Sync with Strategy::Reset()
-        int m_nNumberOfPassBetsMade         = 0;
-        int m_nNumberOfComeBetsMade         = 0;
-        int m_nNumberOfDontPassBetsMade     = 0;
-        int m_nNumberOfDontComeBetsMade     = 0;
-        int m_nNumberOfPlaceBetsMade        = 0;
-        bool m_bPutBetMade                  = false;
-        int m_nNumberOfBig6BetsMade         = 0;
-        int m_nNumberOfBig8BetsMade         = 0;
-        int m_nNumberOfHard4BetsMade        = 0;
-        int m_nNumberOfHard6BetsMade        = 0;
-        int m_nNumberOfHard8BetsMade        = 0;
-        int m_nNumberOfHard10BetsMade       = 0;
-
         int m_nNumberOfPlaceBetsAllowed     = 0;
         int m_nNumberOfPlaceBetsMadeAtOnce  = 0;
         bool m_bPlaceAfterCome              = false;
@@ -278,35 +452,19 @@ class Strategy
         bool m_bFullWager                   = false;
 
         float m_fStandardOdds               = 1.0;
-        float m_fOdds                       = 1.0;
         bool  m_bComeOddsWorking            = false;
 
         OddsProgressionMethod m_ecOddsProgressionMethod   = OddsProgressionMethod::OP_NO_METHOD;
 
-        // Set counters to zero or defaults
-        int m_nTimesStrategyRun             = 0;
-        int m_nTimesStrategyWon             = 0;
-        int m_nTimesStrategyLost            = 0;
-        int m_nNumberOfRolls                = 0;
-        int m_nWinRollsMin                  = INT_MAX;
-        int m_nWinRollsMax                  = INT_MIN;
-        int m_nWinRollsTotal                = 0;
-        int m_nLossRollsMin                 = INT_MAX;
-        int m_nLossRollsMax                 = INT_MIN;
-        int m_nLossRollsTotal               = 0;
+        // Number of rolls to play, 0 to play until broke or significant winnings
         int m_nPlayForNumberOfRolls         = 0;
-        int m_nWinBankrollMin               = INT_MAX;
-        int m_nWinBankrollMax               = INT_MIN;
-        int m_nWinBankrollTotal             = 0;
-        int m_nLossBankrollMin              = INT_MAX;
-        int m_nLossBankrollMax              = INT_MIN;
-        int m_nLossBankrollTotal            = 0;
 
         // Don't track results by default
         bool m_bTrace                       = false;
 
-        // Container for bets
-        std::list<Bet>       m_lBets;;
+        // The state each simulation run starts from, and capture it
+        StrategyState m_cInitialState;
+        void SnapshotState();
 };
 
 #endif // STRATEGY_H
@@ -0,0 +1,81 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The StrategyPlugin class loads a Strategy plugin, a shared
+ * library written against CrapSimPlugin.h, and calls it once before and
+ * once after each roll.  The library is loaded once and shared by copies
+ * of the Strategy; each copy has its own plugin state.
+ *
+ */
+
+#ifndef STRATEGYPLUGIN_H
+#define STRATEGYPLUGIN_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "CrapSimException.h"
+#include "CrapSimPlugin.h"
+#include "RuleProgram.h"
+
+// A loaded plugin library
+struct PluginLibrary;
+
+class StrategyPlugin
+{
+    public:
+        StrategyPlugin() = default;
+        // Copies share the library and have their own state
+        StrategyPlugin(const StrategyPlugin &cOther);
+        StrategyPlugin(StrategyPlugin &&cOther);
+        StrategyPlugin& operator=(StrategyPlugin cOther);
+        ~StrategyPlugin();
+
+        // Load the plugin and make its state
+        void Load(const std::string &sPath, const std::string &sArguments);
+        bool Loaded() const                 { return (m_pcLibrary != nullptr); }
+        const std::string& Path() const     { return (m_sPath); }
+        const std::string& Arguments() const { return (m_sArguments); }
+        // Return the size and modification time of the library, empty if
+        // unknown
+        std::string Version() const;
+
+        // Append the plugin's orders for the roll
+        void MakeBets(const int *pnVariables, std::vector<RuleOrder> &vOrders);
+        // Tell the plugin the roll was resolved, if it wants to know
+        bool ResolvesBets() const;
+        void ResolveBets(const int *pnVariables);
+
+        // Reset the class - meant to be called before a new Simulation run
+        void Reset();
+
+    private:
+        // Make and free the plugin state
+        void Create();
+        void Destroy();
+
+        std::shared_ptr<PluginLibrary> m_pcLibrary;
+        void        *m_pState {nullptr};
+        std::string  m_sPath;
+        std::string  m_sArguments;
+};
+
+#endif // STRATEGYPLUGIN_H
@@ -0,0 +1,86 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief The StrategyRoutine class plays a betting routine that spans many
+ * rolls, e.g., "after two hits press, after a seven out wait three rolls".
+ * Each routine is written as straight line code that waits for the next
+ * roll where it needs to, and gives the same orders as the betting rules
+ * (see RuleProgram.h).  The routine is a stackless coroutine: where it
+ * waits and the counts it keeps are members of the class, so resuming it
+ * allocates nothing and copying a Strategy copies its routine.  The
+ * routines are built in; a new one is a RoutineMethod, an entry in the
+ * table of routine names, a case in Resume() and a member function
+ * written like PressAndWait().
+ *
+ */
+
+#ifndef STRATEGYROUTINE_H
+#define STRATEGYROUTINE_H
+
+#include <string>
+#include <vector>
+#include "CrapSimException.h"
+#include "RuleProgram.h"
+
+// Most orders a routine gives for one roll
+const int ROUTINE_MAX_ORDERS = 4;
+
+// Used to identify a betting routine
+enum class RoutineMethod
+{
+    RM_NO_ROUTINE,
+    RM_PRESS_AND_WAIT,
+    RM_HIT_AND_RUN
+};
+
+class StrategyRoutine
+{
+    public:
+        // Set and return the routine
+        void SetMethod(std::string sMethod);
+        std::string Method() const;
+        bool MethodSet() const { return (m_ecRoutineMethod != RoutineMethod::RM_NO_ROUTINE); }
+
+        // Resume the routine before a roll, with the variables the betting
+        // rules read, and append its orders
+        void Resume(const int *pnVariables, std::vector<RuleOrder> &vOrders);
+
+        // Reset the class - meant to be called before a new Simulation run
+        void Reset();
+
+    private:
+        RoutineMethod m_ecRoutineMethod = RoutineMethod::RM_NO_ROUTINE;
+
+        // Where the routine waits for the next roll, 0 at its start
+        int m_nResumePoint = 0;
+        // Counts the routines keep between rolls
+        int m_nHits        = 0;
+        int m_nUnits       = 0;
+        int m_nWait        = 0;
+
+        // The Press And Wait routine
+        void PressAndWait(const int *pnVariables, std::vector<RuleOrder> &vOrders);
+
+        // The Hit And Run routine
+        void HitAndRun(const int *pnVariables, std::vector<RuleOrder> &vOrders);
+};
+
+#endif // STRATEGYROUTINE_H
@@ -29,9 +29,11 @@
 
 #include <string>
 #include <fstream>
+#include <map>
 #include "Strategy.h"
 #include "Table.h"
 #include "Bet.h"
+#include "BetBoard.h"
 
 class Strategy;
 
@@ -49,9 +51,9 @@ class StrategyTracker
         // Create a new record
         void RecordNew(const Strategy *pcStrategy, const Table &cTable);
         // Update record with current and newly made bets
-        void RecordBetsBeforeRoll(const Strategy *pcStrategy, const std::list<Bet> &lBets);
+        void RecordBetsBeforeRoll(const Strategy *pcStrategy, const BetBoard &lBets);
         // Update record with bet results after the roll
-        void RecordBetsAfterRoll(const Strategy *pcStrategy, const std::list<Bet> &lBets, int nRoll);
+        void RecordBetsAfterRoll(const Strategy *pcStrategy, const BetBoard &lBets, int nRoll);
         // Post the record
         void Post();
 
@@ -26,7 +26,6 @@
 #ifndef TABLE_H
 #define TABLE_H
 
-#include <map>
 #include <string>
 #include <locale>
 #include "CrapSimException.h"
@@ -81,10 +80,10 @@ class Table
         // Reset the table - meant to be called before a new Simulation run
         void   Reset()                  { SetPuckOff(); SetNewShooter(true); }
         // Set and return the table type (odds offered)
-        std::string TableType();
+        std::string TableType() const;
         bool SetTableType(std::string sTableType);
         // Return the bar, for Don't Pass bets.  TODO: make configurable
-        std::string Bar()               { return "Bar 12"; }
+        std::string Bar() const         { return "Bar 12"; }
 
     private:
         // Set the table point
@@ -97,9 +96,6 @@ class Table
         bool        m_bPuckOn       = false;
         int         m_nPoint        = 0;
         bool        m_bNewShooter   = true;
-
-        // Map used to associate the string names with the enum values
-        std::map<std::string, TableOdds> m_mTableOdds;
 };
 
 #endif // TABLE_H
@@ -0,0 +1,52 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ *
+ * \brief The TemporaryFile class writes text to a new file in the
+ * temporary directory, TMPDIR if set, and removes the file when it goes.
+ * It lets configuration text be read by CDataFile, which reads files.
+ *
+ */
+
+#ifndef TEMPORARYFILE_H
+#define TEMPORARYFILE_H
+
+#include <string>
+#include "CrapSimException.h"
+
+class TemporaryFile
+{
+    public:
+        // Write sText to a new temporary file
+        explicit TemporaryFile(const std::string &sText);
+        TemporaryFile(const TemporaryFile &) = delete;
+        TemporaryFile& operator=(const TemporaryFile &) = delete;
+        // Remove the file
+        ~TemporaryFile();
+
+        // Return the path of the file
+        const std::string& Path() const { return (m_sPath); }
+
+    private:
+        std::string m_sPath;
+};
+
+#endif // TEMPORARYFILE_H
@@ -0,0 +1,67 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ *
+ * \brief The ThreadPool class runs tasks on a fixed number of threads, in
+ * the order they are submitted.  Many small jobs share the threads rather
+ * than each starting its own.
+ *
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+    public:
+        typedef std::function<void()> Task;
+
+        // Start nThreads threads, one per hardware thread if nThreads < 1
+        explicit ThreadPool(int nThreads);
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool& operator=(const ThreadPool &) = delete;
+        // Finish the tasks submitted, then stop the threads
+        ~ThreadPool();
+
+        // Run a task on the next free thread
+        void Submit(Task fTask);
+        // Return the number of threads
+        int  Threads() const { return (static_cast<int>(m_vThreads.size())); }
+
+    private:
+        // Run tasks until the pool is stopped and no task is left
+        void Work();
+
+        std::vector<std::thread> m_vThreads;
+        std::deque<Task>         m_dqTasks;
+        std::mutex               m_mtxTasks;
+        std::condition_variable  m_cvTasks;
+        bool                     m_bStopping {false};
+};
+
+#endif // THREADPOOL_H
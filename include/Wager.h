@@ -20,13 +20,12 @@
 #ifndef WAGER_H
 #define WAGER_H
 
-#include <list>
 #include <locale>
-#include <map>
 #include <string>
 
 #include "CrapSimException.h"
 #include "Bet.h"
+#include "BetBoard.h"
 #include "Dice.h"
 #include "Money.h"
 #include "Table.h"
@@ -57,8 +56,6 @@ enum class BetModificationMethods
 class Wager
 {
     public:
-        Wager();
-
         void Initialize(const int nStdWager);
         // Set and return the standard (default) wager.  Is equal to one unit.
         int  StandardWager() const { return (m_nStandardWager); }
@@ -68,9 +65,10 @@ class Wager
 
         // Used to flag use full payoff wager versus a wager that may not payoff fully
         void SetFullWager(const bool b)       { m_bFullWager = b; }
+        bool FullWager() const                { return (m_bFullWager); }
 
         // Call the correct wager progression method and return the number of units for the next bet
-        int WagerUnits(const std::list<Bet>::iterator &it);
+        int WagerUnits(const BetBoard::iterator &it);
 
         // Update the wager amount for a non-Odds bet
         int BetWager(const int nBankroll);
@@ -85,17 +83,17 @@ class Wager
         int PlaceBetUnitsWager(const int nBankroll, const int nUnits, const int nPoint);
 
         // Modify Bets
-        bool ModifyBets(Money &cMoney, const Table &cTable, std::list<Bet> &lBets);
+        bool ModifyBets(Money &cMoney, const Table &cTable, BetBoard &lBets);
 
         // Set and return the wager progression method
         void SetWagerProgressionMethod(std::string sMethod);
         std::string WagerProgressionMethod() const;
-        bool WagerProgressionMethodSet() { return (m_ecWagerProgressionMethod != WagerProgressionMethods::WP_NO_METHOD); }
+        bool WagerProgressionMethodSet() const { return (m_ecWagerProgressionMethod != WagerProgressionMethods::WP_NO_METHOD); }
 
         // Set and return the bet modification method
         void SetBetModificationMethod(std::string sMethod);
         std::string BetModificationMethod() const;
-        bool BetModificationMethodSet() { return (m_ecBetModificationMethod != BetModificationMethods::BM_NO_METHOD); }
+        bool BetModificationMethodSet() const { return (m_ecBetModificationMethod != BetModificationMethods::BM_NO_METHOD); }
 
         // Reset the class - meant to be called before a new Simulation run
         void Reset();
@@ -113,29 +111,29 @@ class Wager
         // Wager Progression Methods
         //
         // The 1-3-2-6 method
-        int Method1_3_2_6(const std::list<Bet>::iterator &it);
+        int Method1_3_2_6(const BetBoard::iterator &it);
         // The Fibonacci method
-        int MethodFibonacci(const std::list<Bet>::iterator &it);
+        int MethodFibonacci(const BetBoard::iterator &it);
         // The Martingale method
-        int MethodMartingale(const std::list<Bet>::iterator &it);
+        int MethodMartingale(const BetBoard::iterator &it);
         // The Paroli method
-        int MethodParoli(const std::list<Bet>::iterator &it);
+        int MethodParoli(const BetBoard::iterator &it);
 
         //
         // Bet Modification Methods
         //
         // Check for the existence of modifable bets
-        bool ModifiableBetsExist(const std::list<Bet> &lBets) const;
+        bool ModifiableBetsExist(const BetBoard &lBets) const;
         // Set up for bet modification methods
-        void BetModificationSetup(const Table &cTable, const std::list<Bet> &lBets);
+        void BetModificationSetup(const Table &cTable, const BetBoard &lBets);
         // Collect, Press, Regress method
-        bool MethodCollectPressRegress(Money &cMoney, const Table &cTable, std::list<Bet> &lBets);
+        bool MethodCollectPressRegress(Money &cMoney, const Table &cTable, BetBoard &lBets);
         // Classic Regression
-        bool MethodClassicRegression(Money &cMoney, const Table &cTable, std::list<Bet> &lBets);
+        bool MethodClassicRegression(Money &cMoney, const Table &cTable, BetBoard &lBets);
         // Press method
-        bool MethodPress(Money &cMoney, const Table &cTable, std::list<Bet> &lBets, const int nTimes);
+        bool MethodPress(Money &cMoney, const Table &cTable, BetBoard &lBets, const int nTimes);
         // Take Down After Hits method
-        bool MethodTakeDownAfterHits(Money &cMoney, const Table &cTable, std::list<Bet> &lBets, const int nTimes);
+        bool MethodTakeDownAfterHits(Money &cMoney, const Table &cTable, BetBoard &lBets, const int nTimes);
 
         // Set defaults
         int m_nStandardWager  {0};
@@ -151,10 +149,6 @@ class Wager
         int m_nPreviousUnits2 {0};
         int m_nBetModCounter  {0};
         bool m_bWon           {false};
-
-        // Map to associate the strings with the enum values
-        std::map<std::string, WagerProgressionMethods> m_mWagerProgressionMethod;
-        std::map<std::string, BetModificationMethods> m_mBetModificationMethod;
 };
 
 #endif // WAGER_H
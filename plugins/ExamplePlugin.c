@@ -0,0 +1,129 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ *
+ * \brief An example Strategy plugin.  It plays the Pass line and, once a
+ * point is set, places the 6 and 8, pressing both by a unit after every
+ * second hit until the next seven.  PluginArguments sets the unit, 6 if
+ * not set.
+ *
+ * Build it with
+ *     gcc -O2 -shared -fPIC -Iinclude -o ExamplePlugin.so plugins/ExamplePlugin.c
+ * and set Plugin=./ExamplePlugin.so in a Strategy section.
+ *
+ */
+
+#include <stdlib.h>
+#include "CrapSimPlugin.h"
+
+#ifdef _WIN32
+#define CRAPSIM_EXPORT __declspec(dllexport)
+#else
+#define CRAPSIM_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* State of one Strategy */
+typedef struct ExampleState
+{
+    int nUnit;                     /* Wager on the 6 and 8 */
+    int nUnits;                    /* Units bet, pressed after every second hit */
+    int nHits;                     /* Hits on the 6 and 8 since the last seven */
+} ExampleState;
+
+CRAPSIM_EXPORT int CrapSimPluginAbi(void)
+{
+    return (CRAPSIM_PLUGIN_ABI);
+}
+
+CRAPSIM_EXPORT void *CrapSimPluginCreate(const char *pszArguments)
+{
+    ExampleState *pState = (ExampleState *)calloc(1, sizeof(ExampleState));
+    if (pState == NULL) return (NULL);
+
+    pState->nUnit  = atoi(pszArguments);
+    if (pState->nUnit < 6) pState->nUnit = 6;
+    pState->nUnits = 1;
+
+    return (pState);
+}
+
+CRAPSIM_EXPORT void CrapSimPluginDestroy(void *pState)
+{
+    free(pState);
+}
+
+CRAPSIM_EXPORT void CrapSimPluginReset(void *pState)
+{
+    ExampleState *pExample = (ExampleState *)pState;
+
+    pExample->nUnits = 1;
+    pExample->nHits  = 0;
+}
+
+/* Add an order */
+static int Order(CrapSimOrder *pOrders, int nOrders, int nAction, int nBet, int nAmount)
+{
+    pOrders[nOrders].nAction = nAction;
+    pOrders[nOrders].nBet    = nBet;
+    pOrders[nOrders].nAmount = nAmount;
+
+    return (nOrders + 1);
+}
+
+CRAPSIM_EXPORT int CrapSimPluginMakeBets(void *pState, const int *pnVariables, CrapSimOrder *pOrders, int nMaxOrders)
+{
+    ExampleState *pExample = (ExampleState *)pState;
+    int nOrders = 0;
+
+    if (nMaxOrders < 2) return (0);
+
+    if (pnVariables[CRAPSIM_VAR_COMEOUT])
+    {
+        nOrders = Order(pOrders, nOrders, CRAPSIM_ACTION_BET, CRAPSIM_BET_PASS, pnVariables[CRAPSIM_VAR_WAGER]);
+    }
+    else
+    {
+        nOrders = Order(pOrders, nOrders, CRAPSIM_ACTION_BET, CRAPSIM_BET_PLACE6, pExample->nUnits * pExample->nUnit);
+        nOrders = Order(pOrders, nOrders, CRAPSIM_ACTION_BET, CRAPSIM_BET_PLACE8, pExample->nUnits * pExample->nUnit);
+    }
+
+    return (nOrders);
+}
+
+CRAPSIM_EXPORT void CrapSimPluginResolveBets(void *pState, const int *pnVariables)
+{
+    ExampleState *pExample = (ExampleState *)pState;
+    const int nRoll = pnVariables[CRAPSIM_VAR_ROLL];
+
+    /* Place bets are off on the come out */
+    if (pnVariables[CRAPSIM_VAR_COMEOUT]) return;
+
+    /* A winning Place bet comes down, so a hit leaves no wager on the number */
+    if (nRoll == 7)
+    {
+        pExample->nUnits = 1;
+        pExample->nHits  = 0;
+    }
+    else if ((nRoll == 6 && pnVariables[CRAPSIM_VAR_FIRST_BET + CRAPSIM_BET_PLACE6] == 0) ||
+             (nRoll == 8 && pnVariables[CRAPSIM_VAR_FIRST_BET + CRAPSIM_BET_PLACE8] == 0))
+    {
+        if (++pExample->nHits % 2 == 0) ++pExample->nUnits;
+    }
+}
@@ -0,0 +1,61 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+// Allocations made by each thread
+static thread_local unsigned long long g_nAllocations = 0;
+
+/**
+  * Return the number of allocations from the global heap the calling
+  * thread has made.
+  *
+  * \return The number of allocations.
+  */
+
+unsigned long long AllocationCounter::Count()
+{
+    return (g_nAllocations);
+}
+
+// The global operator new, counting each allocation.  The array form of
+// operator new calls this one.  The CrapSim library leaves the heap of the
+// program it is built into alone, and counts nothing.
+#ifndef CRAPSIM_LIBRARY
+
+void *operator new(std::size_t nSize)
+{
+    ++g_nAllocations;
+
+    void *p = std::malloc(nSize ? nSize : 1);
+    if (p == nullptr) throw std::bad_alloc();
+
+    return (p);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+#endif // CRAPSIM_LIBRARY
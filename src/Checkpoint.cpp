@@ -0,0 +1,190 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Checkpoint.h"
+#include "CrapSimVersion.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+// Marks the start of a checkpoint file
+static const char *CHECKPOINT_MAGIC = "CrapSimCheckpoint";
+
+/**
+  * Return the memory layout of this build.
+  *
+  * Values are kept as their bytes, so a checkpoint is read only where the
+  * byte order, the sizes of the basic types and their alignment, which set
+  * the padding of the structures kept, are those of the build that wrote
+  * it.  The layout is text, ended by a newline, so that any build can read
+  * it.
+  *
+  * \return The layout.
+  */
+
+static std::string Layout()
+{
+    const unsigned short nOne = 1;
+    const bool bLittleEndian = (*reinterpret_cast<const unsigned char *>(&nOne) == 1);
+
+    return (std::string(bLittleEndian ? "LE" : "BE") +
+            " int " + std::to_string(sizeof(int)) +
+            " long " + std::to_string(sizeof(long)) +
+            " long long " + std::to_string(sizeof(long long)) + "/" + std::to_string(alignof(long long)) +
+            " double " + std::to_string(sizeof(double)) + "/" + std::to_string(alignof(double)) +
+            " pointer " + std::to_string(sizeof(void *)) + "\n");
+}
+
+/**
+  * Return the next bytes of the checkpoint, and move past them.
+  *
+  * \param nSize The number of bytes.
+  *
+  * \return The bytes.
+  */
+
+const char *Checkpoint::Next(unsigned long long nSize)
+{
+    if (nSize > m_sBuffer.size() - m_nPosition)
+        throw CrapSimException("Checkpoint::Get checkpoint is damaged");
+
+    const char *pBytes = m_sBuffer.data() + m_nPosition;
+    m_nPosition += nSize;
+
+    return (pBytes);
+}
+
+/**
+  * Return the checkpoint as the bytes of a file.
+  *
+  * The bytes start with a marker, the memory layout of this build, the
+  * format, the version of CrapSim and the key of the Simulation, followed
+  * by the values put.
+  *
+  * \param sKey The text of everything the Simulation's results depend on.
+  *
+  * \return The bytes.
+  */
+
+std::string Checkpoint::Bytes(const std::string &sKey) const
+{
+    Checkpoint cHeader;
+    cHeader.m_sBuffer.assign(CHECKPOINT_MAGIC);
+    cHeader.m_sBuffer.append(Layout());
+    cHeader.Put(CHECKPOINT_FORMAT);
+    cHeader.Put(CrapSimVersion::SemanticVersion() + " " + CrapSimVersion::DateVersion());
+    cHeader.Put(sKey);
+
+    return (cHeader.m_sBuffer + m_sBuffer);
+}
+
+/**
+  * Read the checkpoint from the bytes of a file, ready to Get() the values
+  * put.
+  *
+  * \param sBytes The bytes.
+  * \param sKey The text of everything the Simulation's results depend on.
+  * \param sSource Where the bytes came from, for errors.
+  */
+
+void Checkpoint::FromBytes(std::string sBytes, const std::string &sKey, const std::string &sSource)
+{
+    m_sBuffer.swap(sBytes);
+
+    const std::string sMagic(CHECKPOINT_MAGIC);
+    if (m_sBuffer.compare(0, sMagic.size(), sMagic) != 0)
+        throw CrapSimException("Checkpoint is not a checkpoint", sSource);
+
+    m_nPosition = sMagic.size();
+
+    const std::string sLayout = Layout();
+    if (m_sBuffer.compare(m_nPosition, sLayout.size(), sLayout) != 0)
+        throw CrapSimException("Checkpoint was written on a platform of another memory layout", sSource);
+
+    m_nPosition += sLayout.size();
+
+    int nFormat = 0;
+    std::string sVersion;
+    std::string sFileKey;
+
+    Get(nFormat);
+    Get(sVersion);
+    if ((nFormat != CHECKPOINT_FORMAT) || (sVersion != CrapSimVersion::SemanticVersion() + " " + CrapSimVersion::DateVersion()))
+        throw CrapSimException("Checkpoint was written by another version of CrapSim", sSource);
+
+    Get(sFileKey);
+    if (sFileKey != sKey)
+        throw CrapSimException("Checkpoint is of another simulation", sSource);
+}
+
+/**
+  * Write the checkpoint to a file.
+  *
+  * The file is written under another name and renamed into place, so that
+  * a Simulation stopped while writing leaves the last checkpoint whole.
+  *
+  * \param sPath The path of the file.
+  * \param sKey The text of everything the Simulation's results depend on.
+  */
+
+void Checkpoint::Write(const std::string &sPath, const std::string &sKey) const
+{
+    const std::string sBytes = Bytes(sKey);
+    const std::string sTemporaryPath = sPath + ".new";
+
+    std::ofstream ofsFile(sTemporaryPath, std::ios::binary | std::ios::trunc);
+    ofsFile.write(sBytes.data(), sBytes.size());
+    ofsFile.close();
+
+    if (!ofsFile)
+    {
+        std::remove(sTemporaryPath.c_str());
+        throw CrapSimException("Checkpoint cannot write", sTemporaryPath);
+    }
+
+#ifdef _WIN32
+    std::remove(sPath.c_str());
+#endif // _WIN32
+
+    if (std::rename(sTemporaryPath.c_str(), sPath.c_str()) != 0)
+    {
+        std::remove(sTemporaryPath.c_str());
+        throw CrapSimException("Checkpoint cannot write", sPath);
+    }
+}
+
+/**
+  * Read a checkpoint from a file.
+  *
+  * \param sPath The path of the file.
+  * \param sKey The text of everything the Simulation's results depend on.
+  *
+  * \return False if there is no file.
+  */
+
+bool Checkpoint::Read(const std::string &sPath, const std::string &sKey)
+{
+    std::ifstream ifsFile(sPath, std::ios::binary);
+    if (!ifsFile) return (false);
+
+    FromBytes(std::string(std::istreambuf_iterator<char>(ifsFile), std::istreambuf_iterator<char>()), sKey, sPath);
+
+    return (true);
+}
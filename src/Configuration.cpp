@@ -0,0 +1,778 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Configuration.h"
+
+#include <iterator>
+#include <locale>
+#include <sstream>
+#include <utility>
+#include "ParameterGrid.h"
+
+/**
+  * Strategy settings from a section of the configuration file.
+  *
+  * Keys swept by a ParameterGrid take their value at the grid point in
+  * place of the range or list written in the file; all other keys are read
+  * from the file.  Missing values are returned the way CDataFile returns
+  * them.
+  *
+  */
+
+class StrategySection
+{
+    public:
+        StrategySection(CDataFile &cConfigFile, const std::string &sSection, const std::map<std::string, std::string> &mSwept) :
+            m_cConfigFile(cConfigFile), m_sSection(sSection), m_mSwept(mSwept) {}
+
+        std::string GetString(const std::string &sKey)
+        {
+            std::map<std::string, std::string>::const_iterator it = m_mSwept.find(sKey);
+            if (it != m_mSwept.end()) return (it->second);
+            return (m_cConfigFile.GetString(sKey, m_sSection));
+        }
+
+        int GetInt(const std::string &sKey)
+        {
+            std::map<std::string, std::string>::const_iterator it = m_mSwept.find(sKey);
+            if (it == m_mSwept.end()) return (m_cConfigFile.GetInt(sKey, m_sSection));
+            try { return (std::stoi(it->second)); }
+            catch (const std::exception &) { throw CrapSimException("Configuration Invalid integer in sweep of " + sKey, it->second); }
+        }
+
+        float GetFloat(const std::string &sKey)
+        {
+            std::map<std::string, std::string>::const_iterator it = m_mSwept.find(sKey);
+            if (it == m_mSwept.end()) return (m_cConfigFile.GetFloat(sKey, m_sSection));
+            try { return (std::stof(it->second)); }
+            catch (const std::exception &) { throw CrapSimException("Configuration Invalid number in sweep of " + sKey, it->second); }
+        }
+
+        bool GetBool(const std::string &sKey)
+        {
+            std::map<std::string, std::string>::const_iterator it = m_mSwept.find(sKey);
+            if (it == m_mSwept.end()) return (m_cConfigFile.GetBool(sKey, m_sSection));
+
+            std::string sValue(it->second);
+            std::locale loc;
+            for (std::string::size_type iii = 0; iii < sValue.length(); ++iii)
+                sValue[iii] = std::tolower(sValue[iii], loc);
+
+            return ((sValue.find("1") == 0) || (sValue == "true") || (sValue == "yes"));
+        }
+
+    private:
+        CDataFile                                &m_cConfigFile;
+        const std::string                         m_sSection;
+        const std::map<std::string, std::string> &m_mSwept;
+};
+
+// Strategy keys that may be swept with range or list syntax.  Sync with CreateStrategy().
+static const char *const g_apszSweepableKeys[] =
+{
+    "StandardWager", "FullWager", "InitialBankroll", "SignificantWinnings", "SWM",
+    "PlayForNumberOfRolls", "Predefined", "PassBet", "DontPassBet", "ComeBets",
+    "DontComeBets", "PlaceBets", "PlaceBetsMadeAtOnce", "PlaceAfterCome", "PlaceBetUnits",
+    "PlaceWorking", "PutBet", "FieldBet", "FieldBetUnits", "Big6Bet", "Big8Bet",
+    "Any7Bet", "AnyCrapsBet", "Craps2Bet", "Craps3Bet", "Yo11Bet", "Craps12Bet",
+    "StandardOdds", "ComeOddsWorking", "OddsProgressionMethod", "WagerProgressionMethod",
+    "QualifiedShooterMethod", "QualifiedShooterMethodCount", "BetModificationMethod"
+};
+
+/**
+  * Read the weights of a dice model key, written as numbers separated by
+  * commas.
+  *
+  *\param sKey The key, for errors
+  *\param sValue The value of the key
+  *
+  *\return The weights
+  */
+
+static std::vector<double> ReadWeights(const std::string &sKey, const std::string &sValue)
+{
+    std::vector<double> vdWeights;
+    std::istringstream issValue(sValue);
+    std::string sWeight;
+
+    while (std::getline(issValue, sWeight, ','))
+    {
+        std::string::size_type nEnd = 0;
+        try
+        {
+            vdWeights.push_back(std::stod(sWeight, &nEnd));
+        }
+        catch (const std::exception &)
+        {
+            nEnd = 0;
+        }
+
+        if ((nEnd == 0) || (sWeight.find_first_not_of(" \t", nEnd) != std::string::npos))
+            throw CrapSimException("Configuration " + sKey + " is not a list of numbers", sValue);
+    }
+
+    return (vdWeights);
+}
+
+/**
+  * Read the dice model keys of a section: FaceWeights, OutcomeWeights and
+  * SevenRate.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *\param sSection The section
+  *\param cModel The model
+  */
+
+static void ReadDiceModel(CDataFile &cConfigFile, const std::string &sSection, DiceModel &cModel)
+{
+    std::string sFaceWeights    = cConfigFile.GetString("FaceWeights", sSection);
+    std::string sOutcomeWeights = cConfigFile.GetString("OutcomeWeights", sSection);
+    float fSevenRate            = cConfigFile.GetFloat("SevenRate", sSection);
+
+    if (!sFaceWeights.empty())    cModel.SetFaceWeights(ReadWeights("FaceWeights", sFaceWeights));
+    if (!sOutcomeWeights.empty()) cModel.SetOutcomeWeights(ReadWeights("OutcomeWeights", sOutcomeWeights));
+    if (fSevenRate != FLT_MIN)    cModel.SetSevenRate(fSevenRate);
+}
+
+/**
+  * Read the table keys of a section: Type, MinimumWager, MaximumWager and
+  * the dice model keys.  Keys the section does not set are left as they
+  * are in the settings.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *\param sSection The section
+  *\param cSettings The settings of the Table and its dice
+  */
+
+static void ReadTable(CDataFile &cConfigFile, const std::string &sSection, SimulationSettings &cSettings)
+{
+    std::string sTableType = cConfigFile.GetString("Type", sSection);
+    int nMinimumWager      = cConfigFile.GetInt("MinimumWager", sSection);
+    int nMaximumWager      = cConfigFile.GetInt("MaximumWager", sSection);
+
+    if (nMinimumWager != INT_MIN) cSettings.m_cTable.SetMinimumBet(nMinimumWager);
+    if (nMaximumWager != INT_MIN) cSettings.m_cTable.SetMaximumBet(nMaximumWager);
+
+    if (!sTableType.empty())
+    {
+        if (!cSettings.m_cTable.SetTableType(sTableType))
+        {
+            throw CrapSimException("Configuration Unknown table type", sTableType);
+        }
+    }
+
+    ReadDiceModel(cConfigFile, sSection, cSettings.m_cDiceModel);
+}
+
+/**
+  * Read the configuration file.
+  *
+  * Read the Table, DefaultStrategy and Simulation sections.  Keys not set
+  * are left INT_MIN, FLT_MIN or empty, as CDataFile returns them.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  */
+
+Configuration::Configuration(CDataFile &cConfigFile)
+{
+    // Set non-Strategy configuration items.
+    m_nDefaultInitBank             = cConfigFile.GetInt("InitialBankroll", "DefaultStrategy");
+    m_nDefaultStdWager             = cConfigFile.GetInt("StandardWager", "DefaultStrategy");
+    m_fDefaultSWM                  = cConfigFile.GetFloat("SWM", "DefaultStrategy");
+    m_nDefaultSigWin               = cConfigFile.GetInt("SignificantWinnings", "DefaultStrategy");
+    m_nDefaultPlayForNumberOfRolls = cConfigFile.GetInt("PlayForNumberOfRolls", "DefaultStrategy");
+
+    m_cSettings.m_nRuns             = cConfigFile.GetInt("Runs", "Simulation");
+    m_cSettings.m_bMuster           = cConfigFile.GetBool("Muster", "Simulation");
+    m_cSettings.m_bTally            = cConfigFile.GetBool("Tally", "Simulation");
+    m_cSettings.m_bCompare          = cConfigFile.GetBool("Compare", "Simulation");
+    m_cSettings.m_sBaseline         = cConfigFile.GetString("CompareBaseline", "Simulation");
+    m_cSettings.m_sSampling         = cConfigFile.GetString("Sampling", "Simulation");
+    m_cSettings.m_fTargetCIWidth    = cConfigFile.GetFloat("TargetCIWidth", "Simulation");
+    m_cSettings.m_nMaxRuns          = cConfigFile.GetInt("MaxRuns", "Simulation");
+    m_cSettings.m_bDropOnTarget     = cConfigFile.GetBool("DropOnTarget", "Simulation");
+    m_cSettings.m_bRace             = cConfigFile.GetBool("Race", "Simulation");
+    m_cSettings.m_nRaceSurvivors    = cConfigFile.GetInt("RaceSurvivors", "Simulation");
+    m_cSettings.m_bLockstep         = cConfigFile.GetBool("Lockstep", "Simulation");
+    m_cSettings.m_bCountAllocations = cConfigFile.GetBool("CountAllocations", "Simulation");
+    m_cSettings.m_nSeed             = cConfigFile.GetInt("Seed", "Simulation");
+    m_cSettings.m_sResultCache      = cConfigFile.GetString("ResultCache", "Simulation");
+    m_cSettings.m_sCheckpoint       = cConfigFile.GetString("Checkpoint", "Simulation");
+    m_cSettings.m_nCheckpointRuns   = cConfigFile.GetInt("CheckpointRuns", "Simulation");
+    m_cSettings.m_nCheckpointSeconds = cConfigFile.GetInt("CheckpointSeconds", "Simulation");
+    m_cSettings.m_sRecordRolls      = cConfigFile.GetString("RecordRolls", "Simulation");
+    m_cSettings.m_sReplayRolls      = cConfigFile.GetString("ReplayRolls", "Simulation");
+    m_cSettings.m_sSurvivalCurve    = cConfigFile.GetString("SurvivalCurve", "Simulation");
+
+    // The Table and its dice, and the dice of dice setters
+    ReadTable(cConfigFile, "Table", m_cSettings);
+    ReadDiceModel(cConfigFile, "DiceSetter", m_cSettings.m_cSetterModel);
+    m_cSettings.m_fSetterShare      = cConfigFile.GetFloat("Share", "DiceSetter");
+}
+
+/**
+  * Return the TableN sections of a configuration file.
+  *
+  * Loop through possible Table sections (TableXX), as CreateStrategies()
+  * does Strategy sections.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *
+  *\return The sections, in order, none if the file has only a Table section.
+  */
+
+std::vector<std::string> Configuration::TableSections(CDataFile &cConfigFile)
+{
+    std::vector<std::string> vsSections;
+    std::string sTableName;
+    for (int iii = 1; iii <= 24; ++iii)
+    {
+        sTableName = "Table" + std::to_string(iii);
+        if (cConfigFile.CheckSectionName(sTableName)) vsSections.push_back(sTableName);
+    }
+
+    return (vsSections);
+}
+
+/**
+  * Return the settings of a TableN section's table.
+  *
+  * The settings are those of the Table and Simulation sections, with the
+  * table and dice keys the TableN section sets.  The tables are played at
+  * once, so nothing may be written to one file by more than one table;
+  * each table's survival curves are written to a file of its own.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *\param sSection The TableN section
+  *
+  *\return The settings.
+  */
+
+SimulationSettings Configuration::TableSettings(CDataFile &cConfigFile, const std::string &sSection) const
+{
+    const std::string sWhat = "Configuration Table sections cannot be used with";
+
+    if (!m_cSettings.m_sCheckpoint.empty())
+        throw CrapSimException(sWhat, "Checkpoint");
+    if (!m_cSettings.m_sRecordRolls.empty())
+        throw CrapSimException(sWhat, "RecordRolls");
+    if (m_cSettings.m_nShards != INT_MIN)
+        throw CrapSimException(sWhat, "Shard");
+    if (m_cSettings.m_bCoordinate)
+        throw CrapSimException(sWhat, "Coordinate");
+
+    SimulationSettings cSettings = m_cSettings;
+    ReadTable(cConfigFile, sSection, cSettings);
+
+    // Each table writes its own survival curves, e.g., Curves-Table1.csv
+    if (!cSettings.m_sSurvivalCurve.empty())
+    {
+        std::string::size_type nDot   = cSettings.m_sSurvivalCurve.rfind('.');
+        std::string::size_type nSlash = cSettings.m_sSurvivalCurve.find_last_of("/\\");
+        if ((nDot == std::string::npos) || ((nSlash != std::string::npos) && (nDot < nSlash)))
+            nDot = cSettings.m_sSurvivalCurve.size();
+
+        cSettings.m_sSurvivalCurve.insert(nDot, "-" + sSection);
+    }
+
+    return (cSettings);
+}
+
+/**
+  * Set up a Simulation.
+  *
+  * Add the Table, seed the dice if a seed is set, and set the sampling
+  * method, stopping rule, race, comparison and other Simulation settings.
+  *
+  *\param cSim The Simulation
+  *\param nRuns Number of runs the Simulation will play
+  */
+
+void SimulationSettings::Apply(Simulation &cSim, int nRuns) const
+{
+    // Add the Table to the Simulation.
+    cSim.AddTable(m_cTable);
+
+    // Seed the dice, if requested.
+    if (m_nSeed != INT_MIN) cSim.SetSeed(static_cast<unsigned>(m_nSeed));
+
+    // Set the dice sampling method.
+    if (!m_sSampling.empty())
+    {
+        if (!cSim.SetSampling(m_sSampling))
+        {
+            throw CrapSimException("Configuration Unknown sampling method", m_sSampling);
+        }
+    }
+
+    // Roll biased dice, and let dice setters shoot, if requested.  The
+    // sampling methods pair and stratify the outcomes of fair dice.
+    if (!m_cDiceModel.Fair() || (m_fSetterShare != FLT_MIN))
+    {
+        if (cSim.Sampling() != DiceSampling::PLAIN)
+            throw CrapSimException("Configuration Biased dice cannot be used with", "Sampling " + m_sSampling);
+
+        cSim.SetDiceModels(m_cDiceModel, m_cSetterModel, m_fSetterShare == FLT_MIN ? 0.0 : m_fSetterShare);
+    }
+
+    // Stopping rules and races run at most MaxRuns.
+    cSim.SetMaxRuns(m_nMaxRuns == INT_MIN ? 10 * nRuns : m_nMaxRuns);
+
+    // Run until the confidence intervals are narrow enough, if requested.
+    if (m_fTargetCIWidth != FLT_MIN)
+    {
+        if (m_fTargetCIWidth <= 0.0)
+        {
+            throw CrapSimException("Configuration Target CI width must be positive", std::to_string(m_fTargetCIWidth));
+        }
+
+        // A race has no place in its ranking for a Strategy dropped on target
+        if (m_bDropOnTarget && (m_bRace || (m_nRaceSurvivors != INT_MIN)))
+        {
+            throw CrapSimException("Configuration DropOnTarget cannot be used with", "Race");
+        }
+
+        cSim.SetStoppingRule(m_fTargetCIWidth, m_bDropOnTarget);
+    }
+
+    // Race the Strategies, if requested.  Survivors implies racing.
+    if (m_nRaceSurvivors != INT_MIN)
+    {
+        if (m_nRaceSurvivors < 1)
+        {
+            throw CrapSimException("Configuration Race survivors must be positive", std::to_string(m_nRaceSurvivors));
+        }
+
+        cSim.SetRace(true, m_nRaceSurvivors);
+    }
+    else
+    {
+        cSim.SetRace(m_bRace, 1);
+    }
+
+    // Compare Strategies pairwise if requested.  A baseline implies comparison.
+    if (m_bCompare || !m_sBaseline.empty()) cSim.SetPairedComparison(true, m_sBaseline);
+
+    // Play independent runs side by side, if requested
+    cSim.SetLockstep(m_bLockstep);
+
+    // Count heap allocations per roll, if requested
+    cSim.SetCountAllocations(m_bCountAllocations);
+
+    // Write the survival curves with the report, if requested
+    cSim.SetSurvivalCurve(m_sSurvivalCurve);
+
+    // Reuse the results of Strategies played before, if requested.  Only a
+    // Strategy's own settings, the seed and the runs may bear on its results.
+    if (!m_sResultCache.empty())
+    {
+        if (m_nSeed == INT_MIN)
+            throw CrapSimException("Configuration ResultCache needs a Seed");
+        if (m_bCompare || !m_sBaseline.empty())
+            throw CrapSimException("Configuration ResultCache cannot be used with", "Compare");
+        if (m_bRace || (m_nRaceSurvivors != INT_MIN))
+            throw CrapSimException("Configuration ResultCache cannot be used with", "Race");
+        if (m_fTargetCIWidth != FLT_MIN)
+            throw CrapSimException("Configuration ResultCache cannot be used with", "TargetCIWidth");
+        if (m_bLockstep)
+            throw CrapSimException("Configuration ResultCache cannot be used with", "Lockstep");
+        if (cSim.Sampling() != DiceSampling::PLAIN)
+            throw CrapSimException("Configuration ResultCache cannot be used with", "Sampling " + m_sSampling);
+
+        cSim.SetResultCache(m_sResultCache);
+    }
+
+    // Record the rolls, and play recorded rolls, if requested.  Rolls are
+    // played a run at a time from the start of each run, so only the
+    // plain sampling of the dice fits them.
+    if (!m_sReplayRolls.empty())
+    {
+        if (m_sReplayRolls == m_sRecordRolls)
+            throw CrapSimException("Configuration ReplayRolls and RecordRolls must be different files", m_sReplayRolls);
+        if (!m_sResultCache.empty())
+            throw CrapSimException("Configuration ReplayRolls cannot be used with", "ResultCache");
+        if (cSim.Sampling() != DiceSampling::PLAIN)
+            throw CrapSimException("Configuration ReplayRolls cannot be used with", "Sampling " + m_sSampling);
+        if (!m_cDiceModel.Fair() || (m_fSetterShare != FLT_MIN))
+            throw CrapSimException("Configuration ReplayRolls cannot be used with", "biased dice");
+    }
+    if (!m_sRecordRolls.empty() && !m_sCheckpoint.empty())
+        throw CrapSimException("Configuration RecordRolls cannot be used with", "Checkpoint");
+
+    // Write checkpoints, and resume from one, if requested.  Unless told
+    // otherwise, a checkpoint is written every minute.
+    if (!m_sCheckpoint.empty())
+    {
+        if (m_bLockstep)
+            throw CrapSimException("Configuration Checkpoint cannot be used with", "Lockstep");
+        if ((m_nCheckpointRuns != INT_MIN) && (m_nCheckpointRuns < 1))
+            throw CrapSimException("Configuration Checkpoint runs must be positive", std::to_string(m_nCheckpointRuns));
+        if ((m_nCheckpointSeconds != INT_MIN) && (m_nCheckpointSeconds < 1))
+            throw CrapSimException("Configuration Checkpoint seconds must be positive", std::to_string(m_nCheckpointSeconds));
+
+        int nEveryRuns    = (m_nCheckpointRuns == INT_MIN) ? 0 : m_nCheckpointRuns;
+        int nEverySeconds = (m_nCheckpointSeconds != INT_MIN) ? m_nCheckpointSeconds : (nEveryRuns == 0 ? 60 : 0);
+
+        cSim.SetCheckpoint(m_sCheckpoint, nEveryRuns, nEverySeconds, m_bResume);
+    }
+    else if (m_bResume)
+    {
+        throw CrapSimException("Configuration Resume needs a Checkpoint");
+    }
+
+    // Play one shard of the runs, or hand the runs to workers, if
+    // requested.  Every shard or worker must play the same dice in its runs
+    // as a single process, so each run is seeded from its number, and
+    // nothing may depend on the runs of others.
+    if ((m_nShards != INT_MIN) || m_bCoordinate)
+    {
+        const std::string sWhat = m_bCoordinate ? "Configuration Coordinate" : "Configuration Shard";
+
+        if (!m_bCoordinate && ((m_nShards < 1) || (m_nShard < 1) || (m_nShard > m_nShards)))
+            throw CrapSimException("Configuration Shard must be 1 to N of N", std::to_string(m_nShard) + "/" + std::to_string(m_nShards));
+        if (m_nSeed == INT_MIN)
+            throw CrapSimException(sWhat + " needs a Seed");
+        if (m_bCompare || !m_sBaseline.empty())
+            throw CrapSimException(sWhat + " cannot be used with", "Compare");
+        if (m_bRace || (m_nRaceSurvivors != INT_MIN))
+            throw CrapSimException(sWhat + " cannot be used with", "Race");
+        if (m_fTargetCIWidth != FLT_MIN)
+            throw CrapSimException(sWhat + " cannot be used with", "TargetCIWidth");
+        if (m_bLockstep)
+            throw CrapSimException(sWhat + " cannot be used with", "Lockstep");
+        if (!m_sResultCache.empty())
+            throw CrapSimException(sWhat + " cannot be used with", "ResultCache");
+        if (cSim.Sampling() != DiceSampling::PLAIN)
+            throw CrapSimException(sWhat + " cannot be used with", "Sampling " + m_sSampling);
+        if (m_bCoordinate && !m_sCheckpoint.empty())
+            throw CrapSimException(sWhat + " cannot be used with", "Checkpoint");
+        if (!m_sRecordRolls.empty())
+            throw CrapSimException(sWhat + " cannot be used with", "RecordRolls");
+        if (!m_sReplayRolls.empty())
+            throw CrapSimException(sWhat + " cannot be used with", "ReplayRolls");
+
+        if (!m_bCoordinate) cSim.SetShard(m_nShard, m_nShards, m_sPartialResults);
+    }
+
+    // Open the roll tapes once every setting is known to be good
+    cSim.SetRollTapes(m_sRecordRolls, m_sReplayRolls);
+}
+
+/**
+  * Create the Strategies of a configuration file.
+  *
+  * Loop though possible Strategy sections (StrategyXX).  If one exists,
+  * expand any swept keys into a grid of settings and create a Strategy for
+  * each point of the grid.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *
+  *\return The Strategies, in the order of their sections.
+  */
+
+std::vector<Strategy> Configuration::CreateStrategies(CDataFile &cConfigFile) const
+{
+    std::vector<std::pair<std::string, ParameterGrid>> vSections;
+    std::size_t nStrategies = 0;
+    std::string sStrategyName;
+    for (int iii = 1; iii <= 24; ++iii)
+    {
+        sStrategyName = "Strategy" + std::to_string(iii);
+        if (cConfigFile.CheckSectionName(sStrategyName))
+        {
+            ParameterGrid cGrid;
+            for (const char *pszKey : g_apszSweepableKeys)
+            {
+                std::string sValue = cConfigFile.GetString(pszKey, sStrategyName);
+                if (ParameterGrid::IsSweep(sValue)) cGrid.AddAxis(pszKey, sValue);
+            }
+
+            nStrategies += cGrid.Size();
+            vSections.push_back(std::make_pair(sStrategyName, cGrid));
+        }
+    }
+
+    // Create a Strategy for each point of each section's grid.
+    std::vector<Strategy> vStrategies;
+    vStrategies.reserve(nStrategies);
+    for (const std::pair<std::string, ParameterGrid> &stSection : vSections)
+    {
+        const ParameterGrid &cGrid = stSection.second;
+        for (std::size_t nPoint = 0; nPoint < cGrid.Size(); ++nPoint)
+        {
+            vStrategies.push_back(CreateStrategy(cConfigFile, stSection.first, cGrid.Point(nPoint),
+                                  cGrid.Size() > 1 ? cGrid.Label(nPoint) : std::string()));
+        }
+    }
+
+    return (vStrategies);
+}
+
+/**
+  * Return the Strategy keys that may be swept with range or list syntax.
+  *
+  * \return The keys.
+  */
+
+const std::vector<std::string>& Configuration::SweepableKeys()
+{
+    static const std::vector<std::string> vsKeys(std::begin(g_apszSweepableKeys), std::end(g_apszSweepableKeys));
+
+    return (vsKeys);
+}
+
+/**
+  * Create a Strategy.
+  *
+  * Read the Strategy's settings from a section of a configuration file, with
+  * the swept keys at a point of the section's grid.  Settings of the
+  * DefaultStrategy section fill in those the section does not set.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *\param sStrategy Section name of strategy from the configuration file
+  *\param mSwept Values of swept keys at this point of the section's parameter grid
+  *\param sLabel Label of the grid point, appended to the Strategy name; empty if nothing is swept
+  *
+  *\return The Strategy.
+  */
+
+Strategy Configuration::CreateStrategy(CDataFile &cConfigFile, const std::string &sStrategy,
+                                       const std::map<std::string, std::string> &mSwept,
+                                       const std::string &sLabel) const
+{
+    StrategySection cSection(cConfigFile, sStrategy, mSwept);
+
+    //
+    // Read config file for parameters this Strategy
+    //
+
+    // Basic
+    std::string sName                   = cSection.GetString("Name");
+    std::string sDescription            = cSection.GetString("Description");
+
+    // Money
+    int         nStandardWager          = cSection.GetInt("StandardWager");
+    bool        bFullWager              = cSection.GetBool("FullWager");
+    int         nInitialBankroll        = cSection.GetInt("InitialBankroll");
+    int         nSignificantWinnings    = cSection.GetInt("SignificantWinnings");
+    float       fSWM                    = cSection.GetFloat("SWM");
+    int         nPlayForNumberOfRolls  = cSection.GetInt("PlayForNumberOfRolls");
+
+    // Predefined Strategies
+    std::string sPredefined             = cSection.GetString("Predefined");
+
+    // Types and numbers of bets allowed
+    int         nPassBet                = cSection.GetInt("PassBet");
+    int         nDontPassBet            = cSection.GetInt("DontPassBet");
+    int         nComeBets               = cSection.GetInt("ComeBets");
+    int         nDontComeBets           = cSection.GetInt("DontComeBets");
+
+    int         nPlaceBets              = cSection.GetInt("PlaceBets");
+    int         nPlaceBetsMadeAtOnce    = cSection.GetInt("PlaceBetsMadeAtOnce");
+    bool        bPlaceAfterCome         = cSection.GetBool("PlaceAfterCome");
+    std::string sPlaceAfterCome         = cSection.GetString("PlaceAfterCome"); // Needed for Predefined strategies
+    int         nPlacePreferred         = cConfigFile.GetInt("PlacePreferred");
+    int         nPlaceBetUnits          = cSection.GetInt("PlaceBetUnits");
+    bool        bPlaceWorking           = cSection.GetBool("PlaceWorking");
+
+    bool        bPutBet                 = cSection.GetBool("PutBet");
+
+    bool        bFieldBet               = cSection.GetBool("FieldBet");
+    int         nFieldBetUnits          = cSection.GetInt("FieldBetUnits");
+
+    bool        bBig6Bet                = cSection.GetBool("Big6Bet");
+    bool        bBig8Bet                = cSection.GetBool("Big8Bet");
+    bool        bAny7Bet                = cSection.GetBool("Any7Bet");
+    bool        bAnyCrapsBet            = cSection.GetBool("AnyCrapsBet");
+    bool        bCraps2Bet              = cSection.GetBool("Craps2Bet");
+    bool        bCraps3Bet              = cSection.GetBool("Craps3Bet");
+    bool        bYo11Bet                = cSection.GetBool("Yo11Bet");
+    bool        bCraps12Bet             = cSection.GetBool("Craps12Bet");
+
+    // Odds settings
+    float       fStandardOdds           = cSection.GetFloat("StandardOdds");
+    bool        bComeOddsWorking        = cSection.GetBool("ComeOddsWorking");
+    std::string sOddsProgressionMethod  = cSection.GetString("OddsProgressionMethod");
+
+    // Wager progression method
+    std::string sWagerProgressionMethod = cSection.GetString("WagerProgressionMethod");
+
+    // Shooter qualification method
+    std::string sQualifiedShooterMethod = cSection.GetString("QualifiedShooterMethod");
+    int         nQualifiedShooterMethodCount = cSection.GetInt("QualifiedShooterMethodCount");
+
+    // Bet modification method
+    std::string sBetModificationMethod = cSection.GetString("BetModificationMethod");
+
+    // Tracking results (used for debugging)
+    bool        bTrace                  = cSection.GetBool("Trace");
+
+    //
+    // Set the Strategy's parameters
+    //
+
+    // Set initial bankroll.  Use DefaultStrategy setting if individual strategy's InitialBankroll is not set.
+    if (nInitialBankroll == INT_MIN) nInitialBankroll = m_nDefaultInitBank;
+
+    // Set standard wager.  Use DefaultStrategy setting if individual strategy's StandardWager is not set.
+    if (nStandardWager == INT_MIN) nStandardWager = m_nDefaultStdWager;
+
+    //Create Strategy
+    Strategy cStrategy(sName, sDescription, nInitialBankroll, nStandardWager, bTrace);
+
+    // If Predefined is defined, use it to modify Strategy.  Exit if entry is unknown.
+    if (sPredefined != "")
+    {
+        // TODO: make this a utility
+        std::locale loc;
+        for (std::string::size_type iii = 0; iii < sPredefined.length(); ++iii)
+            sPredefined[iii] = std::toupper(sPredefined[iii], loc);
+
+        if      (sPredefined == "ELEMENTARY")   cStrategy.SetElementary();
+        else if (sPredefined == "CONSERVATIVE") cStrategy.SetConservative();
+        else if (sPredefined == "CONVENTIONAL") cStrategy.SetConventional();
+        else if (sPredefined == "AGGRESSIVE")   cStrategy.SetAggressive();
+        else  // Don't know what the Predefined parameter is.  Exit with error.
+        {
+            throw CrapSimException("Configuration Unknown Predefined setting:", sPredefined);
+        }
+    }
+
+    // If Name is blank, use the Strategy section name
+    if (cStrategy.Name() == "") cStrategy.SetName(sStrategy);
+
+    // If the section sweeps parameters, name the Strategy for its grid point
+    if (!sLabel.empty()) cStrategy.SetName(cStrategy.Name() + " [" + sLabel + "]");
+
+    //
+    // Pass Default configuration parameters if not overridden
+    // Set significant winnings multiple.  Use DefaultStrategy setting if individual strategy's SWM is not set.
+    if (fSWM == FLT_MIN) fSWM = m_fDefaultSWM;
+    // If Significant Winngings Multiple has been set, pass to Strategy
+    if (fSWM != FLT_MIN) cStrategy.SetSignificantWinningsMultiple(fSWM);
+    // Set significant winnings.  Use DefaultStrategy setting if individual strategy's Significant Winnings is not set.
+    if (nSignificantWinnings == INT_MIN) nSignificantWinnings = m_nDefaultSigWin;
+    // If Significant Winngings Multiple has been set, pass to Strategy
+    if (nSignificantWinnings != INT_MIN) cStrategy.SetSignificantWinnings(nSignificantWinnings);
+    // Set number of rolls to play.  Use DefaultStrategy setting if individual strategy's Play Number Of Rolls is not set.
+    if (nPlayForNumberOfRolls == INT_MIN) nPlayForNumberOfRolls = m_nDefaultPlayForNumberOfRolls;
+    // If Significant Winngings Multiple has been set, pass to Strategy
+    if (nPlayForNumberOfRolls != INT_MIN) cStrategy.SetPlayForNumberOfRolls(nPlayForNumberOfRolls);
+
+    // Pass choice to make Full Wagers to Strategy
+    cStrategy.SetFullWager(bFullWager);
+
+    // If Pass Bet has been set, pass to Strategy
+    if (nPassBet != INT_MIN) cStrategy.SetPassBet(nPassBet);
+
+    // If Dont Pass Bet has been set, pass to Strategy
+    if (nDontPassBet != INT_MIN) cStrategy.SetDontPassBet(nDontPassBet);
+
+    // If number of Come Bets has been set, pass to Strategy
+    if (nComeBets != INT_MIN) cStrategy.SetNumberOfComeBets(nComeBets);
+
+    // If number of Dont Come Bets has been set, pass to Strategy
+    if (nDontComeBets != INT_MIN) cStrategy.SetNumberOfDontComeBets(nDontComeBets);
+
+    // If number of Place Bets has been set, pass to Strategy
+    if (nPlaceBets != INT_MIN) cStrategy.SetNumberOfPlaceBets(nPlaceBets);
+
+    // If number of Place Bets has been set, pass to Strategy
+    if (nPlaceBetsMadeAtOnce != INT_MIN) cStrategy.SetNumberOfPlaceBetsMadeAtOnce(nPlaceBetsMadeAtOnce);
+
+    // If PlaceAfterCome was set (checked using string) then updated settings
+    if (!sPlaceAfterCome.empty())
+    {
+        // Pass choice to make Place bets only after Come bets to Strategy
+        cStrategy.SetPlaceAfterCome(bPlaceAfterCome);
+    }
+
+    // If preferred Place bet number has been set, pass to Strategy
+    if (nPlacePreferred != INT_MIN) cStrategy.SetPlacePreferred(nPlacePreferred);
+
+    // If the number of bet units for Place bets has been set, pass to Strategy
+    if (nPlaceBetUnits != INT_MIN) cStrategy.SetPlaceBetUnits(nPlaceBetUnits);
+
+    // Pass Place bets working to Strategy
+    cStrategy.SetPlaceWorking(bPlaceWorking);
+
+    // Pass Put Bet to Strategy; default is false
+    cStrategy.SetPutBetsAllowed(bPutBet);
+
+    // Pass Field Bet to Strategy; default is false
+    cStrategy.SetFieldBetAllowed(bFieldBet);
+
+    // If the number of bet units for Place bets has been set, pass to Strategy
+    if (nFieldBetUnits != INT_MIN) cStrategy.SetFieldBetUnits(nFieldBetUnits);
+
+    // Pass Any 7 Bet to Strategy; default is false
+    cStrategy.SetAny7BetAllowed(bAny7Bet);
+    // Pass Any Craps Bet to Strategy; default is false
+    cStrategy.SetAnyCrapsBetAllowed(bAnyCrapsBet);
+    // Pass Any Craps Bet to Strategy; default is false
+    cStrategy.SetCraps2BetAllowed(bCraps2Bet);
+    // Pass Any Craps Bet to Strategy; default is false
+    cStrategy.SetCraps3BetAllowed(bCraps3Bet);
+    // Pass Any Craps Bet to Strategy; default is false
+    cStrategy.SetYo11BetAllowed(bYo11Bet);
+    // Pass Any Craps Bet to Strategy; default is false
+    cStrategy.SetCraps12BetAllowed(bCraps12Bet);
+    // Pass Big 6 Bet to Strategy; default is false
+    cStrategy.SetBig6BetAllowed(bBig6Bet);
+    // Pass Big 8 Bet to Strategy; default is false
+    cStrategy.SetBig8BetAllowed(bBig8Bet);
+
+    // If Standard Odds has been set, pass to Strategy
+    if (fStandardOdds != FLT_MIN) cStrategy.SetStandardOdds(fStandardOdds);
+    // Pass choice to make odds working on a table come out roll to Strategy
+    cStrategy.SetComeOddsWorking(bComeOddsWorking);
+
+    // If OddsProgression was set then updated Strategy
+    if (!sOddsProgressionMethod.empty()) cStrategy.SetOddsProgressionMethod(sOddsProgressionMethod);
+
+    // If WagerProgressionMethod was set then update Strategy
+    if (!sWagerProgressionMethod.empty()) cStrategy.SetWagerProgressionMethod(sWagerProgressionMethod);
+
+    // If Qualified Shooter Method was set then update Strategy
+    if (!sQualifiedShooterMethod.empty()) cStrategy.SetQualifiedShooterMethod(sQualifiedShooterMethod);
+
+    if (nQualifiedShooterMethodCount != INT_MIN) cStrategy.SetQualifiedShooterMethodCount(nQualifiedShooterMethodCount);
+
+    // If BetModificationMethod was set then update Strategy
+    if (!sBetModificationMethod.empty()) cStrategy.SetBetModificationMethod(sBetModificationMethod);
+
+    // Compile betting rules Rule1, Rule2, ... up to the first one missing
+    for (int iii = 1; ; ++iii)
+    {
+        std::string sRule = cSection.GetString("Rule" + std::to_string(iii));
+        if (sRule.empty()) break;
+
+        cStrategy.AddRule(sRule);
+    }
+
+    // If Routine was set then update Strategy
+    std::string sRoutine = cSection.GetString("Routine");
+    if (!sRoutine.empty()) cStrategy.SetRoutine(sRoutine);
+
+    // If Plugin was set then load it for the Strategy
+    std::string sPlugin = cSection.GetString("Plugin");
+    if (!sPlugin.empty()) cStrategy.SetPlugin(sPlugin, cSection.GetString("PluginArguments"));
+
+    return (cStrategy);
+}
@@ -0,0 +1,559 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "CrapSimLibrary.h"
+
+#include <array>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Configuration.h"
+#include "Simulation.h"
+#include "Strategy.h"
+#include "TemporaryFile.h"
+#include "ThreadPool.h"
+#include "CDataFile.h"
+
+// The C interface has its own copy of the number
+static_assert(CRAPSIM_HISTOGRAM_BUCKETS == LOG_HISTOGRAM_BUCKETS, "CRAPSIM_HISTOGRAM_BUCKETS does not match LOG_HISTOGRAM_BUCKETS");
+
+struct CrapSimPool
+{
+    ThreadPool cThreadPool;
+
+    explicit CrapSimPool(int nThreads) : cThreadPool(nThreads) {}
+};
+
+/**
+  * A job.
+  *
+  * The Strategies are kept as created, before play, so that a job can be
+  * run again.  Each part of a running job plays copies of them in a
+  * Simulation of its own and keeps its results; the part that finishes
+  * last merges them, in the order of the parts, so that a seeded job gives
+  * the same results however its parts were scheduled.
+  */
+
+struct CrapSimJob
+{
+    Configuration         cConfig;
+    std::vector<Strategy> vStrategies;
+    std::string           sError;
+
+    // Results of the job last finished
+    std::vector<Strategy>      vResults;
+    std::array<long long, 13>  anDiceCounts {};
+    long long                  nTotalRolls {0};
+
+    // A part's results
+    struct Part
+    {
+        std::vector<Strategy>     vStrategies;
+        std::array<long long, 13> anDiceCounts {};
+        long long                 nTotalRolls {0};
+    };
+
+    // Parts of the running job, those still running and the first error
+    // met, guarded by mtxJob
+    std::vector<Part>       vParts;
+    int                     nPartsRunning {0};
+    std::string             sPartError;
+    std::mutex              mtxJob;
+    std::condition_variable cvJob;
+
+    // Play part iPart of nRuns
+    void PlayPart(int iPart, int nRuns, const SimulationSettings &cSettings);
+    // Merge the parts' results
+    void MergeParts();
+};
+
+/**
+  * Play a part of a job.
+  *
+  * The part plays copies of the job's Strategies in a Simulation of its
+  * own, printing nothing.  The results are kept with the part; the last
+  * part to finish merges them and wakes those waiting.
+  *
+  * \param iPart The part.
+  * \param nRuns The runs the part plays.
+  * \param cSettings The Table and Simulation settings, with the part's seed.
+  */
+
+void CrapSimJob::PlayPart(int iPart, int nRuns, const SimulationSettings &cSettings)
+{
+    Part cPart;
+    std::string sError;
+
+    try
+    {
+        // Progress goes nowhere
+        std::ostream osLog(nullptr);
+
+        Simulation cSim;
+        cSim.SetLog(osLog);
+        cSettings.Apply(cSim, nRuns);
+
+        cSim.ReserveStrategies(vStrategies.size());
+        for (const Strategy &cStrategy : vStrategies)
+        {
+            cSim.AddStrategy(cStrategy);
+        }
+
+        if (nRuns > 0) cSim.Run(nRuns, false, false);
+
+        cPart.vStrategies = cSim.Strategies();
+        for (int iii = 2; iii <= 12; ++iii)
+        {
+            cPart.anDiceCounts[iii] = cSim.RollValueCount(iii);
+        }
+        cPart.nTotalRolls = cSim.TotalRolls();
+    }
+    catch (const CrapSimException &e)
+    {
+        sError = std::string(e.what()) + " " + e.m_sArg;
+    }
+    catch (const std::exception &e)
+    {
+        sError = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(mtxJob);
+
+    vParts[iPart] = std::move(cPart);
+    if (sPartError.empty()) sPartError = sError;
+
+    if (--nPartsRunning == 0)
+    {
+        if (sPartError.empty()) MergeParts();
+        cvJob.notify_all();
+    }
+}
+
+/**
+  * Merge the parts' results, in the order of the parts.
+  */
+
+void CrapSimJob::MergeParts()
+{
+    vResults = std::move(vParts[0].vStrategies);
+    anDiceCounts = vParts[0].anDiceCounts;
+    nTotalRolls  = vParts[0].nTotalRolls;
+
+    for (std::vector<Part>::size_type iii = 1; iii < vParts.size(); ++iii)
+    {
+        for (std::vector<Strategy>::size_type jjj = 0; jjj < vResults.size(); ++jjj)
+        {
+            vResults[jjj].MergeResults(vParts[iii].vStrategies[jjj]);
+        }
+
+        for (int kkk = 2; kkk <= 12; ++kkk)
+        {
+            anDiceCounts[kkk] += vParts[iii].anDiceCounts[kkk];
+        }
+        nTotalRolls += vParts[iii].nTotalRolls;
+    }
+
+    vParts.clear();
+}
+
+// Run a function on a job, turning exceptions into CRAPSIM_ERROR with the
+// reason kept for CrapSimJobError()
+template <typename FUNCTION> static int Guard(CrapSimJob *pJob, FUNCTION fFunction)
+{
+    if (pJob == nullptr) return (CRAPSIM_ERROR);
+
+    pJob->sError.clear();
+
+    try
+    {
+        fFunction();
+        return (CRAPSIM_OK);
+    }
+    catch (const CrapSimException &e)
+    {
+        pJob->sError = std::string(e.what()) + " " + e.m_sArg;
+    }
+    catch (const std::exception &e)
+    {
+        pJob->sError = e.what();
+    }
+
+    return (CRAPSIM_ERROR);
+}
+
+// Throw if the job is running
+static void CheckNotRunning(CrapSimJob *pJob)
+{
+    std::lock_guard<std::mutex> lock(pJob->mtxJob);
+    if (pJob->nPartsRunning > 0)
+        throw CrapSimException("CrapSimJob is running");
+}
+
+// Set a key to a string, int or double, if set
+static void SetKey(std::map<std::string, std::string> &mSettings, const char *pszKey, const char *pszValue)
+{
+    if (pszValue) mSettings[pszKey] = pszValue;
+}
+
+static void SetKey(std::map<std::string, std::string> &mSettings, const char *pszKey, int nValue)
+{
+    if (nValue != CRAPSIM_UNSET) mSettings[pszKey] = std::to_string(nValue);
+}
+
+static void SetKey(std::map<std::string, std::string> &mSettings, const char *pszKey, double dValue)
+{
+    if (dValue != 0.0) mSettings[pszKey] = std::to_string(dValue);
+}
+
+extern "C"
+{
+
+int CrapSimLibraryAbi(void)
+{
+    return (CRAPSIM_LIBRARY_ABI);
+}
+
+CrapSimPool *CrapSimPoolCreate(int nThreads)
+{
+    try
+    {
+        return (new CrapSimPool(nThreads));
+    }
+    catch (const std::exception &)
+    {
+        return (nullptr);
+    }
+}
+
+void CrapSimPoolDestroy(CrapSimPool *pPool)
+{
+    delete pPool;
+}
+
+CrapSimJob *CrapSimJobCreate(void)
+{
+    return (new (std::nothrow) CrapSimJob);
+}
+
+void CrapSimJobDestroy(CrapSimJob *pJob)
+{
+    if (pJob == nullptr) return;
+
+    CrapSimJobWait(pJob);
+    delete pJob;
+}
+
+int CrapSimJobLoadIni(CrapSimJob *pJob, const char *pszIni)
+{
+    return (Guard(pJob, [&]
+        {
+            CheckNotRunning(pJob);
+
+            TemporaryFile cFile(pszIni ? pszIni : "");
+            CDataFile cConfigFile(cFile.Path());
+            cConfigFile.ClearDirty();
+
+            Configuration cConfig(cConfigFile);
+            std::vector<Strategy> vStrategies = cConfig.CreateStrategies(cConfigFile);
+
+            pJob->cConfig     = cConfig;
+            pJob->vStrategies = std::move(vStrategies);
+            pJob->vResults.clear();
+        }));
+}
+
+int CrapSimJobSetTable(CrapSimJob *pJob, const char *pszType, int nMinimumWager, int nMaximumWager)
+{
+    return (Guard(pJob, [&]
+        {
+            CheckNotRunning(pJob);
+
+            Table &cTable = pJob->cConfig.Settings().m_cTable;
+            if ((pszType != nullptr) && !cTable.SetTableType(pszType))
+                throw CrapSimException("CrapSimJobSetTable Unknown table type", pszType);
+            if (nMinimumWager != CRAPSIM_UNSET) cTable.SetMinimumBet(nMinimumWager);
+            if (nMaximumWager != CRAPSIM_UNSET) cTable.SetMaximumBet(nMaximumWager);
+        }));
+}
+
+int CrapSimJobSetSeed(CrapSimJob *pJob, int nSeed)
+{
+    return (Guard(pJob, [&]
+        {
+            CheckNotRunning(pJob);
+            pJob->cConfig.Settings().m_nSeed = nSeed;
+        }));
+}
+
+void CrapSimStrategySettingsInit(CrapSimStrategySettings *pSettings)
+{
+    if (pSettings == nullptr) return;
+
+    *pSettings = CrapSimStrategySettings();
+
+    pSettings->nInitialBankroll             = CRAPSIM_UNSET;
+    pSettings->nStandardWager               = CRAPSIM_UNSET;
+    pSettings->nFullWager                   = CRAPSIM_UNSET;
+    pSettings->nSignificantWinnings         = CRAPSIM_UNSET;
+    pSettings->nPlayForNumberOfRolls        = CRAPSIM_UNSET;
+    pSettings->nPassBet                     = CRAPSIM_UNSET;
+    pSettings->nDontPassBet                 = CRAPSIM_UNSET;
+    pSettings->nComeBets                    = CRAPSIM_UNSET;
+    pSettings->nDontComeBets                = CRAPSIM_UNSET;
+    pSettings->nPlaceBets                   = CRAPSIM_UNSET;
+    pSettings->nPlaceBetsMadeAtOnce         = CRAPSIM_UNSET;
+    pSettings->nPlaceBetUnits               = CRAPSIM_UNSET;
+    pSettings->nPlaceWorking                = CRAPSIM_UNSET;
+    pSettings->nPutBet                      = CRAPSIM_UNSET;
+    pSettings->nFieldBet                    = CRAPSIM_UNSET;
+    pSettings->nFieldBetUnits               = CRAPSIM_UNSET;
+    pSettings->nComeOddsWorking             = CRAPSIM_UNSET;
+    pSettings->nQualifiedShooterMethodCount = CRAPSIM_UNSET;
+}
+
+int CrapSimJobAddStrategy(CrapSimJob *pJob, const CrapSimStrategySettings *pSettings)
+{
+    return (Guard(pJob, [&]
+        {
+            CheckNotRunning(pJob);
+
+            if (pSettings == nullptr)
+                throw CrapSimException("CrapSimJobAddStrategy No settings");
+
+            // The settings are passed as the keys of a section that sets nothing else
+            std::map<std::string, std::string> mSettings;
+            SetKey(mSettings, "Name",                        pSettings->pszName);
+            SetKey(mSettings, "Description",                 pSettings->pszDescription);
+            SetKey(mSettings, "Predefined",                  pSettings->pszPredefined);
+            SetKey(mSettings, "InitialBankroll",             pSettings->nInitialBankroll);
+            SetKey(mSettings, "StandardWager",               pSettings->nStandardWager);
+            SetKey(mSettings, "FullWager",                   pSettings->nFullWager);
+            SetKey(mSettings, "SignificantWinnings",         pSettings->nSignificantWinnings);
+            SetKey(mSettings, "SWM",                         pSettings->dSWM);
+            SetKey(mSettings, "PlayForNumberOfRolls",        pSettings->nPlayForNumberOfRolls);
+            SetKey(mSettings, "PassBet",                     pSettings->nPassBet);
+            SetKey(mSettings, "DontPassBet",                 pSettings->nDontPassBet);
+            SetKey(mSettings, "ComeBets",                    pSettings->nComeBets);
+            SetKey(mSettings, "DontComeBets",                pSettings->nDontComeBets);
+            SetKey(mSettings, "PlaceBets",                   pSettings->nPlaceBets);
+            SetKey(mSettings, "PlaceBetsMadeAtOnce",         pSettings->nPlaceBetsMadeAtOnce);
+            SetKey(mSettings, "PlaceBetUnits",               pSettings->nPlaceBetUnits);
+            SetKey(mSettings, "PlaceWorking",                pSettings->nPlaceWorking);
+            SetKey(mSettings, "PutBet",                      pSettings->nPutBet);
+            SetKey(mSettings, "FieldBet",                    pSettings->nFieldBet);
+            SetKey(mSettings, "FieldBetUnits",               pSettings->nFieldBetUnits);
+            SetKey(mSettings, "StandardOdds",                pSettings->dStandardOdds);
+            SetKey(mSettings, "ComeOddsWorking",             pSettings->nComeOddsWorking);
+            SetKey(mSettings, "OddsProgressionMethod",       pSettings->pszOddsProgressionMethod);
+            SetKey(mSettings, "WagerProgressionMethod",      pSettings->pszWagerProgressionMethod);
+            SetKey(mSettings, "BetModificationMethod",       pSettings->pszBetModificationMethod);
+            SetKey(mSettings, "QualifiedShooterMethod",      pSettings->pszQualifiedShooterMethod);
+            SetKey(mSettings, "QualifiedShooterMethodCount", pSettings->nQualifiedShooterMethodCount);
+            SetKey(mSettings, "Routine",                     pSettings->pszRoutine);
+            SetKey(mSettings, "Plugin",                      pSettings->pszPlugin);
+            SetKey(mSettings, "PluginArguments",             pSettings->pszPluginArguments);
+
+            // Rules, one per line, are Rule1, Rule2, ...
+            if (pSettings->pszRules)
+            {
+                std::istringstream issRules(pSettings->pszRules);
+                std::string sRule;
+                int nRule = 0;
+                while (std::getline(issRules, sRule))
+                {
+                    if (!sRule.empty()) mSettings["Rule" + std::to_string(++nRule)] = sRule;
+                }
+            }
+
+            CDataFile cEmpty;
+            std::string sSection = "Strategy" + std::to_string(pJob->vStrategies.size() + 1);
+            pJob->vStrategies.push_back(pJob->cConfig.CreateStrategy(cEmpty, sSection, mSettings, std::string()));
+            pJob->vResults.clear();
+        }));
+}
+
+int CrapSimJobAddStrategyIni(CrapSimJob *pJob, const char *pszSection)
+{
+    return (Guard(pJob, [&]
+        {
+            CheckNotRunning(pJob);
+
+            std::string sSection = "Strategy" + std::to_string(pJob->vStrategies.size() + 1);
+
+            TemporaryFile cFile("[" + sSection + "]\n" + (pszSection ? pszSection : ""));
+            CDataFile cConfigFile(cFile.Path());
+            cConfigFile.ClearDirty();
+
+            const std::map<std::string, std::string> mNone;
+            pJob->vStrategies.push_back(pJob->cConfig.CreateStrategy(cConfigFile, sSection, mNone, std::string()));
+            pJob->vResults.clear();
+        }));
+}
+
+int CrapSimJobSubmit(CrapSimJob *pJob, CrapSimPool *pPool, int nRuns, int nParts)
+{
+    return (Guard(pJob, [&]
+        {
+            CheckNotRunning(pJob);
+
+            if (pPool == nullptr)
+                throw CrapSimException("CrapSimJobSubmit No pool");
+
+            if (nRuns <= 0) nRuns = pJob->cConfig.Settings().m_nRuns;
+            if (nRuns <= 0)
+                throw CrapSimException("CrapSimJobSubmit Number of simulation runs not set");
+
+            if (nParts < 1) nParts = pPool->cThreadPool.Threads();
+            if (nParts > nRuns) nParts = nRuns;
+
+            // Parts would write over each other's roll tape, and play the same runs of one
+            const SimulationSettings &cJobSettings = pJob->cConfig.Settings();
+            if (!cJobSettings.m_sRecordRolls.empty() || !cJobSettings.m_sReplayRolls.empty()) nParts = 1;
+
+            // Copies of a traced Strategy share its tracer, which is not safe across threads
+            for (const Strategy &cStrategy : pJob->vStrategies)
+            {
+                if (cStrategy.Traced()) nParts = 1;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(pJob->mtxJob);
+                pJob->vResults.clear();
+                pJob->vParts.assign(nParts, CrapSimJob::Part());
+                pJob->nPartsRunning = nParts;
+                pJob->sPartError.clear();
+            }
+
+            // Split the runs as evenly as may be, and seed each part apart
+            for (int iii = 0; iii < nParts; ++iii)
+            {
+                SimulationSettings cSettings = pJob->cConfig.Settings();
+                if (cSettings.m_nSeed != INT_MIN) cSettings.m_nSeed += iii;
+                // Parts would write over each other's checkpoints
+                cSettings.m_sCheckpoint.clear();
+
+                int nPartRuns = nRuns / nParts + (iii < nRuns % nParts ? 1 : 0);
+
+                pPool->cThreadPool.Submit([pJob, iii, nPartRuns, cSettings]
+                    {
+                        pJob->PlayPart(iii, nPartRuns, cSettings);
+                    });
+            }
+        }));
+}
+
+int CrapSimJobWait(CrapSimJob *pJob)
+{
+    return (Guard(pJob, [&]
+        {
+            std::unique_lock<std::mutex> lock(pJob->mtxJob);
+            pJob->cvJob.wait(lock, [pJob] { return (pJob->nPartsRunning == 0); });
+
+            if (!pJob->sPartError.empty())
+                throw CrapSimException("CrapSimJobWait", pJob->sPartError);
+        }));
+}
+
+int CrapSimJobRun(CrapSimJob *pJob, CrapSimPool *pPool, int nRuns, int nParts)
+{
+    if (CrapSimJobSubmit(pJob, pPool, nRuns, nParts) != CRAPSIM_OK) return (CRAPSIM_ERROR);
+
+    return (CrapSimJobWait(pJob));
+}
+
+int CrapSimJobStrategies(const CrapSimJob *pJob)
+{
+    return (pJob ? static_cast<int>(pJob->vStrategies.size()) : 0);
+}
+
+int CrapSimJobStrategyResult(const CrapSimJob *pJob, int iStrategy, CrapSimStrategyResult *pResult)
+{
+    if ((pJob == nullptr) || (pResult == nullptr) ||
+        (iStrategy < 0) || (iStrategy >= static_cast<int>(pJob->vResults.size())))
+        return (CRAPSIM_ERROR);
+
+    const Strategy        &cStrategy = pJob->vResults[iStrategy];
+    const StrategyResults &cResults  = cStrategy.Results();
+
+    // Mean of a total over a count, 0 if none
+    auto Mean = [](long long nTotal, long long nCount) { return (nCount > 0 ? static_cast<double>(nTotal) / nCount : 0.0); };
+    // Minimum or maximum, 0 if none
+    auto Extreme = [](int nValue, long long nCount) { return (nCount > 0 ? nValue : 0); };
+
+    bool bByRolls = (cStrategy.PlayForNumberOfRolls() > 0);
+    long long nWinRolls     = bByRolls ? 0 : cResults.m_nTimesStrategyWon;
+    long long nLossRolls    = bByRolls ? 0 : cResults.m_nTimesStrategyLost;
+    long long nWinBankroll  = bByRolls ? cResults.m_nTimesStrategyWon : 0;
+    long long nLossBankroll = bByRolls ? cResults.m_nTimesStrategyLost : 0;
+
+    pResult->pszName           = cStrategy.Name().c_str();
+    pResult->nRuns             = cResults.m_nTimesStrategyRun;
+    pResult->nWins             = cResults.m_nTimesStrategyWon;
+    pResult->nLosses           = cResults.m_nTimesStrategyLost;
+    pResult->dWinPercentage    = cStrategy.WinPercentage();
+    pResult->dWinCIWidth       = cStrategy.WinCIWidth();
+    pResult->dMeanBankroll     = cStrategy.MeanBankroll();
+    pResult->dBankrollCIWidth  = cStrategy.BankrollCIWidth();
+
+    pResult->nWinRollsMin      = Extreme(cResults.m_nWinRollsMin, nWinRolls);
+    pResult->nWinRollsMax      = Extreme(cResults.m_nWinRollsMax, nWinRolls);
+    pResult->dWinRollsMean     = Mean(cResults.m_nWinRollsTotal, nWinRolls);
+    pResult->nLossRollsMin     = Extreme(cResults.m_nLossRollsMin, nLossRolls);
+    pResult->nLossRollsMax     = Extreme(cResults.m_nLossRollsMax, nLossRolls);
+    pResult->dLossRollsMean    = Mean(cResults.m_nLossRollsTotal, nLossRolls);
+
+    pResult->nWinBankrollMin   = Extreme(cResults.m_nWinBankrollMin, nWinBankroll);
+    pResult->nWinBankrollMax   = Extreme(cResults.m_nWinBankrollMax, nWinBankroll);
+    pResult->dWinBankrollMean  = Mean(cResults.m_nWinBankrollTotal, nWinBankroll);
+    pResult->nLossBankrollMin  = Extreme(cResults.m_nLossBankrollMin, nLossBankroll);
+    pResult->nLossBankrollMax  = Extreme(cResults.m_nLossBankrollMax, nLossBankroll);
+    pResult->dLossBankrollMean = Mean(cResults.m_nLossBankrollTotal, nLossBankroll);
+
+    for (int iii = 0; iii < CRAPSIM_HISTOGRAM_BUCKETS; ++iii)
+    {
+        pResult->anRollsHistogram[iii] = cResults.m_cRollsHistogram.Count(iii);
+    }
+
+    return (CRAPSIM_OK);
+}
+
+long long CrapSimJobDiceCounts(const CrapSimJob *pJob, long long anCounts[13])
+{
+    if (pJob == nullptr) return (0);
+
+    for (int iii = 0; iii < 13; ++iii)
+    {
+        anCounts[iii] = pJob->anDiceCounts[iii];
+    }
+
+    return (pJob->nTotalRolls);
+}
+
+const char *CrapSimJobError(const CrapSimJob *pJob)
+{
+    return (pJob ? pJob->sError.c_str() : "");
+}
+
+} // extern "C"
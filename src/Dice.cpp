@@ -17,21 +17,53 @@
     along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
 #include <iostream>
+#include <locale>
 
 #include "Dice.h"
 
+// Names of the dice sampling methods
+static constexpr struct { const char *pszName; DiceSampling ecSampling; } g_asDiceSampling[] =
+{
+    {"PLAIN",      DiceSampling::PLAIN},
+    {"ANTITHETIC", DiceSampling::ANTITHETIC},
+    {"STRATIFIED", DiceSampling::STRATIFIED}
+};
+
 /**
   * Construct a Dice.
   *
   * Create an array / pointer to the number of values that the dice may
-  * generate; construct 2 Dice with six faces.
+  * generate; construct 2 Dice with six faces; set up the antithetic
+  * pairing of outcomes.
   *
   */
 
 Dice::Dice() : m_cDie1(6), m_cDie2(6)
 {
-    m_pnDiceRollValues  = new int[2 * 6]();
+    m_pnDiceRollValues  = new long long[2 * 6]();
+
+    // Pair each outcome with its antithetic partner.  Order the outcomes from
+    // sevens, through craps and eleven, to the easiest point numbers, and pair
+    // the outcome ranked r with the outcome ranked 35 - r, so that sevens are
+    // replayed as sixes and eights and vice versa.  Any pairing of the 36
+    // outcomes preserves the distribution of the roll.
+    const std::array<int, 11> anSumOrder {{7, 2, 3, 12, 11, 4, 10, 5, 9, 6, 8}};
+    std::vector<int> vnOrder;
+
+    for (int nSum : anSumOrder)
+    {
+        for (int iii = 0; iii < DICE_OUTCOMES; ++iii)
+        {
+            if (iii / 6 + iii % 6 + 2 == nSum) vnOrder.push_back(iii);
+        }
+    }
+
+    for (int iii = 0; iii < DICE_OUTCOMES; ++iii)
+    {
+        m_anAntitheticOutcome[vnOrder[iii]] = vnOrder[DICE_OUTCOMES - 1 - iii];
+    }
 }
 
 /**
@@ -55,10 +87,26 @@ Dice::Dice(const Dice& cSource) : m_cDie1(cSource.m_cDie1), m_cDie2(cSource.m_cD
 {
     m_nTotalDiceRolls         = cSource.m_nTotalDiceRolls;
     m_nRollValue              = cSource.m_nRollValue;
+    m_ecDiceSampling          = cSource.m_ecDiceSampling;
+    m_nRun                    = cSource.m_nRun;
+    m_nRunRolls               = cSource.m_nRunRolls;
+    m_nStratum                = cSource.m_nStratum;
+    m_bMirrorRun              = cSource.m_bMirrorRun;
+    m_vnRunOutcomes           = cSource.m_vnRunOutcomes;
+    m_anAntitheticOutcome     = cSource.m_anAntitheticOutcome;
+    m_pcTableModel            = cSource.m_pcTableModel;
+    m_pcSetterModel           = cSource.m_pcSetterModel;
+    m_pcShooterModel          = cSource.m_pcShooterModel;
+    m_dSetterShare            = cSource.m_dSetterShare;
+    m_nSetterThreshold        = cSource.m_nSetterThreshold;
+    m_nShooterPoint           = cSource.m_nShooterPoint;
+    m_bSetterShooting         = cSource.m_bSetterShooting;
+    m_pcRecorder              = cSource.m_pcRecorder;
+    m_pcPlayer                = cSource.m_pcPlayer;
 
     if (cSource.m_pnDiceRollValues)
     {
-        m_pnDiceRollValues = new int[2 * 6];
+        m_pnDiceRollValues = new long long[2 * 6];
         for (std::list<Die>::size_type iii = 0; iii < 2 * 6; ++iii)
         {
             m_pnDiceRollValues[iii] = cSource.m_pnDiceRollValues[iii];
@@ -86,12 +134,28 @@ Dice& Dice::operator=(const Dice& cSource)
 
     m_nTotalDiceRolls         = cSource.m_nTotalDiceRolls;
     m_nRollValue              = cSource.m_nRollValue;
+    m_ecDiceSampling          = cSource.m_ecDiceSampling;
+    m_nRun                    = cSource.m_nRun;
+    m_nRunRolls               = cSource.m_nRunRolls;
+    m_nStratum                = cSource.m_nStratum;
+    m_bMirrorRun              = cSource.m_bMirrorRun;
+    m_vnRunOutcomes           = cSource.m_vnRunOutcomes;
+    m_anAntitheticOutcome     = cSource.m_anAntitheticOutcome;
+    m_pcTableModel            = cSource.m_pcTableModel;
+    m_pcSetterModel           = cSource.m_pcSetterModel;
+    m_pcShooterModel          = cSource.m_pcShooterModel;
+    m_dSetterShare            = cSource.m_dSetterShare;
+    m_nSetterThreshold        = cSource.m_nSetterThreshold;
+    m_nShooterPoint           = cSource.m_nShooterPoint;
+    m_bSetterShooting         = cSource.m_bSetterShooting;
+    m_pcRecorder              = cSource.m_pcRecorder;
+    m_pcPlayer                = cSource.m_pcPlayer;
 
     delete[] m_pnDiceRollValues;
 
     if (cSource.m_pnDiceRollValues)
     {
-        m_pnDiceRollValues = new int[2 * 6];
+        m_pnDiceRollValues = new long long[2 * 6];
         for (std::list<Die>::size_type iii = 0; iii < 2 * 6; ++iii)
         {
             m_pnDiceRollValues[iii] = cSource.m_pnDiceRollValues[iii];
@@ -125,8 +189,43 @@ Dice::~Dice()
 
 int Dice::Roll()
 {
-    // Roll the dice
-    m_nRollValue = m_cDie1.Roll() + m_cDie2.Roll();
+    // Roll the dice, following the sampling method
+    switch (m_ecDiceSampling)
+    {
+        case DiceSampling::ANTITHETIC:
+            // The mirrored run replays the partners of the first run's
+            // outcomes for as long as the first run lasted, then rolls freely
+            if (m_bMirrorRun)
+            {
+                if (m_nRunRolls < static_cast<int>(m_vnRunOutcomes.size()))
+                    ForceOutcome(m_anAntitheticOutcome[m_vnRunOutcomes[m_nRunRolls]]);
+                else
+                    RollOutcome();
+            }
+            else
+            {
+                m_vnRunOutcomes.push_back(RollOutcome());
+            }
+            break;
+
+        case DiceSampling::STRATIFIED:
+            if (m_nRunRolls == 0)
+                ForceOutcome(m_nStratum);
+            else
+                RollOutcome();
+            break;
+
+        default:
+            RollOutcome();
+            break;
+    }
+
+    ++m_nRunRolls;
+
+    m_nRollValue = m_cDie1.RollValue() + m_cDie2.RollValue();
+
+    if (m_pcSetterModel) FollowShooter();
+    if (m_pcRecorder) m_pcRecorder->Record((m_cDie1.RollValue() - 1) * 6 + (m_cDie2.RollValue() - 1));
 
     // Increment the dice value count
     m_pnDiceRollValues[m_nRollValue - 1]++;
@@ -136,3 +235,334 @@ int Dice::Roll()
 
     return(m_nRollValue);
 }
+
+/**
+  * Seed the Dice.
+  *
+  * Each Die is seeded from the seed and its own position, so that the two
+  * dice, and the dice of neighbouring seeds, roll independently.
+  *
+  * \param nSeed The seed.
+  */
+
+void Dice::Seed(unsigned nSeed)
+{
+    std::seed_seq cSeed1 {nSeed, 1u};
+    std::seed_seq cSeed2 {nSeed, 2u};
+
+    m_cDie1.Seed(cSeed1);
+    m_cDie2.Seed(cSeed2);
+}
+
+/**
+  * Seed the Dice for one simulation run.
+  *
+  * As Seed(), with the run number added to the seed of each Die.
+  *
+  * \param nSeed The seed.
+  * \param nRun The simulation run.
+  */
+
+void Dice::Seed(unsigned nSeed, unsigned nRun)
+{
+    std::seed_seq cSeed1 {nSeed, 1u, nRun};
+    std::seed_seq cSeed2 {nSeed, 2u, nRun};
+
+    m_cDie1.Seed(cSeed1);
+    m_cDie2.Seed(cSeed2);
+}
+
+/**
+  * Prepare the Dice for a new simulation run.
+  *
+  * A roll tape recorded ends the last run; a roll tape played moves to the
+  * start of the run.  A new shooter comes out.  For antithetic sampling,
+  * even runs record their outcomes and odd runs replay the antithetic
+  * partner of each.  For stratified sampling, select the come out outcome
+  * for the run, cycling through every outcome in turn.
+  *
+  */
+
+void Dice::NewRun()
+{
+    m_nRunRolls = 0;
+
+    if (m_pcRecorder) m_pcRecorder->EndRun();
+    if (m_pcPlayer) m_pcPlayer->StartRun(m_nRun);
+    if (m_pcSetterModel) NewShooter();
+
+    switch (m_ecDiceSampling)
+    {
+        case DiceSampling::ANTITHETIC:
+            m_bMirrorRun = (m_nRun % 2 == 1);
+            if (!m_bMirrorRun) m_vnRunOutcomes.clear();
+            break;
+
+        case DiceSampling::STRATIFIED:
+            m_nStratum = m_nRun % DICE_OUTCOMES;
+            break;
+
+        default:
+            break;
+    }
+
+    ++m_nRun;
+}
+
+/**
+  * Set the sampling method.
+  *
+  * INI File:
+  * Sampling=PLAIN|ANTITHETIC|STRATIFIED
+  *
+  * \param sSampling The name of the sampling method.
+  *
+  * \return True if the sampling method is known.
+  */
+
+bool Dice::SetSampling(std::string sSampling)
+{
+    if (sSampling.empty())
+        return (false);
+
+    std::locale loc;
+    for (std::string::size_type iii = 0; iii < sSampling.length(); ++iii)
+        sSampling[iii] = std::toupper(sSampling[iii], loc);
+
+    for (const auto &sDiceSampling : g_asDiceSampling)
+    {
+        if (sSampling == sDiceSampling.pszName)
+        {
+            m_ecDiceSampling = sDiceSampling.ecSampling;
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+/**
+  * Return the sampling method in string format.
+  *
+  * \return String representing the sampling method.
+  */
+
+std::string Dice::Sampling() const
+{
+    std::string sSampling("Unknown");
+
+    for (const auto &sDiceSampling : g_asDiceSampling)
+    {
+        if (m_ecDiceSampling == sDiceSampling.ecSampling)
+        {
+            sSampling = sDiceSampling.pszName;
+            break;
+        }
+    }
+
+    return(sSampling);
+}
+
+/**
+  * Roll each Die freely, or play the next roll of the roll tape, or draw
+  * the roll from the shooter's model.  A drawn roll is forced on the dice,
+  * so it is counted and recorded as a free roll is.
+  *
+  *\return The outcome index of the roll, (die1 - 1) * 6 + (die2 - 1).
+  */
+
+int Dice::RollOutcome()
+{
+    if (m_pcPlayer) return (ForceOutcome(m_pcPlayer->Next()));
+    if (m_pcShooterModel) return (ForceOutcome(m_pcShooterModel->Sample(m_cDie1.Draw(), m_cDie2.Draw())));
+
+    int nDie1 = m_cDie1.Roll();
+    int nDie2 = m_cDie2.Roll();
+
+    return ((nDie1 - 1) * 6 + (nDie2 - 1));
+}
+
+/**
+  * Force each Die to the faces of an outcome index.
+  *
+  * \param nOutcome The outcome index, (die1 - 1) * 6 + (die2 - 1).
+  *
+  *\return The outcome index.
+  */
+
+int Dice::ForceOutcome(int nOutcome)
+{
+    m_cDie1.Force(nOutcome / 6 + 1);
+    m_cDie2.Force(nOutcome % 6 + 1);
+
+    return (nOutcome);
+}
+
+/**
+  * Set the models the dice roll by.
+  *
+  * Fair models leave the dice to roll freely.  With a share of dice
+  * setters, each shooter is chosen to be a setter or not as they come out,
+  * at the start of each run and after each seven out.
+  *
+  * \param cTable The model of the dice at the table.
+  * \param cSetter The model of the dice thrown by a dice setter.
+  * \param dSetterShare The share of shooters who are dice setters, 0 to 1.
+  */
+
+void Dice::SetModels(const DiceModel &cTable, const DiceModel &cSetter, double dSetterShare)
+{
+    if (!(dSetterShare >= 0.0) || (dSetterShare > 1.0))
+        throw CrapSimException("Dice::SetModels setter share must be 0 to 1", std::to_string(dSetterShare));
+
+    m_pcTableModel  = cTable.Fair() ? nullptr : std::make_shared<const DiceModel>(cTable);
+    m_pcSetterModel = (dSetterShare > 0.0) ? std::make_shared<const DiceModel>(cSetter) : nullptr;
+
+    m_dSetterShare     = dSetterShare;
+    m_nSetterThreshold = static_cast<uint64_t>(std::llround(dSetterShare * 4294967296.0));
+    m_nShooterPoint    = 0;
+    m_bSetterShooting  = false;
+    m_pcShooterModel   = m_pcTableModel.get();
+}
+
+/**
+  * Return the models in text, exactly, with the share of setters.
+  *
+  * \return The text.
+  */
+
+std::string Dice::ModelFingerprint() const
+{
+    std::string sFingerprint = m_pcTableModel ? m_pcTableModel->Fingerprint() : "Fair";
+
+    if (m_pcSetterModel)
+        sFingerprint += " Setters " + std::to_string(m_nSetterThreshold) + " " + m_pcSetterModel->Fingerprint();
+
+    return (sFingerprint);
+}
+
+/**
+  * Bring out a new shooter, a dice setter with the chance of the share of
+  * setters.
+  */
+
+void Dice::NewShooter()
+{
+    m_bSetterShooting = (m_cDie2.Draw() < m_nSetterThreshold);
+    m_pcShooterModel  = m_bSetterShooting ? m_pcSetterModel.get() : m_pcTableModel.get();
+    m_nShooterPoint   = 0;
+}
+
+/**
+  * Follow the shooter's point after a roll: a point number on the come
+  * out sets the point, the point made clears it, and a seven out brings
+  * out a new shooter.
+  */
+
+void Dice::FollowShooter()
+{
+    if (m_nShooterPoint == 0)
+    {
+        if (IsAPointNumber()) m_nShooterPoint = m_nRollValue;
+    }
+    else if (m_nRollValue == m_nShooterPoint)
+    {
+        m_nShooterPoint = 0;
+    }
+    else if (m_nRollValue == 7)
+    {
+        NewShooter();
+    }
+}
+
+/**
+  * Record the rolls to a roll tape.
+  *
+  * Every roll from here on is recorded, as it is rolled or played, and each
+  * run is ended at the start of the next.
+  *
+  * \param sPath The path of the roll tape.
+  */
+
+void Dice::RecordRolls(const std::string &sPath)
+{
+    m_pcRecorder = std::make_shared<RollTapeRecorder>(sPath);
+}
+
+/**
+  * Finish the roll tape being recorded, ending its last run.
+  */
+
+void Dice::FinishRecording()
+{
+    if (m_pcRecorder) m_pcRecorder->Close();
+}
+
+/**
+  * Play the rolls of a roll tape in place of rolling the Dice.
+  *
+  * Run n plays the rolls of run n of the tape; a run longer than the run
+  * recorded carries on with the rolls of the runs after it.
+  *
+  * \param sPath The path of the roll tape.
+  */
+
+void Dice::ReplayRolls(const std::string &sPath)
+{
+    m_pcPlayer = std::make_shared<RollTapePlayer>(sPath);
+}
+
+/**
+  * Save the Dice to a checkpoint.
+  *
+  * \param cCheckpoint The checkpoint.
+  */
+
+void Dice::Save(Checkpoint &cCheckpoint) const
+{
+    m_cDie1.Save(cCheckpoint);
+    m_cDie2.Save(cCheckpoint);
+
+    cCheckpoint.Put(m_nTotalDiceRolls);
+    cCheckpoint.Put(m_nRollValue);
+    cCheckpoint.Put(std::vector<long long>(m_pnDiceRollValues, m_pnDiceRollValues + 2 * 6));
+    cCheckpoint.Put(m_nRun);
+    cCheckpoint.Put(m_nRunRolls);
+    cCheckpoint.Put(m_nStratum);
+    cCheckpoint.Put(m_bMirrorRun);
+    cCheckpoint.Put(m_vnRunOutcomes);
+    cCheckpoint.Put(m_nShooterPoint);
+    cCheckpoint.Put(m_bSetterShooting);
+}
+
+/**
+  * Restore the Dice from a checkpoint.
+  *
+  * \param cCheckpoint The checkpoint.
+  */
+
+void Dice::Restore(Checkpoint &cCheckpoint)
+{
+    std::vector<long long> vnRollValues;
+
+    m_cDie1.Restore(cCheckpoint);
+    m_cDie2.Restore(cCheckpoint);
+
+    cCheckpoint.Get(m_nTotalDiceRolls);
+    cCheckpoint.Get(m_nRollValue);
+    cCheckpoint.Get(vnRollValues);
+    cCheckpoint.Get(m_nRun);
+    cCheckpoint.Get(m_nRunRolls);
+    cCheckpoint.Get(m_nStratum);
+    cCheckpoint.Get(m_bMirrorRun);
+    cCheckpoint.Get(m_vnRunOutcomes);
+    cCheckpoint.Get(m_nShooterPoint);
+    cCheckpoint.Get(m_bSetterShooting);
+
+    if (vnRollValues.size() != 2 * 6)
+        throw CrapSimException("Dice::Restore checkpoint is damaged");
+
+    std::copy(vnRollValues.begin(), vnRollValues.end(), m_pnDiceRollValues);
+
+    m_pcShooterModel = m_bSetterShooting ? m_pcSetterModel.get() : m_pcTableModel.get();
+}
@@ -0,0 +1,229 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "DiceModel.h"
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+/**
+  * Construct a DiceModel of fair dice.
+  */
+
+DiceModel::DiceModel()
+{
+    Build();
+}
+
+/**
+  * Set the weight of each face.
+  *
+  * Both dice have the same weights, and roll independently, so an outcome
+  * weighs the product of its faces' weights.
+  *
+  * \param vdWeights The weights of faces 1 to 6.
+  */
+
+void DiceModel::SetFaceWeights(const std::vector<double> &vdWeights)
+{
+    if (vdWeights.size() != 6)
+        throw CrapSimException("DiceModel::SetFaceWeights needs 6 weights, not", std::to_string(vdWeights.size()));
+
+    m_vdFaceWeights = vdWeights;
+    Build();
+}
+
+/**
+  * Set the weight of each outcome of the dice thrown together, as a dice
+  * setter's throw gives.  The face weights are not used.
+  *
+  * \param vdWeights The weights of the 36 outcomes, die1 1 with die2 1 to
+  * 6, die1 2 with die2 1 to 6, and so on.
+  */
+
+void DiceModel::SetOutcomeWeights(const std::vector<double> &vdWeights)
+{
+    if (vdWeights.size() != DICE_MODEL_OUTCOMES)
+        throw CrapSimException("DiceModel::SetOutcomeWeights needs 36 weights, not", std::to_string(vdWeights.size()));
+
+    m_vdOutcomeWeights = vdWeights;
+    Build();
+}
+
+/**
+  * Set the chance of a seven.  The sevens keep their weights among
+  * themselves, as do the other outcomes.
+  *
+  * \param dSevenRate The chance of a seven, 0 to 1.
+  */
+
+void DiceModel::SetSevenRate(double dSevenRate)
+{
+    if (!(dSevenRate >= 0.0) || !(dSevenRate < 1.0))
+        throw CrapSimException("DiceModel::SetSevenRate must be at least 0 and less than 1", std::to_string(dSevenRate));
+
+    m_dSevenRate = dSevenRate;
+    Build();
+}
+
+/**
+  * Return the chance of a roll value.
+  *
+  * \param nValue The roll value, 2 to 12.
+  *
+  * \return The chance.
+  */
+
+double DiceModel::ValueProbability(int nValue) const
+{
+    double dProbability = 0.0;
+
+    for (int iii = 0; iii < DICE_MODEL_OUTCOMES; ++iii)
+    {
+        if (iii / 6 + iii % 6 + 2 == nValue) dProbability += m_adProbability[iii];
+    }
+
+    return (dProbability);
+}
+
+/**
+  * Return the distribution in text, with every chance written exactly, so
+  * that two models give the same text only if they roll the same.
+  *
+  * \return The text.
+  */
+
+std::string DiceModel::Fingerprint() const
+{
+    if (m_bFair) return ("Fair");
+
+    std::ostringstream ossFingerprint;
+    ossFingerprint << std::hexfloat;
+    for (int iii = 0; iii < DICE_MODEL_OUTCOMES; ++iii)
+    {
+        ossFingerprint << (iii > 0 ? "," : "") << m_adProbability[iii];
+    }
+
+    return (ossFingerprint.str());
+}
+
+/**
+  * Work out the distribution from the weights, and build its alias table
+  * with Vose's method.
+  *
+  * Scale each chance by 36, so that fair dice give 1 to each outcome.  Pair
+  * each outcome under 1 with one over 1: the column of the outcome under 1
+  * keeps it with its scaled chance and gives the rest to its alias, the
+  * outcome over 1, whose scaled chance falls by that much.
+  */
+
+void DiceModel::Build()
+{
+    std::array<double, DICE_MODEL_OUTCOMES> adWeight;
+
+    for (int iii = 0; iii < DICE_MODEL_OUTCOMES; ++iii)
+    {
+        if (!m_vdOutcomeWeights.empty())
+            adWeight[iii] = m_vdOutcomeWeights[iii];
+        else if (!m_vdFaceWeights.empty())
+            adWeight[iii] = m_vdFaceWeights[iii / 6] * m_vdFaceWeights[iii % 6];
+        else
+            adWeight[iii] = 1.0;
+
+        if (!(adWeight[iii] >= 0.0) || std::isinf(adWeight[iii]))
+            throw CrapSimException("DiceModel weights must not be negative", std::to_string(adWeight[iii]));
+    }
+
+    // Scale the sevens to the seven rate, and the rest to what is left
+    double dSevens = 0.0;
+    double dOthers = 0.0;
+    for (int iii = 0; iii < DICE_MODEL_OUTCOMES; ++iii)
+    {
+        (iii / 6 + iii % 6 == 5 ? dSevens : dOthers) += adWeight[iii];
+    }
+
+    if (m_dSevenRate >= 0.0)
+    {
+        if ((dSevens <= 0.0 && m_dSevenRate > 0.0) || (dOthers <= 0.0))
+            throw CrapSimException("DiceModel seven rate cannot be met by the weights", std::to_string(m_dSevenRate));
+
+        for (int iii = 0; iii < DICE_MODEL_OUTCOMES; ++iii)
+        {
+            if (iii / 6 + iii % 6 == 5)
+                adWeight[iii] *= (dSevens > 0.0 ? m_dSevenRate / dSevens : 0.0);
+            else
+                adWeight[iii] *= (1.0 - m_dSevenRate) / dOthers;
+        }
+
+        dSevens = m_dSevenRate;
+        dOthers = 1.0 - m_dSevenRate;
+    }
+
+    const double dTotal = dSevens + dOthers;
+    if (!(dTotal > 0.0))
+        throw CrapSimException("DiceModel weights must not all be 0");
+
+    m_bFair = true;
+    for (int iii = 0; iii < DICE_MODEL_OUTCOMES; ++iii)
+    {
+        m_adProbability[iii] = adWeight[iii] / dTotal;
+        if (adWeight[iii] != adWeight[0]) m_bFair = false;
+    }
+
+    // Split the scaled chances into those under and over 1
+    std::array<double, DICE_MODEL_OUTCOMES> adScaled;
+    std::vector<int> vnSmall;
+    std::vector<int> vnLarge;
+
+    for (int iii = 0; iii < DICE_MODEL_OUTCOMES; ++iii)
+    {
+        adScaled[iii] = m_adProbability[iii] * DICE_MODEL_OUTCOMES;
+        (adScaled[iii] < 1.0 ? vnSmall : vnLarge).push_back(iii);
+    }
+
+    while (!vnSmall.empty() && !vnLarge.empty())
+    {
+        int nSmall = vnSmall.back();
+        int nLarge = vnLarge.back();
+        vnSmall.pop_back();
+
+        m_anThreshold[nSmall] = static_cast<uint64_t>(std::llround(adScaled[nSmall] * 4294967296.0));
+        m_anAlias[nSmall]     = nLarge;
+
+        adScaled[nLarge] -= 1.0 - adScaled[nSmall];
+        if (adScaled[nLarge] < 1.0)
+        {
+            vnLarge.pop_back();
+            vnSmall.push_back(nLarge);
+        }
+    }
+
+    // What is left is 1 but for rounding, and keeps its own outcome
+    for (int nOutcome : vnSmall)
+    {
+        m_anThreshold[nOutcome] = 4294967296ULL;
+        m_anAlias[nOutcome]     = nOutcome;
+    }
+    for (int nOutcome : vnLarge)
+    {
+        m_anThreshold[nOutcome] = 4294967296ULL;
+        m_anAlias[nOutcome]     = nOutcome;
+    }
+}
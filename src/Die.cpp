@@ -18,36 +18,36 @@
 */
 
 #include "Die.h"
+#include "CrapSimException.h"
 
-// Setup random number generator, using Mersenne Twister 19937.  Assign it to
-// function rollDie().
+#include <sstream>
+
+// Setup random number generator, using Mersenne Twister 19937, and a
+// uniform distribution of the faces.
 
 /**
   * Construct a Die.
   *
-  * Set the random number generator to a uniform distribution of 1..nFaces;
-  * bind rollDie to the distribution and generator; set up array / pointer to
-  * nFaces number of values.  Using Mersenne Twister Engine, seeded with
-  * std::random_device.
+  * Set the random number generator and a uniform distribution of
+  * 1..nFaces; set up array / pointer to nFaces number of values.  Using
+  * Mersenne Twister Engine, seeded with std::random_device.
   *
   * \param nFaces Specifies the number of faces of the die
   */
 
-Die::Die(int nFaces)
+Die::Die(int nFaces) : m_cDistribution(1, nFaces)
 {
 #if defined(_WIN32)
     static unsigned seed  = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     ++seed;
-    std::mt19937 generator{seed};
+    m_cGenerator.seed(seed);
 #else
     std::random_device rdev{};
-    std::mt19937 generator{rdev()};
+    m_cGenerator.seed(rdev());
 #endif // defined
 
-    std::uniform_int_distribution<int> distribution(1, nFaces);
-    rollDie            = std::bind(distribution, generator);
     m_nFaces           = nFaces;
-	m_pnDieRollValues  = new int[m_nFaces]();
+	m_pnDieRollValues  = new long long[m_nFaces]();
 }
 
 /**
@@ -57,7 +57,9 @@ Die::Die(int nFaces)
   * \param cSource The source of the copy
   */
 
-Die::Die(const Die& cSource)
+Die::Die(const Die& cSource) :
+    m_cGenerator(cSource.m_cGenerator),
+    m_cDistribution(cSource.m_cDistribution)
 {
     m_nTotalDieRolls    = cSource.m_nTotalDieRolls;
     m_nLastDieRollValue = cSource.m_nLastDieRollValue;
@@ -65,7 +67,7 @@ Die::Die(const Die& cSource)
 
     if (cSource.m_pnDieRollValues)
     {
-        m_pnDieRollValues = new int[m_nFaces];
+        m_pnDieRollValues = new long long[m_nFaces];
         for (int iii = 0; iii < m_nFaces; ++iii)
         {
             m_pnDieRollValues[iii] = cSource.m_pnDieRollValues[iii];
@@ -92,12 +94,14 @@ Die& Die::operator=(const Die& cSource)
     m_nTotalDieRolls    = cSource.m_nTotalDieRolls;
     m_nLastDieRollValue = cSource.m_nLastDieRollValue;
     m_nFaces            = cSource.m_nFaces;
+    m_cGenerator        = cSource.m_cGenerator;
+    m_cDistribution     = cSource.m_cDistribution;
 
     delete[] m_pnDieRollValues;
 
     if (cSource.m_pnDieRollValues)
         {
-            m_pnDieRollValues = new int[m_nFaces];
+            m_pnDieRollValues = new long long[m_nFaces];
             for (int iii = 0; iii < m_nFaces; ++iii)
             {
                 m_pnDieRollValues[iii] = cSource.m_pnDieRollValues[iii];
@@ -120,20 +124,102 @@ Die::~Die()
 	delete[] m_pnDieRollValues;
 }
 
+/**
+  * Seed the Die.
+  *
+  * Replace the random number generator with one seeded from a seed
+  * sequence, so that the same seed rolls the same values.
+  *
+  * \param cSeed The seed sequence.
+  */
+
+void Die::Seed(std::seed_seq &cSeed)
+{
+    m_cGenerator.seed(cSeed);
+    m_cDistribution.reset();
+}
+
 /**
   * Roll the Die.
   *
-  * Call the function bound to the number generator and uniform ditribution,
-  * rollDie(); capture the value; record the value in the array for later
-  * analysis.
+  * Draw from the uniform distribution with the number generator; capture
+  * the value; record the value in the array for later analysis.
   *
   *\return The value of the rolled Die.
   */
 
 int Die::Roll()
 {
-    m_nLastDieRollValue = rollDie();
+    m_nLastDieRollValue = m_cDistribution(m_cGenerator);
+    m_pnDieRollValues[m_nLastDieRollValue - 1]++;
+    ++m_nTotalDieRolls;
+    return(m_nLastDieRollValue);
+}
+
+/**
+  * Force the Die to a face.
+  *
+  * Used when the Dice replay or stratify an outcome rather than roll it
+  * freely.  The face is recorded exactly as a roll would be, so Die
+  * statistics remain complete.
+  *
+  * \param nValue The face to set, 1..nFaces.
+  *
+  *\return The value of the Die.
+  */
+
+int Die::Force(int nValue)
+{
+    if ((nValue < 1) || (nValue > m_nFaces))
+        throw CrapSimException("Die::Force face out of range", std::to_string(nValue));
+
+    m_nLastDieRollValue = nValue;
     m_pnDieRollValues[m_nLastDieRollValue - 1]++;
     ++m_nTotalDieRolls;
     return(m_nLastDieRollValue);
 }
+
+/**
+  * Save the Die to a checkpoint.
+  *
+  * The generator is saved as the text the standard library writes for it,
+  * which holds its whole state.
+  *
+  * \param cCheckpoint The checkpoint.
+  */
+
+void Die::Save(Checkpoint &cCheckpoint) const
+{
+    std::ostringstream ossGenerator;
+    ossGenerator << m_cGenerator << " " << m_cDistribution;
+
+    cCheckpoint.Put(ossGenerator.str());
+    cCheckpoint.Put(m_nTotalDieRolls);
+    cCheckpoint.Put(m_nLastDieRollValue);
+    cCheckpoint.Put(std::vector<long long>(m_pnDieRollValues, m_pnDieRollValues + m_nFaces));
+}
+
+/**
+  * Restore the Die from a checkpoint.
+  *
+  * \param cCheckpoint The checkpoint.
+  */
+
+void Die::Restore(Checkpoint &cCheckpoint)
+{
+    std::string sGenerator;
+    std::vector<long long> vnRollValues;
+
+    cCheckpoint.Get(sGenerator);
+    cCheckpoint.Get(m_nTotalDieRolls);
+    cCheckpoint.Get(m_nLastDieRollValue);
+    cCheckpoint.Get(vnRollValues);
+
+    std::istringstream issGenerator(sGenerator);
+    issGenerator >> m_cGenerator >> m_cDistribution;
+
+    if (!issGenerator || (static_cast<int>(vnRollValues.size()) != m_nFaces))
+        throw CrapSimException("Die::Restore checkpoint is damaged");
+
+    std::copy(vnRollValues.begin(), vnRollValues.end(), m_pnDieRollValues);
+}
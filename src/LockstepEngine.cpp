@@ -0,0 +1,304 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "LockstepEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+/**
+  * Construct the LockstepEngine.
+  *
+  * Seed each lane's generator from std::random_device and the clock (see
+  * Die.cpp for why the clock), through a seed sequence so that the lanes'
+  * streams are unrelated.  A xorshift128 state must not be all zero.
+  *
+  */
+
+LockstepEngine::LockstepEngine()
+{
+    std::random_device rdev{};
+    std::seed_seq cSeed {static_cast<uint32_t>(rdev()), static_cast<uint32_t>(rdev()),
+                         static_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count())};
+
+    std::vector<uint32_t> vnState(4 * LOCKSTEP_LANES);
+    cSeed.generate(vnState.begin(), vnState.end());
+
+    for (int iii = 0; iii < LOCKSTEP_LANES; ++iii)
+    {
+        m_anRandomX[iii] = vnState[4 * iii];
+        m_anRandomY[iii] = vnState[4 * iii + 1];
+        m_anRandomZ[iii] = vnState[4 * iii + 2];
+        m_anRandomW[iii] = vnState[4 * iii + 3] | 1;
+    }
+
+    m_anRollValue.fill(0);
+    m_anPoint.fill(0);
+    m_anBankroll.fill(0);
+    m_anPassWager.fill(0);
+    m_anOddsWager.fill(0);
+    m_anRolls.fill(0);
+    m_anPlaying.fill(0);
+}
+
+/**
+  * Play the runs of a Strategy.
+  *
+  * Every lane starts a run.  Each roll, all lanes play; then each lane
+  * whose run has ended is recorded in the Strategy's statistics, as
+  * Simulation::UpdateStatisticsAndReset() would, and starts the next run
+  * until nRuns have been started.  Lanes without a run sit out.
+  *
+  * \param cStrategy The Strategy, which makes only Pass and Pass Odds bets.
+  * \param cTable The Table, for its limits.
+  * \param nRuns Number of simulation runs.
+  * \param cDice The Dice, whose history counts the lanes' rolls.
+  */
+
+void LockstepEngine::Run(Strategy &cStrategy, const Table &cTable, int nRuns, Dice &cDice)
+{
+    m_nInitialBankroll      = cStrategy.InitialBankroll();
+    m_nStandardWager        = std::min(cStrategy.StandardWager(), cTable.MaximumBet());
+    m_fOdds                 = cStrategy.StandardOdds();
+    m_nFullWager            = cStrategy.FullWager() ? 1 : 0;
+    m_nSignificantBankroll  = cStrategy.SignificantBankroll();
+    m_nPlayForNumberOfRolls = cStrategy.PlayForNumberOfRolls();
+
+    m_nTableMaximum = cTable.MaximumBet();
+    for (int nPoint : {4, 5, 6, 8, 9, 10})
+    {
+        m_afMaxOdds[nPoint] = cTable.MaxOdds(nPoint);
+    }
+
+    std::array<int, LOCKSTEP_LANES> anBusy;
+    anBusy.fill(0);
+    std::array<long long, 13> anRollValueCount;
+    anRollValueCount.fill(0);
+
+    int nStarted = 0;
+
+    while (true)
+    {
+        // Record finished runs and refill their lanes
+        int nBusy = 0;
+        for (int iii = 0; iii < LOCKSTEP_LANES; ++iii)
+        {
+            while (!m_anPlaying[iii] && (anBusy[iii] || nStarted < nRuns))
+            {
+                if (anBusy[iii])
+                {
+                    cStrategy.SetRunResult(m_anBankroll[iii], m_anRolls[iii]);
+                    cStrategy.UpdateStatistics();
+                    cStrategy.Reset();
+                    anBusy[iii] = 0;
+                }
+
+                if (nStarted < nRuns)
+                {
+                    StartLane(iii);
+                    anBusy[iii] = 1;
+                    ++nStarted;
+                }
+            }
+
+            nBusy += anBusy[iii];
+        }
+
+        if (nBusy == 0) break;
+
+        // Only the rolls of lanes playing count in the dice history
+        std::array<int, LOCKSTEP_LANES> anRolled = m_anPlaying;
+
+        PlayRoll();
+
+        for (int iii = 0; iii < LOCKSTEP_LANES; ++iii)
+        {
+            anRollValueCount[m_anRollValue[iii]] += anRolled[iii];
+        }
+    }
+
+    for (int iii = 2; iii <= 12; ++iii)
+    {
+        cDice.CountRolls(iii, anRollValueCount[iii]);
+    }
+}
+
+/**
+  * Start a new run in a lane.
+  *
+  * The bankroll returns to its initial amount, with no bets or rolls, on
+  * the come out.  The lane plays unless its bankroll already stops it, as
+  * Strategy::StillPlaying() would.
+  *
+  * \param nLane The lane.
+  */
+
+void LockstepEngine::StartLane(int nLane)
+{
+    m_anPoint[nLane]     = 0;
+    m_anBankroll[nLane]  = m_nInitialBankroll;
+    m_anPassWager[nLane] = 0;
+    m_anOddsWager[nLane] = 0;
+    m_anRolls[nLane]     = 0;
+    m_anPlaying[nLane]   = 1;
+
+    if ((m_nPlayForNumberOfRolls <= 0) &&
+        ((m_nInitialBankroll < m_nStandardWager) || (m_nInitialBankroll >= m_nSignificantBankroll)))
+        m_anPlaying[nLane] = 0;
+}
+
+/**
+  * Step a lane's xorshift128 generator.
+  *
+  * \param nLane The lane.
+  *
+  * \return The next 32 random bits.
+  */
+
+uint32_t LockstepEngine::NextRandom(int nLane)
+{
+    uint32_t t = m_anRandomX[nLane] ^ (m_anRandomX[nLane] << 11);
+    m_anRandomX[nLane] = m_anRandomY[nLane];
+    m_anRandomY[nLane] = m_anRandomZ[nLane];
+    m_anRandomZ[nLane] = m_anRandomW[nLane];
+    m_anRandomW[nLane] = m_anRandomW[nLane] ^ (m_anRandomW[nLane] >> 19) ^ t ^ (t >> 8);
+
+    return (m_anRandomW[nLane]);
+}
+
+/**
+  * Roll two dice in every lane.
+  *
+  * Each roll is one of the 36 outcomes of two dice, drawn from 32 random
+  * bits by multiplying by 36 and keeping the high word.  Draws whose low
+  * word is below 2^32 mod 36 would favor some outcomes, so they are drawn
+  * again and every outcome is equally likely.  That is 4 draws in 2^32, so
+  * the first loop has no branches and the second almost never redraws.
+  */
+
+void LockstepEngine::RollDice()
+{
+    // Low words below 2^32 mod 36 are drawn again
+    const uint32_t nReject = static_cast<uint32_t>((UINT64_C(1) << 32) % 36);
+
+    std::array<uint32_t, LOCKSTEP_LANES> anLow;
+    uint32_t nAnyRejected = 0;
+
+    for (int iii = 0; iii < LOCKSTEP_LANES; ++iii)
+    {
+        uint64_t nProduct = static_cast<uint64_t>(NextRandom(iii)) * 36;
+        int nOutcome      = static_cast<int>(nProduct >> 32);
+        anLow[iii]        = static_cast<uint32_t>(nProduct);
+        nAnyRejected     |= (anLow[iii] < nReject);
+        m_anRollValue[iii] = 2 + nOutcome / 6 + nOutcome % 6;
+    }
+
+    if (!nAnyRejected) return;
+
+    for (int iii = 0; iii < LOCKSTEP_LANES; ++iii)
+    {
+        while (anLow[iii] < nReject)
+        {
+            uint64_t nProduct = static_cast<uint64_t>(NextRandom(iii)) * 36;
+            int nOutcome      = static_cast<int>(nProduct >> 32);
+            anLow[iii]        = static_cast<uint32_t>(nProduct);
+            m_anRollValue[iii] = 2 + nOutcome / 6 + nOutcome % 6;
+        }
+    }
+}
+
+/**
+  * Roll the dice and play one roll in every lane.
+  *
+  * Each step follows the Strategy: make the Pass bet on the come out or the
+  * Odds once a point is set, roll, resolve, update the lane's table, and
+  * check whether the run goes on.  Every lane computes every case and keeps
+  * the one that applies, so the loop has no branches.
+  */
+
+void LockstepEngine::PlayRoll()
+{
+    // Full payoff Odds are a multiple of 1 on 4 and 10, 2 on 5 and 9, 5 on 6 and 8
+    static const int anMultiple[13] = {1, 1, 1, 1, 1, 2, 5, 1, 5, 2, 1, 1, 1};
+
+    RollDice();
+
+    for (int iii = 0; iii < LOCKSTEP_LANES; ++iii)
+    {
+        const int nPlaying = m_anPlaying[iii];
+        const int nPoint   = m_anPoint[iii];
+        const int nComeOut = (nPoint == 0);
+
+        // Make the Pass bet on the come out, or the Odds after the point is set
+        int nPass = m_anPassWager[iii];
+        int nOdds = m_anOddsWager[iii];
+        int nBank = m_anBankroll[iii];
+
+        int nPassBet = std::min(m_nStandardWager, nBank);
+        nPassBet     = (nPlaying & nComeOut & (nPass == 0) & (nPassBet >= 1)) ? nPassBet : 0;
+
+        int nOddsBet = static_cast<int>(static_cast<float>(nPass) * std::min(m_afMaxOdds[nPoint], m_fOdds));
+        nOddsBet    -= m_nFullWager * (nOddsBet % anMultiple[nPoint]);
+        nOddsBet     = std::min(std::min(nOddsBet, m_nTableMaximum), nBank);
+        nOddsBet     = (nPlaying & !nComeOut & (nPass > 0) & (nOdds == 0) & (nOddsBet >= 1)) ? nOddsBet : 0;
+
+        nPass += nPassBet;
+        nOdds += nOddsBet;
+        nBank -= nPassBet + nOddsBet;
+
+        // The dice, rolled for every lane above
+        const int nValue = m_anRollValue[iii];
+
+        // Resolve
+        const int nSeven   = (nValue == 7);
+        const int nNatural = nSeven | (nValue == 11);
+        const int nCraps   = (nValue == 2) | (nValue == 3) | (nValue == 12);
+        const int nHit     = !nComeOut & (nValue == nPoint);
+
+        const int n410     = (nPoint == 4) | (nPoint == 10);
+        const int n59      = (nPoint == 5) | (nPoint == 9);
+        int nOddsPayoff    = n410 ? 2 * nOdds : (n59 ? (3 * nOdds) / 2 : (6 * nOdds) / 5);
+
+        int nWin = nComeOut ? (nNatural ? 2 * nPass : 0) : (nHit ? 2 * nPass + nOdds + nOddsPayoff : 0);
+        int nResolved = nComeOut ? (nNatural | nCraps) : (nSeven | nHit);
+
+        nBank += nWin;
+        nPass  = nResolved ? 0 : nPass;
+        nOdds  = nResolved ? 0 : nOdds;
+
+        // Update the lane's table
+        int nNewPoint = nComeOut ? ((nNatural | nCraps) ? 0 : nValue) : ((nSeven | nHit) ? 0 : nPoint);
+
+        // Count the roll and check whether the run goes on
+        int nRolls  = m_anRolls[iii] + 1;
+        int nNoBets = (nPass == 0);
+        int nStop   = m_nPlayForNumberOfRolls > 0 ? (nRolls == m_nPlayForNumberOfRolls) :
+                      ((nNoBets & (nBank < m_nStandardWager)) | (nNoBets & (nBank >= m_nSignificantBankroll)));
+
+        // Lanes not playing keep their state
+        m_anPassWager[iii] = nPlaying ? nPass : m_anPassWager[iii];
+        m_anOddsWager[iii] = nPlaying ? nOdds : m_anOddsWager[iii];
+        m_anBankroll[iii]  = nPlaying ? nBank : m_anBankroll[iii];
+        m_anPoint[iii]     = nPlaying ? nNewPoint : m_anPoint[iii];
+        m_anRolls[iii]     = nPlaying ? nRolls : m_anRolls[iii];
+        m_anPlaying[iii]   = nPlaying & !nStop;
+    }
+}
@@ -19,6 +19,9 @@
 
 #include "Money.h"
 
+#include <algorithm>
+#include <cmath>
+
 /**
   * Initialize the bankroll.
   *
@@ -31,9 +34,7 @@ void Money::Initialize(int n)
 {
     if (n <= 0)
     {
-        std::cerr << "ERROR (Money): Bankroll initialization set to: " << n << std::endl;
-        std::cerr << "Exiting" << std::endl;
-        exit (EXIT_FAILURE);
+        throw CrapSimException("Money::Initialize Bankroll initialization set to:", std::to_string(n));
     }
 
     m_nInitialBankroll = m_nBankroll = m_nMaxBankroll = n;
@@ -75,3 +76,22 @@ void Money::Reset()
     m_nBankroll = m_nMaxBankroll = m_nInitialBankroll;
     m_nBankrollBeforeBetting = m_nBankrollAfterBetting = m_nBankrollAfterResolving = 0;
 }
+
+/**
+  * Return the smallest bankroll that has significant winnings.
+  *
+  * The same test as HasSignificantWinnings(), as a single threshold, for
+  * code that compares many bankrolls at once.
+  *
+  * \return The bankroll at or above which HasSignificantWinnings() is true.
+  */
+
+int Money::SignificantBankroll() const
+{
+    int nSignificantBankroll = static_cast<int>(std::ceil(static_cast<float>(m_nInitialBankroll) * m_fSignificantWinningsMultiple));
+
+    if (m_nSignificantWinnings > 0)
+        nSignificantBankroll = std::min(nSignificantBankroll, m_nInitialBankroll + m_nSignificantWinnings);
+
+    return (nSignificantBankroll);
+}
@@ -0,0 +1,394 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Optimizer.h"
+#include "CrapSimException.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <locale>
+#include <set>
+
+/**
+  * Silence std::cout for the life of the object.
+  *
+  * Candidates are created and run through the same code as a normal
+  * Simulation, which prints its headers, musters and changes made by
+  * Strategy sanity checks.  The Optimizer prints its own progress instead.
+  *
+  */
+
+class SilenceOutput
+{
+    public:
+        SilenceOutput() : m_pcBuffer(std::cout.rdbuf(nullptr)) {}
+        ~SilenceOutput() { std::cout.rdbuf(m_pcBuffer); std::cout.clear(); }
+
+    private:
+        std::streambuf *m_pcBuffer;
+};
+
+/**
+  * Construct an Optimizer.
+  *
+  * \param cTable The Table candidates play.
+  * \param fCreateStrategy Creates a Strategy from settings and adds it to a Simulation.
+  */
+
+Optimizer::Optimizer(const Table &cTable, StrategyFactory fCreateStrategy) :
+    m_cTable(cTable),
+    m_fCreateStrategy(fCreateStrategy),
+    m_cGenerator(std::random_device {}())
+{
+}
+
+/**
+  * Set the objective of the search.
+  *
+  * INI File:
+  * Objective=string
+  *
+  * \param sObjective WIN for win percentage, BANKROLL for mean ending bankroll.
+  *
+  * \return True if the objective is known.
+  */
+
+bool Optimizer::SetObjective(std::string sObjective)
+{
+    std::locale loc;
+    for (std::string::size_type iii = 0; iii < sObjective.length(); ++iii)
+        sObjective[iii] = std::toupper(sObjective[iii], loc);
+
+    if (sObjective == "WIN")           m_bBankroll = false;
+    else if (sObjective == "BANKROLL") m_bBankroll = true;
+    else return (false);
+
+    return (true);
+}
+
+/**
+  * Add a key to the search.
+  *
+  * \param sKey The Strategy key, e.g., StandardOdds.
+  * \param vValues The values the key may take.
+  */
+
+void Optimizer::AddParameter(const std::string &sKey, const std::vector<std::string> &vValues)
+{
+    if (vValues.empty())
+        throw CrapSimException("Optimizer::AddParameter no values for", sKey);
+
+    m_vParameters.push_back(Parameter {sKey, vValues});
+}
+
+/**
+  * Search for the best Strategies.
+  *
+  * Start with a random population of distinct candidates.  Each generation
+  * plays every candidate on common dice and adds the result to the
+  * candidate's fitness, so candidates that survive several generations are
+  * judged on more runs and a lucky generation counts for less.  The better
+  * half survives and the rest of the population is bred from the survivors
+  * by uniform crossover and mutation.  Finally, the best candidates seen
+  * are re-evaluated together over the final number of runs and ranked on
+  * that result alone.
+  */
+
+void Optimizer::Optimize()
+{
+    if (m_vParameters.empty())
+        throw CrapSimException("Optimizer::Optimize no parameters to search");
+    if (m_nGenerations < 1 || m_nPopulation < 2 || m_nRuns < 1 || m_nFinalRuns < 1 || m_nTop < 1)
+        throw CrapSimException("Optimizer::Optimize generations, runs and top must be positive, population at least 2");
+
+    std::size_t nPopulation = std::min(static_cast<std::size_t>(m_nPopulation), SearchSpaceSize(m_nPopulation));
+
+    std::cout << "Optimizer" << std::endl;
+    std::cout << "\tObjective:\t" << (m_bBankroll ? "Mean ending bankroll" : "Win percentage") << std::endl;
+    std::cout << "\tParameters:\t";
+    for (const Parameter &stParameter : m_vParameters) std::cout << stParameter.sKey << "(" << stParameter.vValues.size() << ") ";
+    std::cout << std::endl;
+    std::cout << "\tGenerations:\t" << m_nGenerations << " of " << nPopulation << " candidates, " << m_nRuns << " runs each" << std::endl;
+    std::cout << "\tFinal runs:\t" << m_nFinalRuns << " for the best " << 2 * m_nTop << std::endl;
+
+    // Random initial population of distinct candidates
+    std::vector<Genome> vPopulation;
+    std::set<Genome> sSeen;
+    while (vPopulation.size() < nPopulation)
+    {
+        Genome vnGenes = RandomGenome();
+        if (sSeen.insert(vnGenes).second) vPopulation.push_back(vnGenes);
+    }
+
+    m_mFitness.clear();
+
+    for (int nGeneration = 1; nGeneration <= m_nGenerations; ++nGeneration)
+    {
+        std::vector<Evaluation> vEvaluations = Evaluate(vPopulation, m_nRuns, m_cGenerator());
+        for (std::vector<Genome>::size_type iii = 0; iii < vPopulation.size(); ++iii)
+            m_mFitness[vPopulation[iii]].Add(vEvaluations[iii].dObjective);
+
+        std::vector<Genome> vRanked = Ranked(vPopulation);
+        const RunningStatistics &cBest = m_mFitness[vRanked.front()];
+
+        std::cout << "Generation " << std::setw(4) << nGeneration << ": best " <<
+            std::fixed << std::setprecision(2) << cBest.Mean() <<
+            " over " << cBest.Count() * m_nRuns << " runs, " <<
+            m_mFitness.size() << " candidates tried" << std::endl;
+        std::cout.unsetf(std::ios_base::floatfield);
+
+        if (nGeneration == m_nGenerations) break;
+
+        // The better half survives and breeds the rest
+        std::vector<Genome> vSurvivors(vRanked.begin(), vRanked.begin() + std::max<std::size_t>(1, vRanked.size() / 2));
+        std::set<Genome> sNext(vSurvivors.begin(), vSurvivors.end());
+        vPopulation = vSurvivors;
+
+        // Give up on distinct offspring when the search space is nearly exhausted
+        int nAttempts = 0;
+        while (vPopulation.size() < nPopulation && nAttempts < 100 * m_nPopulation)
+        {
+            ++nAttempts;
+            Genome vnChild = Offspring(vSurvivors);
+            if (sNext.insert(vnChild).second) vPopulation.push_back(vnChild);
+        }
+    }
+
+    // Re-evaluate the best candidates seen with more runs
+    std::vector<Genome> vAll;
+    for (const std::pair<const Genome, RunningStatistics> &stFitness : m_mFitness) vAll.push_back(stFitness.first);
+
+    std::vector<Genome> vFinalists = Ranked(vAll);
+    if (vFinalists.size() > static_cast<std::size_t>(2 * m_nTop)) vFinalists.resize(2 * m_nTop);
+
+    std::vector<Evaluation> vEvaluations = Evaluate(vFinalists, m_nFinalRuns, m_cGenerator());
+
+    m_vResults.clear();
+    for (std::vector<Genome>::size_type iii = 0; iii < vFinalists.size(); ++iii)
+        m_vResults.push_back(Result {vFinalists[iii], vEvaluations[iii]});
+
+    std::stable_sort(m_vResults.begin(), m_vResults.end(),
+        [](const Result &a, const Result &b) { return (a.stEvaluation.dObjective > b.stEvaluation.dObjective); });
+
+    if (m_vResults.size() > static_cast<std::size_t>(m_nTop)) m_vResults.resize(m_nTop);
+}
+
+/**
+  * Write the best Strategies as configuration file sections.
+  *
+  * Each section holds the shared settings and the searched settings, and
+  * can be pasted into a configuration file as is.  The section number and
+  * name give the rank.
+  *
+  * \param os The stream to write to.
+  */
+
+void Optimizer::Report(std::ostream &os) const
+{
+    std::ios_base::fmtflags fFlags = os.flags();
+    std::streamsize nPrecision     = os.precision();
+
+    os << std::fixed << std::setprecision(2);
+    os << ";Optimizer results: " << m_nGenerations << " generations of " << m_nPopulation <<
+        " candidates, re-evaluated over " << m_nFinalRuns << " runs on common dice" << std::endl;
+
+    for (std::vector<Result>::size_type iii = 0; iii < m_vResults.size(); ++iii)
+    {
+        const Result &stResult = m_vResults[iii];
+        std::map<std::string, std::string> mSettings = Settings(stResult.vnGenes);
+        mSettings.erase("Name");
+        mSettings.erase("Description");
+
+        os << std::endl;
+        os << "[Strategy" << iii + 1 << "]" << std::endl;
+        os << "Name=" << m_sName << " " << iii + 1 << std::endl;
+        os << "Description=Win " << stResult.stEvaluation.dWinPercentage << "% +/- " <<
+            stResult.stEvaluation.dWinHalfWidth << ", mean bankroll " <<
+            stResult.stEvaluation.dMeanBankroll << ", over " << m_nFinalRuns << " runs" << std::endl;
+
+        for (const std::pair<const std::string, std::string> &stSetting : mSettings)
+            os << stSetting.first << "=" << stSetting.second << std::endl;
+    }
+
+    os.flags(fFlags);
+    os.precision(nPrecision);
+}
+
+/**
+  * Return the settings of a candidate.
+  *
+  * \param vnGenes The candidate.
+  *
+  * \return The shared settings overlaid with the candidate's searched settings.
+  */
+
+std::map<std::string, std::string> Optimizer::Settings(const Genome &vnGenes) const
+{
+    std::map<std::string, std::string> mSettings(m_mBase);
+
+    for (std::vector<Parameter>::size_type iii = 0; iii < m_vParameters.size(); ++iii)
+        mSettings[m_vParameters[iii].sKey] = m_vParameters[iii].vValues[vnGenes[iii]];
+
+    return (mSettings);
+}
+
+/**
+  * Play candidates on common dice.
+  *
+  * All candidates are added to one Simulation so that they play the same
+  * rolls and differences between them are not drowned by dice luck.  The
+  * dice are seeded from the search's generator, so a seeded search plays
+  * the same rolls each time.
+  *
+  * \param vGenomes The candidates.
+  * \param nRuns Number of simulation runs.
+  * \param nSeed Seed of the dice.
+  *
+  * \return Results of each candidate, in the order given.
+  */
+
+std::vector<Optimizer::Evaluation> Optimizer::Evaluate(const std::vector<Genome> &vGenomes, int nRuns, unsigned nSeed) const
+{
+    Simulation cSim;
+    cSim.AddTable(m_cTable);
+    cSim.SetSeed(nSeed);
+    cSim.ReserveStrategies(vGenomes.size());
+
+    {
+        SilenceOutput cSilence;
+
+        for (std::vector<Genome>::size_type iii = 0; iii < vGenomes.size(); ++iii)
+        {
+            std::map<std::string, std::string> mSettings = Settings(vGenomes[iii]);
+            mSettings["Name"] = "Candidate " + std::to_string(iii + 1);
+            m_fCreateStrategy(mSettings, cSim);
+        }
+
+        cSim.Run(nRuns, false, false);
+    }
+
+    std::vector<Evaluation> vEvaluations;
+    for (const Strategy &cStrategy : cSim.Strategies())
+    {
+        Evaluation stEvaluation;
+        stEvaluation.dWinPercentage = cStrategy.WinPercentage();
+        stEvaluation.dWinHalfWidth  = cStrategy.WinCIWidth() / 2.0;
+        stEvaluation.dMeanBankroll  = cStrategy.MeanBankroll();
+        stEvaluation.dObjective     = m_bBankroll ? stEvaluation.dMeanBankroll : stEvaluation.dWinPercentage;
+        vEvaluations.push_back(stEvaluation);
+    }
+
+    return (vEvaluations);
+}
+
+/**
+  * Return a random candidate.
+  *
+  * \return A candidate with each parameter's value chosen uniformly.
+  */
+
+Optimizer::Genome Optimizer::RandomGenome()
+{
+    Genome vnGenes;
+
+    for (const Parameter &stParameter : m_vParameters)
+    {
+        std::uniform_int_distribution<int> cValue(0, stParameter.vValues.size() - 1);
+        vnGenes.push_back(cValue(m_cGenerator));
+    }
+
+    return (vnGenes);
+}
+
+/**
+  * Return a candidate bred from the survivors.
+  *
+  * Each parent is the better of two survivors picked at random (the
+  * survivors are ranked best first).  Each parameter is taken from either
+  * parent with equal chance, then mutated to a random value with a chance
+  * of one in the number of parameters.
+  *
+  * \param vSurvivors The survivors of a generation, best first.
+  *
+  * \return The offspring.
+  */
+
+Optimizer::Genome Optimizer::Offspring(const std::vector<Genome> &vSurvivors)
+{
+    std::uniform_int_distribution<int> cPick(0, vSurvivors.size() - 1);
+    std::uniform_int_distribution<int> cCoin(0, 1);
+    std::uniform_int_distribution<int> cMutate(0, m_vParameters.size() - 1);
+
+    const Genome &vnFirst  = vSurvivors[std::min(cPick(m_cGenerator), cPick(m_cGenerator))];
+    const Genome &vnSecond = vSurvivors[std::min(cPick(m_cGenerator), cPick(m_cGenerator))];
+
+    Genome vnChild(vnFirst.size());
+    for (Genome::size_type iii = 0; iii < vnChild.size(); ++iii)
+    {
+        vnChild[iii] = cCoin(m_cGenerator) ? vnFirst[iii] : vnSecond[iii];
+
+        if (cMutate(m_cGenerator) == 0)
+        {
+            std::uniform_int_distribution<int> cValue(0, m_vParameters[iii].vValues.size() - 1);
+            vnChild[iii] = cValue(m_cGenerator);
+        }
+    }
+
+    return (vnChild);
+}
+
+/**
+  * Return the number of distinct candidates.
+  *
+  * \param nCap Largest number of interest.
+  *
+  * \return The size of the search space, or nCap if it is larger.
+  */
+
+std::size_t Optimizer::SearchSpaceSize(std::size_t nCap) const
+{
+    std::size_t nSize = 1;
+
+    for (const Parameter &stParameter : m_vParameters)
+    {
+        nSize *= stParameter.vValues.size();
+        if (nSize >= nCap) return (nCap);
+    }
+
+    return (nSize);
+}
+
+/**
+  * Rank candidates by their mean fitness over all generations.
+  *
+  * \param vGenomes The candidates, each already evaluated.
+  *
+  * \return The candidates, best first.
+  */
+
+std::vector<Optimizer::Genome> Optimizer::Ranked(const std::vector<Genome> &vGenomes) const
+{
+    std::vector<Genome> vRanked(vGenomes);
+
+    std::stable_sort(vRanked.begin(), vRanked.end(),
+        [this](const Genome &a, const Genome &b) { return (m_mFitness.at(a).Mean() > m_mFitness.at(b).Mean()); });
+
+    return (vRanked);
+}
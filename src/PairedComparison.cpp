@@ -0,0 +1,168 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PairedComparison.h"
+#include "CrapSimException.h"
+
+#include <iostream>
+#include <iomanip>
+
+/**
+  * Set up the pairs of Strategies to compare.
+  *
+  * With a baseline, each Strategy is paired with the baseline.  Without
+  * one, every Strategy is paired with every other Strategy.
+  *
+  * INI File:
+  * CompareBaseline=string
+  *
+  * \param vNames Names of the Strategies, in Simulation order.
+  * \param sBaseline Name of the baseline Strategy, or empty for all pairs.
+  */
+
+void PairedComparison::Initialize(const std::vector<std::string> &vNames, const std::string &sBaseline)
+{
+    m_vNames = vNames;
+    m_vPairs.clear();
+
+    int nBaseline = -1;
+
+    if (!sBaseline.empty())
+    {
+        for (std::vector<std::string>::size_type iii = 0; iii < m_vNames.size(); ++iii)
+        {
+            if (m_vNames[iii] == sBaseline)
+            {
+                nBaseline = iii;
+                break;
+            }
+        }
+
+        if (nBaseline < 0)
+            throw CrapSimException("PairedComparison::Initialize unknown baseline Strategy", sBaseline);
+    }
+
+    int nStrategies = m_vNames.size();
+
+    for (int iii = 0; iii < nStrategies; ++iii)
+    {
+        // Compare against the baseline, keeping it second so that
+        // differences read "Strategy minus baseline"
+        if (nBaseline >= 0)
+        {
+            if (iii != nBaseline) m_vPairs.push_back(Pair {iii, nBaseline, {}, {}, {}});
+            continue;
+        }
+
+        for (int jjj = iii + 1; jjj < nStrategies; ++jjj)
+        {
+            m_vPairs.push_back(Pair {iii, jjj, {}, {}, {}});
+        }
+    }
+}
+
+/**
+  * Accumulate the outcomes of one simulation run.
+  *
+  * For each pair, record the win flag, ending bankroll and number of rolls
+  * of both Strategies so their covariance is available at report time.
+  * Pairs are only recorded for runs both Strategies played.
+  *
+  * \param vOutcomes Outcomes of the run, one per Strategy in Simulation order.
+  */
+
+void PairedComparison::Update(const std::vector<RunOutcome> &vOutcomes)
+{
+    for (Pair &stPair : m_vPairs)
+    {
+        const RunOutcome &stFirst  = vOutcomes[stPair.nFirst];
+        const RunOutcome &stSecond = vOutcomes[stPair.nSecond];
+
+        // A Strategy that has stopped playing no longer pairs
+        if (!stFirst.bPlayed || !stSecond.bPlayed) continue;
+
+        stPair.cWin.Add(stFirst.bWon ? 100.0 : 0.0, stSecond.bWon ? 100.0 : 0.0);
+        stPair.cBankroll.Add(stFirst.nBankroll, stSecond.nBankroll);
+        stPair.cRolls.Add(stFirst.nRolls, stSecond.nRolls);
+    }
+}
+
+/**
+  * Print the paired comparison report.
+  *
+  * For each pair, print the mean difference in win percentage, ending
+  * bankroll and rolls with the half width of the paired 95% confidence
+  * interval.  The unpaired half width is printed alongside the win
+  * percentage to show the benefit of playing all Strategies on common dice.
+  * A pair is resolved when the win percentage interval excludes zero.
+  */
+
+void PairedComparison::Report() const
+{
+    if (m_vPairs.empty()) return;
+
+    std::ios_base::fmtflags fFlags = std::cout.flags();
+    std::streamsize nPrecision     = std::cout.precision();
+
+    std::cout << "\nPaired Comparison (common dice, 95% confidence)" << std::endl;
+
+    std::cout << std::setw(50) << std::right << "First vs Second " <<
+        std::setw(7)  << std::right << "Runs" <<
+        std::setw(10) << std::right << "Win % +/-" <<
+        std::setw(8)  << std::right << "" <<
+        std::setw(10) << std::right << "Unpaired" <<
+        std::setw(7)  << std::right << "Corr" <<
+        std::setw(18) << std::right << "Bankroll +/-" <<
+        std::setw(18) << std::right << "Rolls +/-" <<
+        "  Verdict" <<
+        std::endl;
+
+    for (const Pair &stPair : m_vPairs)
+    {
+        std::string sPair = m_vNames[stPair.nFirst] + " vs " + m_vNames[stPair.nSecond];
+
+        double dWinDiff = stPair.cWin.MeanDifference();
+        double dWinHalf = stPair.cWin.PairedHalfWidth();
+
+        std::string sVerdict("Unresolved");
+        if (stPair.cWin.Count() > 1)
+        {
+            if (dWinDiff - dWinHalf > 0.0)      sVerdict = "First better";
+            else if (dWinDiff + dWinHalf < 0.0) sVerdict = "Second better";
+        }
+
+        std::cout << std::setw(49) << std::right << sPair << " " <<
+            std::setw(7)  << std::right << stPair.cWin.Count() <<
+            std::fixed << std::setprecision(2) <<
+            std::setw(9)  << std::right << dWinDiff <<
+            std::setw(9)  << std::right << dWinHalf <<
+            std::setw(10) << std::right << stPair.cWin.IndependentHalfWidth() <<
+            std::setw(7)  << std::right << stPair.cWin.Correlation() <<
+            std::setprecision(1) <<
+            std::setw(10) << std::right << stPair.cBankroll.MeanDifference() <<
+            std::setw(8)  << std::right << stPair.cBankroll.PairedHalfWidth() <<
+            std::setw(10) << std::right << stPair.cRolls.MeanDifference() <<
+            std::setw(8)  << std::right << stPair.cRolls.PairedHalfWidth() <<
+            "  " << sVerdict <<
+            std::endl;
+    }
+
+    std::cout.flags(fFlags);
+    std::cout.precision(nPrecision);
+}
@@ -0,0 +1,229 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ParameterGrid.h"
+#include "CrapSimException.h"
+
+#include <cmath>
+#include <sstream>
+
+/**
+  * Check a configuration value for sweep syntax.
+  *
+  * \param sValue The configuration value.
+  *
+  * \return True if the value is a range (a..b or a..b:step) or a list ({x,y}).
+  */
+
+bool ParameterGrid::IsSweep(const std::string &sValue)
+{
+    if (sValue.find("..") != std::string::npos) return (true);
+
+    std::string::size_type nFirst = sValue.find_first_not_of(" \t");
+
+    return ((nFirst != std::string::npos) && (sValue[nFirst] == '{'));
+}
+
+/**
+  * Add a swept key.
+  *
+  * INI File:
+  * Key=first..last:step
+  * Key={value,value,...}
+  *
+  * \param sKey The configuration key.
+  * \param sValue The configuration value, in range or list syntax.
+  */
+
+void ParameterGrid::AddAxis(const std::string &sKey, const std::string &sValue)
+{
+    Axis cAxis;
+    cAxis.sKey    = sKey;
+    cAxis.vValues = Expand(sKey, sValue);
+
+    m_vAxes.push_back(cAxis);
+
+    if (Size() > PARAMETER_GRID_MAX_POINTS)
+        throw CrapSimException("ParameterGrid::AddAxis too many Strategies in sweep", sKey);
+}
+
+/**
+  * Return the number of points in the grid.
+  *
+  * \return The product of the number of values of each swept key.
+  */
+
+std::size_t ParameterGrid::Size() const
+{
+    std::size_t nSize = 1;
+
+    for (const Axis &cAxis : m_vAxes)
+    {
+        nSize *= cAxis.vValues.size();
+    }
+
+    return (nSize);
+}
+
+/**
+  * Return the settings of a point.
+  *
+  * The point number is decoded with the last key varying fastest.
+  *
+  * \param nPoint The point, 0..Size()-1.
+  *
+  * \return Map of swept keys to their values at the point.
+  */
+
+std::map<std::string, std::string> ParameterGrid::Point(std::size_t nPoint) const
+{
+    std::map<std::string, std::string> mSettings;
+
+    for (std::vector<Axis>::const_reverse_iterator it = m_vAxes.rbegin(); it != m_vAxes.rend(); ++it)
+    {
+        mSettings[it->sKey] = it->vValues[nPoint % it->vValues.size()];
+        nPoint /= it->vValues.size();
+    }
+
+    return (mSettings);
+}
+
+/**
+  * Return a label for a point.
+  *
+  * \param nPoint The point, 0..Size()-1.
+  *
+  * \return The swept keys and values, in the order they were added.
+  */
+
+std::string ParameterGrid::Label(std::size_t nPoint) const
+{
+    std::vector<std::string> vLabels(m_vAxes.size());
+
+    for (std::vector<Axis>::size_type iii = m_vAxes.size(); iii-- > 0; )
+    {
+        const Axis &cAxis = m_vAxes[iii];
+
+        vLabels[iii] = cAxis.sKey + "=" + cAxis.vValues[nPoint % cAxis.vValues.size()];
+        nPoint /= cAxis.vValues.size();
+    }
+
+    std::string sLabel;
+    for (const std::string &s : vLabels)
+    {
+        if (!sLabel.empty()) sLabel += ", ";
+        sLabel += s;
+    }
+
+    return (sLabel);
+}
+
+/**
+  * Expand sweep syntax into its values.
+  *
+  * A list is split on commas.  A range runs from first to last inclusive
+  * in steps of step, 1 if omitted; values are written as integers if the
+  * first value and the step are integers.
+  *
+  * \param sKey The configuration key, for error reporting.
+  * \param sValue The configuration value.
+  *
+  * \return The values.
+  */
+
+std::vector<std::string> ParameterGrid::Expand(const std::string &sKey, const std::string &sValue)
+{
+    std::vector<std::string> vValues;
+
+    std::string::size_type nOpen = sValue.find('{');
+
+    // List syntax
+    if (nOpen != std::string::npos)
+    {
+        std::string::size_type nClose = sValue.find('}', nOpen);
+        if (nClose == std::string::npos)
+            throw CrapSimException("ParameterGrid::Expand missing } in " + sKey, sValue);
+
+        std::istringstream issList(sValue.substr(nOpen + 1, nClose - nOpen - 1));
+        std::string sItem;
+        while (std::getline(issList, sItem, ','))
+        {
+            std::string::size_type nFirst = sItem.find_first_not_of(" \t");
+            std::string::size_type nLast  = sItem.find_last_not_of(" \t");
+
+            if (nFirst == std::string::npos)
+                throw CrapSimException("ParameterGrid::Expand empty list item in " + sKey, sValue);
+
+            vValues.push_back(sItem.substr(nFirst, nLast - nFirst + 1));
+        }
+
+        if (vValues.empty())
+            throw CrapSimException("ParameterGrid::Expand empty list in " + sKey, sValue);
+
+        return (vValues);
+    }
+
+    // Range syntax
+    std::string::size_type nDots  = sValue.find("..");
+    std::string::size_type nColon = sValue.find(':', nDots);
+
+    std::string sFirst = sValue.substr(0, nDots);
+    std::string sLast  = sValue.substr(nDots + 2, nColon == std::string::npos ? std::string::npos : nColon - nDots - 2);
+    std::string sStep  = nColon == std::string::npos ? "1" : sValue.substr(nColon + 1);
+
+    double dFirst, dLast, dStep;
+    try
+    {
+        dFirst = std::stod(sFirst);
+        dLast  = std::stod(sLast);
+        dStep  = std::stod(sStep);
+    }
+    catch (const std::exception &)
+    {
+        throw CrapSimException("ParameterGrid::Expand malformed range in " + sKey, sValue);
+    }
+
+    if ((dStep <= 0.0) || (dLast < dFirst))
+        throw CrapSimException("ParameterGrid::Expand empty range in " + sKey, sValue);
+
+    bool bIntegers = (sFirst.find('.') == std::string::npos) && (sStep.find('.') == std::string::npos);
+
+    // Count steps with a little tolerance so 1.1..5.0:0.1 includes 5.0
+    double dSteps = std::floor((dLast - dFirst) / dStep + 1e-9);
+    if (dSteps + 1 > PARAMETER_GRID_MAX_POINTS)
+        throw CrapSimException("ParameterGrid::Expand too many values in " + sKey, sValue);
+
+    for (long iii = 0; iii <= static_cast<long>(dSteps); ++iii)
+    {
+        double dValue = dFirst + iii * dStep;
+
+        if (bIntegers)
+        {
+            vValues.push_back(std::to_string(static_cast<long>(std::llround(dValue))));
+        }
+        else
+        {
+            std::ostringstream ossValue;
+            ossValue << std::round(dValue * 1e6) / 1e6;
+            vValues.push_back(ossValue.str());
+        }
+    }
+
+    return (vValues);
+}
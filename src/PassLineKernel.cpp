@@ -0,0 +1,282 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PassLineKernel.h"
+
+#include <algorithm>
+
+/**
+  * Pay the lanes that made the point.
+  *
+  * The Pass bet pays 1:1 and the Odds pay NUMERATOR:DENOMINATOR, rounded
+  * down as Bet::CalculatePayoff() does.  The odds are a template argument so
+  * that the division is by a constant and the loop vectorizes.
+  *
+  * \param nLanes Number of lanes.
+  * \param pnPlaying Whether each lane is playing.
+  * \param pnBankroll Bankroll of each lane.
+  * \param pnPass Pass wager of each lane.
+  * \param pnOdds Odds wager of each lane.
+  */
+
+template <int NUMERATOR, int DENOMINATOR>
+static void PayPoint(int nLanes, const int *pnPlaying, int *pnBankroll, const int *pnPass, const int *pnOdds)
+{
+    for (int iii = 0; iii < nLanes; ++iii)
+    {
+        int nPayoff = 2 * pnPass[iii] + pnOdds[iii] + (pnOdds[iii] * NUMERATOR) / DENOMINATOR;
+        pnBankroll[iii] += pnPlaying[iii] ? nPayoff : 0;
+    }
+}
+
+/**
+  * Set up a lane for each Strategy.
+  *
+  * Copy each Strategy's numbers into the lane arrays, including the
+  * bankroll at which it has significant winnings, so that the per roll
+  * loops compare integers only.
+  *
+  * \param vpStrategies The Strategies, each of which makes only Pass and Pass Odds bets.
+  * \param cTable The Table.
+  */
+
+void PassLineKernel::Initialize(const std::vector<Strategy *> &vpStrategies, const Table &cTable)
+{
+    m_vpStrategies = vpStrategies;
+
+    m_vnInitialBankroll.clear();
+    m_vnStandardWager.clear();
+    m_vfOdds.clear();
+    m_vnFullWager.clear();
+    m_vnSignificantBankroll.clear();
+    m_vnPlayForNumberOfRolls.clear();
+
+    for (const Strategy *pcStrategy : m_vpStrategies)
+    {
+        m_vnInitialBankroll.push_back(pcStrategy->InitialBankroll());
+        m_vnStandardWager.push_back(std::min(pcStrategy->StandardWager(), cTable.MaximumBet()));
+        m_vfOdds.push_back(pcStrategy->StandardOdds());
+        m_vnFullWager.push_back(pcStrategy->FullWager() ? 1 : 0);
+        m_vnPlayForNumberOfRolls.push_back(pcStrategy->PlayForNumberOfRolls());
+        m_vnSignificantBankroll.push_back(pcStrategy->SignificantBankroll());
+    }
+
+    m_nTableMaximum = cTable.MaximumBet();
+    for (int nPoint : {4, 5, 6, 8, 9, 10})
+    {
+        m_afMaxOdds[nPoint] = cTable.MaxOdds(nPoint);
+    }
+
+    Reset();
+}
+
+/**
+  * Make bets in every lane still playing.
+  *
+  * On the come out, a lane without a Pass bet makes one at its standard
+  * wager.  After the point is set, a lane with a Pass bet and no Odds makes
+  * the Odds bet, limited by the Table odds and rounded to a full payoff if
+  * the Strategy asks.  As in Wager::CheckWager(), neither bet exceeds the
+  * Table maximum or the bankroll, and a bet under one is not made.
+  *
+  * \param cTable The Table.
+  */
+
+void PassLineKernel::MakeBets(const Table &cTable)
+{
+    const int nLanes = m_vpStrategies.size();
+
+    const int *pnPlaying  = m_vnPlaying.data();
+    int       *pnBankroll = m_vnBankroll.data();
+    int       *pnPass     = m_vnPassWager.data();
+    int       *pnOdds     = m_vnOddsWager.data();
+
+    if (cTable.IsComingOutRoll())
+    {
+        const int *pnStandardWager = m_vnStandardWager.data();
+
+        for (int iii = 0; iii < nLanes; ++iii)
+        {
+            int nWager = std::min(pnStandardWager[iii], pnBankroll[iii]);
+            int nBet   = (pnPlaying[iii] && pnPass[iii] == 0 && nWager >= 1) ? nWager : 0;
+
+            pnPass[iii]     += nBet;
+            pnBankroll[iii] -= nBet;
+        }
+    }
+    else
+    {
+        const int    nPoint      = cTable.Point();
+        const float  fMaxOdds    = m_afMaxOdds[nPoint];
+        // Full payoff Odds are a multiple of 1 on 4 and 10, 2 on 5 and 9, 5 on 6 and 8
+        const int    nMultiple   = (nPoint == 4 || nPoint == 10) ? 1 : ((nPoint == 5 || nPoint == 9) ? 2 : 5);
+        const float *pfOdds      = m_vfOdds.data();
+        const int   *pnFullWager = m_vnFullWager.data();
+
+        for (int iii = 0; iii < nLanes; ++iii)
+        {
+            int nWager = static_cast<int>(static_cast<float>(pnPass[iii]) * std::min(fMaxOdds, pfOdds[iii]));
+            nWager -= pnFullWager[iii] * (nWager % nMultiple);
+            nWager  = std::min(std::min(nWager, m_nTableMaximum), pnBankroll[iii]);
+
+            int nBet = (pnPlaying[iii] && pnPass[iii] > 0 && pnOdds[iii] == 0 && nWager >= 1) ? nWager : 0;
+
+            pnOdds[iii]     += nBet;
+            pnBankroll[iii] -= nBet;
+        }
+    }
+}
+
+/**
+  * Resolve the roll in every lane.
+  *
+  * Each lane still playing counts the roll.  On the come out, a natural
+  * wins and craps loses the Pass bet.  After the point is set, making the
+  * point wins and a seven loses both the Pass and the Odds bets.  Then each
+  * lane checks whether it is still playing, as Strategy::StillPlaying()
+  * does.
+  *
+  * \param cTable The Table, before it is updated for the roll.
+  * \param cDice The Dice.
+  *
+  * \return True if any lane is still playing.
+  */
+
+bool PassLineKernel::PlayRoll(const Table &cTable, const Dice &cDice)
+{
+    const int nLanes = m_vpStrategies.size();
+
+    int *pnPlaying  = m_vnPlaying.data();
+    int *pnBankroll = m_vnBankroll.data();
+    int *pnPass     = m_vnPassWager.data();
+    int *pnOdds     = m_vnOddsWager.data();
+    int *pnRolls    = m_vnRolls.data();
+
+    for (int iii = 0; iii < nLanes; ++iii)
+    {
+        pnRolls[iii] += pnPlaying[iii];
+    }
+
+    bool bResolved = false;
+
+    if (cTable.IsComingOutRoll())
+    {
+        if (cDice.IsNatural())
+        {
+            for (int iii = 0; iii < nLanes; ++iii)
+            {
+                pnBankroll[iii] += pnPlaying[iii] ? 2 * pnPass[iii] : 0;
+            }
+        }
+
+        bResolved = cDice.IsNatural() || cDice.IsCraps();
+    }
+    else
+    {
+        if (cDice.RollValue() == cTable.Point())
+        {
+            switch (cTable.Point())
+            {
+                case 4:
+                case 10:
+                    PayPoint<2, 1>(nLanes, pnPlaying, pnBankroll, pnPass, pnOdds);
+                    break;
+                case 5:
+                case 9:
+                    PayPoint<3, 2>(nLanes, pnPlaying, pnBankroll, pnPass, pnOdds);
+                    break;
+                default:
+                    PayPoint<6, 5>(nLanes, pnPlaying, pnBankroll, pnPass, pnOdds);
+                    break;
+            }
+        }
+
+        bResolved = cDice.IsSeven() || (cDice.RollValue() == cTable.Point());
+    }
+
+    if (bResolved)
+    {
+        for (int iii = 0; iii < nLanes; ++iii)
+        {
+            pnPass[iii] = pnPlaying[iii] ? 0 : pnPass[iii];
+            pnOdds[iii] = pnPlaying[iii] ? 0 : pnOdds[iii];
+        }
+    }
+
+    const int *pnStandardWager        = m_vnStandardWager.data();
+    const int *pnSignificantBankroll  = m_vnSignificantBankroll.data();
+    const int *pnPlayForNumberOfRolls = m_vnPlayForNumberOfRolls.data();
+
+    int nStillPlaying = 0;
+
+    for (int iii = 0; iii < nLanes; ++iii)
+    {
+        int nNoBets = (pnPass[iii] == 0);
+        int nBroke  = nNoBets & (pnBankroll[iii] < pnStandardWager[iii]);
+        int nWon    = nNoBets & (pnBankroll[iii] >= pnSignificantBankroll[iii]);
+        int nStop   = pnPlayForNumberOfRolls[iii] > 0 ? (pnRolls[iii] == pnPlayForNumberOfRolls[iii]) : (nBroke | nWon);
+
+        pnPlaying[iii] &= !nStop;
+        nStillPlaying  |= pnPlaying[iii];
+    }
+
+    return (nStillPlaying != 0);
+}
+
+/**
+  * Hand the outcome of the run to each lane's Strategy.
+  *
+  * Called before the Strategies update their statistics, so that they
+  * record the run as if they had played it.
+  */
+
+void PassLineKernel::Store() const
+{
+    for (std::vector<Strategy *>::size_type iii = 0; iii < m_vpStrategies.size(); ++iii)
+    {
+        m_vpStrategies[iii]->SetRunResult(m_vnBankroll[iii], m_vnRolls[iii]);
+    }
+}
+
+/**
+  * Reset the lanes for a new simulation run.
+  *
+  * Bankrolls return to their initial amounts, with no bets or rolls.  A
+  * lane starts out playing unless its bankroll already stops it, as
+  * Strategy::StillPlaying() would.
+  */
+
+void PassLineKernel::Reset()
+{
+    const std::vector<Strategy *>::size_type nLanes = m_vpStrategies.size();
+
+    m_vnBankroll = m_vnInitialBankroll;
+    m_vnPassWager.assign(nLanes, 0);
+    m_vnOddsWager.assign(nLanes, 0);
+    m_vnRolls.assign(nLanes, 0);
+    m_vnPlaying.assign(nLanes, 1);
+
+    for (std::vector<Strategy *>::size_type iii = 0; iii < nLanes; ++iii)
+    {
+        if (m_vnPlayForNumberOfRolls[iii] > 0) continue;
+
+        if ((m_vnBankroll[iii] < m_vnStandardWager[iii]) || (m_vnBankroll[iii] >= m_vnSignificantBankroll[iii]))
+            m_vnPlaying[iii] = 0;
+    }
+}
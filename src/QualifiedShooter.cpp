@@ -20,37 +20,32 @@
 #include <iostream>
 #include "QualifiedShooter.h"
 
-/**
-  * Construct a QualifiedShooter.
-  *
-  * Sets up a map of strings and qualification methods.
-  */
-
-QualifiedShooter::QualifiedShooter()
+// Names of the qualification methods
+static constexpr struct { const char *pszName; QualificationMethod ecMethod; } g_asQualificationMethods[] =
 {
-    m_mQualificationMethod["NO_METHOD"]                               = QualificationMethod::QM_NO_METHOD;
-    m_mQualificationMethod["5COUNT"]                                  = QualificationMethod::QM_5COUNT;
-    m_mQualificationMethod["AFTER_POINT_ESTABLISHED"]                 = QualificationMethod::QM_AFTER_POINT_ESTABLISHED;
-    m_mQualificationMethod["AFTER_POINT_MADE"]                        = QualificationMethod::QM_AFTER_POINT_MADE;
-    m_mQualificationMethod["AFTER_LOSING_FIELD_THREE_TIMES_IN_A_ROW"] = QualificationMethod::QM_AFTER_LOSING_FIELD_THREE_TIMES_IN_A_ROW;
-    m_mQualificationMethod["AFTER_FIVE_NON_SEVEN_ROLLS"]              = QualificationMethod::QM_AFTER_FIVE_NON_SEVEN_ROLLS;
-    m_mQualificationMethod["AFTER_N_2_ROLLS_IN_A_ROW"]                = QualificationMethod::QM_AFTER_N_2_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_3_ROLLS_IN_A_ROW"]                = QualificationMethod::QM_AFTER_N_3_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_4_ROLLS_IN_A_ROW"]                = QualificationMethod::QM_AFTER_N_4_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_5_ROLLS_IN_A_ROW"]                = QualificationMethod::QM_AFTER_N_5_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_6_ROLLS_IN_A_ROW"]                = QualificationMethod::QM_AFTER_N_6_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_8_ROLLS_IN_A_ROW"]                = QualificationMethod::QM_AFTER_N_8_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_9_ROLLS_IN_A_ROW"]                = QualificationMethod::QM_AFTER_N_9_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_10_ROLLS_IN_A_ROW"]               = QualificationMethod::QM_AFTER_N_10_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_11_ROLLS_IN_A_ROW"]               = QualificationMethod::QM_AFTER_N_11_ROLLS_IN_A_ROW;
-    m_mQualificationMethod["AFTER_N_12_ROLLS_IN_A_ROW"]               = QualificationMethod::QM_AFTER_N_12_ROLLS_IN_A_ROW;
-}
+    {"NO_METHOD",                               QualificationMethod::QM_NO_METHOD},
+    {"5COUNT",                                  QualificationMethod::QM_5COUNT},
+    {"AFTER_POINT_ESTABLISHED",                 QualificationMethod::QM_AFTER_POINT_ESTABLISHED},
+    {"AFTER_POINT_MADE",                        QualificationMethod::QM_AFTER_POINT_MADE},
+    {"AFTER_LOSING_FIELD_THREE_TIMES_IN_A_ROW", QualificationMethod::QM_AFTER_LOSING_FIELD_THREE_TIMES_IN_A_ROW},
+    {"AFTER_FIVE_NON_SEVEN_ROLLS",              QualificationMethod::QM_AFTER_FIVE_NON_SEVEN_ROLLS},
+    {"AFTER_N_2_ROLLS_IN_A_ROW",                QualificationMethod::QM_AFTER_N_2_ROLLS_IN_A_ROW},
+    {"AFTER_N_3_ROLLS_IN_A_ROW",                QualificationMethod::QM_AFTER_N_3_ROLLS_IN_A_ROW},
+    {"AFTER_N_4_ROLLS_IN_A_ROW",                QualificationMethod::QM_AFTER_N_4_ROLLS_IN_A_ROW},
+    {"AFTER_N_5_ROLLS_IN_A_ROW",                QualificationMethod::QM_AFTER_N_5_ROLLS_IN_A_ROW},
+    {"AFTER_N_6_ROLLS_IN_A_ROW",                QualificationMethod::QM_AFTER_N_6_ROLLS_IN_A_ROW},
+    {"AFTER_N_8_ROLLS_IN_A_ROW",                QualificationMethod::QM_AFTER_N_8_ROLLS_IN_A_ROW},
+    {"AFTER_N_9_ROLLS_IN_A_ROW",                QualificationMethod::QM_AFTER_N_9_ROLLS_IN_A_ROW},
+    {"AFTER_N_10_ROLLS_IN_A_ROW",               QualificationMethod::QM_AFTER_N_10_ROLLS_IN_A_ROW},
+    {"AFTER_N_11_ROLLS_IN_A_ROW",               QualificationMethod::QM_AFTER_N_11_ROLLS_IN_A_ROW},
+    {"AFTER_N_12_ROLLS_IN_A_ROW",               QualificationMethod::QM_AFTER_N_12_ROLLS_IN_A_ROW}
+};
 
 /**
   * Set the qualification method.
   *
   * Based on a passed string, sets the qualification method for a shooter.
-  * The string is set in the map of strings and QualificationMethod types.
+  * The string is looked up in the table of qualification method names.
   *
   * \param sMethod The qualification method, e.g., 5COUNT, AFTER_POINT_MADE.
   */
@@ -61,24 +56,23 @@ void QualifiedShooter::SetMethod(std::string sMethod)
     for (std::string::size_type iii = 0; iii < sMethod.length(); ++iii)
         sMethod[iii] = std::toupper(sMethod[iii], loc);
 
-    std::map<std::string, QualificationMethod>::iterator it = m_mQualificationMethod.find(sMethod);
-
-    if (it != m_mQualificationMethod.end())
+    for (const auto &sMethodName : g_asQualificationMethods)
     {
-        m_ecQualificationMethod = it->second;
-    }
-    else
-    {
-        throw CrapSimException("QualifiedShooter::SetMethod unknown method", sMethod);
+        if (sMethod == sMethodName.pszName)
+        {
+            m_ecQualificationMethod = sMethodName.ecMethod;
+            return;
+        }
     }
+
+    throw CrapSimException("QualifiedShooter::SetMethod unknown method", sMethod);
 }
 
 /**
   * Return the qualification method for a shooter in string format.
   *
   * Loops the known qualification methods and compares to this Strategy's
-  * qualification method.  When found, return correspnding string. The
-  * string is set in the map of strings and QualificationMethod types.
+  * qualification method.  When found, return correspnding string.
   *
   * \return String representing the qualification method.
   */
@@ -87,13 +81,11 @@ std::string QualifiedShooter::Method() const
 {
     std::string sMethod("Unknown");
 
-    for (std::map<std::string, QualificationMethod>::const_iterator it = m_mQualificationMethod.begin();
-         it != m_mQualificationMethod.end();
-         ++it)
+    for (const auto &sMethodName : g_asQualificationMethods)
     {
-        if (m_ecQualificationMethod == it->second)
+        if (m_ecQualificationMethod == sMethodName.ecMethod)
         {
-            sMethod = it->first;
+            sMethod = sMethodName.pszName;
             break;
         }
     }
@@ -0,0 +1,205 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ResultCache.h"
+#include "CrapSimVersion.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+
+/**
+  * Return the 64 bit FNV-1a hash of a text.
+  *
+  * \param sText The text.
+  *
+  * \return The hash.
+  */
+
+static unsigned long long Hash(const std::string &sText)
+{
+    unsigned long long nHash = 14695981039346656037ULL;
+
+    for (unsigned char c : sText)
+    {
+        nHash ^= c;
+        nHash *= 1099511628211ULL;
+    }
+
+    return (nHash);
+}
+
+/**
+  * Return the path of the file for a key.
+  *
+  * \param sKey The text of everything the results depend on.
+  *
+  * \return The path of the file.
+  */
+
+std::string ResultCache::Path(const std::string &sKey) const
+{
+    std::ostringstream ossPath;
+    ossPath << m_sDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << Hash(Header(sKey)) << ".result";
+
+    return (ossPath.str());
+}
+
+/**
+  * Return the first lines of the file for a key: the format, the version
+  * of CrapSim and the key.  A file is read only if it starts with them, so
+  * results are never read for another key with the same hash.
+  *
+  * \param sKey The text of everything the results depend on.
+  *
+  * \return The header.
+  */
+
+std::string ResultCache::Header(const std::string &sKey)
+{
+    return ("CrapSimResultCache=" + std::to_string(RESULT_CACHE_FORMAT) + "\n" +
+            "Version=" + CrapSimVersion::SemanticVersion() + " " + CrapSimVersion::DateVersion() + "\n" +
+            sKey + "Results\n");
+}
+
+/**
+  * Read the results stored for a key.
+  *
+  * \param sKey The text of everything the results depend on.
+  * \param cResults The results read.
+  *
+  * \return True if results were stored for the key.
+  */
+
+bool ResultCache::Load(const std::string &sKey, StrategyResults &cResults) const
+{
+    std::ifstream ifsFile(Path(sKey), std::ios::binary);
+    if (!ifsFile) return (false);
+
+    std::ostringstream ossText;
+    ossText << ifsFile.rdbuf();
+    const std::string sText = ossText.str();
+
+    const std::string sHeader = Header(sKey);
+    if (sText.compare(0, sHeader.size(), sHeader) != 0) return (false);
+
+    std::istringstream issResults(sText.substr(sHeader.size()));
+    StrategyResults cRead;
+    long long nCount;
+    double    dMean;
+    double    dM2;
+
+    issResults >> cRead.m_nTimesStrategyRun >> cRead.m_nTimesStrategyWon >> cRead.m_nTimesStrategyLost;
+    issResults >> cRead.m_nWinRollsMin >> cRead.m_nWinRollsMax >> cRead.m_nWinRollsTotal;
+    issResults >> cRead.m_nLossRollsMin >> cRead.m_nLossRollsMax >> cRead.m_nLossRollsTotal;
+    issResults >> cRead.m_nWinBankrollMin >> cRead.m_nWinBankrollMax >> cRead.m_nWinBankrollTotal;
+    issResults >> cRead.m_nLossBankrollMin >> cRead.m_nLossBankrollMax >> cRead.m_nLossBankrollTotal;
+
+    issResults >> nCount >> dMean >> dM2;
+    cRead.m_cWinStatistics.Restore(nCount, dMean, dM2);
+    issResults >> nCount >> dMean >> dM2;
+    cRead.m_cBankrollStatistics.Restore(nCount, dMean, dM2);
+
+    for (int iii = 0; iii < LOG_HISTOGRAM_BUCKETS; ++iii)
+    {
+        issResults >> nCount;
+        cRead.m_cRollsHistogram.Restore(iii, nCount);
+    }
+
+    for (int iii = 0; iii < static_cast<int>(SurvivalEvent::SE_COUNT); ++iii)
+    {
+        for (int jjj = 0; jjj < SURVIVAL_CURVE_BUCKETS; ++jjj)
+        {
+            issResults >> nCount;
+            cRead.m_cSurvivalCurve.Restore(static_cast<SurvivalEvent>(iii), jjj, nCount);
+        }
+    }
+
+    if (!issResults) return (false);
+
+    cResults = cRead;
+
+    return (true);
+}
+
+/**
+  * Store the results for a key.
+  *
+  * The file is written under another name and renamed into place, so that
+  * a Simulation running at the same time never reads half a file.
+  *
+  * \param sKey The text of everything the results depend on.
+  * \param cResults The results stored.
+  */
+
+void ResultCache::Store(const std::string &sKey, const StrategyResults &cResults) const
+{
+    const std::string sPath = Path(sKey);
+    const std::string sTemporaryPath = sPath + "." + std::to_string(std::random_device()());
+
+    std::ofstream ofsFile(sTemporaryPath, std::ios::binary | std::ios::trunc);
+
+    ofsFile << Header(sKey);
+    ofsFile << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    ofsFile << cResults.m_nTimesStrategyRun << " " << cResults.m_nTimesStrategyWon << " " << cResults.m_nTimesStrategyLost << "\n";
+    ofsFile << cResults.m_nWinRollsMin << " " << cResults.m_nWinRollsMax << " " << cResults.m_nWinRollsTotal << "\n";
+    ofsFile << cResults.m_nLossRollsMin << " " << cResults.m_nLossRollsMax << " " << cResults.m_nLossRollsTotal << "\n";
+    ofsFile << cResults.m_nWinBankrollMin << " " << cResults.m_nWinBankrollMax << " " << cResults.m_nWinBankrollTotal << "\n";
+    ofsFile << cResults.m_nLossBankrollMin << " " << cResults.m_nLossBankrollMax << " " << cResults.m_nLossBankrollTotal << "\n";
+
+    ofsFile << cResults.m_cWinStatistics.Count() << " " << cResults.m_cWinStatistics.Mean() << " " <<
+        cResults.m_cWinStatistics.SumOfSquares() << "\n";
+    ofsFile << cResults.m_cBankrollStatistics.Count() << " " << cResults.m_cBankrollStatistics.Mean() << " " <<
+        cResults.m_cBankrollStatistics.SumOfSquares() << "\n";
+
+    for (int iii = 0; iii < LOG_HISTOGRAM_BUCKETS; ++iii)
+    {
+        ofsFile << cResults.m_cRollsHistogram.Count(iii) << (iii + 1 < LOG_HISTOGRAM_BUCKETS ? " " : "\n");
+    }
+
+    for (int iii = 0; iii < static_cast<int>(SurvivalEvent::SE_COUNT); ++iii)
+    {
+        for (int jjj = 0; jjj < SURVIVAL_CURVE_BUCKETS; ++jjj)
+        {
+            ofsFile << cResults.m_cSurvivalCurve.Count(static_cast<SurvivalEvent>(iii), jjj) << (jjj + 1 < SURVIVAL_CURVE_BUCKETS ? " " : "\n");
+        }
+    }
+
+    ofsFile.close();
+
+    if (!ofsFile)
+    {
+        std::remove(sTemporaryPath.c_str());
+        throw CrapSimException("ResultCache cannot write", sTemporaryPath);
+    }
+
+#ifdef _WIN32
+    std::remove(sPath.c_str());
+#endif // _WIN32
+
+    if (std::rename(sTemporaryPath.c_str(), sPath.c_str()) != 0)
+    {
+        std::remove(sTemporaryPath.c_str());
+        throw CrapSimException("ResultCache cannot write", sPath);
+    }
+}
@@ -0,0 +1,345 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RollTape.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Marks the start of a roll tape
+static const char ROLLTAPE_MAGIC[] = "CrapTape";
+
+// Bytes written to the tape at a time
+static const std::vector<char>::size_type ROLLTAPE_BUFFER_BYTES = 1 << 16;
+
+// Append a little endian value to a header
+static void PutLittleEndian(std::string &sHeader, unsigned long long nValue, int nBytes)
+{
+    for (int iii = 0; iii < nBytes; ++iii)
+    {
+        sHeader += static_cast<char>((nValue >> (8 * iii)) & 0xff);
+    }
+}
+
+// Return a little endian value of a header
+static unsigned long long GetLittleEndian(const unsigned char *pnBytes, int nBytes)
+{
+    unsigned long long nValue = 0;
+    for (int iii = nBytes - 1; iii >= 0; --iii)
+    {
+        nValue = (nValue << 8) | pnBytes[iii];
+    }
+
+    return (nValue);
+}
+
+// Return the header of a tape of nRuns runs and nRolls rolls
+static std::string Header(unsigned long long nRuns, unsigned long long nRolls)
+{
+    std::string sHeader(ROLLTAPE_MAGIC, sizeof(ROLLTAPE_MAGIC) - 1);
+    PutLittleEndian(sHeader, ROLLTAPE_FORMAT, 4);
+    PutLittleEndian(sHeader, 0, 4);
+    PutLittleEndian(sHeader, nRuns, 8);
+    PutLittleEndian(sHeader, nRolls, 8);
+
+    return (sHeader);
+}
+
+/**
+  * Construct a RollTapeRecorder.
+  *
+  * Create the tape, with room for its header.
+  *
+  * \param sPath The path of the tape.
+  */
+
+RollTapeRecorder::RollTapeRecorder(const std::string &sPath) :
+    m_sPath(sPath),
+    m_ofsTape(sPath, std::ios::binary | std::ios::trunc)
+{
+    const std::string sHeader = Header(0, 0);
+    m_ofsTape.write(sHeader.data(), sHeader.size());
+
+    if (!m_ofsTape)
+        throw CrapSimException("RollTapeRecorder cannot write", m_sPath);
+
+    m_vcBuffer.reserve(ROLLTAPE_BUFFER_BYTES);
+}
+
+/**
+  * Close the tape, if not closed.  Errors are not reported here; Close()
+  * reports them.
+  */
+
+RollTapeRecorder::~RollTapeRecorder()
+{
+    try
+    {
+        Close();
+    }
+    catch (const CrapSimException &)
+    {
+    }
+}
+
+/**
+  * Move the codes waiting to the buffer, three bytes for four codes, and
+  * write the buffer once it is full.
+  */
+
+void RollTapeRecorder::PutBytes()
+{
+    const int nBytes = (6 * m_nCodes + 7) / 8;
+    for (int iii = 0; iii < nBytes; ++iii)
+    {
+        m_vcBuffer.push_back(static_cast<char>((m_nCodeBits >> (8 * iii)) & 0xff));
+    }
+
+    m_nCodeBits = 0;
+    m_nCodes    = 0;
+
+    if (m_vcBuffer.size() >= ROLLTAPE_BUFFER_BYTES)
+    {
+        m_ofsTape.write(m_vcBuffer.data(), m_vcBuffer.size());
+        m_vcBuffer.clear();
+    }
+}
+
+/**
+  * Close the tape.
+  *
+  * End the run being recorded, write the codes waiting and the buffer, and
+  * write the header with the runs and rolls recorded.
+  */
+
+void RollTapeRecorder::Close()
+{
+    if (!m_ofsTape.is_open()) return;
+
+    EndRun();
+    if (m_nCodes > 0) PutBytes();
+
+    m_ofsTape.write(m_vcBuffer.data(), m_vcBuffer.size());
+    m_vcBuffer.clear();
+
+    const std::string sHeader = Header(m_nRuns, m_nRolls);
+    m_ofsTape.seekp(0);
+    m_ofsTape.write(sHeader.data(), sHeader.size());
+    m_ofsTape.close();
+
+    if (!m_ofsTape)
+        throw CrapSimException("RollTapeRecorder cannot write", m_sPath);
+}
+
+/**
+  * Record the rolls of a text roll log to a roll tape.
+  *
+  * Each roll is written as its two faces, e.g., 3-4, 3/4 or 34, and rolls
+  * are separated by spaces, tabs or commas, on as many lines as wanted.  A
+  * blank line ends a run.  Text from a # to the end of a line is a comment.
+  *
+  * \param sLogPath The path of the roll log.
+  * \param sTapePath The path of the roll tape.
+  * \param nRuns The runs recorded.
+  * \param nRolls The rolls recorded.
+  */
+
+void RollTapeRecorder::Import(const std::string &sLogPath, const std::string &sTapePath,
+                              unsigned long long &nRuns, unsigned long long &nRolls)
+{
+    std::ifstream ifsLog(sLogPath);
+    if (!ifsLog)
+        throw CrapSimException("RollTapeRecorder::Import cannot read", sLogPath);
+
+    RollTapeRecorder cRecorder(sTapePath);
+
+    std::string sLine;
+    int nLine = 0;
+
+    try
+    {
+        while (std::getline(ifsLog, sLine))
+        {
+            ++nLine;
+
+            std::string::size_type nEnd = sLine.find('#');
+            if (sLine.find_first_not_of(" \t\r") == nEnd)
+            {
+                // A blank line ends the run; a comment alone does not
+                if (nEnd == std::string::npos) cRecorder.EndRun();
+                continue;
+            }
+            if (nEnd == std::string::npos) nEnd = sLine.size();
+
+            std::string::size_type iii = 0;
+            while (iii < nEnd)
+            {
+                if (std::strchr(" \t\r,", sLine[iii]))
+                {
+                    ++iii;
+                    continue;
+                }
+
+                // Two faces, perhaps with a - or / between them
+                std::string::size_type nStart = iii;
+                int nDie1 = sLine[iii++] - '0';
+                if ((iii < nEnd) && ((sLine[iii] == '-') || (sLine[iii] == '/'))) ++iii;
+                int nDie2 = (iii < nEnd) ? sLine[iii++] - '0' : 0;
+
+                if ((nDie1 < 1) || (nDie1 > 6) || (nDie2 < 1) || (nDie2 > 6) ||
+                    ((iii < nEnd) && !std::strchr(" \t\r,", sLine[iii])))
+                {
+                    std::string::size_type nTokenEnd = sLine.find_first_of(" \t\r,", nStart);
+                    throw CrapSimException("RollTapeRecorder::Import bad roll on line " + std::to_string(nLine) + " of " + sLogPath,
+                                           sLine.substr(nStart, std::min(nTokenEnd, nEnd) - nStart));
+                }
+
+                cRecorder.Record((nDie1 - 1) * 6 + (nDie2 - 1));
+            }
+        }
+    }
+    catch (const CrapSimException &)
+    {
+        // Leave no tape of part of the log
+        cRecorder.m_ofsTape.close();
+        std::remove(sTapePath.c_str());
+        throw;
+    }
+
+    cRecorder.Close();
+
+    nRuns  = cRecorder.Runs();
+    nRolls = cRecorder.Rolls();
+}
+
+/**
+  * Construct a RollTapePlayer.
+  *
+  * Map the tape into memory, so that playing it reads memory and makes no
+  * system calls, check its header, and find the start of each run.
+  *
+  * \param sPath The path of the tape.
+  */
+
+RollTapePlayer::RollTapePlayer(const std::string &sPath) :
+    m_sPath(sPath)
+{
+#ifdef _WIN32
+    std::ifstream ifsTape(sPath, std::ios::binary);
+    if (!ifsTape)
+        throw CrapSimException("RollTapePlayer cannot read", sPath);
+
+    m_vnTape.assign(std::istreambuf_iterator<char>(ifsTape), std::istreambuf_iterator<char>());
+    m_pnTape = m_vnTape.data();
+    m_nSize  = m_vnTape.size();
+#else
+    int nFd = open(sPath.c_str(), O_RDONLY);
+    if (nFd < 0)
+        throw CrapSimException("RollTapePlayer cannot read", sPath);
+
+    struct stat stFile;
+    if (fstat(nFd, &stFile) < 0)
+    {
+        close(nFd);
+        throw CrapSimException("RollTapePlayer cannot read", sPath);
+    }
+
+    m_nSize = stFile.st_size;
+    if (m_nSize > 0)
+    {
+        void *pTape = mmap(nullptr, m_nSize, PROT_READ, MAP_PRIVATE, nFd, 0);
+        if (pTape == MAP_FAILED)
+        {
+            close(nFd);
+            throw CrapSimException("RollTapePlayer cannot map", sPath);
+        }
+
+        madvise(pTape, m_nSize, MADV_SEQUENTIAL);
+        m_pnTape = static_cast<const unsigned char *>(pTape);
+    }
+
+    close(nFd);
+#endif // _WIN32
+
+    try
+    {
+        if ((m_nSize < ROLLTAPE_HEADER_BYTES) || (std::memcmp(m_pnTape, ROLLTAPE_MAGIC, sizeof(ROLLTAPE_MAGIC) - 1) != 0))
+            throw CrapSimException("RollTapePlayer is not a roll tape", sPath);
+        if (GetLittleEndian(m_pnTape + 8, 4) != ROLLTAPE_FORMAT)
+            throw CrapSimException("RollTapePlayer roll tape is of another format", sPath);
+
+        unsigned long long nRuns  = GetLittleEndian(m_pnTape + 16, 8);
+        unsigned long long nRolls = GetLittleEndian(m_pnTape + 24, 8);
+
+        m_pnCodes = m_pnTape + ROLLTAPE_HEADER_BYTES;
+        m_nCodes  = nRuns + nRolls;
+
+        if ((m_nCodes < nRuns) || (m_nCodes > (m_nSize - ROLLTAPE_HEADER_BYTES) * 8 / 6))
+            throw CrapSimException("RollTapePlayer roll tape is damaged", sPath);
+
+        // Every run ends with a run end code
+        m_vnRunStarts.reserve(nRuns);
+        unsigned long long nRunStart = 0;
+
+        for (unsigned long long iii = 0; iii < m_nCodes; ++iii)
+        {
+            unsigned nCode = Code(iii);
+            if (nCode == ROLLTAPE_RUN_END)
+            {
+                m_vnRunStarts.push_back(nRunStart);
+                nRunStart = iii + 1;
+            }
+            else if (nCode >= 36)
+            {
+                throw CrapSimException("RollTapePlayer roll tape is damaged", sPath);
+            }
+        }
+
+        if ((m_vnRunStarts.size() != nRuns) || (nRunStart != m_nCodes))
+            throw CrapSimException("RollTapePlayer roll tape is damaged", sPath);
+    }
+    catch (...)
+    {
+#ifndef _WIN32
+        if (m_pnTape) munmap(const_cast<unsigned char *>(m_pnTape), m_nSize);
+#endif // _WIN32
+        throw;
+    }
+}
+
+/**
+  * Unmap the tape.
+  */
+
+RollTapePlayer::~RollTapePlayer()
+{
+#ifndef _WIN32
+    if (m_pnTape) munmap(const_cast<unsigned char *>(m_pnTape), m_nSize);
+#endif // _WIN32
+}
@@ -0,0 +1,553 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RuleProgram.h"
+#include "CrapSimException.h"
+
+#include <cctype>
+#include <climits>
+#include <locale>
+
+// Instructions of the rule bytecode.  Operands follow the opcode.
+enum class RuleOpcode
+{
+    OP_CONSTANT,                    // Push the operand
+    OP_VARIABLE,                    // Push the variable numbered by the operand
+    OP_ADD,
+    OP_SUBTRACT,
+    OP_MULTIPLY,
+    OP_DIVIDE,                      // Division by zero gives zero
+    OP_NEGATE,
+    OP_LESS,
+    OP_LESS_EQUAL,
+    OP_GREATER,
+    OP_GREATER_EQUAL,
+    OP_EQUAL,
+    OP_NOT_EQUAL,
+    OP_AND,
+    OP_OR,
+    OP_NOT,
+    OP_JUMP_UNLESS,                 // Pop; if zero, jump to the operand
+    OP_ORDER                        // Pop the amount; order the action and bet in the operands
+};
+
+// Names of the variables and bets in rules
+static const struct { const char *pszName; RuleVariable ecVariable; } g_asVariableNames[] =
+{
+    {"COMEOUT",   RuleVariable::RV_COMEOUT},
+    {"POINT",     RuleVariable::RV_POINT},
+    {"ROLL",      RuleVariable::RV_ROLL},
+    {"BANKROLL",  RuleVariable::RV_BANKROLL},
+    {"INITIAL",   RuleVariable::RV_INITIAL},
+    {"WAGER",     RuleVariable::RV_WAGER},
+    {"ROLLS",     RuleVariable::RV_ROLLS},
+    {"HITS",      RuleVariable::RV_HITS},
+    {"QUALIFIED", RuleVariable::RV_QUALIFIED}
+};
+
+static const struct { const char *pszName; RuleBet ecBet; } g_asBetNames[] =
+{
+    {"PASS",     RuleBet::RB_PASS},
+    {"DONTPASS", RuleBet::RB_DONT_PASS},
+    {"FIELD",    RuleBet::RB_FIELD},
+    {"PLACE4",   RuleBet::RB_PLACE4},
+    {"PLACE5",   RuleBet::RB_PLACE5},
+    {"PLACE6",   RuleBet::RB_PLACE6},
+    {"PLACE8",   RuleBet::RB_PLACE8},
+    {"PLACE9",   RuleBet::RB_PLACE9},
+    {"PLACE10",  RuleBet::RB_PLACE10},
+    {"HARD4",    RuleBet::RB_HARD4},
+    {"HARD6",    RuleBet::RB_HARD6},
+    {"HARD8",    RuleBet::RB_HARD8},
+    {"HARD10",   RuleBet::RB_HARD10}
+};
+
+static const struct { const char *pszName; RuleAction ecAction; } g_asActionNames[] =
+{
+    {"BET",      RuleAction::RA_BET},
+    {"PRESS",    RuleAction::RA_PRESS},
+    {"REGRESS",  RuleAction::RA_REGRESS},
+    {"TAKEDOWN", RuleAction::RA_TAKEDOWN}
+};
+
+/**
+  * The RuleCompiler translates one rule into bytecode by recursive descent.
+  *
+  * rule       := [IF or THEN] action
+  * action     := (BET | PRESS | REGRESS) bet sum | TAKEDOWN bet
+  * or         := and {OR and}
+  * and        := not {AND not}
+  * not        := NOT not | comparison
+  * comparison := sum [(< | <= | > | >= | = | == | != | <>) sum]
+  * sum        := product {(+ | -) product}
+  * product    := unary {(* | /) unary}
+  * unary      := - unary | primary
+  * primary    := number | variable | bet | ( or )
+  *
+  */
+
+class RuleCompiler
+{
+    public:
+        RuleCompiler(const std::string &sRule, std::vector<int> &vnCode) :
+            m_sRule(sRule), m_vnCode(vnCode) {}
+
+        // Compile the rule, appending to the code
+        void Compile();
+
+    private:
+        // Split the rule into upper case tokens
+        void Tokenize();
+        // Return the next token, or "" at the end
+        const std::string& Peek() const;
+        // Consume the next token if it is s
+        bool Accept(const std::string &s);
+        // Consume the next token, which must be s
+        void Expect(const std::string &s);
+        // Report a syntax error
+        void Error(const std::string &sWhat) const;
+
+        // Grammar
+        void Action();
+        void Or();
+        void And();
+        void Not();
+        void Comparison();
+        void Sum();
+        void Product();
+        void Unary();
+        void Primary();
+        RuleBet Bet();
+
+        // Emit an instruction that changes the stack depth by nDepth
+        void Emit(RuleOpcode ecOpcode, int nDepth);
+
+        const std::string        &m_sRule;
+        std::vector<int>         &m_vnCode;
+        std::vector<std::string>  m_vsTokens;
+        std::vector<std::string>::size_type m_nNext {0};
+        int                       m_nDepth {0};
+};
+
+void RuleCompiler::Compile()
+{
+    Tokenize();
+
+    if (m_vsTokens.empty()) Error("empty rule");
+
+    if (Accept("IF"))
+    {
+        Or();
+        Expect("THEN");
+
+        // Skip the action unless the condition holds; the jump is patched below
+        Emit(RuleOpcode::OP_JUMP_UNLESS, -1);
+        m_vnCode.push_back(0);
+        std::vector<int>::size_type nJump = m_vnCode.size() - 1;
+
+        Action();
+
+        m_vnCode[nJump] = m_vnCode.size();
+    }
+    else
+    {
+        Action();
+    }
+
+    if (m_nNext != m_vsTokens.size()) Error("unexpected " + Peek());
+}
+
+void RuleCompiler::Tokenize()
+{
+    std::locale loc;
+    std::string::size_type iii = 0;
+
+    while (iii < m_sRule.length())
+    {
+        char c = m_sRule[iii];
+
+        if (std::isspace(c, loc))
+        {
+            ++iii;
+        }
+        else if (std::isalnum(c, loc) || c == '_')
+        {
+            std::string sToken;
+            while (iii < m_sRule.length() && (std::isalnum(m_sRule[iii], loc) || m_sRule[iii] == '_'))
+                sToken += std::toupper(m_sRule[iii++], loc);
+            m_vsTokens.push_back(sToken);
+        }
+        else if ((c == '<' || c == '>' || c == '=' || c == '!') && (iii + 1 < m_sRule.length()) &&
+                 (m_sRule[iii + 1] == '=' || (c == '<' && m_sRule[iii + 1] == '>')))
+        {
+            m_vsTokens.push_back(m_sRule.substr(iii, 2));
+            iii += 2;
+        }
+        else if (std::string("()+-*/<>=").find(c) != std::string::npos)
+        {
+            m_vsTokens.push_back(std::string(1, c));
+            ++iii;
+        }
+        else
+        {
+            Error(std::string("unexpected character ") + c);
+        }
+    }
+}
+
+const std::string& RuleCompiler::Peek() const
+{
+    static const std::string sEnd;
+
+    return (m_nNext < m_vsTokens.size() ? m_vsTokens[m_nNext] : sEnd);
+}
+
+bool RuleCompiler::Accept(const std::string &s)
+{
+    if (Peek() != s) return (false);
+
+    ++m_nNext;
+    return (true);
+}
+
+void RuleCompiler::Expect(const std::string &s)
+{
+    if (!Accept(s)) Error("expected " + s);
+}
+
+void RuleCompiler::Error(const std::string &sWhat) const
+{
+    throw CrapSimException("RuleProgram::AddRule " + sWhat + " in rule", m_sRule);
+}
+
+void RuleCompiler::Action()
+{
+    for (const auto &sAction : g_asActionNames)
+    {
+        if (!Accept(sAction.pszName)) continue;
+
+        RuleBet ecBet = Bet();
+
+        if (sAction.ecAction == RuleAction::RA_TAKEDOWN)
+        {
+            Emit(RuleOpcode::OP_CONSTANT, 1);
+            m_vnCode.push_back(0);
+        }
+        else
+        {
+            Sum();
+        }
+
+        Emit(RuleOpcode::OP_ORDER, -1);
+        m_vnCode.push_back(static_cast<int>(sAction.ecAction));
+        m_vnCode.push_back(static_cast<int>(ecBet));
+        return;
+    }
+
+    Error("expected BET, PRESS, REGRESS or TAKEDOWN");
+}
+
+void RuleCompiler::Or()
+{
+    And();
+    while (Accept("OR"))
+    {
+        And();
+        Emit(RuleOpcode::OP_OR, -1);
+    }
+}
+
+void RuleCompiler::And()
+{
+    Not();
+    while (Accept("AND"))
+    {
+        Not();
+        Emit(RuleOpcode::OP_AND, -1);
+    }
+}
+
+void RuleCompiler::Not()
+{
+    if (Accept("NOT"))
+    {
+        Not();
+        Emit(RuleOpcode::OP_NOT, 0);
+    }
+    else
+    {
+        Comparison();
+    }
+}
+
+void RuleCompiler::Comparison()
+{
+    Sum();
+
+    RuleOpcode ecOpcode;
+    if      (Accept("<"))  ecOpcode = RuleOpcode::OP_LESS;
+    else if (Accept("<=")) ecOpcode = RuleOpcode::OP_LESS_EQUAL;
+    else if (Accept(">"))  ecOpcode = RuleOpcode::OP_GREATER;
+    else if (Accept(">=")) ecOpcode = RuleOpcode::OP_GREATER_EQUAL;
+    else if (Accept("=") || Accept("==")) ecOpcode = RuleOpcode::OP_EQUAL;
+    else if (Accept("!=") || Accept("<>")) ecOpcode = RuleOpcode::OP_NOT_EQUAL;
+    else return;
+
+    Sum();
+    Emit(ecOpcode, -1);
+}
+
+void RuleCompiler::Sum()
+{
+    Product();
+    while (true)
+    {
+        if      (Accept("+")) { Product(); Emit(RuleOpcode::OP_ADD, -1); }
+        else if (Accept("-")) { Product(); Emit(RuleOpcode::OP_SUBTRACT, -1); }
+        else break;
+    }
+}
+
+void RuleCompiler::Product()
+{
+    Unary();
+    while (true)
+    {
+        if      (Accept("*")) { Unary(); Emit(RuleOpcode::OP_MULTIPLY, -1); }
+        else if (Accept("/")) { Unary(); Emit(RuleOpcode::OP_DIVIDE, -1); }
+        else break;
+    }
+}
+
+void RuleCompiler::Unary()
+{
+    if (Accept("-"))
+    {
+        Unary();
+        Emit(RuleOpcode::OP_NEGATE, 0);
+    }
+    else
+    {
+        Primary();
+    }
+}
+
+void RuleCompiler::Primary()
+{
+    if (Accept("("))
+    {
+        Or();
+        Expect(")");
+        return;
+    }
+
+    const std::string sToken = Peek();
+
+    if (!sToken.empty() && std::isdigit(sToken[0], std::locale()))
+    {
+        std::size_t nLength = 0;
+        long lValue = 0;
+        try
+        {
+            lValue = std::stol(sToken, &nLength);
+        }
+        catch (const std::exception &)
+        {
+            Error("bad number " + sToken);
+        }
+        if (nLength != sToken.length() || lValue > INT_MAX) Error("bad number " + sToken);
+
+        ++m_nNext;
+        Emit(RuleOpcode::OP_CONSTANT, 1);
+        m_vnCode.push_back(static_cast<int>(lValue));
+        return;
+    }
+
+    for (const auto &sVariable : g_asVariableNames)
+    {
+        if (Accept(sVariable.pszName))
+        {
+            Emit(RuleOpcode::OP_VARIABLE, 1);
+            m_vnCode.push_back(static_cast<int>(sVariable.ecVariable));
+            return;
+        }
+    }
+
+    // A bet reads as its wager, 0 if not made
+    RuleBet ecBet = Bet();
+    Emit(RuleOpcode::OP_VARIABLE, 1);
+    m_vnCode.push_back(static_cast<int>(RuleVariable::RV_FIRST_BET) + static_cast<int>(ecBet));
+}
+
+RuleBet RuleCompiler::Bet()
+{
+    for (const auto &sBet : g_asBetNames)
+    {
+        if (Accept(sBet.pszName)) return (sBet.ecBet);
+    }
+
+    Error(Peek().empty() ? std::string("expected a bet") : "unknown name " + Peek());
+    return (RuleBet::RB_COUNT);
+}
+
+void RuleCompiler::Emit(RuleOpcode ecOpcode, int nDepth)
+{
+    m_vnCode.push_back(static_cast<int>(ecOpcode));
+
+    m_nDepth += nDepth;
+    if (m_nDepth > RULE_STACK_DEPTH) Error("expression too deep");
+}
+
+/**
+  * Compile a rule and append it to the program.
+  *
+  * INI File:
+  * Rule1=[IF condition THEN] BET|PRESS|REGRESS bet amount
+  * Rule1=[IF condition THEN] TAKEDOWN bet
+  *
+  * \param sRule The rule.
+  */
+
+void RuleProgram::AddRule(const std::string &sRule)
+{
+    std::vector<int> vnCode;
+
+    RuleCompiler cCompiler(sRule, vnCode);
+    cCompiler.Compile();
+
+    // Jumps were compiled relative to the start of the rule
+    std::vector<int>::size_type nBase = m_vnCode.size();
+    for (std::vector<int>::size_type iii = 0; iii < vnCode.size(); )
+    {
+        RuleOpcode ecOpcode = static_cast<RuleOpcode>(vnCode[iii]);
+
+        if (ecOpcode == RuleOpcode::OP_JUMP_UNLESS) vnCode[iii + 1] += nBase;
+
+        if      (ecOpcode == RuleOpcode::OP_ORDER) iii += 3;
+        else if (ecOpcode == RuleOpcode::OP_CONSTANT || ecOpcode == RuleOpcode::OP_VARIABLE ||
+                 ecOpcode == RuleOpcode::OP_JUMP_UNLESS) iii += 2;
+        else ++iii;
+    }
+
+    m_vnCode.insert(m_vnCode.end(), vnCode.begin(), vnCode.end());
+    m_vsRules.push_back(sRule);
+}
+
+/**
+  * Return a value clamped to the range of an int.
+  *
+  * Rule arithmetic is done in long long, which holds any sum, difference
+  * or product of two ints, and saturates rather than wrapping around.
+  *
+  * \param nValue The value.
+  *
+  * \return The value, or INT_MIN or INT_MAX if out of range.
+  */
+
+static inline int Saturate(long long nValue)
+{
+    return (nValue > INT_MAX ? INT_MAX : (nValue < INT_MIN ? INT_MIN : static_cast<int>(nValue)));
+}
+
+/**
+  * Run the rules.
+  *
+  * The rules run in order on the same variables, so a rule does not see
+  * the orders of the rules before it; the Strategy carries out the orders
+  * afterwards, in order.
+  *
+  * \param pnVariables The RULE_VARIABLES values, indexed by RuleVariable and
+  * then RuleBet.
+  * \param vOrders The orders of the rules that fire are appended here.
+  */
+
+void RuleProgram::Execute(const int *pnVariables, std::vector<RuleOrder> &vOrders) const
+{
+    int anStack[RULE_STACK_DEPTH];
+    int nTop = -1;
+
+    const int *pnCode = m_vnCode.data();
+    const int  nSize  = m_vnCode.size();
+
+    int iii = 0;
+    while (iii < nSize)
+    {
+        switch (static_cast<RuleOpcode>(pnCode[iii]))
+        {
+            case RuleOpcode::OP_CONSTANT:
+                anStack[++nTop] = pnCode[iii + 1];
+                iii += 2;
+                break;
+            case RuleOpcode::OP_VARIABLE:
+                anStack[++nTop] = pnVariables[pnCode[iii + 1]];
+                iii += 2;
+                break;
+            case RuleOpcode::OP_ADD:
+                --nTop; anStack[nTop] = Saturate(static_cast<long long>(anStack[nTop]) + anStack[nTop + 1]); ++iii;
+                break;
+            case RuleOpcode::OP_SUBTRACT:
+                --nTop; anStack[nTop] = Saturate(static_cast<long long>(anStack[nTop]) - anStack[nTop + 1]); ++iii;
+                break;
+            case RuleOpcode::OP_MULTIPLY:
+                --nTop; anStack[nTop] = Saturate(static_cast<long long>(anStack[nTop]) * anStack[nTop + 1]); ++iii;
+                break;
+            case RuleOpcode::OP_DIVIDE:
+                // In long long, as INT_MIN / -1 is out of range
+                --nTop; anStack[nTop] = anStack[nTop + 1] ? Saturate(static_cast<long long>(anStack[nTop]) / anStack[nTop + 1]) : 0; ++iii;
+                break;
+            case RuleOpcode::OP_NEGATE:
+                anStack[nTop] = Saturate(-static_cast<long long>(anStack[nTop])); ++iii;
+                break;
+            case RuleOpcode::OP_LESS:
+                --nTop; anStack[nTop] = anStack[nTop] < anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_LESS_EQUAL:
+                --nTop; anStack[nTop] = anStack[nTop] <= anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_GREATER:
+                --nTop; anStack[nTop] = anStack[nTop] > anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_GREATER_EQUAL:
+                --nTop; anStack[nTop] = anStack[nTop] >= anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_EQUAL:
+                --nTop; anStack[nTop] = anStack[nTop] == anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_NOT_EQUAL:
+                --nTop; anStack[nTop] = anStack[nTop] != anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_AND:
+                --nTop; anStack[nTop] = anStack[nTop] && anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_OR:
+                --nTop; anStack[nTop] = anStack[nTop] || anStack[nTop + 1]; ++iii;
+                break;
+            case RuleOpcode::OP_NOT:
+                anStack[nTop] = !anStack[nTop]; ++iii;
+                break;
+            case RuleOpcode::OP_JUMP_UNLESS:
+                iii = anStack[nTop--] ? iii + 2 : pnCode[iii + 1];
+                break;
+            case RuleOpcode::OP_ORDER:
+                vOrders.push_back({static_cast<RuleAction>(pnCode[iii + 1]), static_cast<RuleBet>(pnCode[iii + 2]), anStack[nTop--]});
+                iii += 3;
+                break;
+        }
+    }
+}
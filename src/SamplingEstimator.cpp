@@ -0,0 +1,249 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SamplingEstimator.h"
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+
+/**
+  * Set up an estimate for each Strategy.
+  *
+  * \param ecDiceSampling The sampling method used by the Dice.
+  * \param vNames Names of the Strategies, in Simulation order.
+  */
+
+void SamplingEstimator::Initialize(DiceSampling ecDiceSampling, const std::vector<std::string> &vNames)
+{
+    m_ecDiceSampling = ecDiceSampling;
+    m_vNames         = vNames;
+    m_vEstimates.assign(m_vNames.size(), StrategyEstimate());
+}
+
+/**
+  * Accumulate the outcomes of one simulation run.
+  *
+  * \param vOutcomes Outcomes of the run, one per Strategy in Simulation order.
+  * \param nStratum The come out outcome forced for the run, if stratified.
+  */
+
+void SamplingEstimator::Update(const std::vector<RunOutcome> &vOutcomes, int nStratum)
+{
+    for (std::vector<StrategyEstimate>::size_type iii = 0; iii < m_vEstimates.size(); ++iii)
+    {
+        if (!vOutcomes[iii].bPlayed) continue;
+
+        Add(m_vEstimates[iii].cWin, vOutcomes[iii].bWon ? 100.0 : 0.0, nStratum);
+        Add(m_vEstimates[iii].cBankroll, vOutcomes[iii].nBankroll, nStratum);
+    }
+}
+
+/**
+  * Add an observation to an estimate.
+  *
+  * Antithetic runs arrive in pairs; the second run of a pair completes an
+  * observation of the pair average, which are independent of each other.
+  * Stratified runs are kept by stratum.
+  *
+  * \param cEstimate The estimate.
+  * \param x The observation.
+  * \param nStratum The come out stratum of the run.
+  */
+
+void SamplingEstimator::Add(Estimate &cEstimate, double x, int nStratum)
+{
+    cEstimate.cPlain.Add(x);
+
+    switch (m_ecDiceSampling)
+    {
+        case DiceSampling::ANTITHETIC:
+            if (cEstimate.bPending)
+            {
+                cEstimate.cPairs.Add((cEstimate.dPending + x) / 2.0);
+                cEstimate.bPending = false;
+            }
+            else
+            {
+                cEstimate.dPending = x;
+                cEstimate.bPending = true;
+            }
+            break;
+
+        case DiceSampling::STRATIFIED:
+            cEstimate.acStrata[nStratum].Add(x);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+  * Return the estimated mean.
+  *
+  * Stratified estimates weight each stratum by its probability, 1/36,
+  * regardless of how many runs fell in it; until every stratum has a run,
+  * the strata that have runs share the weight equally.  An unpaired final
+  * antithetic run is left out.
+  *
+  * \param cEstimate The estimate.
+  *
+  * \return The estimated mean.
+  */
+
+double SamplingEstimator::Mean(const Estimate &cEstimate) const
+{
+    switch (m_ecDiceSampling)
+    {
+        case DiceSampling::ANTITHETIC:
+            return (cEstimate.cPairs.Mean());
+
+        case DiceSampling::STRATIFIED:
+        {
+            double dSum    = 0.0;
+            int    nStrata = 0;
+            for (const RunningStatistics &cStratum : cEstimate.acStrata)
+            {
+                if (cStratum.Count() == 0) continue;
+                dSum += cStratum.Mean();
+                ++nStrata;
+            }
+            return (nStrata > 0 ? dSum / nStrata : 0.0);
+        }
+
+        default:
+            return (cEstimate.cPlain.Mean());
+    }
+}
+
+/**
+  * Return the half width of the 95% confidence interval of the mean.
+  *
+  * For stratified estimates the variance is the sum over strata of
+  * w^2 * s^2 / n.  Every stratum needs two runs to estimate its variance;
+  * until then the half width is infinite, as the interval is not known.
+  *
+  * \param cEstimate The estimate.
+  *
+  * \return The half width.
+  */
+
+double SamplingEstimator::HalfWidth(const Estimate &cEstimate) const
+{
+    switch (m_ecDiceSampling)
+    {
+        case DiceSampling::ANTITHETIC:
+            return (cEstimate.cPairs.HalfWidth());
+
+        case DiceSampling::STRATIFIED:
+        {
+            double dVariance = 0.0;
+            for (const RunningStatistics &cStratum : cEstimate.acStrata)
+            {
+                if (cStratum.Count() < 2) return (std::numeric_limits<double>::infinity());
+                dVariance += cStratum.Variance() / cStratum.Count() / (DICE_OUTCOMES * DICE_OUTCOMES);
+            }
+            return (CONFIDENCE_Z95 * std::sqrt(dVariance));
+        }
+
+        default:
+            return (cEstimate.cPlain.HalfWidth());
+    }
+}
+
+/**
+  * Return the efficiency of the sampling method.
+  *
+  * The ratio of the plain variance of the mean to the sampled variance of
+  * the mean, for the same number of runs.  An efficiency of 2 means plain
+  * sampling would need twice as many runs to reach the same confidence.
+  *
+  * \param cEstimate The estimate.
+  *
+  * \return The efficiency, or zero if not yet known.
+  */
+
+double SamplingEstimator::Efficiency(const Estimate &cEstimate) const
+{
+    double dHalfWidth = HalfWidth(cEstimate);
+
+    if ((dHalfWidth <= 0.0) || std::isinf(dHalfWidth)) return (0.0);
+
+    double dRatio = cEstimate.cPlain.HalfWidth() / dHalfWidth;
+
+    return (dRatio * dRatio);
+}
+
+/**
+  * Print the sampling estimate report.
+  *
+  * For each Strategy, print the estimated win percentage and ending
+  * bankroll with the half width of the 95% confidence interval under the
+  * sampling method, the half width plain sampling would give over the same
+  * number of runs, and the efficiency of the sampling method.
+  */
+
+void SamplingEstimator::Report() const
+{
+    if (m_vEstimates.empty() || m_ecDiceSampling == DiceSampling::PLAIN) return;
+
+    std::ios_base::fmtflags fFlags = std::cout.flags();
+    std::streamsize nPrecision     = std::cout.precision();
+
+    std::cout << "\nSampling Estimates (" <<
+        (m_ecDiceSampling == DiceSampling::ANTITHETIC ? "antithetic" : "stratified") <<
+        " dice, 95% confidence)" << std::endl;
+
+    std::cout << std::setw(40) << std::right << "Strategy " <<
+        std::setw(7)  << std::right << "Runs" <<
+        std::setw(9)  << std::right << "Win %" <<
+        std::setw(8)  << std::right << "+/-" <<
+        std::setw(8)  << std::right << "Plain" <<
+        std::setw(7)  << std::right << "Eff" <<
+        std::setw(10) << std::right << "Bankroll" <<
+        std::setw(8)  << std::right << "+/-" <<
+        std::setw(8)  << std::right << "Plain" <<
+        std::setw(7)  << std::right << "Eff" <<
+        std::endl;
+
+    for (std::vector<StrategyEstimate>::size_type iii = 0; iii < m_vEstimates.size(); ++iii)
+    {
+        const StrategyEstimate &cEstimate = m_vEstimates[iii];
+
+        std::cout << std::setw(39) << std::right << m_vNames[iii] << " " <<
+            std::setw(7)  << std::right << cEstimate.cWin.cPlain.Count() <<
+            std::fixed << std::setprecision(2) <<
+            std::setw(9)  << std::right << Mean(cEstimate.cWin) <<
+            std::setw(8)  << std::right << HalfWidth(cEstimate.cWin) <<
+            std::setw(8)  << std::right << cEstimate.cWin.cPlain.HalfWidth() <<
+            std::setw(7)  << std::right << Efficiency(cEstimate.cWin) <<
+            std::setprecision(1) <<
+            std::setw(10) << std::right << Mean(cEstimate.cBankroll) <<
+            std::setw(8)  << std::right << HalfWidth(cEstimate.cBankroll) <<
+            std::setw(8)  << std::right << cEstimate.cBankroll.cPlain.HalfWidth() <<
+            std::setprecision(2) <<
+            std::setw(7)  << std::right << Efficiency(cEstimate.cBankroll) <<
+            std::endl;
+    }
+
+    std::cout.flags(fFlags);
+    std::cout.precision(nPrecision);
+}
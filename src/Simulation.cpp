@@ -18,9 +18,29 @@
 */
 
 #include "Simulation.h"
+#include "AllocationCounter.h"
+#include "Checkpoint.h"
+#include "ResultCache.h"
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
+#include <sstream>
+
+// Return a chance as a percentage with two decimals
+static std::string Percent(double dChance)
+{
+    std::ostringstream ossPercent;
+    ossPercent << std::fixed << std::setprecision(2) << 100.0 * dChance << "%";
+
+    return (ossPercent.str());
+}
 
 /**
   * Construct the Simulatiom
@@ -37,7 +57,18 @@ Simulation::Simulation() :
   * Run the simulatioms.
   *
   * Print configuration information, sanity check the Strategies, print a
-  * muster report, and execute the simulation.
+  * muster report, and execute the simulation.  Progress is printed to the
+  * log, std::cout unless set otherwise.
+  *
+  * With a target confidence interval width, nNumberOfRuns is the minimum
+  * number of runs; after that the Strategies are checked every batch of
+  * runs until they meet the target or the maximum number of runs is reached.
+  *
+  * With a result cache, Strategies whose results are in the cache are not
+  * played, and the results of those played are stored in it.
+  *
+  * A shard plays its slice of the runs and writes their results to its
+  * partial results file.
   *
   *\param nNumberOfRuns Number of simulation runs to execute
   *\param bMusterReport Flag to print muster report
@@ -46,184 +77,961 @@ Simulation::Simulation() :
 
 void Simulation::Run(int nNumberOfRuns, bool bMusterReport, bool bTally)
 {
-    // Ensure that each Strategy conforms to the environment
-    std::cout << "Sanity-checking the Strategies." << std::endl;
-    for (std::vector<Strategy>::iterator it = m_vStrategies.begin(); it != m_vStrategies.end(); ++it)
+    std::ostream &osLog = *m_posLog;
+
+    SanityCheckStrategies();
+
+    // A slice, such as a shard, plays m_nSliceRuns runs from run
+    // m_nSliceFirstRun on of the nNumberOfRuns, and each run is seeded from
+    // its number
+    const int nTotalRuns = nNumberOfRuns;
+    bool bSeedEachRun    = !m_sResultCache.empty();
+
+    if (m_nShards > 0)
+    {
+        m_nSliceFirstRun = static_cast<int>(static_cast<long long>(nTotalRuns) * (m_nShard - 1) / m_nShards);
+        m_nSliceRuns     = static_cast<int>(static_cast<long long>(nTotalRuns) * m_nShard / m_nShards) - m_nSliceFirstRun;
+    }
+
+    if (m_nSliceRuns >= 0)
     {
-        it->SanityCheck(m_cTable);
+        if ((m_nSliceFirstRun < 0) || (m_nSliceFirstRun + m_nSliceRuns > nTotalRuns))
+            throw CrapSimException("Simulation::Run slice is outside the runs", std::to_string(m_nSliceFirstRun) + "+" + std::to_string(m_nSliceRuns));
+
+        nNumberOfRuns = m_nSliceRuns;
+        bSeedEachRun  = true;
     }
-    std::cout << "Sanity-check complete." << std::endl;
+
+    // Set up the paired comparison of Strategies and the sampling estimates
+    std::vector<std::string> vNames;
+    for (const Strategy &cStrategy : m_vStrategies)
+    {
+        vNames.push_back(cStrategy.Name());
+    }
+
+    if (m_bPairedComparison) m_cPairedComparison.Initialize(vNames, m_sComparisonBaseline);
+    m_cSamplingEstimator.Initialize(m_cDice.SamplingMethod(), vNames);
+    m_vRunOutcomes.resize(m_vStrategies.size());
+
+    // All Strategies start out playing
+    m_vbActive.assign(m_vStrategies.size(), true);
+    m_vnEliminatedRound.assign(m_vStrategies.size(), 0);
+
+    // Strategies whose results are in the result cache sit out.  Traced
+    // Strategies always play, so that their trace is written, as do
+    // plugins whose library file cannot be told apart from another build.
+    std::vector<std::string> vsCacheKeys;
+    int nCached = 0;
+
+    if (!m_sResultCache.empty())
+    {
+        ResultCache cCache(m_sResultCache);
+
+        for (std::vector<Strategy>::size_type iii = 0; iii < m_vStrategies.size(); ++iii)
+        {
+            vsCacheKeys.push_back(ResultCacheKey(m_vStrategies[iii], nNumberOfRuns));
+
+            StrategyResults cResults;
+            if (m_vStrategies[iii].Cacheable() && cCache.Load(vsCacheKeys[iii], cResults))
+            {
+                m_vStrategies[iii].SetResults(cResults);
+                m_vbActive[iii] = false;
+                ++nCached;
+            }
+        }
+    }
+
+    bool bSequential = (m_dTargetCIWidth > 0.0);
+    int  nMaxRuns    = (bSequential || m_bRace) ? std::max(m_nMaxRuns, nNumberOfRuns) : nNumberOfRuns;
+
+    // A roll tape played holds only so many runs
+    const RollTapePlayer *pcPlayer = m_cDice.Player();
+    if (pcPlayer)
+    {
+        if (static_cast<unsigned long long>(nNumberOfRuns) > pcPlayer->Runs())
+            throw CrapSimException("Simulation::Run more runs than on the roll tape",
+                                   std::to_string(pcPlayer->Runs()) + " in " + pcPlayer->Path());
+
+        nMaxRuns = static_cast<int>(std::min(static_cast<unsigned long long>(nMaxRuns), pcPlayer->Runs()));
+    }
+
+    // The first racing round is nNumberOfRuns long; each round after doubles
+    int  nRound      = 0;
+    int  nRoundRuns  = nNumberOfRuns;
+    int  nRoundEnd   = nNumberOfRuns;
+
+    // Runs completed, more than none if resumed from a checkpoint
+    int  iii         = 0;
+
+    std::string sCheckpointKey;
+    bool bResumed = false;
+
+    if (!m_sCheckpoint.empty())
+    {
+        sCheckpointKey = CheckpointKey(nTotalRuns);
+        if (m_nSliceRuns >= 0) sCheckpointKey += "Slice=" + std::to_string(m_nSliceFirstRun) + "+" + std::to_string(m_nSliceRuns) + "\n";
+        if (m_bResume) bResumed = ReadCheckpoint(sCheckpointKey, iii, nRound, nRoundRuns, nRoundEnd);
+    }
+
+    UpdateActiveStrategies();
 
     // Write Muster
     if (bMusterReport) Muster();
 
-    std::cout << "\nTable" << std::endl;
-    std::cout << "\tType:\t\t" << m_cTable.TableType() << std::endl;
-    std::cout << "\tMinimum Wager:\t" << m_cTable.MinimumBet() << std::endl;
-    std::cout << "\tMaximum Wager:\t" << m_cTable.MaximumBet() << std::endl;
-    std::cout << "\tBar:\t\t" << m_cTable.Bar() << std::endl;
+    osLog << "\nTable" << std::endl;
+    osLog << "\tType:\t\t" << m_cTable.TableType() << std::endl;
+    osLog << "\tMinimum Wager:\t" << m_cTable.MinimumBet() << std::endl;
+    osLog << "\tMaximum Wager:\t" << m_cTable.MaximumBet() << std::endl;
+    osLog << "\tBar:\t\t" << m_cTable.Bar() << std::endl;
+    if (m_cDice.TableModel())
+        osLog << "\tDice:\t\tBiased, sevens " << Percent(m_cDice.TableModel()->ValueProbability(7)) << std::endl;
+    if (m_cDice.SetterModel())
+        osLog << "\tDice setters:\t" << Percent(m_cDice.SetterShare()) << " of shooters, sevens " <<
+            Percent(m_cDice.SetterModel()->ValueProbability(7)) << std::endl;
+
+    osLog << "Strategies" << std::endl;
+    osLog << "\tNumber of strategies:\t" << m_vStrategies.size() << std::endl;
+    if (m_cPassLineKernel.Lanes() > 0)
+        osLog << "\tPass line lanes:\t" << m_cPassLineKernel.Lanes() << std::endl;
+
+    osLog << "Simulation" << std::endl;
+    osLog << "\tNumber of runs:\t" << nNumberOfRuns << std::endl;
+    if (bSequential || m_bRace)
+        osLog << "\tMaximum runs:\t" << nMaxRuns << std::endl;
+    if (m_bRace)
+        osLog << "\tRace survivors:\t" << m_nRaceSurvivors << std::endl;
+    if (bSequential)
+    {
+        osLog << "\tTarget CI width:\t" << m_dTargetCIWidth << (m_bDropOnTarget ? " (each Strategy)" : " (all Strategies)") << std::endl;
+    }
+    osLog << "\tSampling:\t" << m_cDice.Sampling() << std::endl;
+    if (pcPlayer)
+        osLog << "\tReplaying:\t" << pcPlayer->Path() << ", " << pcPlayer->Runs() << " runs" << std::endl;
+    if (m_cDice.Recorder())
+        osLog << "\tRecording:\t" << m_cDice.Recorder()->Path() << std::endl;
+    if (m_nShards > 0)
+        osLog << "\tShard:\t\t" << m_nShard << " of " << m_nShards << std::endl;
+    if (m_nSliceRuns >= 0)
+        osLog << "\tPlaying runs:\t" << m_nSliceFirstRun + 1 << " to " << m_nSliceFirstRun + m_nSliceRuns <<
+            " of " << nTotalRuns << std::endl;
+    if (!m_sResultCache.empty())
+        osLog << "\tResult cache:\t" << nCached << " of " << m_vStrategies.size() << " strategies cached" << std::endl;
+
+    if (bResumed)
+        osLog << "\tResumed:\t" << iii << " runs from " << m_sCheckpoint << std::endl;
+    else if (m_bResume)
+        osLog << "\tResumed:\tNo, " << m_sCheckpoint << " not found" << std::endl;
+
+    bool bLockstep = m_bLockstep && LockstepEligible();
+    if (m_bLockstep)
+        osLog << "\tLockstep:\t" << (bLockstep ? "Yes" : "No, using the common dice") << std::endl;
 
-    std::cout << "Strategies" << std::endl;
-    std::cout << "\tNumber of strategies:\t" << m_vStrategies.size() << std::endl;
+    osLog << "\nStarting Simulation" << std::endl;
 
-    std::cout << "Simulation" << std::endl;
-    std::cout << "\tNumber of runs:\t" << nNumberOfRuns << std::endl;
+    // Each Strategy plays its runs on lanes of its own, with its own dice
+    if (bLockstep)
+    {
+        for (std::vector<Strategy>::size_type jjj = 0; jjj < m_vStrategies.size(); ++jjj)
+        {
+            m_cLockstepEngine.Run(m_vStrategies[jjj], m_cTable, nNumberOfRuns, m_cDice);
 
-    std::cout << "\nStarting Simulation" << std::endl;
+            if (bTally) osLog << "\rCompleted " << jjj + 1 << " out of " << m_vStrategies.size() << " strategies" << std::flush;
+        }
+
+        osLog << std::endl;
+        return;
+    }
+
+    // Heap allocations and rolls at the end of the first run played
+    unsigned long long nFirstRunAllocations = 0;
+    long long nFirstRunRolls = 0;
+    const int nFirstRun = iii + 1;
+
+    // When the next checkpoint is due
+    std::chrono::steady_clock::time_point tNextCheckpoint =
+        std::chrono::steady_clock::now() + std::chrono::seconds(m_nCheckpointSeconds);
+
+    // Whether the stopping rule found the target met
+    bool bTargetMet = false;
 
     // Loop through the number of runs
-    for (int iii = 0; iii < nNumberOfRuns; ++iii)
+    while ((iii < nMaxRuns) && !m_vpActiveStrategies.empty())
     {
+        if (bSeedEachRun) m_cDice.Seed(m_nSeed, static_cast<unsigned>(m_nSliceFirstRun + iii));
+        m_cDice.NewRun();
+
         do
         {
             MakeBets();
             m_cDice.Roll();
-            QualifyTheShooter();
-            ResolveBets();
-            ModifyBets();
-            FinalizeBets();
-            m_cTable.Update(m_cDice);
         }
-        while (PlayersStillLeft());
+        while (PlayRoll());
 
         UpdateStatisticsAndReset();
+        ++iii;
+
+        if (iii == nFirstRun)
+        {
+            nFirstRunAllocations = AllocationCounter::Count();
+            nFirstRunRolls       = m_cDice.TotalRolls();
+        }
+
+        if (m_bRace && ((iii == nRoundEnd) || (iii == nMaxRuns)))
+        {
+            RaceRound(++nRound);
+
+            nRoundRuns *= 2;
+            nRoundEnd  += nRoundRuns;
+
+            if (static_cast<int>(m_vpActiveStrategies.size()) <= m_nRaceSurvivors)
+            {
+                if (bTally) Tally(iii, nMaxRuns);
+                break;
+            }
+        }
+
+        // The stopping rule also looks at the last run it may play
+        if ((iii % SIMULATION_BATCH_RUNS == 0) || (bSequential && (iii == nMaxRuns)))
+        {
+            bTargetMet = bSequential && (iii >= nNumberOfRuns) && TargetMet();
+
+            if (bTally) Tally(iii, nMaxRuns);
+
+            if (bTargetMet) break;
+        }
+
+        if (!m_sCheckpoint.empty() &&
+            (((m_nCheckpointRuns > 0) && (iii % m_nCheckpointRuns == 0)) ||
+             ((m_nCheckpointSeconds > 0) && (std::chrono::steady_clock::now() >= tNextCheckpoint))))
+        {
+            WriteCheckpoint(sCheckpointKey, iii, nRound, nRoundRuns, nRoundEnd);
+            tNextCheckpoint = std::chrono::steady_clock::now() + std::chrono::seconds(m_nCheckpointSeconds);
+        }
+    }
+
+    osLog << std::endl;
+
+    // The runs are done, so a later resume starts over
+    if (!m_sCheckpoint.empty()) std::remove(m_sCheckpoint.c_str());
+
+    if (m_cDice.Recorder())
+    {
+        m_cDice.FinishRecording();
+        osLog << "Recorded " << m_cDice.Recorder()->Rolls() << " rolls in " << m_cDice.Recorder()->Runs() <<
+            " runs to " << m_cDice.Recorder()->Path() << std::endl;
+    }
 
-        if (bTally)
-            if ((iii+1) % 100 == 0)
-                std::cout << "\rCompleted " << iii+1 << " out of " << nNumberOfRuns << " runs" << std::flush;
+    if (!m_sPartialResults.empty())
+    {
+        WritePartialResults(nTotalRuns);
+        osLog << "Partial results written to " << m_sPartialResults << std::endl;
     }
 
-    std::cout << std::endl;
+    // Store the results of the Strategies played
+    if (!m_sResultCache.empty())
+    {
+        ResultCache cCache(m_sResultCache);
+
+        for (std::vector<Strategy>::size_type jjj = 0; jjj < m_vStrategies.size(); ++jjj)
+        {
+            if (m_vbActive[jjj]) cCache.Store(vsCacheKeys[jjj], m_vStrategies[jjj].Results());
+        }
+    }
+
+    if (m_bRace)
+    {
+        osLog << "Race finished after " << nRound << " rounds and " << iii << " runs with " <<
+            m_vpActiveStrategies.size() << " survivors" << std::endl;
+    }
+
+    if (m_bCountAllocations)
+    {
+        unsigned long long nAllocations = AllocationCounter::Count() - nFirstRunAllocations;
+        long long nRolls = m_cDice.TotalRolls() - nFirstRunRolls;
+
+        osLog << "Heap allocations after the first run: " << nAllocations << " in " << nRolls << " rolls (" <<
+            (nRolls > 0 ? static_cast<double>(nAllocations) / nRolls : 0.0) << " per roll)" << std::endl;
+    }
+
+    if (bSequential)
+    {
+        if (bTargetMet)
+            osLog << "Target CI width met after " << iii << " runs" << std::endl;
+        else
+            osLog << "Target CI width not met after " << iii << " runs" << std::endl;
+    }
 }
 
 /**
-  * Make Bets.
+  * Record the rolls to a roll tape, and play the rolls of another in place
+  * of rolling.  The tape played is opened first, so that a tape that cannot
+  * be played leaves the tape to be recorded alone.
   *
-  * Loop through Strategies and direct them to make bets.  Bets are made if
-  * the shooter is qualified.
+  * \param sRecordPath The path of the roll tape recorded, empty if none.
+  * \param sReplayPath The path of the roll tape played, empty if none.
+  */
+
+void Simulation::SetRollTapes(const std::string &sRecordPath, const std::string &sReplayPath)
+{
+    if (!sReplayPath.empty()) m_cDice.ReplayRolls(sReplayPath);
+    if (!sRecordPath.empty()) m_cDice.RecordRolls(sRecordPath);
+}
+
+/**
+  * Check whether the runs can be played by the LockstepEngine.
   *
+  * The lanes of the LockstepEngine are independent runs with their own
+  * dice, so the Strategies must make only Pass and Pass Odds bets, and
+  * nothing may rely on the Strategies sharing a roll or on stopping or
+  * eliminating Strategies between runs, nor on the rolls of the common
+  * dice being recorded, played from a roll tape, or biased.
+  *
+  * \return True if the LockstepEngine can play the runs.
   */
 
-void Simulation::MakeBets()
+bool Simulation::LockstepEligible() const
 {
-    for (Strategy &cStrategy : m_vStrategies)
+    if (m_bPairedComparison || m_bRace || m_dTargetCIWidth > 0.0) return (false);
+    if (m_cDice.SamplingMethod() != DiceSampling::PLAIN) return (false);
+    if (m_cDice.Recorder() || m_cDice.Player() || !m_cDice.Fair()) return (false);
+
+    for (const Strategy &cStrategy : m_vStrategies)
     {
-        cStrategy.MakeBets(m_cTable);
+        if (!cStrategy.IsPassLineOnly()) return (false);
     }
 
+    return (true);
 }
 
 /**
-  * Resolve Bets.
+  * Check the Strategies against the target confidence interval width.
   *
-  * Loop through Strategies and direct them to resolve bets.
+  * With drop on target, each Strategy that meets the target leaves the set
+  * of active Strategies and plays no further runs.
   *
+  * \return True if every active Strategy meets the target.
   */
 
-void Simulation::ResolveBets()
+bool Simulation::TargetMet()
 {
-    for (Strategy &cStrategy : m_vStrategies)
+    bool bAllMet  = true;
+    bool bDropped = false;
+
+    for (std::vector<Strategy>::size_type iii = 0; iii < m_vStrategies.size(); ++iii)
     {
-        cStrategy.ResolveBets(m_cTable, m_cDice);
+        if (!m_vbActive[iii]) continue;
+
+        if (!m_vStrategies[iii].MeetsTarget(m_dTargetCIWidth))
+        {
+            bAllMet = false;
+        }
+        else if (m_bDropOnTarget)
+        {
+            m_vbActive[iii] = false;
+            bDropped = true;
+        }
     }
+
+    if (bDropped) UpdateActiveStrategies();
+
+    return (bAllMet);
 }
 
 /**
-  * Qualify The Shooter.
+  * Eliminate Strategies at the end of a racing round.
   *
-  * Loop through Strategies and direct them to qualify the shooter.
+  * A Strategy is eliminated when the upper bound of its win percentage
+  * confidence interval is below the lower bound of the k-th best active
+  * Strategy, where k is the number of survivors sought.  Because all
+  * Strategies play the same dice, every bound covers the same runs.
   *
+  * \param nRound The round just completed.
   */
 
-void Simulation::QualifyTheShooter()
+void Simulation::RaceRound(int nRound)
 {
-    for (Strategy &cStrategy : m_vStrategies)
+    std::vector<double> vdLowerBounds;
+    for (const Strategy *pcStrategy : m_vpActiveStrategies)
+    {
+        vdLowerBounds.push_back(pcStrategy->WinPercentage() - pcStrategy->WinCIWidth() / 2.0);
+    }
+
+    if (static_cast<int>(vdLowerBounds.size()) <= m_nRaceSurvivors) return;
+
+    // Find the k-th best lower bound
+    std::nth_element(vdLowerBounds.begin(), vdLowerBounds.begin() + (m_nRaceSurvivors - 1),
+                     vdLowerBounds.end(), std::greater<double>());
+    double dKthLowerBound = vdLowerBounds[m_nRaceSurvivors - 1];
+
+    for (std::vector<Strategy>::size_type iii = 0; iii < m_vStrategies.size(); ++iii)
+    {
+        if (!m_vbActive[iii]) continue;
+
+        const Strategy &cStrategy = m_vStrategies[iii];
+
+        if (cStrategy.WinPercentage() + cStrategy.WinCIWidth() / 2.0 < dKthLowerBound)
+        {
+            m_vbActive[iii]          = false;
+            m_vnEliminatedRound[iii] = nRound;
+        }
+    }
+
+    UpdateActiveStrategies();
+}
+
+/**
+  * Rebuild the active Strategies.
+  *
+  * The per roll loops run over pointers to the Strategies still playing.
+  * If enough of them make only Pass and Pass Odds bets, they are played
+  * together as lanes of the PassLineKernel and the rest one by one.
+  *
+  */
+
+void Simulation::UpdateActiveStrategies()
+{
+    m_vpActiveStrategies.clear();
+    m_vpScalarStrategies.clear();
+
+    std::vector<Strategy *> vpLanes;
+
+    for (std::vector<Strategy>::size_type iii = 0; iii < m_vStrategies.size(); ++iii)
+    {
+        if (!m_vbActive[iii]) continue;
+
+        m_vpActiveStrategies.push_back(&m_vStrategies[iii]);
+
+        if (m_vStrategies[iii].IsPassLineOnly())
+            vpLanes.push_back(&m_vStrategies[iii]);
+        else
+            m_vpScalarStrategies.push_back(&m_vStrategies[iii]);
+    }
+
+    if (vpLanes.size() < PASS_LINE_KERNEL_MIN_LANES)
     {
-        cStrategy.QualifyTheShooter(m_cTable, m_cDice);
+        m_vpScalarStrategies = m_vpActiveStrategies;
+        vpLanes.clear();
     }
+
+    m_cPassLineKernel.Initialize(vpLanes, m_cTable);
 }
 
 /**
-  * Modify Bets.
+  * Return the text of everything a Strategy's results depend on, apart
+  * from the version of CrapSim, which the ResultCache adds: the Strategy's
+  * fingerprint, the Table, the seed and the number of runs.
   *
-  * Loop through Strategies and direct them to modify their bets.
+  * \param cStrategy The Strategy.
+  * \param nRuns Number of simulation runs.
   *
+  * \return The key of the Strategy's results in the ResultCache.
   */
 
-void Simulation::ModifyBets()
+std::string Simulation::ResultCacheKey(const Strategy &cStrategy, int nRuns) const
 {
-    for (Strategy &cStrategy : m_vStrategies)
+    return (cStrategy.Fingerprint() +
+            "TableType=" + m_cTable.TableType() + "\n" +
+            "MinimumWager=" + std::to_string(m_cTable.MinimumBet()) + "\n" +
+            "MaximumWager=" + std::to_string(m_cTable.MaximumBet()) + "\n" +
+            "Bar=" + m_cTable.Bar() + "\n" +
+            "Seed=" + std::to_string(m_nSeed) + "\n" +
+            "Runs=" + std::to_string(nRuns) + "\n" +
+            (m_cDice.Fair() ? "" : "Dice=" + m_cDice.ModelFingerprint() + "\n"));
+}
+
+/**
+  * Ensure that each Strategy conforms to the Table.
+  */
+
+void Simulation::SanityCheckStrategies()
+{
+    std::ostream &osLog = *m_posLog;
+
+    osLog << "Sanity-checking the Strategies." << std::endl;
+    for (std::vector<Strategy>::iterator it = m_vStrategies.begin(); it != m_vStrategies.end(); ++it)
     {
-        cStrategy.ModifyBets(m_cTable);
+        it->SanityCheck(m_cTable, osLog);
     }
+    osLog << "Sanity-check complete." << std::endl;
+}
+
+/**
+  * Start merging the partial results of slices of the runs, such as
+  * shards, in place of running them.
+  *
+  * Each partial result holds the Strategies' results and the dice counts
+  * of a slice.  Every result in the report is a count, total, minimum or
+  * maximum, so the merged report is the report of all the slices' runs
+  * played in one process.  Slices may be merged in any order.
+  *
+  *\param nNumberOfRuns Number of simulation runs of all the slices.
+  */
+
+void Simulation::StartMerge(int nNumberOfRuns)
+{
+    SanityCheckStrategies();
+
+    m_sMergeKey  = PartialResultsKey(nNumberOfRuns);
+    m_nMergeRuns = nNumberOfRuns;
+    m_vMergedRuns.clear();
 }
 
 /**
-  * Finalize Bets.
+  * Merge the partial results of a slice.
   *
-  * Loop through Strategies and direct them to finalize their bets.
+  * Nothing is merged from partial results that are damaged, of another
+  * simulation, or of runs already merged.
+  *
+  *\param sBytes The partial results, as returned by PartialResults().
+  *\param sSource Where the partial results came from, for errors.
+  */
+
+void Simulation::MergePartialResults(const std::string &sBytes, const std::string &sSource)
+{
+    Checkpoint cPartial;
+    cPartial.FromBytes(sBytes, m_sMergeKey, sSource);
+
+    int nFirstRun = 0;
+    int nRuns     = 0;
+    cPartial.Get(nFirstRun);
+    cPartial.Get(nRuns);
+
+    if ((nFirstRun < 0) || (nRuns < 0) || (nFirstRun > m_nMergeRuns - nRuns))
+        throw CrapSimException("Simulation::MergePartialResults runs are not of this simulation", sSource);
+
+    for (const std::pair<int, int> &pRuns : m_vMergedRuns)
+    {
+        if ((nFirstRun < pRuns.first + pRuns.second) && (pRuns.first < nFirstRun + nRuns))
+            throw CrapSimException("Simulation::MergePartialResults runs merged twice, " +
+                std::to_string(nFirstRun + 1) + " to " + std::to_string(nFirstRun + nRuns) + ", in", sSource);
+    }
+
+    std::vector<StrategyResults> vResults(m_vStrategies.size());
+    for (StrategyResults &cResults : vResults)
+    {
+        cPartial.Get(cResults);
+    }
+
+    std::vector<long long> vnRollValues;
+    cPartial.Get(vnRollValues);
+    if (vnRollValues.size() != 2 * 6)
+        throw CrapSimException("Simulation::MergePartialResults partial results are damaged", sSource);
+
+    for (std::vector<Strategy>::size_type iii = 0; iii < m_vStrategies.size(); ++iii)
+    {
+        m_vStrategies[iii].MergeResults(vResults[iii]);
+    }
+
+    for (int iii = 1; iii <= 2 * 6; ++iii)
+    {
+        m_cDice.CountRolls(iii, vnRollValues[iii - 1]);
+    }
+
+    m_vMergedRuns.push_back(std::make_pair(nFirstRun, nRuns));
+}
+
+/**
+  * Return the number of runs merged so far.
   *
+  * \return The number of runs.
   */
 
-void Simulation::FinalizeBets()
+int Simulation::RunsMerged() const
 {
+    int nRuns = 0;
+    for (const std::pair<int, int> &pRuns : m_vMergedRuns)
+    {
+        nRuns += pRuns.second;
+    }
+
+    return (nRuns);
+}
+
+/**
+  * Finish merging: report the runs merged and any missing.
+  */
+
+void Simulation::FinishMerge()
+{
+    std::ostream &osLog = *m_posLog;
+
+    std::sort(m_vMergedRuns.begin(), m_vMergedRuns.end());
+
+    osLog << "Merged " << RunsMerged() << " of " << m_nMergeRuns << " runs" << std::endl;
+
+    int nNextRun = 0;
+    m_vMergedRuns.push_back(std::make_pair(m_nMergeRuns, 0));
+    for (const std::pair<int, int> &pRuns : m_vMergedRuns)
+    {
+        if (pRuns.first > nNextRun)
+            osLog << "\tRuns " << nNextRun + 1 << " to " << pRuns.first << " are missing" << std::endl;
+        nNextRun = pRuns.first + pRuns.second;
+    }
+    m_vMergedRuns.pop_back();
+}
+
+/**
+  * Merge the partial results files of shards.
+  *
+  *\param vsPaths The partial results files.
+  *\param nNumberOfRuns Number of simulation runs of all the shards.
+  */
+
+void Simulation::MergePartialResults(const std::vector<std::string> &vsPaths, int nNumberOfRuns)
+{
+    std::ostream &osLog = *m_posLog;
+
+    StartMerge(nNumberOfRuns);
+
+    for (const std::string &sPath : vsPaths)
+    {
+        std::ifstream ifsFile(sPath, std::ios::binary);
+        if (!ifsFile)
+            throw CrapSimException("Simulation::MergePartialResults cannot read", sPath);
+
+        MergePartialResults(std::string(std::istreambuf_iterator<char>(ifsFile), std::istreambuf_iterator<char>()), sPath);
+
+        osLog << "Merged runs " << m_vMergedRuns.back().first + 1 << " to " <<
+            m_vMergedRuns.back().first + m_vMergedRuns.back().second << " from " << sPath << std::endl;
+    }
+
+    FinishMerge();
+}
+
+/**
+  * Return the text of everything the state of the runs depends on: the
+  * Strategies, the Table, the number of runs and how the runs are played.
+  * The seed is left out, as the checkpoint holds the state of the dice.
+  *
+  * \param nRuns The number of runs.
+  *
+  * \return The key of the checkpoint.
+  */
+
+std::string Simulation::CheckpointKey(int nRuns) const
+{
+    std::string sKey;
+
+    for (const Strategy &cStrategy : m_vStrategies)
+    {
+        sKey += "Strategy=" + cStrategy.Name() + "\n" + cStrategy.Fingerprint();
+    }
+
+    return (sKey +
+            "TableType=" + m_cTable.TableType() + "\n" +
+            "MinimumWager=" + std::to_string(m_cTable.MinimumBet()) + "\n" +
+            "MaximumWager=" + std::to_string(m_cTable.MaximumBet()) + "\n" +
+            "Bar=" + m_cTable.Bar() + "\n" +
+            "Runs=" + std::to_string(nRuns) + "\n" +
+            "MaxRuns=" + std::to_string(m_nMaxRuns) + "\n" +
+            "Sampling=" + m_cDice.Sampling() + "\n" +
+            "TargetCIWidth=" + std::to_string(m_dTargetCIWidth) + (m_bDropOnTarget ? " Drop" : "") + "\n" +
+            "Race=" + (m_bRace ? std::to_string(m_nRaceSurvivors) : "No") + "\n" +
+            "Compare=" + (m_bPairedComparison ? "Yes " + m_sComparisonBaseline : "No") + "\n" +
+            "ResultCache=" + m_sResultCache + "\n" +
+            "ReplayRolls=" + (m_cDice.Player() ? m_cDice.Player()->Path() : "") + "\n" +
+            "Dice=" + m_cDice.ModelFingerprint() + "\n");
+}
+
+/**
+  * Return the text of everything the partial results of every shard
+  * depend on: that of a checkpoint, and the seed.
+  *
+  * \param nRuns The number of runs of all the shards.
+  *
+  * \return The key of the partial results.
+  */
+
+std::string Simulation::PartialResultsKey(int nRuns) const
+{
+    return (CheckpointKey(nRuns) + "Seed=" + std::to_string(m_nSeed) + "\n");
+}
+
+/**
+  * Put the results of the slice played, its runs, the Strategies' results
+  * and the dice counts.
+  *
+  * \param cPartial Where the results are put.
+  */
+
+void Simulation::SavePartialResults(Checkpoint &cPartial) const
+{
+    cPartial.Put(m_nSliceFirstRun);
+    cPartial.Put(m_nSliceRuns);
+
+    for (const Strategy &cStrategy : m_vStrategies)
+    {
+        cPartial.Put(cStrategy.Results());
+    }
+
+    std::vector<long long> vnRollValues;
+    for (int iii = 1; iii <= 2 * 6; ++iii)
+    {
+        vnRollValues.push_back(m_cDice.RollValueCount(iii));
+    }
+    cPartial.Put(vnRollValues);
+}
+
+/**
+  * Return the results of the slice played, to be merged with
+  * MergePartialResults().
+  *
+  * \param nRuns The number of runs of all the slices.
+  *
+  * \return The partial results.
+  */
+
+std::string Simulation::PartialResults(int nRuns) const
+{
+    Checkpoint cPartial;
+    SavePartialResults(cPartial);
+
+    return (cPartial.Bytes(PartialResultsKey(nRuns)));
+}
+
+/**
+  * Write the results of the shard to its partial results file.
+  *
+  * \param nRuns The number of runs of all the shards.
+  */
+
+void Simulation::WritePartialResults(int nRuns) const
+{
+    Checkpoint cPartial;
+    SavePartialResults(cPartial);
+
+    cPartial.Write(m_sPartialResults, PartialResultsKey(nRuns));
+}
+
+/**
+  * Write the state of the runs to the checkpoint file.
+  *
+  * \param sKey The key of the checkpoint.
+  * \param nRuns Runs completed.
+  * \param nRound Racing rounds completed.
+  * \param nRoundRuns Runs in the current racing round.
+  * \param nRoundEnd Run at which the current racing round ends.
+  */
+
+void Simulation::WriteCheckpoint(const std::string &sKey, int nRuns, int nRound, int nRoundRuns, int nRoundEnd) const
+{
+    Checkpoint cCheckpoint;
+
+    cCheckpoint.Put(nRuns);
+    cCheckpoint.Put(nRound);
+    cCheckpoint.Put(nRoundRuns);
+    cCheckpoint.Put(nRoundEnd);
+
+    m_cDice.Save(cCheckpoint);
+
+    for (const Strategy &cStrategy : m_vStrategies)
+    {
+        cCheckpoint.Put(cStrategy.Results());
+    }
+
+    cCheckpoint.Put(std::vector<char>(m_vbActive.begin(), m_vbActive.end()));
+    cCheckpoint.Put(m_vnEliminatedRound);
+
+    m_cPairedComparison.Save(cCheckpoint);
+    m_cSamplingEstimator.Save(cCheckpoint);
+
+    cCheckpoint.Write(m_sCheckpoint, sKey);
+}
+
+/**
+  * Read the state of the runs from the checkpoint file.
+  *
+  * \param sKey The key of the checkpoint.
+  * \param nRuns Runs completed.
+  * \param nRound Racing rounds completed.
+  * \param nRoundRuns Runs in the current racing round.
+  * \param nRoundEnd Run at which the current racing round ends.
+  *
+  * \return False if there is no checkpoint file.
+  */
+
+bool Simulation::ReadCheckpoint(const std::string &sKey, int &nRuns, int &nRound, int &nRoundRuns, int &nRoundEnd)
+{
+    Checkpoint cCheckpoint;
+
+    if (!cCheckpoint.Read(m_sCheckpoint, sKey)) return (false);
+
+    cCheckpoint.Get(nRuns);
+    cCheckpoint.Get(nRound);
+    cCheckpoint.Get(nRoundRuns);
+    cCheckpoint.Get(nRoundEnd);
+
+    m_cDice.Restore(cCheckpoint);
+
     for (Strategy &cStrategy : m_vStrategies)
     {
-        cStrategy.FinalizeBets();
+        StrategyResults cResults;
+        cCheckpoint.Get(cResults);
+        cStrategy.SetResults(cResults);
+    }
+
+    std::vector<char> vcActive;
+    cCheckpoint.Get(vcActive);
+    cCheckpoint.Get(m_vnEliminatedRound);
+
+    if ((vcActive.size() != m_vStrategies.size()) || (m_vnEliminatedRound.size() != m_vStrategies.size()))
+        throw CrapSimException("Simulation::ReadCheckpoint checkpoint is damaged", m_sCheckpoint);
+
+    m_vbActive.assign(vcActive.begin(), vcActive.end());
+
+    m_cPairedComparison.Restore(cCheckpoint);
+    m_cSamplingEstimator.Restore(cCheckpoint);
+
+    return (true);
+}
+
+/**
+  * Print the running tally.
+  *
+  * With a target confidence interval width, also show the number of active
+  * Strategies and the widest win percentage and bankroll intervals among them.
+  *
+  *\param nRuns Number of runs completed
+  *\param nMaxRuns Maximum number of runs
+  */
+
+void Simulation::Tally(int nRuns, int nMaxRuns) const
+{
+    std::ostream &osLog = *m_posLog;
+
+    osLog << "\rCompleted " << nRuns << " out of " << nMaxRuns << " runs";
+
+    if (m_dTargetCIWidth > 0.0)
+    {
+        double dWinCIWidth      = 0.0;
+        double dBankrollCIWidth = 0.0;
+
+        for (const Strategy *pcStrategy : m_vpActiveStrategies)
+        {
+            dWinCIWidth      = std::max(dWinCIWidth, pcStrategy->WinCIWidth());
+            dBankrollCIWidth = std::max(dBankrollCIWidth, pcStrategy->BankrollCIWidth());
+        }
+
+        std::ios_base::fmtflags fFlags = osLog.flags();
+        std::streamsize nPrecision     = osLog.precision();
+
+        osLog << ", " << m_vpActiveStrategies.size() << " of " << m_vStrategies.size() <<
+            " active, widest CI win " << std::fixed << std::setprecision(2) << dWinCIWidth <<
+            " bankroll " << dBankrollCIWidth << "%   ";
+
+        osLog.flags(fFlags);
+        osLog.precision(nPrecision);
+    }
+
+    osLog << std::flush;
+}
+
+/**
+  * Make Bets.
+  *
+  * Loop through Strategies and direct them to make bets.  Bets are made if
+  * the shooter is qualified.
+  *
+  */
+
+void Simulation::MakeBets()
+{
+    for (Strategy *pcStrategy : m_vpScalarStrategies)
+    {
+        pcStrategy->MakeBets(m_cTable);
     }
+
+    m_cPassLineKernel.MakeBets(m_cTable);
 }
 
 /**
-  * Check to see if players (Strategies) are still playing.
+  * Play the roll.
   *
-  * Loop through Strategies and check to see if they are still in the game.
+  * In one pass over the active Strategies, direct each to qualify the
+  * shooter, then resolve, modify and finalize its bets, and check whether
+  * it is still playing.  A Strategy only reads the Table and Dice, so
+  * taking each Strategy through every step before moving to the next
+  * gives the same result as a pass per step, while touching each Strategy
+  * once per roll.  Then play the roll in the pass line lanes, and update
+  * the Table.
   *
+  * \return True if any Strategy is still playing.
   */
 
-bool Simulation::PlayersStillLeft()
+bool Simulation::PlayRoll()
 {
     bool bPlayerStillLeft = false;
 
-    for (const Strategy &cStrategy : m_vStrategies)
+    for (Strategy *pcStrategy : m_vpScalarStrategies)
     {
-        bPlayerStillLeft = cStrategy.StillPlaying() || bPlayerStillLeft;
+        pcStrategy->QualifyTheShooter(m_cTable, m_cDice);
+        pcStrategy->ResolveBets(m_cTable, m_cDice);
+        pcStrategy->ModifyBets(m_cTable);
+        pcStrategy->FinalizeBets();
+
+        bPlayerStillLeft = pcStrategy->StillPlaying() || bPlayerStillLeft;
     }
 
+    bPlayerStillLeft = m_cPassLineKernel.PlayRoll(m_cTable, m_cDice) || bPlayerStillLeft;
+
+    m_cTable.Update(m_cDice);
+
     return (bPlayerStillLeft);
 }
 
 /**
   * Update stats and reset for a new simulation run.
   *
-  * Loop through Strategies, update stats and reset.
+  * Hand the pass line lanes' outcomes to their Strategies.  Loop through
+  * Strategies, update stats and reset.  If comparing Strategies or
+  * sampling the dice, capture each Strategy's run outcome before the reset.
   *
   */
 
 void Simulation::UpdateStatisticsAndReset()
 {
-    for (Strategy &cStrategy : m_vStrategies)
+    m_cPassLineKernel.Store();
+
+    if (m_bPairedComparison || m_cDice.SamplingMethod() != DiceSampling::PLAIN)
+    {
+        for (std::vector<Strategy>::size_type iii = 0; iii < m_vStrategies.size(); ++iii)
+        {
+            m_vRunOutcomes[iii].bPlayed   = m_vbActive[iii];
+            m_vRunOutcomes[iii].bWon      = m_vStrategies[iii].RunWon();
+            m_vRunOutcomes[iii].nBankroll = m_vStrategies[iii].Bankroll();
+            m_vRunOutcomes[iii].nRolls    = m_vStrategies[iii].Rolls();
+        }
+
+        if (m_bPairedComparison) m_cPairedComparison.Update(m_vRunOutcomes);
+        m_cSamplingEstimator.Update(m_vRunOutcomes, m_cDice.Stratum());
+    }
+
+    for (Strategy *pcStrategy : m_vpActiveStrategies)
     {
-        cStrategy.UpdateStatistics();
-        cStrategy.Reset();
+        pcStrategy->UpdateStatistics();
+        pcStrategy->Reset();
     }
 
+    m_cPassLineKernel.Reset();
     m_cTable.Reset();
 }
 
 /**
   * Print muster report.
   *
-  * Loop through Strategies and direct them to print a muster.
+  * Loop through Strategies and direct them to print a muster to the log.
   *
   */
 
 void Simulation::Muster()
 {
-    std::cout << "Muster" << std::endl;
+    std::ostream &osLog = *m_posLog;
+
+    osLog << "Muster" << std::endl;
 
     for (const Strategy &cStrategy : m_vStrategies)
     {
-        cStrategy.Muster();
+        cStrategy.Muster(osLog);
     }
 }
 
@@ -241,6 +1049,10 @@ void Simulation::Report()
         it->Report();
     }
 
+    if (m_bPairedComparison) m_cPairedComparison.Report();
+    if (m_bRace) RaceReport();
+    m_cSamplingEstimator.Report();
+
     std::cout << "\nDice History" << std::endl;
     for (int iii = 2; iii <= (2 * 6); ++iii)
     {
@@ -248,4 +1060,143 @@ void Simulation::Report()
             " times (" << m_cDice.RollValuePercentage(iii) << "%)" << std::endl;
     }
     std::cout << "\tTotal Rolls for all Simluations: " << m_cDice.TotalRolls() << std::endl;
+
+    // A shard's results, curves included, go to its partial results file
+    if (!m_sSurvivalCurve.empty() && (m_nShards == 0))
+    {
+        WriteSurvivalCurves();
+        std::cout << "\nSurvival curves written to " << m_sSurvivalCurve << std::endl;
+    }
+}
+
+/**
+  * Write the survival curve of each Strategy to a CSV file.
+  *
+  * For each bucket of rolls in which a run ended, one row gives the runs
+  * ended by the end of the bucket: bust, with significant winnings, or
+  * stopped at the roll limit; the chance of still being solvent after
+  * that many rolls; and the chance of still playing.  The curves are
+  * exact at the end of each bucket, and need only the buckets, not the
+  * runs, however many runs are played.
+  */
+
+void Simulation::WriteSurvivalCurves() const
+{
+    std::ofstream ofsCurves(m_sSurvivalCurve, std::ios::trunc);
+    if (!ofsCurves)
+    {
+        throw CrapSimException("Simulation::WriteSurvivalCurves cannot open", m_sSurvivalCurve);
+    }
+
+    ofsCurves << "Strategy,Rolls,Runs,Bust,Won,Stopped,Solvent,Playing\n";
+
+    for (const Strategy &cStrategy : m_vStrategies)
+    {
+        const StrategyResults &cResults = cStrategy.Results();
+        const long long nRuns = cResults.m_nTimesStrategyRun;
+        if (nRuns == 0) continue;
+
+        // Names are quoted, with quotes doubled
+        std::string sName("\"");
+        for (char c : cStrategy.Name())
+        {
+            sName += c;
+            if (c == '"') sName += c;
+        }
+        sName += "\"";
+
+        long long nBust    = 0;
+        long long nWon     = 0;
+        long long nStopped = 0;
+
+        for (int iii = 0; iii < SURVIVAL_CURVE_BUCKETS; ++iii)
+        {
+            const long long nBucketBust    = cResults.m_cSurvivalCurve.Count(SurvivalEvent::SE_BUST, iii);
+            const long long nBucketWon     = cResults.m_cSurvivalCurve.Count(SurvivalEvent::SE_WON, iii);
+            const long long nBucketStopped = cResults.m_cSurvivalCurve.Count(SurvivalEvent::SE_STOPPED, iii);
+            if (nBucketBust + nBucketWon + nBucketStopped == 0) continue;
+
+            nBust    += nBucketBust;
+            nWon     += nBucketWon;
+            nStopped += nBucketStopped;
+
+            ofsCurves << sName << "," << SurvivalCurve::BucketEnd(iii) << "," << nRuns << "," <<
+                nBust << "," << nWon << "," << nStopped << "," <<
+                1.0 - static_cast<double>(nBust) / nRuns << "," <<
+                1.0 - static_cast<double>(nBust + nWon + nStopped) / nRuns << "\n";
+        }
+    }
+
+    ofsCurves.close();
+    if (!ofsCurves)
+    {
+        throw CrapSimException("Simulation::WriteSurvivalCurves cannot write", m_sSurvivalCurve);
+    }
+}
+
+/**
+  * Print the race results.
+  *
+  * Rank survivors by win percentage, followed by the eliminated Strategies,
+  * latest eliminated first.
+  *
+  */
+
+void Simulation::RaceReport() const
+{
+    std::vector<std::vector<Strategy>::size_type> vnRanking;
+    for (std::vector<Strategy>::size_type iii = 0; iii < m_vStrategies.size(); ++iii)
+    {
+        vnRanking.push_back(iii);
+    }
+
+    std::stable_sort(vnRanking.begin(), vnRanking.end(),
+        [this](std::vector<Strategy>::size_type a, std::vector<Strategy>::size_type b)
+        {
+            int nRoundA = m_vnEliminatedRound[a] == 0 ? INT_MAX : m_vnEliminatedRound[a];
+            int nRoundB = m_vnEliminatedRound[b] == 0 ? INT_MAX : m_vnEliminatedRound[b];
+
+            if (nRoundA != nRoundB) return (nRoundA > nRoundB);
+
+            return (m_vStrategies[a].WinPercentage() > m_vStrategies[b].WinPercentage());
+        });
+
+    std::ios_base::fmtflags fFlags = std::cout.flags();
+    std::streamsize nPrecision     = std::cout.precision();
+
+    std::cout << "\nRace Results (95% confidence)" << std::endl;
+
+    std::cout << std::setw(5)  << std::right << "Rank" <<
+        std::setw(40) << std::right << "Name " <<
+        std::setw(8)  << std::right << "Runs" <<
+        std::setw(9)  << std::right << "Win %" <<
+        std::setw(8)  << std::right << "+/-" <<
+        std::setw(10) << std::right << "Bankroll" <<
+        "  Status" <<
+        std::endl;
+
+    int nRank = 0;
+    for (std::vector<Strategy>::size_type iii : vnRanking)
+    {
+        const Strategy &cStrategy = m_vStrategies[iii];
+
+        std::cout << std::setw(5) << std::right << ++nRank <<
+            std::setw(39) << std::right << cStrategy.Name() << " " <<
+            std::setw(8)  << std::right << cStrategy.Runs() <<
+            std::fixed << std::setprecision(2) <<
+            std::setw(9)  << std::right << cStrategy.WinPercentage() <<
+            std::setw(8)  << std::right << cStrategy.WinCIWidth() / 2.0 <<
+            std::setprecision(1) <<
+            std::setw(10) << std::right << cStrategy.MeanBankroll() << "  ";
+
+        if (m_vnEliminatedRound[iii] == 0)
+            std::cout << "Survivor";
+        else
+            std::cout << "Eliminated in round " << m_vnEliminatedRound[iii];
+
+        std::cout << std::endl;
+    }
+
+    std::cout.flags(fFlags);
+    std::cout.precision(nPrecision);
 }
@@ -0,0 +1,707 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SimulationCluster.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+// Return bytes as hex digits
+static std::string ToHex(const std::string &sBytes)
+{
+    static const char acHex[] = "0123456789abcdef";
+
+    std::string sHex;
+    sHex.reserve(2 * sBytes.size());
+    for (unsigned char c : sBytes)
+    {
+        sHex += acHex[c >> 4];
+        sHex += acHex[c & 0xf];
+    }
+
+    return (sHex);
+}
+
+// Return the value of a hex digit, -1 if not one
+static int HexDigit(char c)
+{
+    if ((c >= '0') && (c <= '9')) return (c - '0');
+    if ((c >= 'a') && (c <= 'f')) return (c - 'a' + 10);
+    if ((c >= 'A') && (c <= 'F')) return (c - 'A' + 10);
+
+    return (-1);
+}
+
+// Return the bytes written as hex digits
+static std::string FromHex(const std::string &sHex)
+{
+    if (sHex.size() % 2 != 0)
+        throw CrapSimException("SimulationCluster partial results are not hex");
+
+    std::string sBytes;
+    sBytes.reserve(sHex.size() / 2);
+    for (std::string::size_type iii = 0; iii < sHex.size(); iii += 2)
+    {
+        int nHigh = HexDigit(sHex[iii]);
+        int nLow  = HexDigit(sHex[iii + 1]);
+        if ((nHigh < 0) || (nLow < 0))
+            throw CrapSimException("SimulationCluster partial results are not hex");
+
+        sBytes += static_cast<char>((nHigh << 4) | nLow);
+    }
+
+    return (sBytes);
+}
+
+// Return the token shared by the coordinator and workers
+static std::string Token(const std::string &sLoc)
+{
+    const char *pcToken = std::getenv(CLUSTER_TOKEN_VARIABLE);
+    std::string sToken(pcToken == nullptr ? "" : pcToken);
+
+    if (sToken.empty())
+        throw CrapSimException(sLoc + " needs a token in the environment variable", CLUSTER_TOKEN_VARIABLE);
+
+    return (sToken);
+}
+
+// Return the SHA-256 digest of bytes (FIPS 180-4)
+static std::string Sha256(const std::string &sBytes)
+{
+    static const uint32_t anK[64] =
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    uint32_t anHash[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+    // Pad to a whole number of 64 byte blocks, ending with the length in bits
+    std::string sPadded(sBytes);
+    sPadded += static_cast<char>(0x80);
+    while (sPadded.size() % 64 != 56) sPadded += static_cast<char>(0);
+    uint64_t nBits = static_cast<uint64_t>(sBytes.size()) * 8;
+    for (int iii = 7; iii >= 0; --iii)
+    {
+        sPadded += static_cast<char>((nBits >> (8 * iii)) & 0xff);
+    }
+
+    auto Rotate = [](uint32_t n, int nBy) { return ((n >> nBy) | (n << (32 - nBy))); };
+
+    for (std::string::size_type nBlock = 0; nBlock < sPadded.size(); nBlock += 64)
+    {
+        uint32_t anW[64];
+        for (int iii = 0; iii < 16; ++iii)
+        {
+            const unsigned char *pcWord = reinterpret_cast<const unsigned char *>(sPadded.data() + nBlock + 4 * iii);
+            anW[iii] = (static_cast<uint32_t>(pcWord[0]) << 24) | (static_cast<uint32_t>(pcWord[1]) << 16) |
+                       (static_cast<uint32_t>(pcWord[2]) << 8) | static_cast<uint32_t>(pcWord[3]);
+        }
+        for (int iii = 16; iii < 64; ++iii)
+        {
+            uint32_t nS0 = Rotate(anW[iii - 15], 7) ^ Rotate(anW[iii - 15], 18) ^ (anW[iii - 15] >> 3);
+            uint32_t nS1 = Rotate(anW[iii - 2], 17) ^ Rotate(anW[iii - 2], 19) ^ (anW[iii - 2] >> 10);
+            anW[iii] = anW[iii - 16] + nS0 + anW[iii - 7] + nS1;
+        }
+
+        uint32_t a = anHash[0], b = anHash[1], c = anHash[2], d = anHash[3];
+        uint32_t e = anHash[4], f = anHash[5], g = anHash[6], h = anHash[7];
+        for (int iii = 0; iii < 64; ++iii)
+        {
+            uint32_t nT1 = h + (Rotate(e, 6) ^ Rotate(e, 11) ^ Rotate(e, 25)) + ((e & f) ^ (~e & g)) + anK[iii] + anW[iii];
+            uint32_t nT2 = (Rotate(a, 2) ^ Rotate(a, 13) ^ Rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + nT1;
+            d = c; c = b; b = a; a = nT1 + nT2;
+        }
+
+        anHash[0] += a; anHash[1] += b; anHash[2] += c; anHash[3] += d;
+        anHash[4] += e; anHash[5] += f; anHash[6] += g; anHash[7] += h;
+    }
+
+    std::string sDigest;
+    for (uint32_t nWord : anHash)
+    {
+        for (int iii = 3; iii >= 0; --iii)
+        {
+            sDigest += static_cast<char>((nWord >> (8 * iii)) & 0xff);
+        }
+    }
+
+    return (sDigest);
+}
+
+// Return the HMAC-SHA-256 of a message under a key (RFC 2104), in hex
+static std::string Hmac(const std::string &sKey, const std::string &sMessage)
+{
+    std::string sBlockKey = (sKey.size() > 64) ? Sha256(sKey) : sKey;
+    sBlockKey.resize(64, static_cast<char>(0));
+
+    std::string sInner(sBlockKey);
+    std::string sOuter(sBlockKey);
+    for (int iii = 0; iii < 64; ++iii)
+    {
+        sInner[iii] ^= 0x36;
+        sOuter[iii] ^= 0x5c;
+    }
+
+    return (ToHex(Sha256(sOuter + Sha256(sInner + sMessage))));
+}
+
+// Return a fresh challenge, random hex digits
+static std::string Challenge()
+{
+    std::random_device cRandom;
+    std::string sBytes;
+    for (int iii = 0; iii < 16; ++iii)
+    {
+        sBytes += static_cast<char>(cRandom() & 0xff);
+    }
+
+    return (ToHex(sBytes));
+}
+
+// Return the proof that a side, coordinator or worker, holds the token,
+// bound to both challenges of a connection
+static std::string Proof(const std::string &sToken, const std::string &sSide,
+                         const std::string &sCoordinatorChallenge, const std::string &sWorkerChallenge)
+{
+    return (Hmac(sToken, sSide + " " + sCoordinatorChallenge + " " + sWorkerChallenge));
+}
+
+// Compare proofs in a time that does not tell how much of them matches
+static bool SameProof(const std::string &sProof, const std::string &sSent)
+{
+    unsigned char cDiffer = (sProof.size() == sSent.size()) ? 0 : 1;
+    for (std::string::size_type iii = 0; iii < sProof.size(); ++iii)
+    {
+        cDiffer |= sProof[iii] ^ (iii < sSent.size() ? sSent[iii] : 0);
+    }
+
+    return (cDiffer == 0);
+}
+
+/**
+  * Construct a SimulationCluster.
+  *
+  * \param cSim The Simulation, with its Strategies, into which the results are merged.
+  * \param sConfig The text of the configuration file the Simulation was set up from.
+  * \param nRuns The number of runs.
+  * \param nSeed The seed of the runs.
+  * \param sAddress The TCP port the workers connect to, after the address
+  *        to listen on and a colon if not the loopback interface.
+  */
+
+SimulationCluster::SimulationCluster(Simulation &cSim, std::string sConfig, int nRuns, int nSeed, const std::string &sAddress) :
+    m_cSim(cSim),
+    m_sConfig(sConfig),
+    m_nRuns(nRuns),
+    m_nSeed(nSeed),
+    m_sHost("127.0.0.1"),
+    m_sPort(sAddress)
+{
+    std::string::size_type nColon = sAddress.rfind(':');
+    if (nColon != std::string::npos)
+    {
+        m_sHost = sAddress.substr(0, nColon);
+        m_sPort = sAddress.substr(nColon + 1);
+
+        // An IPv6 address is written in brackets, e.g., [::1]:4000
+        if ((m_sHost.size() >= 2) && (m_sHost.front() == '[') && (m_sHost.back() == ']'))
+            m_sHost = m_sHost.substr(1, m_sHost.size() - 2);
+        if (m_sHost.empty())
+            throw CrapSimException("SimulationCluster::SimulationCluster address must be [address:]port", sAddress);
+    }
+
+    if (m_sPort.empty() || (m_sPort.size() > 5) || (m_sPort.find_first_not_of("0123456789") != std::string::npos) ||
+        (std::atoi(m_sPort.c_str()) < 1) || (std::atoi(m_sPort.c_str()) > 65535))
+        throw CrapSimException("SimulationCluster::SimulationCluster port must be 1 to 65535", m_sPort);
+
+    m_sToken = Token("SimulationCluster::SimulationCluster");
+}
+
+/**
+  * Wait for the next batch of runs for a worker.
+  *
+  * A batch handed out before, to a worker that went, comes first.
+  * Otherwise a batch is sized to take the worker about
+  * CLUSTER_BATCH_SECONDS, but is no more than half the runs left shared by
+  * the workers, so that the last batches are small and the workers finish
+  * together.  A worker's first batch is SIMULATION_BATCH_RUNS.
+  *
+  * \param dSecondsPerRun Seconds the worker took for a run, 0 if not known.
+  * \param cBatch The batch.
+  *
+  * \return False once the runs are done or failed.
+  */
+
+bool SimulationCluster::NextBatch(double dSecondsPerRun, Batch &cBatch)
+{
+    std::unique_lock<std::mutex> lock(m_mtxRuns);
+    m_cvRuns.wait(lock, [this] { return (m_bDone || !m_dqReissued.empty() || (m_nNextRun < m_nRuns)); });
+
+    if (m_bDone) return (false);
+
+    if (!m_dqReissued.empty())
+    {
+        cBatch = m_dqReissued.front();
+        m_dqReissued.pop_front();
+        return (true);
+    }
+
+    int nRunsLeft = m_nRuns - m_nNextRun;
+    int nRuns     = SIMULATION_BATCH_RUNS;
+
+    if (dSecondsPerRun > 0.0)
+        nRuns = static_cast<int>(std::min(CLUSTER_BATCH_SECONDS / dSecondsPerRun, static_cast<double>(INT_MAX)));
+
+    nRuns = std::min(nRuns, nRunsLeft / (2 * std::max(m_nWorkers, 1)));
+    nRuns = std::min(std::max(nRuns, CLUSTER_MIN_BATCH_RUNS), nRunsLeft);
+
+    cBatch.nFirstRun = m_nNextRun;
+    cBatch.nRuns     = nRuns;
+    m_nNextRun      += nRuns;
+
+    return (true);
+}
+
+#ifndef _WIN32
+
+/**
+  * Coordinate the runs.
+  *
+  * Listen on the port and serve each worker that connects on a thread of
+  * its own, until every run is merged or a worker reports an error.
+  *
+  * \param bTally Print the runs merged as they come.
+  */
+
+void SimulationCluster::Coordinate(bool bTally)
+{
+    // A worker that goes away must not stop the coordinator
+    signal(SIGPIPE, SIG_IGN);
+
+    m_cSim.StartMerge(m_nRuns);
+    m_bTally = bTally;
+
+    struct addrinfo stHints;
+    std::memset(&stHints, 0, sizeof(stHints));
+    stHints.ai_family   = AF_UNSPEC;
+    stHints.ai_socktype = SOCK_STREAM;
+    stHints.ai_flags    = AI_PASSIVE | AI_NUMERICSERV;
+
+    struct addrinfo *pstAddresses = nullptr;
+    int nError = getaddrinfo(m_sHost.c_str(), m_sPort.c_str(), &stHints, &pstAddresses);
+    if (nError != 0)
+        throw CrapSimException("SimulationCluster::Coordinate cannot resolve " + m_sHost, gai_strerror(nError));
+
+    int nListen = socket(pstAddresses->ai_family, pstAddresses->ai_socktype, pstAddresses->ai_protocol);
+    if (nListen < 0)
+    {
+        freeaddrinfo(pstAddresses);
+        throw CrapSimException("SimulationCluster::Coordinate cannot create socket", std::strerror(errno));
+    }
+
+    int nOn = 1;
+    setsockopt(nListen, SOL_SOCKET, SO_REUSEADDR, &nOn, sizeof(nOn));
+
+    bool bListening = (bind(nListen, pstAddresses->ai_addr, pstAddresses->ai_addrlen) == 0) &&
+                      (listen(nListen, SOMAXCONN) == 0);
+    freeaddrinfo(pstAddresses);
+    if (!bListening)
+    {
+        int nErrno = errno;
+        close(nListen);
+        throw CrapSimException("SimulationCluster::Coordinate cannot listen on " + m_sHost + " port " + m_sPort, std::strerror(nErrno));
+    }
+
+    std::cout << "Coordinating " << m_nRuns << " runs on " << m_sHost << " port " << m_sPort << std::endl;
+
+    int nRunsTallied = -1;
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mtxRuns);
+            if (m_bDone) break;
+
+            if (bTally && (m_cSim.RunsMerged() != nRunsTallied))
+            {
+                nRunsTallied = m_cSim.RunsMerged();
+                std::cout << "\rCompleted " << nRunsTallied << " out of " << m_nRuns << " runs on " <<
+                    m_nWorkers << " workers" << std::flush;
+            }
+        }
+
+        struct pollfd stPoll;
+        stPoll.fd     = nListen;
+        stPoll.events = POLLIN;
+        if (poll(&stPoll, 1, 250) <= 0) continue;
+
+        struct sockaddr_storage stWorker;
+        socklen_t nLength = sizeof(stWorker);
+        int nFd = accept(nListen, reinterpret_cast<struct sockaddr *>(&stWorker), &nLength);
+        if (nFd < 0) continue;
+
+        char acHost[NI_MAXHOST];
+        char acPort[NI_MAXSERV];
+        std::string sWorker("worker");
+        if (getnameinfo(reinterpret_cast<struct sockaddr *>(&stWorker), nLength, acHost, sizeof(acHost),
+                        acPort, sizeof(acPort), NI_NUMERICHOST | NI_NUMERICSERV) == 0)
+            sWorker = std::string(acHost) + ":" + acPort;
+
+        int nNoDelay = 1;
+        setsockopt(nFd, IPPROTO_TCP, TCP_NODELAY, &nNoDelay, sizeof(nNoDelay));
+
+        {
+            std::lock_guard<std::mutex> lock(m_mtxRuns);
+            ++m_nWorkers;
+            m_vnSockets.push_back(nFd);
+        }
+
+        m_vThreads.emplace_back(&SimulationCluster::ServeWorker, this, nFd, sWorker);
+    }
+
+    close(nListen);
+
+    // Tell the workers, and wait for the threads serving them
+    {
+        std::lock_guard<std::mutex> lock(m_mtxRuns);
+        for (int nFd : m_vnSockets)
+        {
+            shutdown(nFd, SHUT_RDWR);
+        }
+    }
+    m_cvRuns.notify_all();
+
+    for (std::thread &cThread : m_vThreads)
+    {
+        cThread.join();
+    }
+    for (int nFd : m_vnSockets)
+    {
+        close(nFd);
+    }
+
+    if (bTally) std::cout << "\rCompleted " << m_cSim.RunsMerged() << " out of " << m_nRuns << " runs" << std::endl;
+
+    if (!m_sError.empty())
+        throw CrapSimException("SimulationCluster::Coordinate", m_sError);
+
+    m_cSim.FinishMerge();
+}
+
+/**
+  * Serve a worker.
+  *
+  * Send the worker a challenge, and drop it unless it answers within
+  * CLUSTER_TIMEOUT_SECONDS with a challenge of its own and the proof that
+  * it holds the token; then prove the coordinator holds it too.  Hand the
+  * worker a batch at a time and merge its results.  If the worker goes, or
+  * takes CLUSTER_TIMEOUT_FACTOR times longer than expected and at least
+  * CLUSTER_TIMEOUT_SECONDS, its batch is handed out again and the worker
+  * dropped.
+  *
+  * \param nFd The connection to the worker.
+  * \param sWorker The worker's address.
+  */
+
+void SimulationCluster::ServeWorker(int nFd, std::string sWorker)
+{
+    std::string sBuffer;
+    double dSecondsPerRun = 0.0;
+    Batch cBatch;
+
+    struct timeval stTimeout;
+    stTimeout.tv_sec  = CLUSTER_TIMEOUT_SECONDS;
+    stTimeout.tv_usec = 0;
+    setsockopt(nFd, SOL_SOCKET, SO_RCVTIMEO, &stTimeout, sizeof(stTimeout));
+
+    // The worker answers with its challenge and its proof
+    const std::string sChallenge = Challenge();
+    std::string sAnswer;
+    bool bJoined = SimulationServer::WriteAll(nFd, sChallenge + "\n") &&
+                   SimulationServer::ReadLine(nFd, sBuffer, sAnswer, CLUSTER_MAX_HANDSHAKE_LENGTH);
+
+    std::string::size_type nSpace = sAnswer.find(' ');
+    bJoined = bJoined && (nSpace != std::string::npos) &&
+              SameProof(Proof(m_sToken, "worker", sChallenge, sAnswer.substr(0, nSpace)), sAnswer.substr(nSpace + 1)) &&
+              SimulationServer::WriteAll(nFd, Proof(m_sToken, "coordinator", sChallenge, sAnswer.substr(0, nSpace)) + "\n");
+
+    if (!bJoined)
+    {
+        // A worker joining as the runs finish is cut off by the shutdown,
+        // not refused
+        std::lock_guard<std::mutex> lock(m_mtxRuns);
+        if (!m_bDone)
+            std::cout << (m_bTally ? "\n" : "") << "Refused " << sWorker << ", which did not prove it holds the token" << std::endl;
+    }
+
+    while (bJoined && NextBatch(dSecondsPerRun, cBatch))
+    {
+        SimulationJob cJob;
+        cJob.sId       = "runs" + std::to_string(cBatch.nFirstRun + 1) + "-" + std::to_string(cBatch.nFirstRun + cBatch.nRuns);
+        cJob.sConfig   = m_sConfig;
+        cJob.nRuns     = m_nRuns;
+        cJob.nSeed     = m_nSeed;
+        cJob.nFirstRun = cBatch.nFirstRun;
+        cJob.nRunCount = cBatch.nRuns;
+
+        stTimeout.tv_sec  = std::max(CLUSTER_TIMEOUT_SECONDS,
+                                     static_cast<int>(std::min(CLUSTER_TIMEOUT_FACTOR * dSecondsPerRun * cBatch.nRuns, static_cast<double>(INT_MAX))));
+        stTimeout.tv_usec = 0;
+        setsockopt(nFd, SOL_SOCKET, SO_RCVTIMEO, &stTimeout, sizeof(stTimeout));
+
+        std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+
+        std::string sResult;
+        bool bAnswered = SimulationServer::WriteAll(nFd, SimulationServer::FormatJob(cJob) + "\n") &&
+                         SimulationServer::ReadLine(nFd, sBuffer, sResult);
+
+        std::chrono::duration<double> dSeconds = std::chrono::steady_clock::now() - tStart;
+
+        std::lock_guard<std::mutex> lock(m_mtxRuns);
+
+        if (m_bDone) break;
+
+        if (!bAnswered)
+        {
+            m_dqReissued.push_back(cBatch);
+            m_cvRuns.notify_all();
+            std::cout << (m_bTally ? "\n" : "") << "Lost " << sWorker << ", handing out runs " << cBatch.nFirstRun + 1 << " to " <<
+                cBatch.nFirstRun + cBatch.nRuns << " again" << std::endl;
+            break;
+        }
+
+        try
+        {
+            std::string sId;
+            std::string sStatus;
+            std::string sText;
+            SimulationServer::ParseResult(sResult, sId, sStatus, sText);
+
+            if (sStatus != "done")
+                throw CrapSimException("worker " + sWorker + " failed:", sText);
+            if (sId != cJob.sId)
+                throw CrapSimException("worker " + sWorker + " answered the wrong batch", sId);
+
+            m_cSim.MergePartialResults(FromHex(sText), sWorker);
+        }
+        catch (const CrapSimException &e)
+        {
+            m_sError = std::string(e.what()) + " " + e.m_sArg;
+            m_bDone  = true;
+            m_cvRuns.notify_all();
+            break;
+        }
+
+        if (m_cSim.RunsMerged() == m_nRuns)
+        {
+            m_bDone = true;
+            m_cvRuns.notify_all();
+        }
+
+        dSecondsPerRun = dSeconds.count() / cBatch.nRuns;
+    }
+
+    // Tell the worker the coordinator is done with it
+    shutdown(nFd, SHUT_RDWR);
+
+    std::lock_guard<std::mutex> lock(m_mtxRuns);
+    --m_nWorkers;
+}
+
+// Connect to host:port, -1 if it cannot be reached
+static int Connect(const std::string &sHost, const std::string &sPort)
+{
+    struct addrinfo stHints;
+    std::memset(&stHints, 0, sizeof(stHints));
+    stHints.ai_family   = AF_UNSPEC;
+    stHints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo *pstAddresses = nullptr;
+    if (getaddrinfo(sHost.c_str(), sPort.c_str(), &stHints, &pstAddresses) != 0) return (-1);
+
+    int nFd = -1;
+    for (struct addrinfo *pstAddress = pstAddresses; pstAddress != nullptr; pstAddress = pstAddress->ai_next)
+    {
+        nFd = socket(pstAddress->ai_family, pstAddress->ai_socktype, pstAddress->ai_protocol);
+        if (nFd < 0) continue;
+
+        if (connect(nFd, pstAddress->ai_addr, pstAddress->ai_addrlen) == 0) break;
+
+        close(nFd);
+        nFd = -1;
+    }
+
+    freeaddrinfo(pstAddresses);
+
+    return (nFd);
+}
+
+/**
+  * Run as a worker.
+  *
+  * Connect to the coordinator, waiting until it can be reached.  Answer
+  * its challenge with a challenge of the worker's and the proof that the
+  * worker holds the token, and leave unless the coordinator proves it holds
+  * the token too; the token itself is never sent.  Play the batches the
+  * coordinator sends, one at a time, until it goes; then wait for the next
+  * coordinator at the same address.
+  *
+  * \param sAddress The coordinator's address, host:port.
+  * \param fPlayBatch Plays a batch and returns its partial results.
+  *
+  * \return The exit status.
+  */
+
+int SimulationCluster::Work(const std::string &sAddress, const BatchFunction &fPlayBatch)
+{
+    std::string::size_type nColon = sAddress.rfind(':');
+    if ((nColon == std::string::npos) || (nColon == 0) || (nColon == sAddress.size() - 1))
+        throw CrapSimException("SimulationCluster::Work address must be host:port", sAddress);
+
+    const std::string sHost  = sAddress.substr(0, nColon);
+    const std::string sPort  = sAddress.substr(nColon + 1);
+    const std::string sToken = Token("SimulationCluster::Work");
+
+    // A coordinator that goes away must not stop the worker
+    signal(SIGPIPE, SIG_IGN);
+
+    bool bWaiting = false;
+
+    while (true)
+    {
+        int nFd = Connect(sHost, sPort);
+        if (nFd < 0)
+        {
+            if (!bWaiting) std::cerr << "Waiting for the coordinator at " << sAddress << std::endl;
+            bWaiting = true;
+
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        bWaiting = false;
+
+        std::string sBuffer;
+        std::string sLine;
+
+        struct timeval stTimeout;
+        stTimeout.tv_sec  = CLUSTER_TIMEOUT_SECONDS;
+        stTimeout.tv_usec = 0;
+        setsockopt(nFd, SOL_SOCKET, SO_RCVTIMEO, &stTimeout, sizeof(stTimeout));
+
+        const std::string sChallenge = Challenge();
+        std::string sCoordinatorChallenge;
+        bool bAnswered = SimulationServer::ReadLine(nFd, sBuffer, sCoordinatorChallenge, CLUSTER_MAX_HANDSHAKE_LENGTH) &&
+                         SimulationServer::WriteAll(nFd, sChallenge + " " +
+                                                    Proof(sToken, "worker", sCoordinatorChallenge, sChallenge) + "\n") &&
+                         SimulationServer::ReadLine(nFd, sBuffer, sLine, CLUSTER_MAX_HANDSHAKE_LENGTH);
+
+        if (!bAnswered || !SameProof(Proof(sToken, "coordinator", sCoordinatorChallenge, sChallenge), sLine))
+        {
+            // A coordinator finishing its runs, or holding another token,
+            // closes the connection without answering
+            close(nFd);
+            if (bAnswered)
+                std::cerr << "Left the coordinator at " << sAddress << ", which did not prove it holds the token" << std::endl;
+
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        // Batches come as the coordinator has them
+        stTimeout.tv_sec = 0;
+        setsockopt(nFd, SOL_SOCKET, SO_RCVTIMEO, &stTimeout, sizeof(stTimeout));
+
+        std::cerr << "Joined the coordinator at " << sAddress << std::endl;
+
+        while (SimulationServer::ReadLine(nFd, sBuffer, sLine))
+        {
+            std::string sResult;
+
+            try
+            {
+                SimulationJob cJob = SimulationServer::ParseJob(sLine);
+
+                try
+                {
+                    sResult = SimulationServer::FormatResult(cJob.sId, "done", "output", ToHex(fPlayBatch(cJob)));
+                }
+                catch (const CrapSimException &e)
+                {
+                    sResult = SimulationServer::FormatResult(cJob.sId, "error", "error", std::string(e.what()) + " " + e.m_sArg);
+                }
+                catch (const std::exception &e)
+                {
+                    sResult = SimulationServer::FormatResult(cJob.sId, "error", "error", e.what());
+                }
+            }
+            catch (const CrapSimException &e)
+            {
+                sResult = SimulationServer::FormatResult("", "error", "error", std::string(e.what()) + " " + e.m_sArg);
+            }
+
+            if (!SimulationServer::WriteAll(nFd, sResult + "\n")) break;
+        }
+
+        close(nFd);
+        std::cerr << "Left the coordinator at " << sAddress << std::endl;
+    }
+}
+
+#else
+
+void SimulationCluster::Coordinate(bool)
+{
+    throw CrapSimException("SimulationCluster::Coordinate not supported on Windows");
+}
+
+void SimulationCluster::ServeWorker(int, std::string) {}
+
+int SimulationCluster::Work(const std::string &, const BatchFunction &)
+{
+    throw CrapSimException("SimulationCluster::Work not supported on Windows");
+}
+
+#endif // _WIN32
@@ -0,0 +1,814 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "SimulationServer.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include "TemporaryFile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+  * A connection to the server.
+  *
+  * The connection stays open until it is closed for reading and the last of
+  * its jobs has been answered, so it is shared by its reader and its jobs.
+  */
+
+struct ServerClient
+{
+    int        nFd {-1};
+    std::mutex mtxWrite;
+
+    explicit ServerClient(int n) : nFd(n) {}
+    ServerClient(const ServerClient &) = delete;
+    ServerClient& operator=(const ServerClient &) = delete;
+#ifndef _WIN32
+    ~ServerClient() { close(nFd); }
+#endif
+
+    // Send a line, whole, unless the client has gone
+    void Send(const std::string &sLine);
+};
+
+#ifndef _WIN32
+
+/**
+  * Write all of a string to a descriptor.
+  *
+  * \param nFd The descriptor.
+  * \param sText The string.
+  *
+  * \return False if the other end has gone.
+  */
+
+bool SimulationServer::WriteAll(int nFd, const std::string &sText)
+{
+    std::string::size_type nWritten = 0;
+    while (nWritten < sText.size())
+    {
+        ssize_t nBytes = write(nFd, sText.data() + nWritten, sText.size() - nWritten);
+        if (nBytes < 0)
+        {
+            if (errno == EINTR) continue;
+            return (false);
+        }
+        nWritten += nBytes;
+    }
+
+    return (true);
+}
+
+/**
+  * Read the next line from a descriptor.
+  *
+  * \param nFd The descriptor.
+  * \param sBuffer Read but not yet returned, kept from call to call.
+  * \param sLine The line, without its newline.
+  * \param nMaxLength The most bytes to buffer without finding a newline.
+  *
+  * \return False at end of input, or if the line is too long.
+  */
+
+bool SimulationServer::ReadLine(int nFd, std::string &sBuffer, std::string &sLine, std::string::size_type nMaxLength)
+{
+    char acChunk[4096];
+
+    while (true)
+    {
+        std::string::size_type nEnd = sBuffer.find('\n');
+        if (nEnd != std::string::npos)
+        {
+            sLine.assign(sBuffer, 0, nEnd);
+            sBuffer.erase(0, nEnd + 1);
+            return (true);
+        }
+        if (sBuffer.size() >= nMaxLength) return (false);
+
+        ssize_t nBytes = read(nFd, acChunk, sizeof(acChunk));
+        if (nBytes < 0)
+        {
+            if (errno == EINTR) continue;
+            return (false);
+        }
+        if (nBytes == 0) return (false);
+
+        sBuffer.append(acChunk, nBytes);
+    }
+}
+
+// Keep a descriptor from being inherited by the workers
+static void CloseOnExec(int nFd)
+{
+    fcntl(nFd, F_SETFD, fcntl(nFd, F_GETFD) | FD_CLOEXEC);
+}
+
+void ServerClient::Send(const std::string &sLine)
+{
+    std::lock_guard<std::mutex> lock(mtxWrite);
+    SimulationServer::WriteAll(nFd, sLine + "\n");
+}
+
+#else
+
+void ServerClient::Send(const std::string &) {}
+
+bool SimulationServer::WriteAll(int, const std::string &)
+{
+    return (false);
+}
+
+bool SimulationServer::ReadLine(int, std::string &, std::string &, std::string::size_type)
+{
+    return (false);
+}
+
+#endif // _WIN32
+
+// Return a string as a JSON string
+static std::string JsonString(const std::string &sText)
+{
+    static const char acHex[] = "0123456789abcdef";
+
+    std::string sJson("\"");
+    for (unsigned char c : sText)
+    {
+        switch (c)
+        {
+            case '"':  sJson += "\\\""; break;
+            case '\\': sJson += "\\\\"; break;
+            case '\n': sJson += "\\n";  break;
+            case '\r': sJson += "\\r";  break;
+            case '\t': sJson += "\\t";  break;
+            default:
+                if (c < 0x20)
+                {
+                    sJson += "\\u00";
+                    sJson += acHex[c >> 4];
+                    sJson += acHex[c & 0xf];
+                }
+                else
+                {
+                    sJson += c;
+                }
+        }
+    }
+    sJson += '"';
+
+    return (sJson);
+}
+
+// Skip white space
+static void SkipSpace(const std::string &sJson, std::string::size_type &iii)
+{
+    while ((iii < sJson.size()) &&
+           ((sJson[iii] == ' ') || (sJson[iii] == '\t') || (sJson[iii] == '\r') || (sJson[iii] == '\n'))) ++iii;
+}
+
+// Append a code point as UTF-8
+static void AppendUtf8(std::string &sText, unsigned nCode)
+{
+    if (nCode < 0x80)
+    {
+        sText += static_cast<char>(nCode);
+    }
+    else if (nCode < 0x800)
+    {
+        sText += static_cast<char>(0xc0 | (nCode >> 6));
+        sText += static_cast<char>(0x80 | (nCode & 0x3f));
+    }
+    else if (nCode < 0x10000)
+    {
+        sText += static_cast<char>(0xe0 | (nCode >> 12));
+        sText += static_cast<char>(0x80 | ((nCode >> 6) & 0x3f));
+        sText += static_cast<char>(0x80 | (nCode & 0x3f));
+    }
+    else
+    {
+        sText += static_cast<char>(0xf0 | (nCode >> 18));
+        sText += static_cast<char>(0x80 | ((nCode >> 12) & 0x3f));
+        sText += static_cast<char>(0x80 | ((nCode >> 6) & 0x3f));
+        sText += static_cast<char>(0x80 | (nCode & 0x3f));
+    }
+}
+
+// Parse the four hex digits of a \u escape
+static unsigned ParseHex4(const std::string &sJson, std::string::size_type &iii)
+{
+    if (iii + 4 > sJson.size()) throw CrapSimException("SimulationServer::ParseJob bad \\u escape");
+
+    unsigned nCode = 0;
+    for (int jjj = 0; jjj < 4; ++jjj)
+    {
+        char c = sJson[iii++];
+        nCode <<= 4;
+        if      ((c >= '0') && (c <= '9')) nCode |= c - '0';
+        else if ((c >= 'a') && (c <= 'f')) nCode |= c - 'a' + 10;
+        else if ((c >= 'A') && (c <= 'F')) nCode |= c - 'A' + 10;
+        else throw CrapSimException("SimulationServer::ParseJob bad \\u escape");
+    }
+
+    return (nCode);
+}
+
+// Parse a JSON string starting at its opening quote
+static std::string ParseString(const std::string &sJson, std::string::size_type &iii)
+{
+    std::string sText;
+
+    ++iii;
+    while (true)
+    {
+        if (iii >= sJson.size()) throw CrapSimException("SimulationServer::ParseJob unterminated string");
+
+        char c = sJson[iii++];
+        if (c == '"') return (sText);
+        if (c != '\\')
+        {
+            sText += c;
+            continue;
+        }
+
+        if (iii >= sJson.size()) throw CrapSimException("SimulationServer::ParseJob unterminated string");
+
+        c = sJson[iii++];
+        switch (c)
+        {
+            case '"':  sText += '"';  break;
+            case '\\': sText += '\\'; break;
+            case '/':  sText += '/';  break;
+            case 'b':  sText += '\b'; break;
+            case 'f':  sText += '\f'; break;
+            case 'n':  sText += '\n'; break;
+            case 'r':  sText += '\r'; break;
+            case 't':  sText += '\t'; break;
+            case 'u':
+            {
+                unsigned nCode = ParseHex4(sJson, iii);
+                // A surrogate pair
+                if ((nCode >= 0xd800) && (nCode < 0xdc00) &&
+                    (iii + 1 < sJson.size()) && (sJson[iii] == '\\') && (sJson[iii + 1] == 'u'))
+                {
+                    iii += 2;
+                    unsigned nLow = ParseHex4(sJson, iii);
+                    nCode = 0x10000 + ((nCode - 0xd800) << 10) + (nLow - 0xdc00);
+                }
+                AppendUtf8(sText, nCode);
+                break;
+            }
+            default:
+                throw CrapSimException("SimulationServer::ParseJob bad escape", std::string(1, c));
+        }
+    }
+}
+
+// Parse a JSON integer
+static int ParseInteger(const std::string &sJson, std::string::size_type &iii)
+{
+    std::string::size_type nStart = iii;
+    if ((iii < sJson.size()) && (sJson[iii] == '-')) ++iii;
+    while ((iii < sJson.size()) && (sJson[iii] >= '0') && (sJson[iii] <= '9')) ++iii;
+
+    std::string sNumber = sJson.substr(nStart, iii - nStart);
+    if ((sNumber.empty()) || (sNumber == "-") ||
+        ((iii < sJson.size()) && ((sJson[iii] == '.') || (sJson[iii] == 'e') || (sJson[iii] == 'E'))))
+        throw CrapSimException("SimulationServer::ParseJob expected an integer at", sJson.substr(nStart, 16));
+
+    try
+    {
+        return (std::stoi(sNumber));
+    }
+    catch (const std::out_of_range &)
+    {
+        throw CrapSimException("SimulationServer::ParseJob integer out of range", sNumber);
+    }
+}
+
+/**
+  * Construct a SimulationServer.
+  *
+  * \param sSocketPath The path of the Unix domain socket to listen on.
+  * \param nWorkers The number of worker processes.
+  * \param sProgram The program run as a worker, with --worker.
+  */
+
+SimulationServer::SimulationServer(std::string sSocketPath, int nWorkers, std::string sProgram) :
+    m_sSocketPath(sSocketPath),
+    m_sProgram(sProgram),
+    m_vWorkers(nWorkers)
+{
+    if (nWorkers < 1)
+        throw CrapSimException("SimulationServer::SimulationServer number of workers must be positive", std::to_string(nWorkers));
+}
+
+// A field of a JSON object: a string, or an integer kept as text
+struct JsonField
+{
+    bool        bString;
+    std::string sValue;
+};
+
+// Parse a line holding a JSON object.  Only string and integer fields are
+// kept; true, false and null are skipped.
+static std::map<std::string, JsonField> ParseObject(const std::string &sLine)
+{
+    std::map<std::string, JsonField> mFields;
+    std::string::size_type iii = 0;
+
+    SkipSpace(sLine, iii);
+    if ((iii >= sLine.size()) || (sLine[iii] != '{'))
+        throw CrapSimException("SimulationServer::ParseJob a job must be a JSON object");
+    ++iii;
+
+    SkipSpace(sLine, iii);
+    if ((iii < sLine.size()) && (sLine[iii] == '}')) return (mFields);
+
+    while (true)
+    {
+        SkipSpace(sLine, iii);
+        if ((iii >= sLine.size()) || (sLine[iii] != '"'))
+            throw CrapSimException("SimulationServer::ParseJob expected a field name");
+        std::string sKey = ParseString(sLine, iii);
+
+        SkipSpace(sLine, iii);
+        if ((iii >= sLine.size()) || (sLine[iii] != ':'))
+            throw CrapSimException("SimulationServer::ParseJob expected ':' after", sKey);
+        ++iii;
+        SkipSpace(sLine, iii);
+
+        if (iii >= sLine.size())
+            throw CrapSimException("SimulationServer::ParseJob no value for", sKey);
+
+        if (sLine[iii] == '"')
+        {
+            mFields[sKey] = JsonField{true, ParseString(sLine, iii)};
+        }
+        else if ((sLine[iii] == '-') || ((sLine[iii] >= '0') && (sLine[iii] <= '9')))
+        {
+            mFields[sKey] = JsonField{false, std::to_string(ParseInteger(sLine, iii))};
+        }
+        else if (sLine.compare(iii, 4, "true") == 0)  { iii += 4; }
+        else if (sLine.compare(iii, 5, "false") == 0) { iii += 5; }
+        else if (sLine.compare(iii, 4, "null") == 0)  { iii += 4; }
+        else
+        {
+            throw CrapSimException("SimulationServer::ParseJob unsupported value for", sKey);
+        }
+
+        SkipSpace(sLine, iii);
+        if ((iii < sLine.size()) && (sLine[iii] == ','))
+        {
+            ++iii;
+            continue;
+        }
+        if ((iii < sLine.size()) && (sLine[iii] == '}')) break;
+
+        throw CrapSimException("SimulationServer::ParseJob expected ',' or '}' after", sKey);
+    }
+
+    return (mFields);
+}
+
+/**
+  * Parse a job line.
+  *
+  * A job is a JSON object.  The fields id and config are strings, and
+  * runs, seed, priority, first and count are integers; other fields are
+  * ignored.
+  *
+  * \param sLine The line.
+  *
+  * \return The job.
+  */
+
+SimulationJob SimulationServer::ParseJob(const std::string &sLine)
+{
+    SimulationJob cJob;
+
+    for (const auto &pField : ParseObject(sLine))
+    {
+        const std::string &sKey   = pField.first;
+        const JsonField   &cField = pField.second;
+
+        if (sKey == "id")
+        {
+            cJob.sId = cField.sValue;
+        }
+        else if (sKey == "config")
+        {
+            if (!cField.bString) throw CrapSimException("SimulationServer::ParseJob expected a string for", sKey);
+            cJob.sConfig = cField.sValue;
+        }
+        else if ((sKey == "runs") || (sKey == "seed") || (sKey == "priority") || (sKey == "first") || (sKey == "count"))
+        {
+            if (cField.bString) throw CrapSimException("SimulationServer::ParseJob expected an integer for", sKey);
+
+            int nValue = std::stoi(cField.sValue);
+            if      (sKey == "runs")     cJob.nRuns     = nValue;
+            else if (sKey == "seed")     cJob.nSeed     = nValue;
+            else if (sKey == "priority") cJob.nPriority = nValue;
+            else if (sKey == "first")    cJob.nFirstRun = nValue;
+            else                         cJob.nRunCount = nValue;
+        }
+    }
+
+    return (cJob);
+}
+
+/**
+  * Parse a result line, as written by FormatResult().
+  *
+  * \param sLine The line.
+  * \param sId The job's id.
+  * \param sStatus The status, e.g., done.
+  * \param sText The output, or the error message, empty if neither.
+  */
+
+void SimulationServer::ParseResult(const std::string &sLine, std::string &sId, std::string &sStatus, std::string &sText)
+{
+    std::map<std::string, JsonField> mFields = ParseObject(sLine);
+
+    sId     = mFields["id"].sValue;
+    sStatus = mFields["status"].sValue;
+    sText   = mFields.count("output") ? mFields["output"].sValue : mFields["error"].sValue;
+}
+
+/**
+  * Format a job as a line, as sent to a worker.
+  *
+  * \param cJob The job.
+  *
+  * \return The job as a JSON object, without a newline.
+  */
+
+std::string SimulationServer::FormatJob(const SimulationJob &cJob)
+{
+    std::string sLine = "{\"id\": " + JsonString(cJob.sId) + ", \"config\": " + JsonString(cJob.sConfig);
+
+    if (cJob.nRuns != INT_MIN) sLine += ", \"runs\": " + std::to_string(cJob.nRuns);
+    if (cJob.nSeed != INT_MIN) sLine += ", \"seed\": " + std::to_string(cJob.nSeed);
+    if (cJob.nFirstRun != INT_MIN) sLine += ", \"first\": " + std::to_string(cJob.nFirstRun);
+    if (cJob.nRunCount != INT_MIN) sLine += ", \"count\": " + std::to_string(cJob.nRunCount);
+    sLine += ", \"priority\": " + std::to_string(cJob.nPriority) + "}";
+
+    return (sLine);
+}
+
+/**
+  * Format a result line.
+  *
+  * \param sId The job's id.
+  * \param sStatus queued, done or error.
+  * \param sField The field carrying sText, e.g., output, or empty for none.
+  * \param sText The report or error message.
+  *
+  * \return The result as a JSON object, without a newline.
+  */
+
+std::string SimulationServer::FormatResult(const std::string &sId, const std::string &sStatus,
+                                           const std::string &sField, const std::string &sText)
+{
+    std::string sLine = "{\"id\": " + JsonString(sId) + ", \"status\": " + JsonString(sStatus);
+
+    if (!sField.empty()) sLine += ", " + JsonString(sField) + ": " + JsonString(sText);
+    sLine += "}";
+
+    return (sLine);
+}
+
+#ifndef _WIN32
+
+/**
+  * Serve.
+  *
+  * Start the workers and a thread handing jobs to each, then listen on the
+  * socket and read each connection's jobs on a thread of its own.  Returns
+  * only if the socket fails.  A socket left at the path by an earlier
+  * server is replaced, but any other file there is refused.
+  */
+
+void SimulationServer::Serve()
+{
+    // A client that goes away must not stop the server
+    signal(SIGPIPE, SIG_IGN);
+
+    struct stat stPath;
+    if ((lstat(m_sSocketPath.c_str(), &stPath) == 0) && !S_ISSOCK(stPath.st_mode))
+        throw CrapSimException("SimulationServer::Serve will not replace a file that is not a socket", m_sSocketPath);
+
+    for (Worker &cWorker : m_vWorkers)
+    {
+        StartWorker(cWorker);
+    }
+
+    struct sockaddr_un stAddress;
+    std::memset(&stAddress, 0, sizeof(stAddress));
+    stAddress.sun_family = AF_UNIX;
+    if (m_sSocketPath.size() >= sizeof(stAddress.sun_path))
+        throw CrapSimException("SimulationServer::Serve socket path too long", m_sSocketPath);
+    std::strcpy(stAddress.sun_path, m_sSocketPath.c_str());
+
+    int nListen = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (nListen < 0)
+        throw CrapSimException("SimulationServer::Serve cannot create socket", std::strerror(errno));
+    CloseOnExec(nListen);
+
+    if ((lstat(m_sSocketPath.c_str(), &stPath) == 0) && S_ISSOCK(stPath.st_mode)) unlink(m_sSocketPath.c_str());
+    if ((bind(nListen, reinterpret_cast<struct sockaddr *>(&stAddress), sizeof(stAddress)) < 0) ||
+        (listen(nListen, SOMAXCONN) < 0))
+        throw CrapSimException("SimulationServer::Serve cannot listen on " + m_sSocketPath, std::strerror(errno));
+
+    for (Worker &cWorker : m_vWorkers)
+    {
+        std::thread(&SimulationServer::Dispatch, this, std::ref(cWorker)).detach();
+    }
+
+    std::cerr << "Serving on " << m_sSocketPath << " with " << m_vWorkers.size() << " workers" << std::endl;
+
+    while (true)
+    {
+        int nClient = accept(nListen, nullptr, nullptr);
+        if (nClient < 0)
+        {
+            if ((errno == EINTR) || (errno == ECONNABORTED)) continue;
+            throw CrapSimException("SimulationServer::Serve accept failed", std::strerror(errno));
+        }
+        CloseOnExec(nClient);
+
+        std::thread(&SimulationServer::ReadClient, this, std::make_shared<ServerClient>(nClient)).detach();
+    }
+}
+
+/**
+  * Start, or restart, a worker process.
+  *
+  * \param cWorker The worker.
+  */
+
+void SimulationServer::StartWorker(Worker &cWorker)
+{
+    if (cWorker.nPid > 0)
+    {
+        close(cWorker.nInput);
+        close(cWorker.nOutput);
+        waitpid(cWorker.nPid, nullptr, 0);
+
+        // Not running until started again, should that fail
+        cWorker.nPid    = -1;
+        cWorker.nInput  = -1;
+        cWorker.nOutput = -1;
+    }
+
+    int anInput[2];
+    int anOutput[2];
+    if (pipe(anInput) < 0)
+        throw CrapSimException("SimulationServer::StartWorker cannot create pipes", std::strerror(errno));
+    if (pipe(anOutput) < 0)
+    {
+        int nErrno = errno;
+        close(anInput[0]);
+        close(anInput[1]);
+        throw CrapSimException("SimulationServer::StartWorker cannot create pipes", std::strerror(nErrno));
+    }
+
+    CloseOnExec(anInput[1]);
+    CloseOnExec(anOutput[0]);
+
+    int nPid = fork();
+    if (nPid < 0)
+    {
+        int nErrno = errno;
+        close(anInput[0]);
+        close(anInput[1]);
+        close(anOutput[0]);
+        close(anOutput[1]);
+        throw CrapSimException("SimulationServer::StartWorker cannot fork", std::strerror(nErrno));
+    }
+
+    if (nPid == 0)
+    {
+        dup2(anInput[0], STDIN_FILENO);
+        dup2(anOutput[1], STDOUT_FILENO);
+        close(anInput[0]);
+        close(anOutput[1]);
+
+        execlp(m_sProgram.c_str(), m_sProgram.c_str(), "--worker", static_cast<char *>(nullptr));
+        _exit(127);
+    }
+
+    close(anInput[0]);
+    close(anOutput[1]);
+
+    cWorker.nPid    = nPid;
+    cWorker.nInput  = anInput[1];
+    cWorker.nOutput = anOutput[0];
+    cWorker.sBuffer.clear();
+}
+
+/**
+  * Read a client's job lines and queue them.
+  *
+  * Each job is answered at once with a queued line, or with an error line if
+  * it cannot be read.  A job without an id is given one.  A line longer than
+  * SERVER_MAX_LINE_LENGTH is answered with an error and the connection
+  * closed for reading.
+  *
+  * \param pcClient The client.
+  */
+
+void SimulationServer::ReadClient(std::shared_ptr<ServerClient> pcClient)
+{
+    std::string sBuffer;
+    std::string sLine;
+
+    while (ReadLine(pcClient->nFd, sBuffer, sLine, SERVER_MAX_LINE_LENGTH))
+    {
+        if (sLine.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        QueuedJob cQueued;
+        try
+        {
+            cQueued.cJob = ParseJob(sLine);
+        }
+        catch (const CrapSimException &e)
+        {
+            pcClient->Send(FormatResult("", "error", "error", std::string(e.what()) + " " + e.m_sArg));
+            continue;
+        }
+        cQueued.pcClient = pcClient;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mtxJobs);
+            cQueued.cJob.nSequence = ++m_nSequence;
+            if (cQueued.cJob.sId.empty()) cQueued.cJob.sId = "job" + std::to_string(cQueued.cJob.nSequence);
+        }
+
+        // A client slow to read blocks only its own reader, not the queue.
+        // The job is queued after the reply, so its result cannot come first.
+        pcClient->Send(FormatResult(cQueued.cJob.sId, "queued", "", ""));
+
+        {
+            std::lock_guard<std::mutex> lock(m_mtxJobs);
+            m_qJobs.push(cQueued);
+        }
+        m_cvJobs.notify_one();
+    }
+
+    if (sBuffer.size() >= SERVER_MAX_LINE_LENGTH)
+        pcClient->Send(FormatResult("", "error", "error", "SimulationServer::ReadClient job line longer than " +
+                                    std::to_string(SERVER_MAX_LINE_LENGTH) + " bytes"));
+}
+
+/**
+  * Hand queued jobs to a worker, one at a time, and send each result to
+  * the client that sent the job.  A worker that exits is restarted, and its
+  * job answered with an error.  A worker that cannot be restarted answers
+  * its jobs with the error until it can.
+  *
+  * \param cWorker The worker.
+  */
+
+void SimulationServer::Dispatch(Worker &cWorker)
+{
+    while (true)
+    {
+        QueuedJob cQueued;
+        {
+            std::unique_lock<std::mutex> lock(m_mtxJobs);
+            m_cvJobs.wait(lock, [this] { return (!m_qJobs.empty()); });
+            cQueued = m_qJobs.top();
+            m_qJobs.pop();
+        }
+
+        std::string sResult;
+        try
+        {
+            if (cWorker.nPid < 0) StartWorker(cWorker);
+
+            if (!WriteAll(cWorker.nInput, FormatJob(cQueued.cJob) + "\n") ||
+                !ReadLine(cWorker.nOutput, cWorker.sBuffer, sResult))
+            {
+                sResult = FormatResult(cQueued.cJob.sId, "error", "error", "worker exited");
+                StartWorker(cWorker);
+            }
+        }
+        catch (const CrapSimException &e)
+        {
+            sResult = FormatResult(cQueued.cJob.sId, "error", "error", std::string(e.what()) + " " + e.m_sArg);
+        }
+
+        cQueued.pcClient->Send(sResult);
+    }
+}
+
+/**
+  * Run as a worker.
+  *
+  * Read jobs on standard input, one per line, until it is closed.  Write
+  * each job's configuration to a TemporaryFile, run it with the report
+  * going to a string, and write the result on standard output.
+  *
+  * \param fRunJob Runs a job from a configuration file.
+  *
+  * \return The exit status.
+  */
+
+int SimulationServer::Work(const JobFunction &fRunJob)
+{
+    std::string sBuffer;
+    std::string sLine;
+
+    while (ReadLine(STDIN_FILENO, sBuffer, sLine))
+    {
+        std::string sResult;
+
+        try
+        {
+            SimulationJob cJob = ParseJob(sLine);
+
+            // Keep the report, and any formatting it leaves on std::cout, to this job
+            std::ostringstream ossReport;
+            std::ios cFormat(nullptr);
+            cFormat.copyfmt(std::cout);
+            std::streambuf *pcCout = std::cout.rdbuf(ossReport.rdbuf());
+            std::streambuf *pcCerr = std::cerr.rdbuf(ossReport.rdbuf());
+
+            try
+            {
+                TemporaryFile cConfigFile(cJob.sConfig);
+                fRunJob(cConfigFile.Path(), cJob.nRuns, cJob.nSeed);
+                sResult = FormatResult(cJob.sId, "done", "output", ossReport.str());
+            }
+            catch (const CrapSimException &e)
+            {
+                sResult = FormatResult(cJob.sId, "error", "error", std::string(e.what()) + " " + e.m_sArg);
+            }
+            catch (const std::exception &e)
+            {
+                sResult = FormatResult(cJob.sId, "error", "error", e.what());
+            }
+
+            std::cout.rdbuf(pcCout);
+            std::cerr.rdbuf(pcCerr);
+            std::cout.copyfmt(cFormat);
+            std::cout.clear();
+        }
+        catch (const CrapSimException &e)
+        {
+            sResult = FormatResult("", "error", "error", std::string(e.what()) + " " + e.m_sArg);
+        }
+
+        if (!WriteAll(STDOUT_FILENO, sResult + "\n")) return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
+
+#else
+
+void SimulationServer::Serve()
+{
+    throw CrapSimException("SimulationServer::Serve not supported on Windows");
+}
+
+void SimulationServer::StartWorker(Worker &) {}
+void SimulationServer::ReadClient(std::shared_ptr<ServerClient>) {}
+void SimulationServer::Dispatch(Worker &) {}
+
+int SimulationServer::Work(const JobFunction &)
+{
+    throw CrapSimException("SimulationServer::Work not supported on Windows");
+}
+
+#endif // _WIN32
@@ -0,0 +1,217 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Statistics.h"
+
+/**
+  * Add an observation.
+  *
+  * Update the count, mean, and sum of squared deviations using Welford's
+  * method, which is numerically stable for long simulations.
+  *
+  * \param x The observation.
+  */
+
+void RunningStatistics::Add(double x)
+{
+    ++m_nCount;
+
+    double dDelta = x - m_dMean;
+    m_dMean += dDelta / m_nCount;
+    m_dM2   += dDelta * (x - m_dMean);
+}
+
+/**
+  * Add the observations of another RunningStatistics.
+  *
+  * Combine the counts, means, and sums of squared deviations with Chan's
+  * parallel method, as if every observation had been added to this one.
+  *
+  * \param cOther The RunningStatistics merged.
+  */
+
+void RunningStatistics::Merge(const RunningStatistics &cOther)
+{
+    if (cOther.m_nCount == 0) return;
+
+    long long nCount = m_nCount + cOther.m_nCount;
+    double    dDelta = cOther.m_dMean - m_dMean;
+
+    m_dMean += dDelta * cOther.m_nCount / nCount;
+    m_dM2   += cOther.m_dM2 + dDelta * dDelta * m_nCount * cOther.m_nCount / nCount;
+    m_nCount = nCount;
+}
+
+/**
+  * Add a pair of observations.
+  *
+  * Update the means, sums of squared deviations, and the co-moment of the
+  * two series in a single pass.
+  *
+  * \param x The observation of the first series.
+  * \param y The observation of the second series.
+  */
+
+void RunningCovariance::Add(double x, double y)
+{
+    ++m_nCount;
+
+    double dDeltaX = x - m_dMeanX;
+    double dDeltaY = y - m_dMeanY;
+
+    m_dMeanX += dDeltaX / m_nCount;
+    m_dMeanY += dDeltaY / m_nCount;
+
+    m_dM2X      += dDeltaX * (x - m_dMeanX);
+    m_dM2Y      += dDeltaY * (y - m_dMeanY);
+    m_dCoMoment += dDeltaX * (y - m_dMeanY);
+}
+
+/**
+  * Return the correlation of the two series.
+  *
+  * \return The sample correlation, or zero if either series has no variance.
+  */
+
+double RunningCovariance::Correlation() const
+{
+    double dDenominator = std::sqrt(VarianceX() * VarianceY());
+
+    if (dDenominator <= 0.0) return (0.0);
+
+    return (Covariance() / dDenominator);
+}
+
+/**
+  * Return the half width of the paired confidence interval.
+  *
+  * Both series are observed on the same dice, so the variance of their
+  * difference is reduced by twice their covariance.
+  *
+  * \return Half width of the 95% confidence interval of the mean difference.
+  */
+
+double RunningCovariance::PairedHalfWidth() const
+{
+    if (m_nCount < 2) return (0.0);
+
+    double dVariance = VarianceX() + VarianceY() - 2.0 * Covariance();
+    if (dVariance < 0.0) dVariance = 0.0;
+
+    return (CONFIDENCE_Z95 * std::sqrt(dVariance / m_nCount));
+}
+
+/**
+  * Return the half width of an unpaired confidence interval.
+  *
+  * Used to show how much the pairing has narrowed the interval.
+  *
+  * \return Half width of the 95% confidence interval ignoring covariance.
+  */
+
+double RunningCovariance::IndependentHalfWidth() const
+{
+    if (m_nCount < 2) return (0.0);
+
+    return (CONFIDENCE_Z95 * std::sqrt((VarianceX() + VarianceY()) / m_nCount));
+}
+
+/**
+  * Add an observation.
+  *
+  * The bucket is the position of the highest bit set, so that each bucket
+  * is twice as wide as the one before.
+  *
+  * \param n The observation.
+  */
+
+void LogHistogram::Add(int n)
+{
+    int nBucket = 0;
+    for (unsigned nValue = (n > 1) ? static_cast<unsigned>(n) : 1u; nValue > 1; nValue >>= 1)
+        ++nBucket;
+
+    ++m_anCounts[nBucket];
+}
+
+/**
+  * Add the observations of another LogHistogram.
+  *
+  * \param cOther The LogHistogram merged.
+  */
+
+void LogHistogram::Merge(const LogHistogram &cOther)
+{
+    for (int iii = 0; iii < LOG_HISTOGRAM_BUCKETS; ++iii)
+        m_anCounts[iii] += cOther.m_anCounts[iii];
+}
+
+/**
+  * Return the bucket of a number of rolls.
+  *
+  * Rolls under 2 * SURVIVAL_CURVE_STEPS are their own bucket.  Above that,
+  * the rolls are shifted right until they are under 2 * SURVIVAL_CURVE_STEPS;
+  * the shift picks the doubling and the bits left the step within it, so a
+  * bucket is never wider than 1 / SURVIVAL_CURVE_STEPS of its rolls.
+  *
+  * \param nRolls The number of rolls, 0 or more.
+  *
+  * \return The bucket.
+  */
+
+int SurvivalCurve::Bucket(int nRolls)
+{
+    if (nRolls < 2 * SURVIVAL_CURVE_STEPS) return (nRolls > 0 ? nRolls : 0);
+
+    int nShift = 0;
+    for (int nValue = nRolls; nValue >= 2 * SURVIVAL_CURVE_STEPS; nValue >>= 1)
+        ++nShift;
+
+    return (SURVIVAL_CURVE_STEPS * (nShift + 1) + (nRolls >> nShift) - SURVIVAL_CURVE_STEPS);
+}
+
+/**
+  * Return the fewest rolls counted in a bucket.
+  *
+  * \param nBucket The bucket.
+  *
+  * \return The rolls at the start of the bucket.
+  */
+
+int SurvivalCurve::BucketStart(int nBucket)
+{
+    if (nBucket < 2 * SURVIVAL_CURVE_STEPS) return (nBucket);
+
+    return ((SURVIVAL_CURVE_STEPS + nBucket % SURVIVAL_CURVE_STEPS) << (nBucket / SURVIVAL_CURVE_STEPS - 1));
+}
+
+/**
+  * Add the runs of another SurvivalCurve.
+  *
+  * \param cOther The SurvivalCurve merged.
+  */
+
+void SurvivalCurve::Merge(const SurvivalCurve &cOther)
+{
+    for (int iii = 0; iii < static_cast<int>(SurvivalEvent::SE_COUNT); ++iii)
+    {
+        for (int jjj = 0; jjj < SURVIVAL_CURVE_BUCKETS; ++jjj)
+            m_aanCounts[iii][jjj] += cOther.m_aanCounts[iii][jjj];
+    }
+}
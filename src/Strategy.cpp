@@ -19,9 +19,14 @@
 
 #include "Strategy.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+
+// Whether the header of the Strategy reports has been printed
+bool Strategy::m_bReportHeaderPrinted = false;
 
 /**
   * Construct a Strategy.
@@ -222,9 +227,10 @@ void Strategy::SetQualifiedShooterMethod(std::string sQualifiedShooterMethod)
   * at one time cannot exceed the number of total Place bets.
   *
   *\param cTable The Table.
+  *\param osLog Where changes made to the Strategy are noted.
   */
 
-void Strategy::SanityCheck(const Table &cTable)
+void Strategy::SanityCheck(const Table &cTable, std::ostream &osLog)
 {
     // Record Table minimum and maximum bet amounts
     m_cWager.SetTableLimits(cTable.MinimumBet(), cTable.MaximumBet());
@@ -233,13 +239,13 @@ void Strategy::SanityCheck(const Table &cTable)
     {
         if (m_nFieldBetUnits > 1)
         {
-            std::cout << "\tChanging Strategy" << m_sName << ": disregard Field Bet Units and use Wager Progression Method" << std::endl;
+            osLog << "\tChanging Strategy" << m_sName << ": disregard Field Bet Units and use Wager Progression Method" << std::endl;
             m_nFieldBetUnits = 1;
         }
 
         if (m_nPlaceBetUnits > 1)
         {
-            std::cout << "\tChanging Strategy" << m_sName << ": disregard Place Bet Units and use Wager Progression Method" << std::endl;
+            osLog << "\tChanging Strategy" << m_sName << ": disregard Place Bet Units and use Wager Progression Method" << std::endl;
             m_nPlaceBetUnits = 0;
         }
     }
@@ -247,32 +253,136 @@ void Strategy::SanityCheck(const Table &cTable)
     // Ensure that Strategy's number of place bets at once is less than or equal to the number of place bets allowed
     if (m_nNumberOfPlaceBetsMadeAtOnce > m_nNumberOfPlaceBetsAllowed)
     {
-        std::cout << "\tChanging Strategy " << m_sName << ": number of place bets at once to number of place bets allowed [" << m_nNumberOfPlaceBetsMadeAtOnce << " to " << m_nNumberOfPlaceBetsAllowed << "]" << std::endl;
+        osLog << "\tChanging Strategy " << m_sName << ": number of place bets at once to number of place bets allowed [" << m_nNumberOfPlaceBetsMadeAtOnce << " to " << m_nNumberOfPlaceBetsAllowed << "]" << std::endl;
         m_nNumberOfPlaceBetsMadeAtOnce = m_nNumberOfPlaceBetsAllowed;
     }
 
     // Ensure that Strategy's number of place bets at once is less than or equal to the number of place bets allowed
     if ((m_nNumberOfPlaceBetsMadeAtOnce <= 0) && (m_nNumberOfPlaceBetsAllowed > 0))
     {
-        std::cout << "\tChanging Strategy " << m_sName << ": number of place bets made at once to one [" << m_nNumberOfPlaceBetsMadeAtOnce << " to " << 1 << "]" << std::endl;
+        osLog << "\tChanging Strategy " << m_sName << ": number of place bets made at once to one [" << m_nNumberOfPlaceBetsMadeAtOnce << " to " << 1 << "]" << std::endl;
         m_nNumberOfPlaceBetsMadeAtOnce = 1;
     }
 
+    // Make room for every order the rules, routine and plugin may give for
+    // a roll, so that no roll allocates
+    if (HasRules()) m_vRuleOrders.reserve(m_cRuleProgram.Rules() + ROUTINE_MAX_ORDERS + CRAPSIM_MAX_ORDERS);
+
+    // Use the MakeBets() and ResolveBets() compiled for the bets the Strategy makes
+    SelectBetMask();
+
+    // Capture the state each simulation run starts from
+    SnapshotState();
+
     // TODO: if not bets selected, discard strategy
 }
 
+/**
+  * Return the bet types and methods the Strategy uses.
+  *
+  * A Place bet made after the Come bets may be a Come bet instead, if the
+  * 6 or 8 is already covered.
+  *
+  * \return The bet mask.
+  */
+
+unsigned Strategy::BetMask() const
+{
+    unsigned nMask = 0;
+
+    if (m_nNumberOfPassBetsAllowed > 0)     nMask |= STRATEGY_BET_PASS;
+    if (m_nNumberOfComeBetsAllowed > 0)     nMask |= STRATEGY_BET_COME;
+    if (m_nNumberOfDontPassBetsAllowed > 0) nMask |= STRATEGY_BET_DONT_PASS;
+    if (m_nNumberOfDontComeBetsAllowed > 0) nMask |= STRATEGY_BET_DONT_COME;
+    if (m_fStandardOdds != 0.0)             nMask |= STRATEGY_BET_ODDS;
+    if (m_nNumberOfPlaceBetsAllowed > 0)    nMask |= STRATEGY_BET_PLACE;
+    if (m_nNumberOfPlaceBetsAllowed > 0 && m_bPlaceAfterCome) nMask |= STRATEGY_BET_COME;
+    if (m_bPutBetsAllowed)                  nMask |= STRATEGY_BET_PUT;
+
+    if (m_bHard4BetAllowed || m_bHard6BetAllowed || m_bHard8BetAllowed || m_bHard10BetAllowed)
+        nMask |= STRATEGY_BET_HARD;
+    if (m_bBig6BetAllowed || m_bBig8BetAllowed)
+        nMask |= STRATEGY_BET_BIG;
+    if (m_bFieldBetsAllowed || m_bAny7BetAllowed || m_bAnyCrapsBetAllowed || m_bCraps2BetAllowed ||
+        m_bCraps3BetAllowed || m_bYo11BetAllowed || m_bCraps12BetAllowed)
+        nMask |= STRATEGY_BET_ONE_ROLL;
+
+    if (IsUsingOddsProgession())            nMask |= STRATEGY_BET_ODDS_PROGRESSION;
+    // Betting rules, routines and plugins may make Pass, Dont Pass, Field, Place and Hard Way bets
+    if (HasRules())                         nMask |= STRATEGY_BET_RULES_ANY;
+
+    return (nMask);
+}
+
+/**
+  * Choose the MakeBets() and ResolveBets() compiled for the bet mask.
+  *
+  * Versions are compiled in advance for the predefined Strategies and
+  * plain Pass line play; in these, the calls and checks for bets the
+  * Strategy never makes are compiled away.  Any other Strategy uses the
+  * versions for all bets.
+  */
+
+void Strategy::SelectBetMask()
+{
+    switch (BetMask())
+    {
+        // Pass line
+        case STRATEGY_BET_PASS:
+            m_pfMakeBets    = &Strategy::MakeBetsFor<STRATEGY_BET_PASS>;
+            m_pfResolveBets = &Strategy::ResolveBetsFor<STRATEGY_BET_PASS>;
+            break;
+        case STRATEGY_BET_PASS | STRATEGY_BET_ODDS:
+            m_pfMakeBets    = &Strategy::MakeBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_ODDS>;
+            m_pfResolveBets = &Strategy::ResolveBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_ODDS>;
+            break;
+        // Elementary
+        case STRATEGY_BET_PASS | STRATEGY_BET_ODDS | STRATEGY_BET_ODDS_PROGRESSION:
+            m_pfMakeBets    = &Strategy::MakeBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_ODDS | STRATEGY_BET_ODDS_PROGRESSION>;
+            m_pfResolveBets = &Strategy::ResolveBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_ODDS | STRATEGY_BET_ODDS_PROGRESSION>;
+            break;
+        // Conservative and Conventional
+        case STRATEGY_BET_PASS | STRATEGY_BET_COME | STRATEGY_BET_ODDS | STRATEGY_BET_ODDS_PROGRESSION:
+            m_pfMakeBets    = &Strategy::MakeBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_COME | STRATEGY_BET_ODDS | STRATEGY_BET_ODDS_PROGRESSION>;
+            m_pfResolveBets = &Strategy::ResolveBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_COME | STRATEGY_BET_ODDS | STRATEGY_BET_ODDS_PROGRESSION>;
+            break;
+        // Aggressive
+        case STRATEGY_BET_PASS | STRATEGY_BET_COME | STRATEGY_BET_ODDS | STRATEGY_BET_PLACE | STRATEGY_BET_ODDS_PROGRESSION:
+            m_pfMakeBets    = &Strategy::MakeBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_COME | STRATEGY_BET_ODDS | STRATEGY_BET_PLACE | STRATEGY_BET_ODDS_PROGRESSION>;
+            m_pfResolveBets = &Strategy::ResolveBetsFor<STRATEGY_BET_PASS | STRATEGY_BET_COME | STRATEGY_BET_ODDS | STRATEGY_BET_PLACE | STRATEGY_BET_ODDS_PROGRESSION>;
+            break;
+        // Betting rules, routine or plugin alone
+        case STRATEGY_BET_RULES_ANY:
+        case STRATEGY_BET_RULES_ANY | STRATEGY_BET_ODDS:
+            m_pfMakeBets    = &Strategy::MakeBetsFor<STRATEGY_BET_RULES_ANY | STRATEGY_BET_ODDS>;
+            m_pfResolveBets = &Strategy::ResolveBetsFor<STRATEGY_BET_RULES_ANY | STRATEGY_BET_ODDS>;
+            break;
+        default:
+            m_pfMakeBets    = &Strategy::MakeBetsFor<STRATEGY_BET_ALL>;
+            m_pfResolveBets = &Strategy::ResolveBetsFor<STRATEGY_BET_ALL>;
+            break;
+    }
+}
+
 /**
   * Make Bets.
   *
-  * Call each bet type.  MakeXXXBet create and push a Bet onto the bets
-  * container. If tracking results, call StrategyTracker.
+  * Call each bet type in MASK.  MakeXXXBet create and push a Bet onto the
+  * bets container. If tracking results, call StrategyTracker.
   *
   *\param cTable The Table.
   */
 
-void Strategy::MakeBets(const Table &cTable)
+template <unsigned MASK>
+void Strategy::MakeBetsFor(const Table &cTable)
 {
-    if (StillPlaying() && ShooterQualified())
+    if (!StillPlaying()) return;
+
+    // Betting rules, routines and plugins play whether or not the shooter is qualified
+    const bool bQualified = ShooterQualified();
+    const bool bRules     = (MASK & STRATEGY_BET_RULES) && HasRules();
+
+    if (bQualified || bRules)
     {
         // If tracking results, start a new record, which updates bankroll, and update table stats
         if (m_bTrace) m_pcStrategyTracker->RecordNew(this, cTable);
@@ -280,29 +390,34 @@ void Strategy::MakeBets(const Table &cTable)
         // Mark beinning bankroll
         m_cMoney.MarkBeforeBetting();
 
-        MakePassBet(cTable);
-        MakeComeBet(cTable);
+        if (bQualified)
+        {
+            if (MASK & STRATEGY_BET_PASS)      MakePassBet(cTable);
+            if (MASK & STRATEGY_BET_COME)      MakeComeBet(cTable);
+
+            if (MASK & STRATEGY_BET_DONT_PASS) MakeDontPassBet(cTable);
+            if (MASK & STRATEGY_BET_DONT_COME) MakeDontComeBet(cTable);
 
-        MakeDontPassBet(cTable);
-        MakeDontComeBet(cTable);
+            if (MASK & STRATEGY_BET_ODDS)      MakeOddsBet(cTable);
 
-        MakeOddsBet(cTable);
+            if (MASK & STRATEGY_BET_PLACE)     MakePlaceBets(cTable);
 
-        MakePlaceBets(cTable);
+            if (MASK & STRATEGY_BET_PUT)       MakePutBet(cTable);
 
-        MakePutBet(cTable);
+            if (MASK & STRATEGY_BET_HARD)      MakeHardWayBets();
 
-        MakeHardWayBets();
+            if (MASK & STRATEGY_BET_BIG)       MakeBigBets();
 
-        MakeBigBets();
+            if (MASK & STRATEGY_BET_ONE_ROLL)  MakeOneRollBets();
+        }
 
-        MakeOneRollBets();
+        if (bRules) PlayRules(cTable);
 
         // Mark bankroll after making bets
         m_cMoney.MarkAfterBetting();
 
         // If tracking results, capture bankroll post bets
-        if (m_bTrace) m_pcStrategyTracker->RecordBetsBeforeRoll(this, m_lBets);
+        if (m_bTrace) m_pcStrategyTracker->RecordBetsBeforeRoll(this, m_cBetBoard);
     }
 }
 
@@ -310,7 +425,7 @@ void Strategy::MakeBets(const Table &cTable)
   * Resolve Bets.
   *
   * Check to see if the Strategy is sill playing.  If so, Loop through all bets
-  * and call each bet type. If the bet is resolved, update the eager units.
+  * and call each bet type in MASK. If the bet is resolved, update the eager units.
   * If tracking results, call StrategyTracker. If Odds Progression is set,
   * compare before and after bankroll and adjust accordingly.
   *
@@ -318,38 +433,43 @@ void Strategy::MakeBets(const Table &cTable)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveBets(const Table &cTable, const Dice &cDice)
+template <unsigned MASK>
+void Strategy::ResolveBetsFor(const Table &cTable, const Dice &cDice)
 {
     if (!StillPlaying()) return;
 
     // Increment number of rolls
     ++m_nNumberOfRolls;
 
+    // Whether any bet won or lost on this roll, for the betting rules
+    bool bWon  = false;
+    bool bLost = false;
+
     // Resolve all bets
-    for (std::list<Bet>::iterator it = m_lBets.begin(); it != m_lBets.end(); ++it)
+    for (BetBoard::iterator it = m_cBetBoard.begin(); it != m_cBetBoard.end(); ++it)
     {
-        if (it->IsPassBet())         ResolvePass(it, cDice);
-        if (it->IsPassOddsBet())     ResolvePassOdds(it, cTable, cDice);
+        if ((MASK & STRATEGY_BET_PASS)      && it->IsPassBet())         ResolvePass(it, cDice);
+        if ((MASK & STRATEGY_BET_PASS)      && it->IsPassOddsBet())     ResolvePassOdds(it, cTable, cDice);
 
-        if (it->IsComeBet())         ResolveCome(it, cDice);
-        if (it->IsComeOddsBet())     ResolveComeOdds(it, cTable, cDice);
+        if ((MASK & STRATEGY_BET_COME)      && it->IsComeBet())         ResolveCome(it, cDice);
+        if ((MASK & STRATEGY_BET_COME)      && it->IsComeOddsBet())     ResolveComeOdds(it, cTable, cDice);
 
-        if (it->IsDontPassBet())     ResolveDontPass(it, cDice);
-        if (it->IsDontPassOddsBet()) ResolveDontPassOdds(it, cTable, cDice);
+        if ((MASK & STRATEGY_BET_DONT_PASS) && it->IsDontPassBet())     ResolveDontPass(it, cDice);
+        if ((MASK & STRATEGY_BET_DONT_PASS) && it->IsDontPassOddsBet()) ResolveDontPassOdds(it, cTable, cDice);
 
-        if (it->IsDontComeBet())     ResolveDontCome(it, cDice);
-        if (it->IsDontComeOddsBet()) ResolveDontComeOdds(it, cDice);
+        if ((MASK & STRATEGY_BET_DONT_COME) && it->IsDontComeBet())     ResolveDontCome(it, cDice);
+        if ((MASK & STRATEGY_BET_DONT_COME) && it->IsDontComeOddsBet()) ResolveDontComeOdds(it, cDice);
 
-        if (it->IsPlaceBet())        ResolvePlace(it, cTable, cDice);
+        if ((MASK & STRATEGY_BET_PLACE)     && it->IsPlaceBet())        ResolvePlace(it, cTable, cDice);
 
-        if (it->IsPutBet())          ResolvePut(it, cDice);
-        if (it->IsPutOddsBet())      ResolvePutOdds(it, cDice);
+        if ((MASK & STRATEGY_BET_PUT)       && it->IsPutBet())          ResolvePut(it, cDice);
+        if ((MASK & STRATEGY_BET_PUT)       && it->IsPutOddsBet())      ResolvePutOdds(it, cDice);
 
-        if (it->IsHardBet())         ResolveHardWayBets(it, cDice);
+        if ((MASK & STRATEGY_BET_HARD)      && it->IsHardBet())         ResolveHardWayBets(it, cDice);
 
-        if (it->IsBigBet())          ResolveBig(it, cDice);
+        if ((MASK & STRATEGY_BET_BIG)       && it->IsBigBet())          ResolveBig(it, cDice);
 
-        if (it->IsOneRollBet())      ResolveOneRollBets(it, cDice);
+        if ((MASK & STRATEGY_BET_ONE_ROLL)  && it->IsOneRollBet())      ResolveOneRollBets(it, cDice);
 
         if (it->Pushed())
             it->SetUnresolved();
@@ -359,13 +479,35 @@ void Strategy::ResolveBets(const Table &cTable, const Dice &cDice)
             // Update wager units for next bet based on this resolved bet
             m_cWager.WagerUnits(it);
         }
+
+        if (MASK & STRATEGY_BET_RULES)
+        {
+            bWon  = bWon || it->Won();
+            bLost = bLost || it->Lost();
+        }
+    }
+
+    // A roll with a win and no loss extends the winning rolls in a row
+    if (MASK & STRATEGY_BET_RULES)
+    {
+        m_nLastRoll = cDice.RollValue();
+
+        if (bLost)     m_nHits = 0;
+        else if (bWon) ++m_nHits;
+
+        if (m_cPlugin.ResolvesBets())
+        {
+            int anVariables[RULE_VARIABLES];
+            RuleVariables(cTable, anVariables);
+            m_cPlugin.ResolveBets(anVariables);
+        }
     }
 
     // Mark ending bankroll
     m_cMoney.MarkAfterResolvingBets();
 
     // Check Odds Progression tactic
-    if (IsUsingOddsProgession())
+    if ((MASK & STRATEGY_BET_ODDS_PROGRESSION) && IsUsingOddsProgession())
     {
         // If bankroll has increased, increase Odds
         if (m_cMoney.GainAfterBetting()) IncreaseOdds();
@@ -374,7 +516,7 @@ void Strategy::ResolveBets(const Table &cTable, const Dice &cDice)
     }
 
     // If tracking results, record ending bankroll and post results
-    if (m_bTrace) m_pcStrategyTracker->RecordBetsAfterRoll(this, m_lBets, cDice.RollValue());
+    if (m_bTrace) m_pcStrategyTracker->RecordBetsAfterRoll(this, m_cBetBoard, cDice.RollValue());
     if (m_bTrace) m_pcStrategyTracker->Post();
 }
 
@@ -393,14 +535,14 @@ void Strategy::ModifyBets(const Table &cTable)
 {
     if (!StillPlaying()) return;
 
-    if (m_cWager.ModifyBets(m_cMoney, cTable, m_lBets))
+    if (m_cWager.ModifyBets(m_cMoney, cTable, m_cBetBoard))
         m_cQualifiedShooter.WaitForNewQualification();
 
     // Mark ending bankroll
     //m_cMoney.MarkAfterResolvingBets();
 
     // If tracking results, record ending bankroll and post results
-    //if (m_bTrace) m_pcStrategyTracker->RecordBetsAfterRoll(this, m_lBets, cDice.RollValue());
+    //if (m_bTrace) m_pcStrategyTracker->RecordBetsAfterRoll(this, m_cBetBoard, cDice.RollValue());
     //if (m_bTrace) m_pcStrategyTracker->Post();
 }
 
@@ -408,42 +550,13 @@ void Strategy::FinalizeBets()
 {
     if (!StillPlaying()) return;
 
-    std::list<Bet>::iterator it = m_lBets.begin();
-    while(it != m_lBets.end())
+    BetBoard::iterator it = m_cBetBoard.begin();
+    while(it != m_cBetBoard.end())
     {
         if (it->Resolved())
         {
-            if (it->IsPassBet()) --m_nNumberOfPassBetsMade;  //TODO make this true or false
-            //if (it->IsPassOddsBet()) {}
-            if (it->IsDontPassBet()) --m_nNumberOfDontPassBetsMade; //TODO make this true or false
-            //if (it->IsDontPassOddsBet()) {}
-            if (it->IsComeBet()) --m_nNumberOfComeBetsMade;
-            //if (it->IsComeOddsBet()) {}
-            if (it->IsDontComeBet()) --m_nNumberOfDontComeBetsMade;
-            //if (it->IsDontComeOddsBet()) {}
-            if (it->IsPutBet()) m_bPutBetMade = false;
-            //if (it->IsPutOddsBet()) {}
-            if (it->IsPlaceBet())
-            {
-                // Set Place bet number to false (bet not made)
-                m_mPlaceBets[it->Point()] = false;
-                // Decrement the number of Place bets made
-                --m_nNumberOfPlaceBetsMade;
-            }
-            if (it->IsBigBet())
-            {
-                if (it->IsBig6Bet()) --m_nNumberOfBig6BetsMade;
-                if (it->IsBig8Bet()) --m_nNumberOfBig8BetsMade;
-            }
-            if (it->IsHardBet())
-            {
-                if (it->IsHard4Bet())  --m_nNumberOfHard4BetsMade;
-                if (it->IsHard6Bet())  --m_nNumberOfHard6BetsMade;
-                if (it->IsHard8Bet())  --m_nNumberOfHard8BetsMade;
-                if (it->IsHard10Bet()) --m_nNumberOfHard10BetsMade;
-            }
-            //if (it->IsOneRollBet()) {}
-            it = m_lBets.erase(it);
+            ForgetBet(*it);
+            it = m_cBetBoard.erase(it);
         }
         else
         {
@@ -453,6 +566,233 @@ void Strategy::FinalizeBets()
 
 }
 
+/**
+  * Update the bet counters for a bet leaving the table.
+  *
+  *\param cBet The Bet, resolved or taken down.
+  */
+
+void Strategy::ForgetBet(const Bet &cBet)
+{
+    if (cBet.IsPassBet()) --m_nNumberOfPassBetsMade;  //TODO make this true or false
+    //if (cBet.IsPassOddsBet()) {}
+    if (cBet.IsDontPassBet()) --m_nNumberOfDontPassBetsMade; //TODO make this true or false
+    //if (cBet.IsDontPassOddsBet()) {}
+    if (cBet.IsComeBet()) --m_nNumberOfComeBetsMade;
+    //if (cBet.IsComeOddsBet()) {}
+    if (cBet.IsDontComeBet()) --m_nNumberOfDontComeBetsMade;
+    //if (cBet.IsDontComeOddsBet()) {}
+    if (cBet.IsPutBet()) m_bPutBetMade = false;
+    //if (cBet.IsPutOddsBet()) {}
+    if (cBet.IsPlaceBet())
+    {
+        // Set Place bet number to false (bet not made)
+        m_abPlaceBets[cBet.Point()] = false;
+        // Decrement the number of Place bets made
+        --m_nNumberOfPlaceBetsMade;
+    }
+    if (cBet.IsBigBet())
+    {
+        if (cBet.IsBig6Bet()) --m_nNumberOfBig6BetsMade;
+        if (cBet.IsBig8Bet()) --m_nNumberOfBig8BetsMade;
+    }
+    if (cBet.IsHardBet())
+    {
+        if (cBet.IsHard4Bet())  --m_nNumberOfHard4BetsMade;
+        if (cBet.IsHard6Bet())  --m_nNumberOfHard6BetsMade;
+        if (cBet.IsHard8Bet())  --m_nNumberOfHard8BetsMade;
+        if (cBet.IsHard10Bet()) --m_nNumberOfHard10BetsMade;
+    }
+    //if (cBet.IsOneRollBet()) {}
+}
+
+/**
+  * Fill in the variables the betting rules read.
+  *
+  * Bets resolved on the last roll but not yet taken off the table do not
+  * count.
+  *
+  *\param cTable The Table.
+  *\param pnVariables The variables, RULE_VARIABLES of them.
+  */
+
+void Strategy::RuleVariables(const Table &cTable, int *pnVariables)
+{
+    std::fill(pnVariables, pnVariables + RULE_VARIABLES, 0);
+
+    pnVariables[static_cast<int>(RuleVariable::RV_COMEOUT)]   = cTable.IsComingOutRoll() ? 1 : 0;
+    pnVariables[static_cast<int>(RuleVariable::RV_POINT)]     = cTable.IsComingOutRoll() ? 0 : cTable.Point();
+    pnVariables[static_cast<int>(RuleVariable::RV_ROLL)]      = m_nLastRoll;
+    pnVariables[static_cast<int>(RuleVariable::RV_BANKROLL)]  = m_cMoney.Bankroll();
+    pnVariables[static_cast<int>(RuleVariable::RV_INITIAL)]   = m_cMoney.InitialBankroll();
+    pnVariables[static_cast<int>(RuleVariable::RV_WAGER)]     = m_cWager.StandardWager();
+    pnVariables[static_cast<int>(RuleVariable::RV_ROLLS)]     = m_nNumberOfRolls;
+    pnVariables[static_cast<int>(RuleVariable::RV_HITS)]      = m_nHits;
+    pnVariables[static_cast<int>(RuleVariable::RV_QUALIFIED)] = ShooterQualified() ? 1 : 0;
+
+    for (const Bet &cBet : m_cBetBoard)
+    {
+        if (cBet.Resolved()) continue;
+
+        RuleBet ecBet = RuleBetOf(cBet);
+        if (ecBet != RuleBet::RB_COUNT)
+            pnVariables[static_cast<int>(RuleVariable::RV_FIRST_BET) + static_cast<int>(ecBet)] += cBet.Wager();
+    }
+}
+
+/**
+  * Play the betting rules, routine and plugin.
+  *
+  * Fill in the variables the rules read, run the rules, resume the routine,
+  * call the plugin, and carry out the orders given, in order.
+  *
+  *\param cTable The Table.
+  */
+
+void Strategy::PlayRules(const Table &cTable)
+{
+    int anVariables[RULE_VARIABLES];
+    RuleVariables(cTable, anVariables);
+
+    m_vRuleOrders.clear();
+    m_cRuleProgram.Execute(anVariables, m_vRuleOrders);
+    m_cRoutine.Resume(anVariables, m_vRuleOrders);
+    if (m_cPlugin.Loaded()) m_cPlugin.MakeBets(anVariables, m_vRuleOrders);
+
+    for (const RuleOrder &cOrder : m_vRuleOrders)
+    {
+        CarryOut(cOrder, cTable);
+    }
+}
+
+/**
+  * Carry out an order of a betting rule.
+  *
+  * BET makes the bet if it is not already made; Pass and Dont Pass bets
+  * only on the come out.  PRESS adds to a bet, REGRESS takes some of it
+  * back and TAKEDOWN all of it; these apply only to bets that may be
+  * modified, so not to the Pass and Dont Pass bets.  Wagers are limited
+  * by the bankroll and the Table maximum.
+  *
+  *\param cOrder The order.
+  *\param cTable The Table.
+  */
+
+void Strategy::CarryOut(const RuleOrder &cOrder, const Table &cTable)
+{
+    BetBoard::iterator it = m_cBetBoard.begin();
+    while ((it != m_cBetBoard.end()) && (RuleBetOf(*it) != cOrder.ecBet)) ++it;
+
+    if (cOrder.ecAction == RuleAction::RA_BET)
+    {
+        if (it != m_cBetBoard.end()) return;
+
+        int nWager = std::min(std::min(cOrder.nAmount, m_cMoney.Bankroll()), cTable.MaximumBet());
+        if (nWager < 1) return;
+
+        Bet cBet;
+        switch (cOrder.ecBet)
+        {
+            case RuleBet::RB_PASS:
+                if (!cTable.IsComingOutRoll()) return;
+                cBet.MakePassBet(nWager);
+                ++m_nNumberOfPassBetsMade;
+                break;
+            case RuleBet::RB_DONT_PASS:
+                if (!cTable.IsComingOutRoll()) return;
+                cBet.MakeDontPassBet(nWager);
+                ++m_nNumberOfDontPassBetsMade;
+                break;
+            case RuleBet::RB_FIELD:
+                cBet.MakeFieldBet(nWager);
+                break;
+            case RuleBet::RB_PLACE4:  cBet.MakePlaceBet(nWager, 4);  break;
+            case RuleBet::RB_PLACE5:  cBet.MakePlaceBet(nWager, 5);  break;
+            case RuleBet::RB_PLACE6:  cBet.MakePlaceBet(nWager, 6);  break;
+            case RuleBet::RB_PLACE8:  cBet.MakePlaceBet(nWager, 8);  break;
+            case RuleBet::RB_PLACE9:  cBet.MakePlaceBet(nWager, 9);  break;
+            case RuleBet::RB_PLACE10: cBet.MakePlaceBet(nWager, 10); break;
+            case RuleBet::RB_HARD4:   cBet.MakeHard4Bet(nWager);  ++m_nNumberOfHard4BetsMade;  break;
+            case RuleBet::RB_HARD6:   cBet.MakeHard6Bet(nWager);  ++m_nNumberOfHard6BetsMade;  break;
+            case RuleBet::RB_HARD8:   cBet.MakeHard8Bet(nWager);  ++m_nNumberOfHard8BetsMade;  break;
+            case RuleBet::RB_HARD10:  cBet.MakeHard10Bet(nWager); ++m_nNumberOfHard10BetsMade; break;
+            case RuleBet::RB_COUNT:   return;
+        }
+
+        if (cBet.IsPlaceBet())
+        {
+            m_abPlaceBets[cBet.Point()] = true;
+            ++m_nNumberOfPlaceBetsMade;
+        }
+
+        m_cMoney.Decrement(nWager);
+        m_cBetBoard.push_back(cBet);
+        return;
+    }
+
+    if ((it == m_cBetBoard.end()) || !it->Modifiable()) return;
+
+    int nAmount = cOrder.nAmount;
+
+    if (cOrder.ecAction == RuleAction::RA_PRESS)
+    {
+        nAmount = std::min(std::min(nAmount, m_cMoney.Bankroll()), cTable.MaximumBet() - it->Wager());
+        if (nAmount < 1) return;
+
+        it->SetWager(it->Wager() + nAmount);
+        m_cMoney.Decrement(nAmount);
+    }
+    else if ((cOrder.ecAction == RuleAction::RA_REGRESS) && (nAmount < it->Wager()))
+    {
+        if (nAmount < 1) return;
+
+        it->SetWager(it->Wager() - nAmount);
+        m_cMoney.Increment(nAmount);
+    }
+    // Take down, or regress by the whole wager
+    else
+    {
+        m_cMoney.Increment(it->Wager());
+        ForgetBet(*it);
+        m_cBetBoard.erase(it);
+    }
+}
+
+/**
+  * Return the RuleBet a bet is.
+  *
+  *\param cBet The Bet.
+  *
+  *\return The RuleBet, or RuleBet::RB_COUNT if rules cannot name the bet.
+  */
+
+RuleBet Strategy::RuleBetOf(const Bet &cBet)
+{
+    if (cBet.IsPassBet())     return (RuleBet::RB_PASS);
+    if (cBet.IsDontPassBet()) return (RuleBet::RB_DONT_PASS);
+    if (cBet.IsFieldBet())    return (RuleBet::RB_FIELD);
+
+    if (cBet.IsPlaceBet())
+    {
+        switch (cBet.Point())
+        {
+            case 4:  return (RuleBet::RB_PLACE4);
+            case 5:  return (RuleBet::RB_PLACE5);
+            case 6:  return (RuleBet::RB_PLACE6);
+            case 8:  return (RuleBet::RB_PLACE8);
+            case 9:  return (RuleBet::RB_PLACE9);
+            case 10: return (RuleBet::RB_PLACE10);
+        }
+    }
+
+    if (cBet.IsHard4Bet())  return (RuleBet::RB_HARD4);
+    if (cBet.IsHard6Bet())  return (RuleBet::RB_HARD6);
+    if (cBet.IsHard8Bet())  return (RuleBet::RB_HARD8);
+    if (cBet.IsHard10Bet()) return (RuleBet::RB_HARD10);
+
+    return (RuleBet::RB_COUNT);
+}
+
 /**
   * Make a Pass Bet.
   *
@@ -478,7 +818,7 @@ void Strategy::MakePassBet(const Table &cTable)
             cBet.MakePassBet(nWager);
             m_cMoney.Decrement(nWager);
             ++m_nNumberOfPassBetsMade;
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 }
@@ -508,7 +848,7 @@ void Strategy::MakeDontPassBet(const Table &cTable)
             cBet.MakeDontPassBet(nWager);
             m_cMoney.Decrement(nWager);
             ++m_nNumberOfDontPassBetsMade;
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 }
@@ -539,7 +879,7 @@ void Strategy::MakeComeBet(const Table &cTable)
             cBet.MakeComeBet(nWager);
             m_cMoney.Decrement(nWager);
             ++m_nNumberOfComeBetsMade;
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 }
@@ -570,7 +910,7 @@ void Strategy::MakeDontComeBet(const Table &cTable)
             cBet.MakeDontComeBet(nWager);
             m_cMoney.Decrement(nWager);
             ++m_nNumberOfDontComeBetsMade;
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 }
@@ -593,7 +933,7 @@ void Strategy::MakeOddsBet(const Table &cTable)
     // 0.0 Odds indicates no Odds Bets
     if (m_fStandardOdds == 0.0) return;
 
-    for (std::list<Bet>::iterator it = m_lBets.begin();it != m_lBets.end(); ++it)
+    for (BetBoard::iterator it = m_cBetBoard.begin();it != m_cBetBoard.end(); ++it)
     {
         // Pass Bet or Dont Pass Bet
         if (it->IsPassBet() || it->IsDontPassBet() || it->IsComeBet() || it->IsDontComeBet() || it->IsPutBet())
@@ -658,7 +998,7 @@ void Strategy::MakeOddsBet(const Table &cTable)
                     it->SetOddsBetMade();
 
                     m_cMoney.Decrement(nWager);
-                    m_lBets.push_back(cBet);
+                    m_cBetBoard.push_back(cBet);
                 }
             }
         }
@@ -700,7 +1040,7 @@ void Strategy::MakePlaceBets(const Table &cTable)
                     cBet.MakeComeBet(nWager);
                     m_cMoney.Decrement(nWager);
                     ++m_nNumberOfComeBetsMade;
-                    m_lBets.push_back(cBet);
+                    m_cBetBoard.push_back(cBet);
                 }
                 // Make a Place bet
                 else
@@ -753,7 +1093,7 @@ void Strategy::MakePlaceBet()
     Bet cBet;
 
     // Set Place bet number to true (bet  made)
-    m_mPlaceBets[nPlaceBetNumber] = true;
+    m_abPlaceBets[nPlaceBetNumber] = true;
 
     // Make Place bet, with nWager (versus m_nWager)
     cBet.MakePlaceBet(nWager, nPlaceBetNumber);
@@ -762,7 +1102,7 @@ void Strategy::MakePlaceBet()
     // Increment the number of Place bets made
     ++m_nNumberOfPlaceBetsMade;
 
-    m_lBets.push_back(cBet);
+    m_cBetBoard.push_back(cBet);
 }
 
 /**
@@ -778,13 +1118,13 @@ void Strategy::MakePlaceBet()
 
 int Strategy::PlaceBetNumber()
 {
-    if (m_mPlaceBets[m_nPreferredPlaceBet] == false) return (m_nPreferredPlaceBet);
-    if (m_mPlaceBets[8]  == false) return (8);
-    if (m_mPlaceBets[6]  == false) return (6);
-    if (m_mPlaceBets[5]  == false) return (5);
-    if (m_mPlaceBets[9]  == false) return (9);
-    if (m_mPlaceBets[4]  == false) return (4);
-    if (m_mPlaceBets[10] == false) return (10);
+    if (m_abPlaceBets[m_nPreferredPlaceBet] == false) return (m_nPreferredPlaceBet);
+    if (m_abPlaceBets[8]  == false) return (8);
+    if (m_abPlaceBets[6]  == false) return (6);
+    if (m_abPlaceBets[5]  == false) return (5);
+    if (m_abPlaceBets[9]  == false) return (9);
+    if (m_abPlaceBets[4]  == false) return (4);
+    if (m_abPlaceBets[10] == false) return (10);
 
     return (-1);
 }
@@ -799,7 +1139,7 @@ int Strategy::PlaceBetNumber()
 
 bool Strategy::SixOrEightCovered()
 {
-    for (const Bet &cBet : m_lBets)
+    for (const Bet &cBet : m_cBetBoard)
     {
         if ((cBet.Point() == 6) || (cBet.Point() == 8))
             return (true);
@@ -832,7 +1172,7 @@ void Strategy::MakePutBet(const Table &cTable)
         cBet.MakePutBet(nWager, cTable.Point());
         m_cMoney.Decrement(nWager);
         m_bPutBetMade = true;
-        m_lBets.push_back(cBet);
+        m_cBetBoard.push_back(cBet);
 
         MakeOddsBet(cTable); // Take Odds on Put Bet
     }
@@ -862,7 +1202,7 @@ void Strategy::MakeHardWayBets()
         cBet.MakeHard4Bet(nWager);
         m_cMoney.Decrement(nWager);
         ++m_nNumberOfHard4BetsMade;
-        m_lBets.push_back(cBet);
+        m_cBetBoard.push_back(cBet);
     }
 
     if (m_bHard6BetAllowed && m_nNumberOfHard6BetsMade == 0)
@@ -875,7 +1215,7 @@ void Strategy::MakeHardWayBets()
         cBet.MakeHard6Bet(nWager);
         m_cMoney.Decrement(nWager);
         ++m_nNumberOfHard6BetsMade;
-        m_lBets.push_back(cBet);
+        m_cBetBoard.push_back(cBet);
     }
 
     if (m_bHard8BetAllowed && m_nNumberOfHard8BetsMade)
@@ -888,7 +1228,7 @@ void Strategy::MakeHardWayBets()
         cBet.MakeHard8Bet(nWager);
         m_cMoney.Decrement(nWager);
         ++m_nNumberOfHard8BetsMade;
-        m_lBets.push_back(cBet);
+        m_cBetBoard.push_back(cBet);
     }
 
     if (m_bHard10BetAllowed && m_nNumberOfHard10BetsMade)
@@ -901,7 +1241,7 @@ void Strategy::MakeHardWayBets()
         cBet.MakeHard10Bet(nWager);
         m_cMoney.Decrement(nWager);
         ++m_nNumberOfHard10BetsMade;
-        m_lBets.push_back(cBet);
+        m_cBetBoard.push_back(cBet);
     }
 }
 
@@ -927,7 +1267,7 @@ void Strategy::MakeBigBets()
         cBet.MakeBig6Bet(nWager);
         m_cMoney.Decrement(nWager);
         ++m_nNumberOfBig6BetsMade;
-        m_lBets.push_back(cBet);
+        m_cBetBoard.push_back(cBet);
     }
 
 
@@ -941,7 +1281,7 @@ void Strategy::MakeBigBets()
         cBet.MakeBig8Bet(nWager);
         m_cMoney.Decrement(nWager);
         ++m_nNumberOfBig8BetsMade;
-        m_lBets.push_back(cBet);
+        m_cBetBoard.push_back(cBet);
     }
 }
 
@@ -981,7 +1321,7 @@ void Strategy::MakeOneRollBets()
             Bet cBet;
             cBet.MakeFieldBet(nWager);
             m_cMoney.Decrement(nWager);
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 
@@ -994,7 +1334,7 @@ void Strategy::MakeOneRollBets()
             Bet cBet;
             cBet.MakeAny7Bet(nWager);
             m_cMoney.Decrement(nWager);
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 
@@ -1007,7 +1347,7 @@ void Strategy::MakeOneRollBets()
             Bet cBet;
             cBet.MakeAnyCrapsBet(nWager);
             m_cMoney.Decrement(nWager);
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 
@@ -1020,7 +1360,7 @@ void Strategy::MakeOneRollBets()
             Bet cBet;
             cBet.MakeCraps2Bet(nWager);
             m_cMoney.Decrement(nWager);
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 
@@ -1033,7 +1373,7 @@ void Strategy::MakeOneRollBets()
             Bet cBet;
             cBet.MakeCraps3Bet(nWager);
             m_cMoney.Decrement(nWager);
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 
@@ -1046,7 +1386,7 @@ void Strategy::MakeOneRollBets()
             Bet cBet;
             cBet.MakeYo11Bet(nWager);
             m_cMoney.Decrement(nWager);
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 
@@ -1059,7 +1399,7 @@ void Strategy::MakeOneRollBets()
             Bet cBet;
             cBet.MakeCraps12Bet(nWager);
             m_cMoney.Decrement(nWager);
-            m_lBets.push_back(cBet);
+            m_cBetBoard.push_back(cBet);
         }
     }
 }
@@ -1073,7 +1413,7 @@ void Strategy::MakeOneRollBets()
   *\param cDice The Dice.
   */
 
-void Strategy::ResolvePass(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolvePass(BetBoard::iterator &it, const Dice &cDice)
 {
     if (it->OnTheComeOut())                                 // Pass Bet On the Come Out?
     {
@@ -1118,7 +1458,7 @@ void Strategy::ResolvePass(std::list<Bet>::iterator &it, const Dice &cDice)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveDontPass(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolveDontPass(BetBoard::iterator &it, const Dice &cDice)
 {
     if (it->OnTheComeOut())                                 // Dont Pass Bet On the Come Out?
     {
@@ -1167,7 +1507,7 @@ void Strategy::ResolveDontPass(std::list<Bet>::iterator &it, const Dice &cDice)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveCome(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolveCome(BetBoard::iterator &it, const Dice &cDice)
 {
     if (it->OnTheComeOut())                                 // Come Bet On the Come Out?
     {
@@ -1212,7 +1552,7 @@ void Strategy::ResolveCome(std::list<Bet>::iterator &it, const Dice &cDice)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveDontCome(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolveDontCome(BetBoard::iterator &it, const Dice &cDice)
 {
     if (it->OnTheComeOut())                                 // Dont Come Bet On the Come Out?
     {
@@ -1259,7 +1599,7 @@ void Strategy::ResolveDontCome(std::list<Bet>::iterator &it, const Dice &cDice)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolvePut(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolvePut(BetBoard::iterator &it, const Dice &cDice)
 {
     if (cDice.IsSeven())                                    // Put Bet and a Seven Roll?
     {
@@ -1284,7 +1624,7 @@ void Strategy::ResolvePut(std::list<Bet>::iterator &it, const Dice &cDice)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolvePassOdds(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice)
+void Strategy::ResolvePassOdds(BetBoard::iterator &it, const Table &cTable, const Dice &cDice)
 {
     if (cTable.IsComingOutRoll() == true)             // There should not be a Pass Odds bet if this is coming out roll
         throw CrapSimException("Strategy::ResolvePassOdds called when Table is coming out");
@@ -1310,7 +1650,7 @@ void Strategy::ResolvePassOdds(std::list<Bet>::iterator &it, const Table &cTable
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveDontPassOdds(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice)
+void Strategy::ResolveDontPassOdds(BetBoard::iterator &it, const Table &cTable, const Dice &cDice)
 {
     if (cTable.IsComingOutRoll() == true)             // There should not be a Don't Pass Odds bet if this is coming out roll
         throw CrapSimException("Strategy::ResolveDontPassOdds called when Table is coming out");
@@ -1339,7 +1679,7 @@ void Strategy::ResolveDontPassOdds(std::list<Bet>::iterator &it, const Table &cT
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveComeOdds(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice)
+void Strategy::ResolveComeOdds(BetBoard::iterator &it, const Table &cTable, const Dice &cDice)
 {
     if (cTable.IsComingOutRoll())                           // Come Odds Bet and Come Out Roll for the Table?
     {
@@ -1396,7 +1736,7 @@ void Strategy::ResolveComeOdds(std::list<Bet>::iterator &it, const Table &cTable
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveDontComeOdds(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolveDontComeOdds(BetBoard::iterator &it, const Dice &cDice)
 {
     if (cDice.IsSeven())                                        // Dont Come Odds Bet and a Seven Roll?
     {
@@ -1419,7 +1759,7 @@ void Strategy::ResolveDontComeOdds(std::list<Bet>::iterator &it, const Dice &cDi
   *\param cDice The Dice.
   */
 
-void Strategy::ResolvePutOdds(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolvePutOdds(BetBoard::iterator &it, const Dice &cDice)
 {
     if (cDice.IsSeven())                                    // Put Odds Bets and a Seven Roll?
     {
@@ -1441,14 +1781,14 @@ void Strategy::ResolvePutOdds(std::list<Bet>::iterator &it, const Dice &cDice)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolvePlace(std::list<Bet>::iterator &it, const Table &cTable, const Dice &cDice)
+void Strategy::ResolvePlace(BetBoard::iterator &it, const Table &cTable, const Dice &cDice)
 {
     if (!cTable.IsComingOutRoll() || m_bPlaceWorking)       // Place Bets are off on the Table come out roll unless explicitly turned on
     {
         if (cDice.IsSeven())                                    // Place Bet and not a come out roll and a Seven Roll?
         {
             //// Set Place bet number to false (bet not made)
-            ////m_mPlaceBets[it->Point()] = false;
+            ////m_abPlaceBets[it->Point()] = false;
             //// Decrement the number of Place bets made
             ////--m_nNumberOfPlaceBetsMade;
             it->SetLost();
@@ -1458,7 +1798,7 @@ void Strategy::ResolvePlace(std::list<Bet>::iterator &it, const Table &cTable, c
             // Gather winnings
             m_cMoney.Increment(it->Wager() + it->CalculatePayoff());// Payoff
             //// Set Place bet number to false (bet not made)
-            ////m_mPlaceBets[it->Point()] = false;
+            ////m_abPlaceBets[it->Point()] = false;
             //// Decrement the number of Place bets made
             ////--m_nNumberOfPlaceBetsMade;
             it->SetWon();
@@ -1474,43 +1814,19 @@ void Strategy::ResolvePlace(std::list<Bet>::iterator &it, const Table &cTable, c
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveHardWayBets(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolveHardWayBets(BetBoard::iterator &it, const Dice &cDice)
 {
+    // A hard way bet is resolved only by a seven or by its number
+    if (!cDice.IsSeven() && (cDice.RollValue() != it->Point())) return;
+
     if (cDice.IsSeven() || !cDice.IsHard())
     {
         it->SetLost();
-        ////if (it->IsHard4Bet())  --m_nNumberOfHard4BetsMade;
-        ////if (it->IsHard6Bet())  --m_nNumberOfHard6BetsMade;
-        ////if (it->IsHard8Bet())  --m_nNumberOfHard8BetsMade;
-        ////if (it->IsHard10Bet()) --m_nNumberOfHard10BetsMade;
-    }
-
-    if (cDice.IsFour() && it->IsHard4Bet())
-    {
-        m_cMoney.Increment(it->Wager() + it->CalculatePayoff());
-        it->SetWon();
-        ////--m_nNumberOfHard4BetsMade;
     }
-
-    if (cDice.IsSix() && it->IsHard6Bet())
-    {
-        m_cMoney.Increment(it->Wager() + it->CalculatePayoff());
-        it->SetWon();
-        ////--m_nNumberOfHard6BetsMade;
-    }
-
-    if (cDice.IsEight() && it->IsHard8Bet())
-    {
-        m_cMoney.Increment(it->Wager() + it->CalculatePayoff());
-        it->SetWon();
-        ////--m_nNumberOfHard8BetsMade;
-    }
-
-    if (cDice.IsTen() && it->IsHard10Bet())
+    else
     {
         m_cMoney.Increment(it->Wager() + it->CalculatePayoff());
         it->SetWon();
-        ////--m_nNumberOfHard10BetsMade;
     }
 }
 
@@ -1522,7 +1838,7 @@ void Strategy::ResolveHardWayBets(std::list<Bet>::iterator &it, const Dice &cDic
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveBig(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolveBig(BetBoard::iterator &it, const Dice &cDice)
 {
     if (cDice.IsSeven())
     {
@@ -1555,7 +1871,7 @@ void Strategy::ResolveBig(std::list<Bet>::iterator &it, const Dice &cDice)
   *\param cDice The Dice.
   */
 
-void Strategy::ResolveOneRollBets(std::list<Bet>::iterator &it, const Dice &cDice)
+void Strategy::ResolveOneRollBets(BetBoard::iterator &it, const Dice &cDice)
 {
     if (it->IsFieldBet())                                   // Field Bet?
     {
@@ -1656,22 +1972,87 @@ bool Strategy::StillPlaying() const
     {
         // If bankroll is out of money and no more bets are on the table,
         // then stop playing
-        if ((m_cMoney.Bankroll() < m_cWager.StandardWager()) && (m_lBets.empty()))
+        if ((m_cMoney.Bankroll() < m_cWager.StandardWager()) && (m_cBetBoard.empty()))
             bStillPlaying = false;
 
         // If bankroll has significant winnings and no more bets are on the table,
         // then stop playing
-        if ((m_cMoney.HasSignificantWinnings()) && (m_lBets.empty()))
+        if ((m_cMoney.HasSignificantWinnings()) && (m_cBetBoard.empty()))
             bStillPlaying = false;
     }
 
     return (bStillPlaying);
 }
 
+/**
+  * Check whether the Strategy can be played as a PassLineKernel lane.
+  *
+  * The lane plays a Pass bet at the standard wager and Odds at the standard
+  * odds, nothing else.  Any other bet, progression, modification,
+  * qualification or tracing requires the Strategy itself.
+  *
+  *\return True if the Strategy makes only Pass and Pass Odds bets.
+  */
+
+bool Strategy::IsPassLineOnly() const
+{
+    if (m_nNumberOfPassBetsAllowed != 1) return (false);
+
+    if (m_nNumberOfComeBetsAllowed || m_nNumberOfDontPassBetsAllowed || m_nNumberOfDontComeBetsAllowed ||
+        m_nNumberOfPlaceBetsAllowed || m_bPutBetsAllowed || m_bFieldBetsAllowed ||
+        m_bBig6BetAllowed || m_bBig8BetAllowed ||
+        m_bHard4BetAllowed || m_bHard6BetAllowed || m_bHard8BetAllowed || m_bHard10BetAllowed ||
+        m_bAny7BetAllowed || m_bAnyCrapsBetAllowed || m_bCraps2BetAllowed || m_bCraps3BetAllowed ||
+        m_bYo11BetAllowed || m_bCraps12BetAllowed)
+        return (false);
+
+    if (IsUsingOddsProgession() || m_cWager.WagerProgressionMethodSet() ||
+        m_cWager.BetModificationMethodSet() || m_cQualifiedShooter.MethodSet() ||
+        HasRules())
+        return (false);
+
+    return (!m_bTrace);
+}
+
+/**
+  * Set the outcome of a run played on the Strategy's behalf.
+  *
+  * Used by the PassLineKernel so that the run is recorded by
+  * UpdateStatistics() as if the Strategy had played it.
+  *
+  *\param nBankroll Bankroll at the end of the run.
+  *\param nRolls Number of rolls played.
+  */
+
+void Strategy::SetRunResult(int nBankroll, int nRolls)
+{
+    m_cMoney.SetBankroll(nBankroll);
+    m_nNumberOfRolls = nRolls;
+}
+
+/**
+  * Check whether the current simulation run is a win.
+  *
+  * If using the PlayForNumberRolls configuration, a win is achieved when
+  * the current bankroll is greater than or equal to the initial bankroll.
+  * Otherwise, if the Strategy still has money, consider it a win.
+  *
+  *\return True if the run is a win.
+  */
+
+bool Strategy::RunWon() const
+{
+    if (m_nPlayForNumberOfRolls > 0)
+        return (m_cMoney.Bankroll() >= m_cMoney.InitialBankroll());
+
+    return (m_cMoney.Bankroll() > m_cWager.StandardWager());
+}
+
 /**
   * Update statistcs on the last simluation run.
   *
-  * Record the win or loss and the nuber of dice rolls.
+  * Record the win or loss and the nuber of dice rolls, and how and on which
+  * roll the run ended.
   *
   */
 
@@ -1679,11 +2060,21 @@ void Strategy::UpdateStatistics()
 {
     ++m_nTimesStrategyRun;
 
-    // If using the PlayForNumberRolls configuration, a win is achieved when
-    // the current bankroll is greater than the initial bankroll
+    m_cWinStatistics.Add(RunWon() ? 100.0 : 0.0);
+    m_cBankrollStatistics.Add(m_cMoney.Bankroll());
+    m_cRollsHistogram.Add(m_nNumberOfRolls);
+
+    // Runs played for a number of rolls end at the roll limit, so those
+    // out of money are counted as bust on the last roll
+    if (m_nPlayForNumberOfRolls > 0)
+        m_cSurvivalCurve.Add(m_cMoney.Bankroll() < m_cWager.StandardWager() ? SurvivalEvent::SE_BUST : SurvivalEvent::SE_STOPPED,
+                             m_nNumberOfRolls);
+    else
+        m_cSurvivalCurve.Add(RunWon() ? SurvivalEvent::SE_WON : SurvivalEvent::SE_BUST, m_nNumberOfRolls);
+
     if (m_nPlayForNumberOfRolls > 0)
     {
-        if (m_cMoney.Bankroll() >= m_cMoney.InitialBankroll())
+        if (RunWon())
         {
             ++m_nTimesStrategyWon;
 
@@ -1700,10 +2091,9 @@ void Strategy::UpdateStatistics()
             if (m_cMoney.Bankroll() > m_nLossBankrollMax) m_nLossBankrollMax = m_cMoney.Bankroll();
         }
     }
-    // Else if Strategy still has money, consider it a win.
     else
     {
-        if (m_cMoney.Bankroll() > m_cWager.StandardWager())
+        if (RunWon())
         {
             ++m_nTimesStrategyWon;
 
@@ -1722,39 +2112,115 @@ void Strategy::UpdateStatistics()
     }
 }
 
+/**
+  * Add the results of other runs.
+  *
+  * Counts and totals are summed, minimums and maximums are taken over both,
+  * and the running statistics, histogram and survival curve are merged, as
+  * if the runs had all been played by one Strategy.
+  *
+  * \param cOther The results merged.
+  */
+
+void StrategyResults::Merge(const StrategyResults &cOther)
+{
+    m_nTimesStrategyRun  += cOther.m_nTimesStrategyRun;
+    m_nTimesStrategyWon  += cOther.m_nTimesStrategyWon;
+    m_nTimesStrategyLost += cOther.m_nTimesStrategyLost;
+
+    m_nWinRollsMin        = std::min(m_nWinRollsMin, cOther.m_nWinRollsMin);
+    m_nWinRollsMax        = std::max(m_nWinRollsMax, cOther.m_nWinRollsMax);
+    m_nWinRollsTotal     += cOther.m_nWinRollsTotal;
+    m_nLossRollsMin       = std::min(m_nLossRollsMin, cOther.m_nLossRollsMin);
+    m_nLossRollsMax       = std::max(m_nLossRollsMax, cOther.m_nLossRollsMax);
+    m_nLossRollsTotal    += cOther.m_nLossRollsTotal;
+
+    m_nWinBankrollMin     = std::min(m_nWinBankrollMin, cOther.m_nWinBankrollMin);
+    m_nWinBankrollMax     = std::max(m_nWinBankrollMax, cOther.m_nWinBankrollMax);
+    m_nWinBankrollTotal  += cOther.m_nWinBankrollTotal;
+    m_nLossBankrollMin    = std::min(m_nLossBankrollMin, cOther.m_nLossBankrollMin);
+    m_nLossBankrollMax    = std::max(m_nLossBankrollMax, cOther.m_nLossBankrollMax);
+    m_nLossBankrollTotal += cOther.m_nLossBankrollTotal;
+
+    m_cWinStatistics.Merge(cOther.m_cWinStatistics);
+    m_cBankrollStatistics.Merge(cOther.m_cBankrollStatistics);
+    m_cRollsHistogram.Merge(cOther.m_cRollsHistogram);
+    m_cSurvivalCurve.Merge(cOther.m_cSurvivalCurve);
+}
+
+/**
+  * Return the width of the win percentage confidence interval.
+  *
+  * \return Full width of the 95% confidence interval, in percentage points.
+  */
+
+double Strategy::WinCIWidth() const
+{
+    return (2.0 * m_cWinStatistics.HalfWidth());
+}
+
+/**
+  * Return the width of the mean ending bankroll confidence interval.
+  *
+  * Expressed relative to the initial bankroll so that one target applies to
+  * Strategies with different bankrolls.
+  *
+  * \return Full width of the 95% confidence interval, as a percentage of
+  * the initial bankroll.
+  */
+
+double Strategy::BankrollCIWidth() const
+{
+    if (m_cMoney.InitialBankroll() <= 0) return (0.0);
+
+    return (2.0 * m_cBankrollStatistics.HalfWidth() / m_cMoney.InitialBankroll() * 100.0);
+}
+
+/**
+  * Check the Strategy's confidence intervals against a target.
+  *
+  * \param dTargetCIWidth The target width, used for both the win percentage
+  * (percentage points) and the mean ending bankroll (percent of initial).
+  *
+  * \return True if both intervals are no wider than the target.
+  */
+
+bool Strategy::MeetsTarget(double dTargetCIWidth) const
+{
+    if (m_cWinStatistics.Count() < 2) return (false);
+
+    return ((WinCIWidth() <= dTargetCIWidth) && (BankrollCIWidth() <= dTargetCIWidth));
+}
+
 /**
   * Resets the Strategy for a new simulation run.
   *
-  * Sets to zero the counts.  Resets the standard wager and odds.
-  * Calls Money.Reset().
+  * Restores the state captured by SnapshotState(), so the bankroll, wager,
+  * qualification, counters, odds and bets are as they were before the first
+  * run, with one plain copy and no allocation.  Tells the plugin, whose
+  * state is its own, that a new run starts.
   *
   */
 
 void Strategy::Reset()
 {
-    // Bet Counters - Sync with Strategy.h
-    m_nNumberOfPassBetsMade         = 0;
-    m_nNumberOfComeBetsMade         = 0;
-    m_nNumberOfDontPassBetsMade     = 0;
-    m_nNumberOfDontComeBetsMade     = 0;
-    m_nNumberOfPlaceBetsMade        = 0;
-    m_bPutBetMade                  = false;
-    m_nNumberOfBig6BetsMade         = 0;
-    m_nNumberOfBig8BetsMade         = 0;
-    m_nNumberOfHard4BetsMade        = 0;
-    m_nNumberOfHard6BetsMade        = 0;
-    m_nNumberOfHard8BetsMade        = 0;
-    m_nNumberOfHard10BetsMade       = 0;
-
-    m_nNumberOfRolls         = 0;
-
-    m_fOdds  = m_fStandardOdds;
-
-    m_lBets.clear();
-
-    m_cMoney.Reset();
-    m_cWager.Reset();
-    m_cQualifiedShooter.Reset();
+    static_cast<StrategyState &>(*this) = m_cInitialState;
+
+    m_cPlugin.Reset();
+}
+
+/**
+  * Capture the state a simulation run starts from.
+  *
+  * Called once the settings are final, at the end of SanityCheck().
+  *
+  */
+
+void Strategy::SnapshotState()
+{
+    m_fOdds = m_fStandardOdds;
+
+    m_cInitialState = static_cast<const StrategyState &>(*this);
 }
 
 /**
@@ -1762,77 +2228,157 @@ void Strategy::Reset()
   *
   * Prints a listing of the Strategy's settings.
   *
+  *\param osLog Where the listing is printed.
   */
 
-void Strategy::Muster() const
+void Strategy::Muster(std::ostream &osLog) const
 {
         const int left = 26;
         const int right = 25;
 
-        std::cout << std::setw(left) << std::right << "Name: "                << Name()                                   << std::endl;
-        std::cout << std::setw(left) << std::right << "Description: "         << Description()                            << std::endl;
+        osLog << std::setw(left) << std::right << "Name: "                << Name()                                   << std::endl;
+        osLog << std::setw(left) << std::right << "Description: "         << Description()                            << std::endl;
 
 
-        std::cout << std::setw(left) << std::right << "Pass Bet: "            << m_nNumberOfPassBetsAllowed               <<
+        osLog << std::setw(left) << std::right << "Pass Bet: "            << m_nNumberOfPassBetsAllowed               <<
                      std::setw(right) << std::right << "  Standard Wager: "    << m_cWager.StandardWager()                 << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Come Bets: "           << m_nNumberOfComeBetsAllowed               <<
+        osLog << std::setw(left) << std::right << "Come Bets: "           << m_nNumberOfComeBetsAllowed               <<
                      std::setw(right) << std::right << "  Full Wager: "        << std::boolalpha << m_bFullWager           << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Come Odds Working: "   << std::boolalpha << m_bComeOddsWorking     <<
+        osLog << std::setw(left) << std::right << "Come Odds Working: "   << std::boolalpha << m_bComeOddsWorking     <<
                      std::setw(right) << std::right << "  Initial Bankroll: "  << m_cMoney.InitialBankroll()               << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Dont Pass Bet: "       << m_nNumberOfDontPassBetsAllowed           <<
+        osLog << std::setw(left) << std::right << "Dont Pass Bet: "       << m_nNumberOfDontPassBetsAllowed           <<
                      std::setw(right) << std::right << "  Standard Odds: "     << m_fStandardOdds                          << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Dont Come Bets: "      << m_nNumberOfDontComeBetsAllowed           << std::endl;
+        osLog << std::setw(left) << std::right << "Dont Come Bets: "      << m_nNumberOfDontComeBetsAllowed           << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Place Bets: "          << m_nNumberOfPlaceBetsAllowed              <<
+        osLog << std::setw(left) << std::right << "Place Bets: "          << m_nNumberOfPlaceBetsAllowed              <<
                      std::setw(right) << std::right << "  Place Preferred: "   << m_nPreferredPlaceBet                     << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Place After Come: "    << std::boolalpha << m_bPlaceAfterCome      << std::endl;
-        std::cout << std::setw(left) << std::right << "Place Made At Once: "  << m_nNumberOfPlaceBetsMadeAtOnce           << std::endl;
+        osLog << std::setw(left) << std::right << "Place After Come: "    << std::boolalpha << m_bPlaceAfterCome      << std::endl;
+        osLog << std::setw(left) << std::right << "Place Made At Once: "  << m_nNumberOfPlaceBetsMadeAtOnce           << std::endl;
 
 
-        std::cout << std::setw(left) << std::right << "Field Bets: "          << std::boolalpha << m_bFieldBetsAllowed    <<
+        osLog << std::setw(left) << std::right << "Field Bets: "          << std::boolalpha << m_bFieldBetsAllowed    <<
                      std::setw(right) << std::right << "  Trace Results: "     << std::boolalpha << m_bTrace              << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Play For Number of Rolls: " << m_nPlayForNumberOfRolls            << std::endl;
+        osLog << std::setw(left) << std::right << "Play For Number of Rolls: " << m_nPlayForNumberOfRolls            << std::endl;
 
-        std::cout << std::setw(left) << std::right << "Sig. Win. Mult.: ";
+        osLog << std::setw(left) << std::right << "Sig. Win. Mult.: ";
         if (m_nPlayForNumberOfRolls < 1 )
-            std::cout << m_cMoney.SignificantWinningsMultiple() << std::endl;
+            osLog << m_cMoney.SignificantWinningsMultiple() << std::endl;
         else
-            std::cout << "NOT USED" << std::endl;
+            osLog << "NOT USED" << std::endl;
 
         int nSigWin = m_cMoney.SignificantWinnings();
         if (nSigWin > 0 && m_nPlayForNumberOfRolls < 1)
         {
-            std::cout << std::setw(left) << std::right << "Sig. Winnings: "       << m_cMoney.SignificantWinnings()       << std::endl;
+            osLog << std::setw(left) << std::right << "Sig. Winnings: "       << m_cMoney.SignificantWinnings()       << std::endl;
         }
         else
         {
-            std::cout << std::setw(left) << std::right << "Sig. Winnings: "       << "NOT USED"                           << std::endl;
+            osLog << std::setw(left) << std::right << "Sig. Winnings: "       << "NOT USED"                           << std::endl;
         }
 
-        std::cout << std::setw(left) << std::right << "Odds Prog. Method: ";
+        osLog << std::setw(left) << std::right << "Odds Prog. Method: ";
 
         if (!IsUsingOddsProgession())
-            std::cout << "NOT USED" << std::endl;
+            osLog << "NOT USED" << std::endl;
         else
         {
             if (IsArithmeticOddsProgression())
-                std::cout << "Arithmetic" << std::endl;
+                osLog << "Arithmetic" << std::endl;
             else
-                std::cout << "Geometric" << std::endl;
+                osLog << "Geometric" << std::endl;
         }
 
-        std::cout << std::setw(left) << std::right << "Wager Progression Method: " << m_cWager.WagerProgressionMethod() << std::endl;
-        std::cout << std::setw(left) << std::right << "Bet Modification Method: " << m_cWager.BetModificationMethod() << std::endl;
-        std::cout << std::setw(left) << std::right << "Qual. Shooter Method: "     << m_cQualifiedShooter.Method() << std::endl;
-        std::cout << std::setw(left) << std::right << "Qual. Shooter Method Cnt: " << m_cQualifiedShooter.Count() << std::endl;
+        osLog << std::setw(left) << std::right << "Wager Progression Method: " << m_cWager.WagerProgressionMethod() << std::endl;
+        osLog << std::setw(left) << std::right << "Bet Modification Method: " << m_cWager.BetModificationMethod() << std::endl;
+        osLog << std::setw(left) << std::right << "Qual. Shooter Method: "     << m_cQualifiedShooter.Method() << std::endl;
+        osLog << std::setw(left) << std::right << "Qual. Shooter Method Cnt: " << m_cQualifiedShooter.Count() << std::endl;
+
+        for (const std::string &sRule : m_cRuleProgram.RuleText())
+        {
+            osLog << std::setw(left) << std::right << "Rule: " << sRule << std::endl;
+        }
+
+        if (m_cRoutine.MethodSet())
+            osLog << std::setw(left) << std::right << "Routine: " << m_cRoutine.Method() << std::endl;
+
+        if (m_cPlugin.Loaded())
+            osLog << std::setw(left) << std::right << "Plugin: " << m_cPlugin.Path() << std::endl;
+
+        osLog << std::endl;
+}
 
-        std::cout << std::endl;
+/**
+  * Return the Strategy's fingerprint.
+  *
+  * Every setting that bears on how the Strategy plays, after
+  * SanityCheck(), one Key=Value per line.  The name and description are
+  * left out, so renaming a Strategy does not change it.  A plugin is known
+  * by its path and arguments, not by the contents of its library.
+  *
+  * \return The fingerprint.
+  */
+
+std::string Strategy::Fingerprint() const
+{
+    std::ostringstream ossFingerprint;
+    ossFingerprint << std::setprecision(9) << std::boolalpha;
+
+    ossFingerprint << "PassBet="                  << m_nNumberOfPassBetsAllowed           << "\n";
+    ossFingerprint << "ComeBets="                 << m_nNumberOfComeBetsAllowed           << "\n";
+    ossFingerprint << "DontPassBet="              << m_nNumberOfDontPassBetsAllowed       << "\n";
+    ossFingerprint << "DontComeBets="             << m_nNumberOfDontComeBetsAllowed       << "\n";
+    ossFingerprint << "PutBets="                  << m_bPutBetsAllowed                    << "\n";
+    ossFingerprint << "Big6Bet="                  << m_bBig6BetAllowed                    << "\n";
+    ossFingerprint << "Big8Bet="                  << m_bBig8BetAllowed                    << "\n";
+    ossFingerprint << "Hard4Bet="                 << m_bHard4BetAllowed                   << "\n";
+    ossFingerprint << "Hard6Bet="                 << m_bHard6BetAllowed                   << "\n";
+    ossFingerprint << "Hard8Bet="                 << m_bHard8BetAllowed                   << "\n";
+    ossFingerprint << "Hard10Bet="                << m_bHard10BetAllowed                  << "\n";
+    ossFingerprint << "Any7Bet="                  << m_bAny7BetAllowed                    << "\n";
+    ossFingerprint << "AnyCrapsBet="              << m_bAnyCrapsBetAllowed                << "\n";
+    ossFingerprint << "Craps2Bet="                << m_bCraps2BetAllowed                  << "\n";
+    ossFingerprint << "Craps3Bet="                << m_bCraps3BetAllowed                  << "\n";
+    ossFingerprint << "Yo11Bet="                  << m_bYo11BetAllowed                    << "\n";
+    ossFingerprint << "Craps12Bet="               << m_bCraps12BetAllowed                 << "\n";
+    ossFingerprint << "PlaceBets="                << m_nNumberOfPlaceBetsAllowed          << "\n";
+    ossFingerprint << "PlaceMadeAtOnce="          << m_nNumberOfPlaceBetsMadeAtOnce       << "\n";
+    ossFingerprint << "PlaceAfterCome="           << m_bPlaceAfterCome                    << "\n";
+    ossFingerprint << "PlaceBetUnits="            << m_nPlaceBetUnits                     << "\n";
+    ossFingerprint << "PlacePreferred="           << m_nPreferredPlaceBet                 << "\n";
+    ossFingerprint << "PlaceWorking="             << m_bPlaceWorking                      << "\n";
+    ossFingerprint << "FieldBet="                 << m_bFieldBetsAllowed                  << "\n";
+    ossFingerprint << "FieldBetUnits="            << m_nFieldBetUnits                     << "\n";
+    ossFingerprint << "StandardOdds="             << m_fStandardOdds                      << "\n";
+    ossFingerprint << "ComeOddsWorking="          << m_bComeOddsWorking                   << "\n";
+    ossFingerprint << "OddsProgression="          << static_cast<int>(m_ecOddsProgressionMethod) << "\n";
+    ossFingerprint << "PlayForNumberOfRolls="     << m_nPlayForNumberOfRolls              << "\n";
+    ossFingerprint << "InitialBankroll="          << m_cMoney.InitialBankroll()           << "\n";
+    ossFingerprint << "SWM="                      << m_cMoney.SignificantWinningsMultiple() << "\n";
+    ossFingerprint << "SignificantWinnings="      << m_cMoney.SignificantWinnings()       << "\n";
+    ossFingerprint << "StandardWager="            << m_cWager.StandardWager()             << "\n";
+    ossFingerprint << "FullWager="                << m_cWager.FullWager()                 << "\n";
+    ossFingerprint << "WagerProgressionMethod="   << m_cWager.WagerProgressionMethod()    << "\n";
+    ossFingerprint << "BetModificationMethod="    << m_cWager.BetModificationMethod()     << "\n";
+    ossFingerprint << "QualifiedShooterMethod="   << m_cQualifiedShooter.Method()         << "\n";
+    ossFingerprint << "QualifiedShooterMethodCount=" << m_cQualifiedShooter.Count()       << "\n";
+
+    for (const std::string &sRule : m_cRuleProgram.RuleText())
+    {
+        ossFingerprint << "Rule="                 << sRule                                << "\n";
+    }
+
+    ossFingerprint << "Routine="                  << m_cRoutine.Method()                  << "\n";
+    ossFingerprint << "Plugin="                   << m_cPlugin.Path()                     << "\n";
+    ossFingerprint << "PluginArguments="          << m_cPlugin.Arguments()                << "\n";
+    ossFingerprint << "PluginVersion="            << m_cPlugin.Version()                  << "\n";
+
+    return (ossFingerprint.str());
 }
 
 /**
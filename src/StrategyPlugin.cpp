@@ -0,0 +1,294 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StrategyPlugin.h"
+
+#include <sys/stat.h>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+// The plugin interface is plain C, so its numbers must match the rules'
+static_assert(CRAPSIM_VAR_FIRST_BET == static_cast<int>(RuleVariable::RV_FIRST_BET), "CrapSimVariable does not match RuleVariable");
+static_assert(CRAPSIM_VAR_QUALIFIED == static_cast<int>(RuleVariable::RV_QUALIFIED), "CrapSimVariable does not match RuleVariable");
+static_assert(CRAPSIM_BET_COUNT     == static_cast<int>(RuleBet::RB_COUNT),          "CrapSimBet does not match RuleBet");
+static_assert(CRAPSIM_BET_HARD10    == static_cast<int>(RuleBet::RB_HARD10),         "CrapSimBet does not match RuleBet");
+static_assert(CRAPSIM_ACTION_TAKEDOWN == static_cast<int>(RuleAction::RA_TAKEDOWN),  "CrapSimAction does not match RuleAction");
+static_assert(CRAPSIM_VARIABLES     == RULE_VARIABLES,                               "CRAPSIM_VARIABLES does not match RULE_VARIABLES");
+
+/**
+  * A loaded plugin library and the functions it exports.
+  *
+  * The library is unloaded when the last StrategyPlugin using it goes.
+  */
+
+struct PluginLibrary
+{
+#ifdef _WIN32
+    HMODULE pHandle {nullptr};
+#else
+    void   *pHandle {nullptr};
+#endif
+
+    CrapSimPluginCreateFunction      pfCreate      {nullptr};
+    CrapSimPluginDestroyFunction     pfDestroy     {nullptr};
+    CrapSimPluginResetFunction       pfReset       {nullptr};
+    CrapSimPluginMakeBetsFunction    pfMakeBets    {nullptr};
+    CrapSimPluginResolveBetsFunction pfResolveBets {nullptr};
+
+    // Size and modification time of the library file, empty if unknown
+    std::string sVersion;
+
+    PluginLibrary() = default;
+    PluginLibrary(const PluginLibrary &) = delete;
+    PluginLibrary& operator=(const PluginLibrary &) = delete;
+
+    ~PluginLibrary()
+    {
+#ifdef _WIN32
+        if (pHandle) FreeLibrary(pHandle);
+#else
+        if (pHandle) dlclose(pHandle);
+#endif
+    }
+
+    // Return the function exported as sName, nullptr if none
+    template <typename FUNCTION> FUNCTION Function(const char *sName) const
+    {
+#ifdef _WIN32
+        return (reinterpret_cast<FUNCTION>(GetProcAddress(pHandle, sName)));
+#else
+        return (reinterpret_cast<FUNCTION>(dlsym(pHandle, sName)));
+#endif
+    }
+};
+
+/**
+  * Copy a StrategyPlugin.
+  *
+  * The copy shares the library and makes its own plugin state.
+  *
+  * \param cOther The StrategyPlugin copied.
+  */
+
+StrategyPlugin::StrategyPlugin(const StrategyPlugin &cOther) :
+    m_pcLibrary(cOther.m_pcLibrary),
+    m_sPath(cOther.m_sPath),
+    m_sArguments(cOther.m_sArguments)
+{
+    Create();
+}
+
+/**
+  * Move a StrategyPlugin, taking its plugin state.
+  *
+  * \param cOther The StrategyPlugin moved.
+  */
+
+StrategyPlugin::StrategyPlugin(StrategyPlugin &&cOther) :
+    m_pcLibrary(std::move(cOther.m_pcLibrary)),
+    m_pState(cOther.m_pState),
+    m_sPath(std::move(cOther.m_sPath)),
+    m_sArguments(std::move(cOther.m_sArguments))
+{
+    cOther.m_pState = nullptr;
+}
+
+/**
+  * Assign a StrategyPlugin, by copy or move.
+  *
+  * \param cOther The StrategyPlugin, already copied or moved.
+  *
+  * \return This StrategyPlugin.
+  */
+
+StrategyPlugin& StrategyPlugin::operator=(StrategyPlugin cOther)
+{
+    std::swap(m_pcLibrary, cOther.m_pcLibrary);
+    std::swap(m_pState, cOther.m_pState);
+    std::swap(m_sPath, cOther.m_sPath);
+    std::swap(m_sArguments, cOther.m_sArguments);
+
+    return (*this);
+}
+
+/**
+  * Free the plugin state.
+  */
+
+StrategyPlugin::~StrategyPlugin()
+{
+    Destroy();
+}
+
+/**
+  * Load a plugin.
+  *
+  * Load the shared library, check that it was built for this ABI, find
+  * the functions it exports, and make the plugin state.  The size and
+  * modification time of the library file are kept as its version, so that
+  * results kept for one build of a plugin are not taken for another's.
+  *
+  * \param sPath The path of the shared library.
+  * \param sArguments Passed to the plugin when it makes its state.
+  */
+
+void StrategyPlugin::Load(const std::string &sPath, const std::string &sArguments)
+{
+    std::shared_ptr<PluginLibrary> pcLibrary = std::make_shared<PluginLibrary>();
+
+#ifdef _WIN32
+    pcLibrary->pHandle = LoadLibraryA(sPath.c_str());
+    if (pcLibrary->pHandle == nullptr)
+        throw CrapSimException("StrategyPlugin::Load cannot load", sPath);
+#else
+    pcLibrary->pHandle = dlopen(sPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (pcLibrary->pHandle == nullptr)
+        throw CrapSimException("StrategyPlugin::Load cannot load", dlerror());
+#endif
+
+    CrapSimPluginAbiFunction pfAbi = pcLibrary->Function<CrapSimPluginAbiFunction>("CrapSimPluginAbi");
+    if ((pfAbi == nullptr) || (pfAbi() != CRAPSIM_PLUGIN_ABI))
+        throw CrapSimException("StrategyPlugin::Load wrong ABI version", sPath);
+
+    pcLibrary->pfCreate      = pcLibrary->Function<CrapSimPluginCreateFunction>("CrapSimPluginCreate");
+    pcLibrary->pfDestroy     = pcLibrary->Function<CrapSimPluginDestroyFunction>("CrapSimPluginDestroy");
+    pcLibrary->pfReset       = pcLibrary->Function<CrapSimPluginResetFunction>("CrapSimPluginReset");
+    pcLibrary->pfMakeBets    = pcLibrary->Function<CrapSimPluginMakeBetsFunction>("CrapSimPluginMakeBets");
+    pcLibrary->pfResolveBets = pcLibrary->Function<CrapSimPluginResolveBetsFunction>("CrapSimPluginResolveBets");
+
+    if (pcLibrary->pfMakeBets == nullptr)
+        throw CrapSimException("StrategyPlugin::Load no CrapSimPluginMakeBets in", sPath);
+
+    // A path without a directory is looked up on the library search path,
+    // so its file is not known and the library has no version
+    struct stat stFile;
+    if ((sPath.find_first_of("/\\") != std::string::npos) && (stat(sPath.c_str(), &stFile) == 0))
+        pcLibrary->sVersion = std::to_string(static_cast<long long>(stFile.st_size)) + " bytes, modified " +
+                              std::to_string(static_cast<long long>(stFile.st_mtime));
+
+    Destroy();
+
+    m_pcLibrary  = std::move(pcLibrary);
+    m_sPath      = sPath;
+    m_sArguments = sArguments;
+
+    Create();
+}
+
+/**
+  * Return the version of the loaded library, its size and modification
+  * time, empty if not loaded or unknown.
+  *
+  * \return The version.
+  */
+
+std::string StrategyPlugin::Version() const
+{
+    return (m_pcLibrary ? m_pcLibrary->sVersion : std::string());
+}
+
+/**
+  * Make the plugin state.
+  */
+
+void StrategyPlugin::Create()
+{
+    if (m_pcLibrary && m_pcLibrary->pfCreate)
+        m_pState = m_pcLibrary->pfCreate(m_sArguments.c_str());
+}
+
+/**
+  * Free the plugin state.
+  */
+
+void StrategyPlugin::Destroy()
+{
+    if (m_pcLibrary && m_pcLibrary->pfDestroy && m_pState)
+        m_pcLibrary->pfDestroy(m_pState);
+
+    m_pState = nullptr;
+}
+
+/**
+  * Append the plugin's orders for the roll.
+  *
+  * The plugin writes all of its orders for the roll in one call, into an
+  * array on the stack, so a roll costs one call through a pointer however
+  * many orders it gives.
+  *
+  * \param pnVariables The variables the betting rules read, RULE_VARIABLES of them.
+  * \param vOrders The orders given.
+  */
+
+void StrategyPlugin::MakeBets(const int *pnVariables, std::vector<RuleOrder> &vOrders)
+{
+    CrapSimOrder aOrders[CRAPSIM_MAX_ORDERS];
+
+    int nOrders = m_pcLibrary->pfMakeBets(m_pState, pnVariables, aOrders, CRAPSIM_MAX_ORDERS);
+    if ((nOrders < 0) || (nOrders > CRAPSIM_MAX_ORDERS))
+        throw CrapSimException("StrategyPlugin::MakeBets bad number of orders from", m_sPath);
+
+    for (int iii = 0; iii < nOrders; ++iii)
+    {
+        const CrapSimOrder &cOrder = aOrders[iii];
+
+        if ((cOrder.nAction < CRAPSIM_ACTION_BET) || (cOrder.nAction > CRAPSIM_ACTION_TAKEDOWN) ||
+            (cOrder.nBet < 0) || (cOrder.nBet >= CRAPSIM_BET_COUNT))
+            throw CrapSimException("StrategyPlugin::MakeBets bad order from", m_sPath);
+
+        vOrders.push_back(RuleOrder{static_cast<RuleAction>(cOrder.nAction), static_cast<RuleBet>(cOrder.nBet), cOrder.nAmount});
+    }
+}
+
+/**
+  * Return whether the plugin exports CrapSimPluginResolveBets(), so that
+  * a Strategy fills in the variables after a roll only if they are read.
+  *
+  * \return True if the plugin is told when rolls are resolved.
+  */
+
+bool StrategyPlugin::ResolvesBets() const
+{
+    return (m_pcLibrary && m_pcLibrary->pfResolveBets);
+}
+
+/**
+  * Tell the plugin the roll was resolved.
+  *
+  * \param pnVariables The variables the betting rules read, after the roll.
+  */
+
+void StrategyPlugin::ResolveBets(const int *pnVariables)
+{
+    m_pcLibrary->pfResolveBets(m_pState, pnVariables);
+}
+
+/**
+  * Tell the plugin a new simulation run starts.
+  */
+
+void StrategyPlugin::Reset()
+{
+    if (m_pcLibrary && m_pcLibrary->pfReset) m_pcLibrary->pfReset(m_pState);
+}
@@ -0,0 +1,287 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "StrategyRoutine.h"
+
+#include <algorithm>
+#include <locale>
+
+// A routine's body is a switch on where it last waited.  ROUTINE_NEXT_ROLL
+// records its own line, returns, and on the next Resume() continues just
+// after itself, even inside a loop.  Anything a routine keeps from one roll
+// to the next must be a member, not a local variable, and there may be only
+// one ROUTINE_NEXT_ROLL per line.  Values read afresh on every resume, such
+// as the last roll, are computed before ROUTINE_BEGIN.  Routines loop
+// forever; Reset() starts them over.
+#define ROUTINE_BEGIN     switch (m_nResumePoint) { case 0:
+#define ROUTINE_NEXT_ROLL do { m_nResumePoint = __LINE__; return; case __LINE__: ; } while (false)
+#define ROUTINE_END       }
+
+// Return a variable the routines read
+static int Value(const int *pnVariables, RuleVariable ecVariable)
+{
+    return (pnVariables[static_cast<int>(ecVariable)]);
+}
+
+// Return the wager on a bet, 0 if not made
+static int Wager(const int *pnVariables, RuleBet ecBet)
+{
+    return (pnVariables[static_cast<int>(RuleVariable::RV_FIRST_BET) + static_cast<int>(ecBet)]);
+}
+
+// Return the Place bet on a number
+static RuleBet PlaceBet(int nNumber)
+{
+    switch (nNumber)
+    {
+        case 4:  return (RuleBet::RB_PLACE4);
+        case 5:  return (RuleBet::RB_PLACE5);
+        case 6:  return (RuleBet::RB_PLACE6);
+        case 8:  return (RuleBet::RB_PLACE8);
+        case 9:  return (RuleBet::RB_PLACE9);
+        case 10: return (RuleBet::RB_PLACE10);
+        default: return (RuleBet::RB_COUNT);
+    }
+}
+
+// Give an order
+static void Order(std::vector<RuleOrder> &vOrders, RuleAction ecAction, RuleBet ecBet, int nAmount)
+{
+    vOrders.push_back(RuleOrder{ecAction, ecBet, nAmount});
+}
+
+// Names of the betting routines
+static constexpr struct { const char *pszName; RoutineMethod ecMethod; } g_asRoutineMethods[] =
+{
+    {"NO_ROUTINE",     RoutineMethod::RM_NO_ROUTINE},
+    {"PRESS_AND_WAIT", RoutineMethod::RM_PRESS_AND_WAIT},
+    {"HIT_AND_RUN",    RoutineMethod::RM_HIT_AND_RUN}
+};
+
+/**
+  * Set the routine.
+  *
+  * Based on a passed string, sets the betting routine.  The string is
+  * looked up in the table of routine names.
+  *
+  * \param sMethod The routine, e.g., PRESS_AND_WAIT.
+  */
+
+void StrategyRoutine::SetMethod(std::string sMethod)
+{
+    std::locale loc;
+    for (std::string::size_type iii = 0; iii < sMethod.length(); ++iii)
+        sMethod[iii] = std::toupper(sMethod[iii], loc);
+
+    for (const auto &sMethodName : g_asRoutineMethods)
+    {
+        if (sMethod == sMethodName.pszName)
+        {
+            m_ecRoutineMethod = sMethodName.ecMethod;
+            Reset();
+            return;
+        }
+    }
+
+    throw CrapSimException("StrategyRoutine::SetMethod unknown method", sMethod);
+}
+
+/**
+  * Return the routine in string format.
+  *
+  * \return String representing the routine.
+  */
+
+std::string StrategyRoutine::Method() const
+{
+    std::string sMethod("Unknown");
+
+    for (const auto &sMethodName : g_asRoutineMethods)
+    {
+        if (m_ecRoutineMethod == sMethodName.ecMethod)
+        {
+            sMethod = sMethodName.pszName;
+            break;
+        }
+    }
+
+    return(sMethod);
+}
+
+/**
+  * Resume the routine.
+  *
+  * Called once before every roll the Strategy plays.  The routine runs from
+  * where it last waited until it waits for the next roll, appending its
+  * orders.
+  *
+  * \param pnVariables The variables the betting rules read, RULE_VARIABLES of them.
+  * \param vOrders The orders given.
+  */
+
+void StrategyRoutine::Resume(const int *pnVariables, std::vector<RuleOrder> &vOrders)
+{
+    switch (m_ecRoutineMethod)
+    {
+        case RoutineMethod::RM_PRESS_AND_WAIT:
+            PressAndWait(pnVariables, vOrders);
+            break;
+        case RoutineMethod::RM_HIT_AND_RUN:
+            HitAndRun(pnVariables, vOrders);
+            break;
+        case RoutineMethod::RM_NO_ROUTINE:
+            break;
+    }
+}
+
+/**
+  * Reset the routine to its start.
+  */
+
+void StrategyRoutine::Reset()
+{
+    m_nResumePoint = 0;
+    m_nHits        = 0;
+    m_nUnits       = 0;
+    m_nWait        = 0;
+}
+
+/**
+  * The Press And Wait routine.
+  *
+  * Once a point is set, place the 6 and 8, and keep them placed until a
+  * seven out, pressing both by a unit after every second hit.  After the
+  * seven out, sit out three rolls before waiting for the next point.  A
+  * unit is the standard wager rounded down to a multiple of 6, as the 6 and
+  * 8 pay 7 to 6.
+  *
+  * A Place bet that wins comes down with its payoff, so the routine places
+  * it again at the pressed amount; a bet that is still up is left alone.
+  *
+  * \param pnVariables The variables the betting rules read.
+  * \param vOrders The orders given.
+  */
+
+void StrategyRoutine::PressAndWait(const int *pnVariables, std::vector<RuleOrder> &vOrders)
+{
+    const int nUnit = std::max(6, Value(pnVariables, RuleVariable::RV_WAGER) / 6 * 6);
+    const int nRoll = Value(pnVariables, RuleVariable::RV_ROLL);
+
+    ROUTINE_BEGIN
+
+    while (true)
+    {
+        m_nHits  = 0;
+        m_nUnits = 1;
+
+        // Wait for a point
+        while (Value(pnVariables, RuleVariable::RV_POINT) == 0) ROUTINE_NEXT_ROLL;
+
+        while (true)
+        {
+            Order(vOrders, RuleAction::RA_BET, RuleBet::RB_PLACE6, m_nUnits * nUnit);
+            Order(vOrders, RuleAction::RA_BET, RuleBet::RB_PLACE8, m_nUnits * nUnit);
+
+            ROUTINE_NEXT_ROLL;
+
+            // A seven that took the bets down is a seven out; on the come
+            // out the bets are off and stay up
+            if ((nRoll == 7) && (Wager(pnVariables, RuleBet::RB_PLACE6) == 0))
+                break;
+
+            // A bet on the roll's number that is down has won
+            if (((nRoll == 6) || (nRoll == 8)) && (Wager(pnVariables, PlaceBet(nRoll)) == 0))
+            {
+                if (++m_nHits % 2 == 0) ++m_nUnits;
+            }
+        }
+
+        // Sit out three rolls
+        for (m_nWait = 0; m_nWait < 3; ++m_nWait) ROUTINE_NEXT_ROLL;
+    }
+
+    ROUTINE_END
+}
+
+/**
+  * The Hit And Run routine.
+  *
+  * Once a point is set, place the 5, 6, 8 and 9, placing each again after
+  * it hits.  After two hits, take all four down and wait for the next come
+  * out; after a seven out, wait for the next point.  The 5 and 9 are placed
+  * in units of 5 and the 6 and 8 in units of 6, from the standard wager.
+  *
+  * \param pnVariables The variables the betting rules read.
+  * \param vOrders The orders given.
+  */
+
+void StrategyRoutine::HitAndRun(const int *pnVariables, std::vector<RuleOrder> &vOrders)
+{
+    static const int anNumbers[] = {5, 6, 8, 9};
+
+    const int nWager = Value(pnVariables, RuleVariable::RV_WAGER);
+    const int nFive  = std::max(5, nWager / 5 * 5);
+    const int nSix   = std::max(6, nWager / 6 * 6);
+    const int nRoll  = Value(pnVariables, RuleVariable::RV_ROLL);
+
+    ROUTINE_BEGIN
+
+    while (true)
+    {
+        m_nHits = 0;
+
+        // Wait for a point
+        while (Value(pnVariables, RuleVariable::RV_POINT) == 0) ROUTINE_NEXT_ROLL;
+
+        while (true)
+        {
+            for (int nNumber : anNumbers)
+            {
+                Order(vOrders, RuleAction::RA_BET, PlaceBet(nNumber), (nNumber == 6 || nNumber == 8) ? nSix : nFive);
+            }
+
+            ROUTINE_NEXT_ROLL;
+
+            // Seven out, with every bet taken
+            if ((nRoll == 7) &&
+                (Wager(pnVariables, RuleBet::RB_PLACE5) + Wager(pnVariables, RuleBet::RB_PLACE6) +
+                 Wager(pnVariables, RuleBet::RB_PLACE8) + Wager(pnVariables, RuleBet::RB_PLACE9) == 0))
+                break;
+
+            // A bet on the roll's number that is down has won
+            if ((nRoll == 5 || nRoll == 6 || nRoll == 8 || nRoll == 9) && (Wager(pnVariables, PlaceBet(nRoll)) == 0))
+                ++m_nHits;
+
+            if (m_nHits == 2)
+            {
+                for (int nNumber : anNumbers)
+                {
+                    Order(vOrders, RuleAction::RA_TAKEDOWN, PlaceBet(nNumber), 0);
+                }
+
+                // Wait for the come out
+                while (Value(pnVariables, RuleVariable::RV_POINT) != 0) ROUTINE_NEXT_ROLL;
+
+                break;
+            }
+        }
+    }
+
+    ROUTINE_END
+}
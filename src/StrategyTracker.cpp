@@ -36,9 +36,7 @@ StrategyTracker::StrategyTracker(Strategy *pcStrategy)
     m_ofsBasics->open(sFileName);
     if (!m_ofsBasics->is_open())
     {
-        std::cerr << "ERROR (StrategyTracker): Could not open " << sFileName << " for writing" << std::endl;
-        std::cerr << "Exiting" << std::endl;
-        exit (EXIT_FAILURE);
+        throw CrapSimException("StrategyTracker Could not open for writing", sFileName);
     }
 
     sFileName = "CrapSim" + sStrategyName + "SingleBets.csv";
@@ -46,9 +44,7 @@ StrategyTracker::StrategyTracker(Strategy *pcStrategy)
     m_ofsSingleBets->open(sFileName);
     if (!m_ofsSingleBets->is_open())
     {
-        std::cerr << "ERROR (StrategyTracker): Could not open " << sFileName << " for writing" << std::endl;
-        std::cerr << "Exiting" << std::endl;
-        exit (EXIT_FAILURE);
+        throw CrapSimException("StrategyTracker Could not open for writing", sFileName);
     }
 }
 
@@ -137,12 +133,12 @@ void StrategyTracker::RecordNew(const Strategy *pcStrategy, const Table &cTable)
 }
 
 // Record additions and changes to bets before roll
-void StrategyTracker::RecordBetsBeforeRoll(const Strategy *pcStrategy, const std::list<Bet> &lBets)
+void StrategyTracker::RecordBetsBeforeRoll(const Strategy *pcStrategy, const BetBoard &lBets)
 {
     // Clear struct before recording bets
     m_stBeforeSingleBets = {};
 
-    for (std::list<Bet>::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
+    for (BetBoard::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
     {
         if ((*it).IsPassBet())
         {
@@ -180,12 +176,12 @@ void StrategyTracker::RecordBetsBeforeRoll(const Strategy *pcStrategy, const std
 }
 
 // Record additions and changes to bets after roll
-void StrategyTracker::RecordBetsAfterRoll(const Strategy *pcStrategy, const std::list<Bet> &lBets, int nRoll)
+void StrategyTracker::RecordBetsAfterRoll(const Strategy *pcStrategy, const BetBoard &lBets, int nRoll)
 {
     // Clear struct before recording bets
     m_stAfterSingleBets = {};
 
-    for (std::list<Bet>::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
+    for (BetBoard::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
     {
         if ((*it).IsPassBet())
         {
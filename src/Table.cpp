@@ -20,10 +20,24 @@
 #include "Table.h"
 
 
+// Names of the types of Table odds
+static constexpr struct { const char *pszName; TableOdds ecTableOdds; } g_asTableOdds[] =
+{
+    {"1X",          TableOdds::TYPE_1X},
+    {"2X",          TableOdds::TYPE_2X},
+    {"FULL_DOUBLE", TableOdds::TYPE_FULL_DOUBLE},
+    {"3X",          TableOdds::TYPE_3X},
+    {"3X_4X_5X",    TableOdds::TYPE_3X_4X_5X},
+    {"5X",          TableOdds::TYPE_5X},
+    {"10X",         TableOdds::TYPE_10X},
+    {"20X",         TableOdds::TYPE_20X},
+    {"100X",        TableOdds::TYPE_100X}
+};
+
 /**
   * Construct a Table.
   *
-  * Set minimum and maximum wagers and sets up a map for Table Odds.
+  * Set minimum and maximum wagers.
   *
   */
 
@@ -31,16 +45,6 @@ Table::Table(int nMin, int nMax)
 {
     nMin > 0 ? m_nMinimumBet = nMin : m_nMinimumBet = 5;
     nMax > 0 ? m_nMaximumBet = nMax : m_nMaximumBet = 5000;
-
-    m_mTableOdds["1X"]          = TableOdds::TYPE_1X;
-    m_mTableOdds["2X"]          = TableOdds::TYPE_2X;
-    m_mTableOdds["FULL_DOUBLE"] = TableOdds::TYPE_FULL_DOUBLE;
-    m_mTableOdds["3X"]          = TableOdds::TYPE_3X;
-    m_mTableOdds["3X_4X_5X"]    = TableOdds::TYPE_3X_4X_5X;
-    m_mTableOdds["5X"]          = TableOdds::TYPE_5X;
-    m_mTableOdds["10X"]         = TableOdds::TYPE_10X;
-    m_mTableOdds["20X"]         = TableOdds::TYPE_20X;
-    m_mTableOdds["100X"]        = TableOdds::TYPE_100X;
 }
 
 /**
@@ -117,8 +121,8 @@ float Table::MaxOdds(int nPoint) const
 /**
   * Set the table type.
   *
-  * Based on a passed string, sets the table odds.  The string is set in the
-  * map of strings and TableOdds types.
+  * Based on a passed string, sets the table odds.  The string is looked up
+  * in the table of TableOdds names.
   *
   * \param sTableType The type of table odds, e.g., 3X_4X_5X, 10X.
   *
@@ -134,34 +138,36 @@ bool Table::SetTableType(std::string sTableType)
     for (std::string::size_type iii = 0; iii < sTableType.length(); ++iii)
         sTableType[iii] = std::toupper(sTableType[iii], loc);
 
-    std::map<std::string, TableOdds>::iterator it = m_mTableOdds.find(sTableType);
-
-    if (it == m_mTableOdds.end()) return (false);
+    for (const auto &sTableOdds : g_asTableOdds)
+    {
+        if (sTableType == sTableOdds.pszName)
+        {
+            m_ecTableOdds = sTableOdds.ecTableOdds;
+            return (true);
+        }
+    }
 
-    //SetTableOdds(it->second);
-    m_ecTableOdds = it->second;
-    return (true);
+    return (false);
 }
 
 /**
   * Return the table type in string format.
   *
   * Loops the known table types and compares to this table's odds.  When found,
-  * return correspnding string. The string is set in the map of strings and
-  * TableOdds types.
+  * return correspnding string.
   *
   * \return String representing the type of table odds.
   */
 
-std::string Table::TableType()
+std::string Table::TableType() const
 {
     std::string sTableType("Unknown");
 
-    for (std::map<std::string, TableOdds>::iterator it = m_mTableOdds.begin(); it != m_mTableOdds.end(); ++it)
+    for (const auto &sTableOdds : g_asTableOdds)
     {
-        if (m_ecTableOdds == it->second)
+        if (m_ecTableOdds == sTableOdds.ecTableOdds)
         {
-            sTableType = it->first;
+            sTableType = sTableOdds.pszName;
             break;
         }
     }
@@ -0,0 +1,85 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "TemporaryFile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+  * Write text to a new temporary file.
+  *
+  * The file is made with a unique name, so that jobs running at once never
+  * share one.
+  *
+  * \param sText The text written.
+  */
+
+TemporaryFile::TemporaryFile(const std::string &sText)
+{
+#ifdef _WIN32
+    char szDirectory[MAX_PATH + 1];
+    char szPath[MAX_PATH + 1];
+    if ((GetTempPathA(sizeof(szDirectory), szDirectory) == 0) ||
+        (GetTempFileNameA(szDirectory, "CrapSim", 0, szPath) == 0))
+        throw CrapSimException("TemporaryFile cannot create temporary file");
+    m_sPath = szPath;
+#else
+    const char *pszTemporary = std::getenv("TMPDIR");
+    std::string sTemplate = std::string(pszTemporary ? pszTemporary : "/tmp") + "/CrapSimJobXXXXXX";
+
+    std::vector<char> vszPath(sTemplate.begin(), sTemplate.end());
+    vszPath.push_back('\0');
+    int nFd = mkstemp(vszPath.data());
+    if (nFd < 0)
+        throw CrapSimException("TemporaryFile cannot create temporary file", std::strerror(errno));
+    close(nFd);
+    m_sPath = vszPath.data();
+#endif // _WIN32
+
+    std::ofstream ofsFile(m_sPath, std::ios::binary | std::ios::trunc);
+    ofsFile << sText;
+    ofsFile.close();
+
+    if (!ofsFile)
+    {
+        std::remove(m_sPath.c_str());
+        throw CrapSimException("TemporaryFile cannot write temporary file", m_sPath);
+    }
+}
+
+/**
+  * Remove the file.
+  */
+
+TemporaryFile::~TemporaryFile()
+{
+    std::remove(m_sPath.c_str());
+}
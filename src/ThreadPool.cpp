@@ -0,0 +1,98 @@
+/*
+    Copyright 2014 Dom Maddalone
+
+    This file is part of CrapSim.
+
+    CrapSim is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    CrapSim is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ThreadPool.h"
+
+#include <utility>
+
+/**
+  * Start the threads.
+  *
+  * \param nThreads Number of threads, one per hardware thread if less than one.
+  */
+
+ThreadPool::ThreadPool(int nThreads)
+{
+    if (nThreads < 1) nThreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (nThreads < 1) nThreads = 1;
+
+    m_vThreads.reserve(nThreads);
+    for (int iii = 0; iii < nThreads; ++iii)
+    {
+        m_vThreads.emplace_back(&ThreadPool::Work, this);
+    }
+}
+
+/**
+  * Finish the tasks submitted, then stop the threads.
+  */
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtxTasks);
+        m_bStopping = true;
+    }
+    m_cvTasks.notify_all();
+
+    for (std::thread &cThread : m_vThreads)
+    {
+        cThread.join();
+    }
+}
+
+/**
+  * Run a task on the next free thread.
+  *
+  * \param fTask The task.  It must not throw.
+  */
+
+void ThreadPool::Submit(Task fTask)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtxTasks);
+        m_dqTasks.push_back(std::move(fTask));
+    }
+    m_cvTasks.notify_one();
+}
+
+/**
+  * Run tasks until the pool is stopped and no task is left.
+  */
+
+void ThreadPool::Work()
+{
+    while (true)
+    {
+        Task fTask;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mtxTasks);
+            m_cvTasks.wait(lock, [this] { return (m_bStopping || !m_dqTasks.empty()); });
+
+            if (m_dqTasks.empty()) return;
+
+            fTask = std::move(m_dqTasks.front());
+            m_dqTasks.pop_front();
+        }
+
+        fTask();
+    }
+}
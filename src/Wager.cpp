@@ -19,29 +19,28 @@
 
 #include "Wager.h"
 
-/**
-  * Construct a Progression.
-  *
-  * Sets up a maps for wager progression and bet modification methods.
-  */
-
-Wager::Wager()
+// Names of the wager progression methods
+static constexpr struct { const char *pszName; WagerProgressionMethods ecMethod; } g_asWagerProgressionMethods[] =
 {
-    m_mWagerProgressionMethod["NO_METHOD"]  = WagerProgressionMethods::WP_NO_METHOD;
-    m_mWagerProgressionMethod["1_3_2_6"]    = WagerProgressionMethods::WP_1_3_2_6;
-    m_mWagerProgressionMethod["FIBONACCI"]  = WagerProgressionMethods::WP_FIBONACCI;
-    m_mWagerProgressionMethod["MARTINGALE"] = WagerProgressionMethods::WP_MARTINGALE;
-    m_mWagerProgressionMethod["PAROLI"]     = WagerProgressionMethods::WP_PAROLI;
-
-    m_mBetModificationMethod["NO_METHOD"]                  = BetModificationMethods::BM_NO_METHOD;
-    m_mBetModificationMethod["COLLECT_PRESS_REGRESS"]      = BetModificationMethods::BM_COLLECT_PRESS_REGRESS;
-    m_mBetModificationMethod["CLASSIC_REGRESSION"]         = BetModificationMethods::BM_CLASSIC_REGRESSION;
-    m_mBetModificationMethod["PRESS_ONCE"]                 = BetModificationMethods::BM_PRESS_ONCE;
-    m_mBetModificationMethod["PRESS_TWICE"]                = BetModificationMethods::BM_PRESS_TWICE;
-    m_mBetModificationMethod["TAKE_DOWN_AFTER_ONE_HIT"]    = BetModificationMethods::BM_TAKE_DOWN_AFTER_ONE_HIT;
-    m_mBetModificationMethod["TAKE_DOWN_AFTER_TWO_HITS"]   = BetModificationMethods::BM_TAKE_DOWN_AFTER_TWO_HITS;
-    m_mBetModificationMethod["TAKE_DOWN_AFTER_THREE_HITS"] = BetModificationMethods::BM_TAKE_DOWN_AFTER_THREE_HITS;
-}
+    {"NO_METHOD",  WagerProgressionMethods::WP_NO_METHOD},
+    {"1_3_2_6",    WagerProgressionMethods::WP_1_3_2_6},
+    {"FIBONACCI",  WagerProgressionMethods::WP_FIBONACCI},
+    {"MARTINGALE", WagerProgressionMethods::WP_MARTINGALE},
+    {"PAROLI",     WagerProgressionMethods::WP_PAROLI}
+};
+
+// Names of the bet modification methods
+static constexpr struct { const char *pszName; BetModificationMethods ecMethod; } g_asBetModificationMethods[] =
+{
+    {"NO_METHOD",                  BetModificationMethods::BM_NO_METHOD},
+    {"COLLECT_PRESS_REGRESS",      BetModificationMethods::BM_COLLECT_PRESS_REGRESS},
+    {"CLASSIC_REGRESSION",         BetModificationMethods::BM_CLASSIC_REGRESSION},
+    {"PRESS_ONCE",                 BetModificationMethods::BM_PRESS_ONCE},
+    {"PRESS_TWICE",                BetModificationMethods::BM_PRESS_TWICE},
+    {"TAKE_DOWN_AFTER_ONE_HIT",    BetModificationMethods::BM_TAKE_DOWN_AFTER_ONE_HIT},
+    {"TAKE_DOWN_AFTER_TWO_HITS",   BetModificationMethods::BM_TAKE_DOWN_AFTER_TWO_HITS},
+    {"TAKE_DOWN_AFTER_THREE_HITS", BetModificationMethods::BM_TAKE_DOWN_AFTER_THREE_HITS}
+};
 
 /**
   * Initialize the wager class.
@@ -61,7 +60,7 @@ void Wager::Initialize(const int nStdWager)
   * Set the wager progression method.
   *
   * Based on a passed string, sets the wager progression method.
-  * The string is set in the map of strings and WagerProgressionMethod types.
+  * The string is looked up in the table of WagerProgressionMethods names.
   *
   * \param sMethod The wager progression method, e.g., 1-3-2-5, Martingale.
   *
@@ -73,24 +72,23 @@ void Wager::SetWagerProgressionMethod(std::string sMethod)
     for (std::string::size_type iii = 0; iii < sMethod.length(); ++iii)
         sMethod[iii] = std::toupper(sMethod[iii], loc);
 
-    std::map<std::string, WagerProgressionMethods>::iterator it = m_mWagerProgressionMethod.find(sMethod);
-
-    if (it != m_mWagerProgressionMethod.end())
-    {
-        m_ecWagerProgressionMethod = it->second;
-    }
-    else
+    for (const auto &sMethodName : g_asWagerProgressionMethods)
     {
-        throw CrapSimException("Wager::SetWagerProgressionMethod unknown method", sMethod);
+        if (sMethod == sMethodName.pszName)
+        {
+            m_ecWagerProgressionMethod = sMethodName.ecMethod;
+            return;
+        }
     }
+
+    throw CrapSimException("Wager::SetWagerProgressionMethod unknown method", sMethod);
 }
 
 /**
   * Return the wager progression method for a shooter in string format.
   *
   * Loops the known wager progression methods and compares to this Strategy's
-  * wager progression method.  When found, return correspnding string. The
-  * string is set in the map of strings and WagerProgressionMethod types.
+  * wager progression method.  When found, return correspnding string.
   *
   * \return String representing the wager progression method.
   */
@@ -99,13 +97,11 @@ std::string Wager::WagerProgressionMethod() const
 {
     std::string sMethod("Unknown");
 
-    for (std::map<std::string, WagerProgressionMethods>::const_iterator it = m_mWagerProgressionMethod.begin();
-         it != m_mWagerProgressionMethod.end();
-         ++it)
+    for (const auto &sMethodName : g_asWagerProgressionMethods)
     {
-        if (m_ecWagerProgressionMethod == it->second)
+        if (m_ecWagerProgressionMethod == sMethodName.ecMethod)
         {
-            sMethod = it->first;
+            sMethod = sMethodName.pszName;
             break;
         }
     }
@@ -117,7 +113,7 @@ std::string Wager::WagerProgressionMethod() const
   * Set the bet modification method.
   *
   * Based on a passed string, sets the bet modification method.
-  * The string is set in the map of strings and BetModificationMethod types.
+  * The string is looked up in the table of BetModificationMethods names.
   *
   * \param sMethod The wager progression method, e.g., Classic_Regression, Press_Once
   *
@@ -129,24 +125,23 @@ void Wager::SetBetModificationMethod(std::string sMethod)
     for (std::string::size_type iii = 0; iii < sMethod.length(); ++iii)
         sMethod[iii] = std::toupper(sMethod[iii], loc);
 
-    std::map<std::string, BetModificationMethods>::iterator it = m_mBetModificationMethod.find(sMethod);
-
-    if (it != m_mBetModificationMethod.end())
-    {
-        m_ecBetModificationMethod = it->second;
-    }
-    else
+    for (const auto &sMethodName : g_asBetModificationMethods)
     {
-        throw CrapSimException("Wager::SetBetModificationMethod unknown method", sMethod);
+        if (sMethod == sMethodName.pszName)
+        {
+            m_ecBetModificationMethod = sMethodName.ecMethod;
+            return;
+        }
     }
+
+    throw CrapSimException("Wager::SetBetModificationMethod unknown method", sMethod);
 }
 
 /**
   * Return the bet modification method in string format.
   *
   * Loops the known bet modification methods and compares to this Strategy's
-  * bet modification method.  When found, return corresponding string. The
-  * string is set in the map of strings and BetModificationMethod types.
+  * bet modification method.  When found, return corresponding string.
   *
   * \return String representing the bet modification method.
   */
@@ -155,13 +150,11 @@ std::string Wager::BetModificationMethod() const
 {
     std::string sMethod("Unknown");
 
-    for (std::map<std::string, BetModificationMethods>::const_iterator it = m_mBetModificationMethod.begin();
-         it != m_mBetModificationMethod.end();
-         ++it)
+    for (const auto &sMethodName : g_asBetModificationMethods)
     {
-        if (m_ecBetModificationMethod == it->second)
+        if (m_ecBetModificationMethod == sMethodName.ecMethod)
         {
-            sMethod = it->first;
+            sMethod = sMethodName.pszName;
             break;
         }
     }
@@ -410,7 +403,7 @@ void Wager::PlaceBetFullPayoffWager(const int nPlaceNumber)
   * \return The number of wager units to bet.
   */
 
-int Wager::WagerUnits(const std::list<Bet>::iterator &it)
+int Wager::WagerUnits(const BetBoard::iterator &it)
 {
     switch (m_ecWagerProgressionMethod)
     {
@@ -447,7 +440,7 @@ int Wager::WagerUnits(const std::list<Bet>::iterator &it)
   * \return The number of wager units to bet.
   */
 
-int Wager::MethodMartingale(const std::list<Bet>::iterator &it)
+int Wager::MethodMartingale(const BetBoard::iterator &it)
 {
     if (it->Lost())
         m_nUnits = m_nUnits * 2;
@@ -480,7 +473,7 @@ int Wager::MethodMartingale(const std::list<Bet>::iterator &it)
   * \return The number of wager units to bet.
   */
 
-int Wager::Method1_3_2_6(const std::list<Bet>::iterator &it)
+int Wager::Method1_3_2_6(const BetBoard::iterator &it)
 {
     if (it->Lost())
     {
@@ -528,7 +521,7 @@ int Wager::Method1_3_2_6(const std::list<Bet>::iterator &it)
   * \return The number of wager units to bet.
   */
 
-int Wager::MethodFibonacci(const std::list<Bet>::iterator &it)
+int Wager::MethodFibonacci(const BetBoard::iterator &it)
 {
     if (it->Won())
     {
@@ -557,7 +550,7 @@ int Wager::MethodFibonacci(const std::list<Bet>::iterator &it)
   * \return The number of wager units to bet.
   */
 
-int Wager::MethodParoli(const std::list<Bet>::iterator &it)
+int Wager::MethodParoli(const BetBoard::iterator &it)
 {
     if (it->Lost())
     {
@@ -576,13 +569,13 @@ int Wager::MethodParoli(const std::list<Bet>::iterator &it)
   *
   * Depending on the set bet modification method, calls the corresponding
   * bet modification method.  The bet modifications methods operate from the
-  * Strategy's list of bets.
+  * Strategy's board of bets.
   *
   * \param cBet The Bet.
   *
   */
 
-bool Wager::ModifyBets(Money &cMoney, const Table &cTable, std::list<Bet> &lBets)
+bool Wager::ModifyBets(Money &cMoney, const Table &cTable, BetBoard &lBets)
 {
     ////if (lBets.empty()) return (false);
 
@@ -623,17 +616,17 @@ bool Wager::ModifyBets(Money &cMoney, const Table &cTable, std::list<Bet> &lBets
   *
   * Check to see if any modifiable bets exists.
   *
-  * \param lBets The list container of bets
+  * \param lBets The board of bets
   *
   * \return True if modifiable bets exists, false otherwise
   *
   */
 
-bool Wager::ModifiableBetsExist(const std::list<Bet> &lBets) const
+bool Wager::ModifiableBetsExist(const BetBoard &lBets) const
 {
     if (lBets.empty()) return (false);
 
-    for (std::list<Bet>::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
+    for (BetBoard::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
     {
         if (it->Modifiable()) return (true);
     }
@@ -647,11 +640,11 @@ bool Wager::ModifiableBetsExist(const std::list<Bet> &lBets) const
   * Reset counter if coming out and no bets are currently laid.
   * Loop through bets and check for a won bet.  If found, set flag to true.
   *
-  * \param lBets The list container of bets
+  * \param lBets The board of bets
   *
   */
 
-void Wager::BetModificationSetup(const Table &cTable, const std::list<Bet> &lBets)
+void Wager::BetModificationSetup(const Table &cTable, const BetBoard &lBets)
 {
     // If table is coming out and no modifiable bets exist, reset counter
     if (cTable.IsComingOutRoll() && !ModifiableBetsExist(lBets))  // This counts all bets  TODO: count only modifiable bets
@@ -663,7 +656,7 @@ void Wager::BetModificationSetup(const Table &cTable, const std::list<Bet> &lBet
     // If found, increment by one
     m_bWon = false;
 
-    for (std::list<Bet>::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
+    for (BetBoard::const_iterator it = lBets.begin(); it != lBets.end(); ++it)
     {
         if (it->Won())
         {
@@ -686,12 +679,12 @@ void Wager::BetModificationSetup(const Table &cTable, const std::list<Bet> &lBet
   * \param cMoney The bankroll
   * \param cTable The table
   * \param cDice The dice
-  * \param lBets The list container of bets
+  * \param lBets The board of bets
   *
   * \return True if no more bets should be made, false otherwise
   */
 
-bool Wager::MethodCollectPressRegress(Money &cMoney, const Table &cTable, std::list<Bet> &lBets)
+bool Wager::MethodCollectPressRegress(Money &cMoney, const Table &cTable, BetBoard &lBets)
 {
     BetModificationSetup(cTable, lBets);
     if (m_bWon) ++m_nBetModCounter;
@@ -702,7 +695,7 @@ bool Wager::MethodCollectPressRegress(Money &cMoney, const Table &cTable, std::l
 
     if (m_bWon && m_nBetModCounter == 1)
     {
-        for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+        for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
         {
             if (it->Modifiable() && it->Won())
             {
@@ -721,7 +714,7 @@ bool Wager::MethodCollectPressRegress(Money &cMoney, const Table &cTable, std::l
 
     if (m_bWon && m_nBetModCounter == 2)
     {
-        for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+        for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
         {
             if (it->Modifiable()  && it->Won())
             {
@@ -741,7 +734,7 @@ bool Wager::MethodCollectPressRegress(Money &cMoney, const Table &cTable, std::l
 
     if (m_bWon && m_nBetModCounter == 3)
     {
-        for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+        for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
         {
             if (it->Modifiable()  && it->Won())
             {
@@ -770,12 +763,12 @@ bool Wager::MethodCollectPressRegress(Money &cMoney, const Table &cTable, std::l
   * \param cMoney The bankroll
   * \param cTable The table
   * \param cDice The dice
-  * \param lBets The list container of bets
+  * \param lBets The board of bets
   *
   * \return True if no more bets should be made, false otherwise
   */
 
-bool Wager::MethodClassicRegression(Money &cMoney, const Table &cTable, std::list<Bet> &lBets)
+bool Wager::MethodClassicRegression(Money &cMoney, const Table &cTable, BetBoard &lBets)
 {
     bool bStopMakingBets = false;
 
@@ -792,7 +785,7 @@ bool Wager::MethodClassicRegression(Money &cMoney, const Table &cTable, std::lis
 
     if (m_bWon && m_nBetModCounter == 1)
     {
-        for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+        for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
         {
             // If bet is modifiable
             if (it->Modifiable())
@@ -841,7 +834,7 @@ bool Wager::MethodClassicRegression(Money &cMoney, const Table &cTable, std::lis
 
     if (m_bWon && m_nBetModCounter == 2)
     {
-        for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+        for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
         {
             if (it->Modifiable())
             {
@@ -871,13 +864,13 @@ bool Wager::MethodClassicRegression(Money &cMoney, const Table &cTable, std::lis
   * \param cMoney The bankroll
   * \param cTable The table
   * \param cDice The dice
-  * \param lBets The list container of bets
+  * \param lBets The board of bets
   * \param nTimes The numbers of times to press
   *
   * \return True if no more bets should be made, false otherwise
   */
 
-bool Wager::MethodPress(Money &cMoney, const Table &cTable, std::list<Bet> &lBets, const int nTimes)
+bool Wager::MethodPress(Money &cMoney, const Table &cTable, BetBoard &lBets, const int nTimes)
 {
     BetModificationSetup(cTable, lBets);
     if (m_bWon) ++m_nBetModCounter;
@@ -893,7 +886,7 @@ bool Wager::MethodPress(Money &cMoney, const Table &cTable, std::list<Bet> &lBet
     {
         if (m_nBetModCounter <= nTimes)
         {
-            for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+            for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
             {
                 if (it->Modifiable() && it->Won())
                 {
@@ -925,13 +918,13 @@ bool Wager::MethodPress(Money &cMoney, const Table &cTable, std::list<Bet> &lBet
   * \param cMoney The bankroll
   * \param cTable The table
   * \param cDice The dice
-  * \param lBets The list container of bets
+  * \param lBets The board of bets
   * \param nTimes The numbers of times to press
   *
   * \return True if no more bets should be made, false otherwise
   */
 
-bool Wager::MethodTakeDownAfterHits(Money &cMoney, const Table &cTable, std::list<Bet> &lBets, const int nTimes)
+bool Wager::MethodTakeDownAfterHits(Money &cMoney, const Table &cTable, BetBoard &lBets, const int nTimes)
 {
     BetModificationSetup(cTable, lBets);
     if (m_bWon) ++m_nBetModCounter;
@@ -945,7 +938,7 @@ bool Wager::MethodTakeDownAfterHits(Money &cMoney, const Table &cTable, std::lis
     {
         if (m_nBetModCounter <= nTimes)
         {
-            for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+            for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
             {
                 if (it->Modifiable() && it->Won())
                 {
@@ -957,7 +950,7 @@ bool Wager::MethodTakeDownAfterHits(Money &cMoney, const Table &cTable, std::lis
         // Else remove all modifiable unresolved bets and reset thge counter
         else
         {
-            for (std::list<Bet>::iterator it = lBets.begin(); it != lBets.end(); ++it)
+            for (BetBoard::iterator it = lBets.begin(); it != lBets.end(); ++it)
             {
                 if (it->Modifiable() && !it->Resolved())
                 {
@@ -17,20 +17,43 @@
     along with CrapSim.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <chrono>
 #include <climits>
 #include <cfloat>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
 #include <getopt.h>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "CrapSimException.h"
 #include "CrapSimVersion.h"
+#include "Configuration.h"
 #include "Bet.h"
 #include "Die.h"
 #include "Dice.h"
 #include "Table.h"
 #include "Money.h"
+#include "Optimizer.h"
+#include "RollTape.h"
+#include "ParameterGrid.h"
 #include "Simulation.h"
+#include "SimulationCluster.h"
+#include "SimulationServer.h"
 #include "Strategy.h"
 #include "CDataFile.h"
+#include "TemporaryFile.h"
+#include "ThreadPool.h"
 
 /**
   * ShowUsage
@@ -45,8 +68,32 @@ static void ShowUsage(std::string sName)
     std::cerr << "Usage: " << sName << " [OPTION] [FILE]\n"
               << "Run a Craps Simulation based on settings in the FILE\n\n"
               << "Options:\n"
-              << "    -h, --help     Show this help message and exit\n"
-              << "    -v, --version  Show version and exit\n"
+              << "    -h, --help         Show this help message and exit\n"
+              << "    -o, --optimize     Search for the best Strategy settings in the\n"
+              << "                       Optimizer section of the FILE\n"
+              << "    -b, --benchmark    Time each Strategy of the FILE played alone and\n"
+              << "                       report the nanoseconds per roll\n"
+              << "    -r, --resume       Carry on from the Checkpoint of the FILE, if\n"
+              << "                       there is one\n"
+              << "    -S, --shard I/N    Play shard I of N of the runs and write their\n"
+              << "                       results to FILE.I-of-N.partial\n"
+              << "    -m, --merge        Merge the partial results files following the\n"
+              << "                       FILE and report them as one simulation\n"
+              << "    -I, --import-rolls LOG\n"
+              << "                       Record the rolls of the text roll LOG to the\n"
+              << "                       roll tape FILE\n"
+              << "    -c, --coordinate [ADDRESS:]PORT\n"
+              << "                       Hand the runs of the FILE to workers joining on\n"
+              << "                       TCP PORT of ADDRESS (default 127.0.0.1) and\n"
+              << "                       report them as one simulation; the coordinator\n"
+              << "                       and workers share a token in CRAPSIM_CLUSTER_TOKEN\n"
+              << "    -j, --join HOST:PORT\n"
+              << "                       Play runs for the coordinator at HOST:PORT\n"
+              << "                       instead of running a FILE\n"
+              << "    -s, --serve SOCKET Serve simulation jobs on a Unix domain SOCKET\n"
+              << "                       instead of running a FILE\n"
+              << "    -w, --workers N    Run N jobs at once when serving (default 1)\n"
+              << "    -v, --version      Show version and exit\n"
               << std::endl;
 }
 
@@ -62,225 +109,299 @@ static void ShowVersion()
     std::cerr << "Craps Simulation version " << CrapSimVersion::SemanticVersion() << " " << CrapSimVersion::DateVersion() << std::endl;
 }
 
+// Keys the Optimizer searches when the Optimizer section does not set them,
+// with the values searched.
+static const char *const g_apszOptimizerDefaults[][2] =
+{
+    {"StandardOdds",           "{1,2,3,5,10,20,100}"},
+    {"ComeBets",               "0..6"},
+    {"PlaceBets",              "0..6"},
+    {"PlaceBetUnits",          "1..5"},
+    {"SWM",                    "1.25..5:0.25"},
+    {"WagerProgressionMethod", "{NO_METHOD,1_3_2_6,FIBONACCI,MARTINGALE,PAROLI}"},
+    {"BetModificationMethod",  "{NO_METHOD,COLLECT_PRESS_REGRESS,CLASSIC_REGRESSION,PRESS_ONCE,PRESS_TWICE,"
+                               "TAKE_DOWN_AFTER_ONE_HIT,TAKE_DOWN_AFTER_TWO_HITS,TAKE_DOWN_AFTER_THREE_HITS}"},
+    {"QualifiedShooterMethod", "{NO_METHOD,5COUNT,AFTER_POINT_ESTABLISHED,AFTER_POINT_MADE,"
+                               "AFTER_LOSING_FIELD_THREE_TIMES_IN_A_ROW,AFTER_FIVE_NON_SEVEN_ROLLS,"
+                               "AFTER_N_2_ROLLS_IN_A_ROW,AFTER_N_3_ROLLS_IN_A_ROW,AFTER_N_4_ROLLS_IN_A_ROW,"
+                               "AFTER_N_5_ROLLS_IN_A_ROW,AFTER_N_6_ROLLS_IN_A_ROW,AFTER_N_8_ROLLS_IN_A_ROW,"
+                               "AFTER_N_9_ROLLS_IN_A_ROW,AFTER_N_10_ROLLS_IN_A_ROW,AFTER_N_11_ROLLS_IN_A_ROW,"
+                               "AFTER_N_12_ROLLS_IN_A_ROW}"}
+};
+
 /**
-  * Create a Strategy.
+  * Optimizer Driver.
   *
-  * Construct the Simulation and the Table.  Read the configuration file for
-  * all non-Strategy configuration sections. Create strategies.  Run
-  * simulations.  Report.
+  * Read the Optimizer section of the configuration file.  Keys written with
+  * range or list syntax are searched over their values; the default search
+  * keys not set in the section are searched over their default values; all
+  * other keys are shared by every candidate.  Search, then write the best
+  * Strategies as configuration file sections.
   *
-  *\param sStrategy Section name of strategy from the configuration file
   *\param cConfigFile Configfile class containing key, value settings
-  *\param nDefaultInitBank Default initial bankroll
-  *\param nDefaultStdWager Default standard wager
-  *\param fDefaultSWM Default significant winnings multiple
-  *\param nDefaultSigWin Default significant winnings amount
-  *\param nDefaultPlayForNumberOfRolls Default number of rolls to play before ending the simulation run
-  *\param cSim The Simulation class
+  *\param cTable The Table candidates play
+  *\param nSeed Seed of the search, from the Seed key; INT_MIN if not set
+  *\param fCreateStrategy Creates a Strategy from the Optimizer section and settings
+  *
   */
 
-void CreateStrategy(const std::string sStrategy, CDataFile &cConfigFile, const int nDefaultInitBank,
-                    const int nDefaultStdWager, const float fDefaultSWM, const int nDefaultSigWin,
-                    const int nDefaultPlayForNumberOfRolls, Simulation &cSim)
+static int CrapsOptimizer(CDataFile &cConfigFile, const Table &cTable, int nSeed, Optimizer::StrategyFactory fCreateStrategy)
 {
-    //
-    // Read config file for parameters this Strategy
-    //
-
-    // Basic
-    std::string sName                   = cConfigFile.GetString("Name", sStrategy);
-    std::string sDescription            = cConfigFile.GetString("Description", sStrategy);
-
-    // Money
-    int         nStandardWager          = cConfigFile.GetInt("StandardWager", sStrategy);
-    bool        bFullWager              = cConfigFile.GetBool("FullWager", sStrategy);
-    int         nInitialBankroll        = cConfigFile.GetInt("InitialBankroll", sStrategy);
-    int         nSignificantWinnings    = cConfigFile.GetInt("SignificantWinnings", sStrategy);
-    float       fSWM                    = cConfigFile.GetFloat("SWM", sStrategy);
-    int         nPlayForNumberOfRolls  = cConfigFile.GetInt("PlayForNumberOfRolls", sStrategy);
-
-    // Predefined Strategies
-    std::string sPredefined             = cConfigFile.GetString("Predefined", sStrategy);
-
-    // Types and numbers of bets allowed
-    int         nPassBet                = cConfigFile.GetInt("PassBet", sStrategy);
-    int         nDontPassBet            = cConfigFile.GetInt("DontPassBet", sStrategy);
-    int         nComeBets               = cConfigFile.GetInt("ComeBets", sStrategy);
-    int         nDontComeBets           = cConfigFile.GetInt("DontComeBets", sStrategy);
-
-    int         nPlaceBets              = cConfigFile.GetInt("PlaceBets", sStrategy);
-    int         nPlaceBetsMadeAtOnce    = cConfigFile.GetInt("PlaceBetsMadeAtOnce", sStrategy);
-    bool        bPlaceAfterCome         = cConfigFile.GetBool("PlaceAfterCome", sStrategy);
-    std::string sPlaceAfterCome         = cConfigFile.GetString("PlaceAfterCome", sStrategy); // Needed for Predefined strategies
-    int         nPlacePreferred         = cConfigFile.GetInt("PlacePreferred");
-    int         nPlaceBetUnits          = cConfigFile.GetInt("PlaceBetUnits",sStrategy);
-    bool        bPlaceWorking           = cConfigFile.GetBool("PlaceWorking", sStrategy);
-
-    bool        bPutBet                 = cConfigFile.GetBool("PutBet", sStrategy);
-
-    bool        bFieldBet               = cConfigFile.GetBool("FieldBet", sStrategy);
-    int         nFieldBetUnits          = cConfigFile.GetInt("FieldBetUnits",sStrategy);
-
-    bool        bBig6Bet                = cConfigFile.GetBool("Big6Bet", sStrategy);
-    bool        bBig8Bet                = cConfigFile.GetBool("Big8Bet", sStrategy);
-    bool        bAny7Bet                = cConfigFile.GetBool("Any7Bet", sStrategy);
-    bool        bAnyCrapsBet            = cConfigFile.GetBool("AnyCrapsBet", sStrategy);
-    bool        bCraps2Bet              = cConfigFile.GetBool("Craps2Bet", sStrategy);
-    bool        bCraps3Bet              = cConfigFile.GetBool("Craps3Bet", sStrategy);
-    bool        bYo11Bet                = cConfigFile.GetBool("Yo11Bet", sStrategy);
-    bool        bCraps12Bet             = cConfigFile.GetBool("Craps12Bet", sStrategy);
-
-    // Odds settings
-    float       fStandardOdds           = cConfigFile.GetFloat("StandardOdds", sStrategy);
-    bool        bComeOddsWorking        = cConfigFile.GetBool("ComeOddsWorking", sStrategy);
-    std::string sOddsProgressionMethod  = cConfigFile.GetString("OddsProgressionMethod", sStrategy);
-
-    // Wager progression method
-    std::string sWagerProgressionMethod = cConfigFile.GetString("WagerProgressionMethod", sStrategy);
-
-    // Shooter qualification method
-    std::string sQualifiedShooterMethod = cConfigFile.GetString("QualifiedShooterMethod", sStrategy);
-    int         nQualifiedShooterMethodCount = cConfigFile.GetInt("QualifiedShooterMethodCount", sStrategy);
-
-    // Bet modification method
-    std::string sBetModificationMethod = cConfigFile.GetString("BetModificationMethod", sStrategy);
-
-    // Tracking results (used for debugging)
-    bool        bTrace                  = cConfigFile.GetBool("Trace", sStrategy);
-
-    //
-    // Set the Strategy's parameters
-    //
-
-    // Set initial bankroll.  Use DefaultStrategy setting if individual strategy's InitialBankroll is not set.
-    if (nInitialBankroll == INT_MIN) nInitialBankroll = nDefaultInitBank;
-
-    // Set standard wager.  Use DefaultStrategy setting if individual strategy's StandardWager is not set.
-    if (nStandardWager == INT_MIN) nStandardWager = nDefaultStdWager;
-
-    //Create Strategy
-    Strategy cStrategy(sName, sDescription, nInitialBankroll, nStandardWager, bTrace);
-
-    // If Predefined is defined, use it to modify Strategy.  Exit if entry is unknown.
-    if (sPredefined != "")
-    {
-        // TODO: make this a utility
-        std::locale loc;
-        for (std::string::size_type iii = 0; iii < sPredefined.length(); ++iii)
-            sPredefined[iii] = std::toupper(sPredefined[iii], loc);
-
-        if      (sPredefined == "ELEMENTARY")   cStrategy.SetElementary();
-        else if (sPredefined == "CONSERVATIVE") cStrategy.SetConservative();
-        else if (sPredefined == "CONVENTIONAL") cStrategy.SetConventional();
-        else if (sPredefined == "AGGRESSIVE")   cStrategy.SetAggressive();
-        else  // Don't know what the Predefined parameter is.  Exit with error.
+    const std::string sSection("Optimizer");
+
+    if (!cConfigFile.CheckSectionName(sSection))
+    {
+        throw CrapSimException("main No Optimizer section in configuration file");
+    }
+
+    Optimizer cOptimizer(cTable, fCreateStrategy);
+    if (nSeed != INT_MIN) cOptimizer.SetSeed(static_cast<unsigned>(nSeed));
+
+    int nGenerations       = cConfigFile.GetInt("Generations", sSection);
+    int nPopulation        = cConfigFile.GetInt("Population", sSection);
+    int nRuns              = cConfigFile.GetInt("Runs", sSection);
+    int nFinalRuns         = cConfigFile.GetInt("FinalRuns", sSection);
+    int nTop               = cConfigFile.GetInt("Top", sSection);
+    std::string sObjective = cConfigFile.GetString("Objective", sSection);
+    std::string sName      = cConfigFile.GetString("Name", sSection);
+    std::string sOutput    = cConfigFile.GetString("Output", sSection);
+
+    if (nGenerations != INT_MIN) cOptimizer.SetGenerations(nGenerations);
+    if (nPopulation  != INT_MIN) cOptimizer.SetPopulation(nPopulation);
+    if (nRuns        != INT_MIN) cOptimizer.SetRuns(nRuns);
+    if (nFinalRuns   != INT_MIN) cOptimizer.SetFinalRuns(nFinalRuns);
+    if (nTop         != INT_MIN) cOptimizer.SetTop(nTop);
+    if (!sName.empty())          cOptimizer.SetName(sName);
+
+    if (!sObjective.empty())
+    {
+        if (!cOptimizer.SetObjective(sObjective))
         {
-            throw CrapSimException("main Unknown Predefined setting:", sPredefined);
+            throw CrapSimException("main Unknown optimizer objective", sObjective);
         }
     }
 
-    // If Name is blank, use the Strategy section name
-    if (cStrategy.Name() == "") cStrategy.SetName(sStrategy);
+    // Swept keys are searched, others are shared by every candidate
+    std::map<std::string, std::string> mBase;
+    for (const std::string &sKey : Configuration::SweepableKeys())
+    {
+        std::string sValue = cConfigFile.GetString(sKey, sSection);
+        if (ParameterGrid::IsSweep(sValue))
+            cOptimizer.AddParameter(sKey, ParameterGrid::Expand(sKey, sValue));
+        else if (!sValue.empty())
+            mBase[sKey] = sValue;
+    }
 
-    //
-    // Pass Default configuration parameters if not overridden
-    // Set significant winnings multiple.  Use DefaultStrategy setting if individual strategy's SWM is not set.
-    if (fSWM == FLT_MIN) fSWM = fDefaultSWM;
-    // If Significant Winngings Multiple has been set, pass to Strategy
-    if (fSWM != FLT_MIN) cStrategy.SetSignificantWinningsMultiple(fSWM);
-    // Set significant winnings.  Use DefaultStrategy setting if individual strategy's Significant Winnings is not set.
-    if (nSignificantWinnings == INT_MIN) nSignificantWinnings = nDefaultSigWin;
-    // If Significant Winngings Multiple has been set, pass to Strategy
-    if (nSignificantWinnings != INT_MIN) cStrategy.SetSignificantWinnings(nSignificantWinnings);
-    // Set number of rolls to play.  Use DefaultStrategy setting if individual strategy's Play Number Of Rolls is not set.
-    if (nPlayForNumberOfRolls == INT_MIN) nPlayForNumberOfRolls = nDefaultPlayForNumberOfRolls;
-    // If Significant Winngings Multiple has been set, pass to Strategy
-    if (nPlayForNumberOfRolls != INT_MIN) cStrategy.SetPlayForNumberOfRolls(nPlayForNumberOfRolls);
+    // Default search keys not set in the section
+    for (const auto &apszDefault : g_apszOptimizerDefaults)
+    {
+        if (cConfigFile.GetString(apszDefault[0], sSection).empty())
+            cOptimizer.AddParameter(apszDefault[0], ParameterGrid::Expand(apszDefault[0], apszDefault[1]));
+    }
 
-    // Pass choice to make Full Wagers to Strategy
-    cStrategy.SetFullWager(bFullWager);
+    cOptimizer.SetBase(mBase);
+    cOptimizer.Optimize();
 
-    // If Pass Bet has been set, pass to Strategy
-    if (nPassBet != INT_MIN) cStrategy.SetPassBet(nPassBet);
+    // Write the best Strategies to the output file, or the console
+    if (sOutput.empty())
+    {
+        std::cout << std::endl;
+        cOptimizer.Report(std::cout);
+    }
+    else
+    {
+        std::ofstream ofsOutput(sOutput);
+        if (!ofsOutput)
+        {
+            throw CrapSimException("main Unable to open optimizer output file", sOutput);
+        }
 
-    // If Dont Pass Bet has been set, pass to Strategy
-    if (nDontPassBet != INT_MIN) cStrategy.SetDontPassBet(nDontPassBet);
+        cOptimizer.Report(ofsOutput);
+        std::cout << "Best Strategies written to " << sOutput << std::endl;
+    }
 
-    // If number of Come Bets has been set, pass to Strategy
-    if (nComeBets != INT_MIN) cStrategy.SetNumberOfComeBets(nComeBets);
+    return (0);
+}
 
-    // If number of Dont Come Bets has been set, pass to Strategy
-    if (nDontComeBets != INT_MIN) cStrategy.SetNumberOfDontComeBets(nDontComeBets);
+// A table played by CrapsTables(), with its own Simulation and dice, and
+// the log of its Simulation
+struct TableRun
+{
+    std::string        sSection;
+    Table              cTable {5, 5000};
+    Simulation         cSim;
+    std::ostringstream ossLog;
+    std::exception_ptr pError;
+};
 
-    // If number of Place Bets has been set, pass to Strategy
-    if (nPlaceBets != INT_MIN) cStrategy.SetNumberOfPlaceBets(nPlaceBets);
+/**
+  * Tables Driver.
+  *
+  * Play the Strategies at the table of each TableN section, the tables at
+  * once on as many threads as there are hardware threads.  The Strategy
+  * sections are read once, and each table plays its own copies of the
+  * Strategies with its own Simulation and dice.  With a Seed, the dice of
+  * every table are seeded alike, so that the tables are compared on
+  * common dice.  Once every table is done, print the log of each table,
+  * then one report grouped by table, in the order of the sections.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *\param cConfig The configuration read from the file
+  *\param vsSections The TableN sections
+  *
+  */
 
-    // If number of Place Bets has been set, pass to Strategy
-    if (nPlaceBetsMadeAtOnce != INT_MIN) cStrategy.SetNumberOfPlaceBetsMadeAtOnce(nPlaceBetsMadeAtOnce);
+static int CrapsTables(CDataFile &cConfigFile, const Configuration &cConfig, const std::vector<std::string> &vsSections)
+{
+    const SimulationSettings &cSettings = cConfig.Settings();
 
-    // If PlaceAfterCome was set (checked using string) then updated settings
-    if (!sPlaceAfterCome.empty())
+    // Read the Strategy sections once.  Copies of a Strategy share its
+    // trace files, so traced Strategies cannot play at several tables.
+    std::vector<Strategy> vStrategies = cConfig.CreateStrategies(cConfigFile);
+    for (const Strategy &cStrategy : vStrategies)
     {
-        // Pass choice to make Place bets only after Come bets to Strategy
-        cStrategy.SetPlaceAfterCome(bPlaceAfterCome);
+        if (cStrategy.Traced())
+        {
+            throw CrapSimException("main Table sections cannot be used with Trace in", cStrategy.Name());
+        }
     }
 
-    // If preferred Place bet number has been set, pass to Strategy
-    if (nPlacePreferred != INT_MIN) cStrategy.SetPlacePreferred(nPlacePreferred);
+    // Set up a Simulation for each table, writing its progress to its log
+    std::vector<std::unique_ptr<TableRun>> vpTables;
+    for (const std::string &sSection : vsSections)
+    {
+        SimulationSettings cTableSettings = cConfig.TableSettings(cConfigFile, sSection);
 
-    // If the number of bet units for Place bets has been set, pass to Strategy
-    if (nPlaceBetUnits != INT_MIN) cStrategy.SetPlaceBetUnits(nPlaceBetUnits);
+        std::unique_ptr<TableRun> pTable(new TableRun);
+        pTable->sSection = sSection;
+        pTable->cTable   = cTableSettings.m_cTable;
+        pTable->cSim.SetLog(pTable->ossLog);
+        cTableSettings.Apply(pTable->cSim, cTableSettings.m_nRuns);
 
-    // Pass Place bets working to Strategy
-    cStrategy.SetPlaceWorking(bPlaceWorking);
+        pTable->cSim.ReserveStrategies(vStrategies.size());
+        for (const Strategy &cStrategy : vStrategies)
+        {
+            pTable->cSim.AddStrategy(cStrategy);
+        }
 
-    // Pass Put Bet to Strategy; default is false
-    cStrategy.SetPutBetsAllowed(bPutBet);
+        vpTables.push_back(std::move(pTable));
+    }
 
-    // Pass Field Bet to Strategy; default is false
-    cStrategy.SetFieldBetAllowed(bFieldBet);
+    // Play the tables.  The pool finishes every table before it goes.
+    {
+        const int nThreads = std::min(static_cast<int>(vpTables.size()), static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+        std::mutex mtxConsole;
+        ThreadPool cPool(nThreads);
 
-    // If the number of bet units for Place bets has been set, pass to Strategy
-    if (nFieldBetUnits != INT_MIN) cStrategy.SetFieldBetUnits(nFieldBetUnits);
+        for (std::unique_ptr<TableRun> &pTable : vpTables)
+        {
+            TableRun *pRun = pTable.get();
+            cPool.Submit([pRun, &cSettings, &mtxConsole]
+                {
+                    try
+                    {
+                        pRun->cSim.Run(cSettings.m_nRuns, cSettings.m_bMuster, cSettings.m_bTally);
+                    }
+                    catch (...)
+                    {
+                        pRun->pError = std::current_exception();
+                    }
+
+                    if (cSettings.m_bTally)
+                    {
+                        std::lock_guard<std::mutex> lock(mtxConsole);
+                        std::cout << "Completed " << pRun->sSection << std::endl;
+                    }
+                });
+        }
+    }
 
-    // Pass Any 7 Bet to Strategy; default is false
-    cStrategy.SetAny7BetAllowed(bAny7Bet);
-    // Pass Any Craps Bet to Strategy; default is false
-    cStrategy.SetAnyCrapsBetAllowed(bAnyCrapsBet);
-    // Pass Any Craps Bet to Strategy; default is false
-    cStrategy.SetCraps2BetAllowed(bCraps2Bet);
-    // Pass Any Craps Bet to Strategy; default is false
-    cStrategy.SetCraps3BetAllowed(bCraps3Bet);
-    // Pass Any Craps Bet to Strategy; default is false
-    cStrategy.SetYo11BetAllowed(bYo11Bet);
-    // Pass Any Craps Bet to Strategy; default is false
-    cStrategy.SetCraps12BetAllowed(bCraps12Bet);
-    // Pass Big 6 Bet to Strategy; default is false
-    cStrategy.SetBig6BetAllowed(bBig6Bet);
-    // Pass Big 8 Bet to Strategy; default is false
-    cStrategy.SetBig8BetAllowed(bBig8Bet);
+    for (const std::unique_ptr<TableRun> &pTable : vpTables)
+    {
+        if (pTable->pError) std::rethrow_exception(pTable->pError);
+    }
 
-    // If Standard Odds has been set, pass to Strategy
-    if (fStandardOdds != FLT_MIN) cStrategy.SetStandardOdds(fStandardOdds);
-    // Pass choice to make odds working on a table come out roll to Strategy
-    cStrategy.SetComeOddsWorking(bComeOddsWorking);
+    // Print the logs, then the report of each table
+    for (const std::unique_ptr<TableRun> &pTable : vpTables)
+    {
+        std::cout << "\n[" << pTable->sSection << "]" << std::endl << pTable->ossLog.str();
+    }
 
-    // If OddsProgression was set then updated Strategy
-    if (!sOddsProgressionMethod.empty()) cStrategy.SetOddsProgressionMethod(sOddsProgressionMethod);
+    for (const std::unique_ptr<TableRun> &pTable : vpTables)
+    {
+        std::cout << "\n\n[" << pTable->sSection << "] " << pTable->cTable.TableType() << " odds, wagers " <<
+            pTable->cTable.MinimumBet() << " to " << pTable->cTable.MaximumBet() << std::endl;
 
-    // If WagerProgressionMethod was set then update Strategy
-    if (!sWagerProgressionMethod.empty()) cStrategy.SetWagerProgressionMethod(sWagerProgressionMethod);
+        Strategy::m_bReportHeaderPrinted = false;
+        pTable->cSim.Report();
+    }
 
-    // If Qualified Shooter Method was set then update Strategy
-    if (!sQualifiedShooterMethod.empty()) cStrategy.SetQualifiedShooterMethod(sQualifiedShooterMethod);
+    return (0);
+}
 
-    if (nQualifiedShooterMethodCount != INT_MIN) cStrategy.SetQualifiedShooterMethodCount(nQualifiedShooterMethodCount);
+/**
+  * Benchmark Driver.
+  *
+  * Play each Strategy alone in its own Simulation, with the settings of the
+  * file, and report the rolls played, the time taken, the nanoseconds per
+  * roll and how many more than the first Strategy's.  With a Seed, every
+  * Strategy plays the same dice, so with PlayForNumberOfRolls they play the
+  * same rolls and the difference is the cost of how each makes its bets,
+  * e.g., rules or a routine against the built-in bets.  Settings that write
+  * files, or let a Strategy sit out, are ignored.
+  *
+  *\param cConfigFile Configfile class containing key, value settings
+  *\param cConfig The configuration read from the file
+  *
+  */
 
-    // If BetModificationMethod was set then update Strategy
-    if (!sBetModificationMethod.empty()) cStrategy.SetBetModificationMethod(sBetModificationMethod);
+static int CrapsBenchmark(CDataFile &cConfigFile, const Configuration &cConfig)
+{
+    SimulationSettings cSettings = cConfig.Settings();
+    cSettings.m_bCompare = false;
+    cSettings.m_bRace    = false;
+    cSettings.m_sResultCache.clear();
+    cSettings.m_sCheckpoint.clear();
+    cSettings.m_sPartialResults.clear();
+    cSettings.m_sRecordRolls.clear();
+    cSettings.m_sSurvivalCurve.clear();
+
+    std::vector<Strategy> vStrategies = cConfig.CreateStrategies(cConfigFile);
+
+    std::cout << std::endl << std::setw(32) << std::right << "Strategy" <<
+        std::setw(14) << std::right << "Rolls" <<
+        std::setw(10) << std::right << "Seconds" <<
+        std::setw(10) << std::right << "ns/Roll" <<
+        std::setw(10) << std::right << "Extra" << std::endl;
+
+    double dFirstNanoseconds = 0.0;
+    for (std::vector<Strategy>::size_type iii = 0; iii < vStrategies.size(); ++iii)
+    {
+        std::ostream osLog(nullptr);
+
+        Simulation cSim;
+        cSim.SetLog(osLog);
+        cSettings.Apply(cSim, cSettings.m_nRuns);
+        cSim.AddStrategy(vStrategies[iii]);
+
+        std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+        cSim.Run(cSettings.m_nRuns, false, false);
+        double dSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+        long long nRolls = cSim.TotalRolls();
+        double dNanoseconds = (nRolls > 0 ? dSeconds * 1.0e9 / nRolls : 0.0);
+        if (iii == 0) dFirstNanoseconds = dNanoseconds;
+
+        std::cout << std::setw(32) << std::right << vStrategies[iii].Name() <<
+            std::setw(14) << std::right << nRolls <<
+            std::fixed << std::setprecision(2) <<
+            std::setw(10) << std::right << dSeconds <<
+            std::setw(10) << std::right << dNanoseconds <<
+            std::setw(10) << std::right << dNanoseconds - dFirstNanoseconds << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
 
-    // Add Strategy to Simulation
-    cSim.AddStrategy(cStrategy);
+    return (0);
 }
 
 /**
@@ -288,20 +409,27 @@ void CreateStrategy(const std::string sStrategy, CDataFile &cConfigFile, const i
   *
   * Construct the Simulation and the Table.  Read the configuration file for
   * all non-Strategy configuration sections. Create strategies.  Run
-  * simulations.  Report.
+  * simulations.  Report.  Or, if optimizing, search for the best Strategy
+  * settings instead, or with TableN sections, play every table.
   *
   *\param sINIFile Name of the INI configuration file
+  *\param bOptimize Run the Optimizer instead of the Simulation
+  *\param nRuns Number of runs in place of the Runs key, INT_MIN if not set
+  *\param nSeed Seed in place of the Seed key, INT_MIN if not set
+  *\param bResume Resume from the checkpoint named by the Checkpoint key
+  *\param sShard The shard to play, I/N, empty if not sharded
+  *\param vsPartials Partial results files to merge in place of running
+  *\param sCoordinate [Address:]TCP port to hand the runs to workers on, empty if not coordinating
+  *\param bBenchmark Time each Strategy played alone instead of running the Simulation
   *
   */
 
-int CrapsSimulation(std::string sINIFile)
+int CrapsSimulation(std::string sINIFile, bool bOptimize, int nRuns = INT_MIN, int nSeed = INT_MIN, bool bResume = false,
+                    std::string sShard = std::string(), const std::vector<std::string> &vsPartials = std::vector<std::string>(),
+                    std::string sCoordinate = std::string(), bool bBenchmark = false)
 {
     ShowVersion();
 
-    // Construct Simualtion and Table
-    Simulation  cSim;
-    Table       cTable(5, 5000);
-
     // No config file, no simulation.
     if (sINIFile.empty())
     {
@@ -314,55 +442,122 @@ int CrapsSimulation(std::string sINIFile)
     // Stop CDataFile cConfigFile from Save() and writing out (aka corrupting) the file
     cConfigFile.ClearDirty();
 
-    // Set non-Strategy configuration items.
-    std::string sTableType = cConfigFile.GetString("Type", "Table");
-    int nMinimumWager      = cConfigFile.GetInt("MinimumWager", "Table");
-    int nMaximumWager      = cConfigFile.GetInt("MaximumWager", "Table");
+    // Read non-Strategy configuration items and set the Table.
+    Configuration cConfig(cConfigFile);
+
+    // Optimize the Strategy in the Optimizer section, if requested.
+    if (bOptimize)
+    {
+        return (CrapsOptimizer(cConfigFile, cConfig.Settings().m_cTable, cConfig.Settings().m_nSeed,
+            [&](const std::map<std::string, std::string> &mSettings, Simulation &cCandidateSim)
+            {
+                cCandidateSim.AddStrategy(cConfig.CreateStrategy(cConfigFile, "Optimizer", mSettings, std::string()));
+            }));
+    }
+
+    if (nRuns != INT_MIN) cConfig.Settings().m_nRuns = nRuns;
+    if (nSeed != INT_MIN) cConfig.Settings().m_nSeed = nSeed;
+    cConfig.Settings().m_bResume = bResume;
+
+    // Play one shard, written I/N, if requested.
+    if (!sShard.empty())
+    {
+        std::string::size_type nSlash = sShard.find('/');
+        if ((nSlash == std::string::npos) ||
+            (sShard.find_first_not_of("0123456789/") != std::string::npos) ||
+            (nSlash == 0) || (nSlash == sShard.size() - 1) || (sShard.find('/', nSlash + 1) != std::string::npos))
+        {
+            throw CrapSimException("main Shard must be written I/N", sShard);
+        }
+
+        cConfig.Settings().m_nShard          = std::stoi(sShard.substr(0, nSlash));
+        cConfig.Settings().m_nShards         = std::stoi(sShard.substr(nSlash + 1));
+        cConfig.Settings().m_sPartialResults = sINIFile + "." + std::to_string(cConfig.Settings().m_nShard) + "-of-" +
+            std::to_string(cConfig.Settings().m_nShards) + ".partial";
+    }
+
+    // Hand the runs to workers, if requested.
+    if (!sCoordinate.empty())
+    {
+        if (!sShard.empty() || !vsPartials.empty())
+        {
+            throw CrapSimException("main Coordinate cannot be used with", sShard.empty() ? "Merge" : "Shard");
+        }
 
-    int   nDefaultInitBank             = cConfigFile.GetInt("InitialBankroll", "DefaultStrategy");
-    int   nDefaultStdWager             = cConfigFile.GetInt("StandardWager", "DefaultStrategy");
-    float fDefaultSWM                  = cConfigFile.GetFloat("SWM", "DefaultStrategy");
-    int   nDefaultSigWin               = cConfigFile.GetInt("SignificantWinnings", "DefaultStrategy");
-    int   nDefaultPlayForNumberOfRolls = cConfigFile.GetInt("PlayForNumberOfRolls", "DefaultStrategy");
+        cConfig.Settings().m_bCoordinate = true;
+    }
 
-    int nNumberOfRuns      = cConfigFile.GetInt("Runs", "Simulation");
-    bool bMusterReport     = cConfigFile.GetBool("Muster", "Simulation");
-    bool bTally            = cConfigFile.GetBool("Tally", "Simulation");
+    const SimulationSettings &cSettings = cConfig.Settings();
 
     // No simulation runs, no simulation,
-    if (nNumberOfRuns <= 0)
+    if (cSettings.m_nRuns <= 0)
     {
         throw CrapSimException("main Number of simulation runs not set");
     }
 
-    // Set Table attributes and add it to the Simulation.
-    if (nMinimumWager != INT_MIN) cTable.SetMinimumBet(nMinimumWager);
-    if (nMaximumWager != INT_MIN) cTable.SetMaximumBet(nMaximumWager);
+    // Time each Strategy alone, if requested.
+    if (bBenchmark)
+    {
+        if (!sShard.empty() || !vsPartials.empty() || !sCoordinate.empty())
+        {
+            throw CrapSimException("main Benchmark cannot be used with", !sShard.empty() ? "Shard" :
+                                   (!vsPartials.empty() ? "Merge" : "Coordinate"));
+        }
+
+        return (CrapsBenchmark(cConfigFile, cConfig));
+    }
 
-    if (!sTableType.empty())
+    // Play the Strategies at several tables, if there are TableN sections.
+    std::vector<std::string> vsTables = Configuration::TableSections(cConfigFile);
+    if (!vsTables.empty())
     {
-        if (!cTable.SetTableType(sTableType))
+        if (!vsPartials.empty())
         {
-            throw CrapSimException("main Unknown table type", sTableType);
+            throw CrapSimException("main Table sections cannot be used with", "Merge");
         }
+
+        return (CrapsTables(cConfigFile, cConfig, vsTables));
     }
 
-    cSim.AddTable(cTable);
+    // Construct Simualtion and set it up
+    Simulation cSim;
+    cSettings.Apply(cSim, cSettings.m_nRuns);
 
-    // Loop though possible Strategy sections (StrategyXX).  If it exists,
-    // call function to create it.
-    std::string sStrategyName;
-    for (int iii = 1; iii <= 24; ++iii)
+    // Create a Strategy for each point of each Strategy section's grid.
+    std::vector<Strategy> vStrategies = cConfig.CreateStrategies(cConfigFile);
+    cSim.ReserveStrategies(vStrategies.size());
+    for (Strategy &cStrategy : vStrategies)
     {
-        sStrategyName = "Strategy" + std::to_string(iii);
-        if (cConfigFile.CheckSectionName(sStrategyName))
-            CreateStrategy(sStrategyName, cConfigFile, nDefaultInitBank,
-                           nDefaultStdWager, fDefaultSWM, nDefaultSigWin,
-                           nDefaultPlayForNumberOfRolls, cSim);
+        cSim.AddStrategy(std::move(cStrategy));
     }
 
-    // Run the Simulation.
-    cSim.Run(nNumberOfRuns, bMusterReport, bTally);
+    // Merge the results of the shards, if requested, or run the Simulation.
+    if (!vsPartials.empty())
+    {
+        if (cSettings.m_nSeed == INT_MIN)
+        {
+            throw CrapSimException("main Merging partial results needs a Seed");
+        }
+
+        cSim.MergePartialResults(vsPartials, cSettings.m_nRuns);
+    }
+    else if (cSettings.m_bCoordinate)
+    {
+        // The workers set up their Simulations from the same file
+        std::ifstream ifsConfig(sINIFile);
+        std::string sConfig((std::istreambuf_iterator<char>(ifsConfig)), std::istreambuf_iterator<char>());
+        if (!ifsConfig)
+        {
+            throw CrapSimException("main Unable to read configuration file", sINIFile);
+        }
+
+        SimulationCluster cCluster(cSim, sConfig, cSettings.m_nRuns, cSettings.m_nSeed, sCoordinate);
+        cCluster.Coordinate(cSettings.m_bTally);
+    }
+    else
+    {
+        cSim.Run(cSettings.m_nRuns, cSettings.m_bMuster, cSettings.m_bTally);
+    }
 
     // After action report.
     cSim.Report();
@@ -370,6 +565,71 @@ int CrapsSimulation(std::string sINIFile)
     return (0);
 }
 
+/**
+  * Batch Driver.
+  *
+  * Play a batch of runs for a coordinator.  Set up the Simulation from the
+  * job's configuration file text as CrapsSimulation() does, play the runs
+  * of the batch quietly and return their partial results.  A configuration
+  * that would load a Plugin or write files on the worker is refused.
+  *
+  *\param cJob The job, with the runs of the batch
+  *
+  *\return The partial results of the batch
+  *
+  */
+
+static std::string CrapsBatch(const SimulationJob &cJob)
+{
+    TemporaryFile cINIFile(cJob.sConfig);
+    CDataFile cConfigFile(cINIFile.Path());
+    cConfigFile.ClearDirty();
+
+    // Check before anything is loaded or opened
+    for (const char *pszKey : {"RecordRolls", "ResultCache", "SurvivalCurve"})
+    {
+        if (!cConfigFile.GetString(pszKey, "Simulation").empty())
+            throw CrapSimException("main Batch refuses the key", pszKey);
+    }
+    for (int iii = 1; iii <= 24; ++iii)
+    {
+        const std::string sStrategyName = "Strategy" + std::to_string(iii);
+        if (!cConfigFile.CheckSectionName(sStrategyName)) continue;
+
+        if (!cConfigFile.GetString("Plugin", sStrategyName).empty())
+            throw CrapSimException("main Batch refuses the key", sStrategyName + " Plugin");
+        if (cConfigFile.GetBool("Trace", sStrategyName))
+            throw CrapSimException("main Batch refuses the key", sStrategyName + " Trace");
+    }
+
+    Configuration cConfig(cConfigFile);
+
+    // The coordinator keeps the checkpoint and the results
+    SimulationSettings cSettings = cConfig.Settings();
+    cSettings.m_nRuns = cJob.nRuns;
+    cSettings.m_nSeed = cJob.nSeed;
+    cSettings.m_sCheckpoint.clear();
+    cSettings.m_sPartialResults.clear();
+
+    std::ostream osLog(nullptr);
+
+    Simulation cSim;
+    cSim.SetLog(osLog);
+    cSettings.Apply(cSim, cSettings.m_nRuns);
+
+    std::vector<Strategy> vStrategies = cConfig.CreateStrategies(cConfigFile);
+    cSim.ReserveStrategies(vStrategies.size());
+    for (Strategy &cStrategy : vStrategies)
+    {
+        cSim.AddStrategy(std::move(cStrategy));
+    }
+
+    cSim.SetSlice(cJob.nFirstRun, cJob.nRunCount);
+    cSim.Run(cSettings.m_nRuns, false, false);
+
+    return (cSim.PartialResults(cSettings.m_nRuns));
+}
+
 /**
   * Main
   *
@@ -377,8 +637,6 @@ int CrapsSimulation(std::string sINIFile)
   *
   */
 
-bool Strategy::m_bReportHeaderPrinted = false;
-
 int main(int argc, char* argv[])
 {
     // Check for command line arguments
@@ -391,20 +649,76 @@ int main(int argc, char* argv[])
     // Set up and execute getopt_long
     static struct option stLongOptions[] =
     {
-        {"help",    no_argument, nullptr, 'h'},
-        {"version", no_argument, nullptr, 'v'},
-        {NULL,      0,           nullptr,  0}
+        {"help",     no_argument,       nullptr, 'h'},
+        {"optimize", no_argument,       nullptr, 'o'},
+        {"benchmark", no_argument,      nullptr, 'b'},
+        {"resume",   no_argument,       nullptr, 'r'},
+        {"shard",    required_argument, nullptr, 'S'},
+        {"merge",    no_argument,       nullptr, 'm'},
+        {"import-rolls", required_argument, nullptr, 'I'},
+        {"coordinate", required_argument, nullptr, 'c'},
+        {"join",     required_argument, nullptr, 'j'},
+        {"serve",    required_argument, nullptr, 's'},
+        {"workers",  required_argument, nullptr, 'w'},
+        {"worker",   no_argument,       nullptr, 'k'},
+        {"version",  no_argument,       nullptr, 'v'},
+        {NULL,       0,                 nullptr,  0}
     };
 
+    bool bOptimize = false;
+    bool bBenchmark = false;
+    bool bResume   = false;
+    bool bMerge    = false;
+    std::string sShard;
+    std::string sRollLog;
+    std::string sCoordinate;
+    std::string sCoordinator;
+    bool bWorker   = false;
+    std::string sSocketPath;
+    int nWorkers   = 1;
+
     int nC = 0;
     int nOptionIndex = 0;
-    while ((nC = getopt_long(argc, argv, "hv", stLongOptions, &nOptionIndex)) != -1)
+    while ((nC = getopt_long(argc, argv, "hobrS:mI:c:j:s:w:v", stLongOptions, &nOptionIndex)) != -1)
     {
         switch (nC)
         {
             case 'h':
                 ShowUsage(argv[0]);
                 exit(EXIT_SUCCESS);
+            case 'o':
+                bOptimize = true;
+                break;
+            case 'b':
+                bBenchmark = true;
+                break;
+            case 'r':
+                bResume = true;
+                break;
+            case 'S':
+                sShard = optarg;
+                break;
+            case 'm':
+                bMerge = true;
+                break;
+            case 'I':
+                sRollLog = optarg;
+                break;
+            case 'c':
+                sCoordinate = optarg;
+                break;
+            case 'j':
+                sCoordinator = optarg;
+                break;
+            case 's':
+                sSocketPath = optarg;
+                break;
+            case 'w':
+                nWorkers = std::atoi(optarg);
+                break;
+            case 'k':
+                bWorker = true;
+                break;
             case 'v':
                 ShowVersion();
                 exit(EXIT_SUCCESS);
@@ -418,10 +732,79 @@ int main(int argc, char* argv[])
     }
 
 
+    // Run jobs for a server, each in a fresh Simulation
+    if (bWorker)
+    {
+        return (SimulationServer::Work([](const std::string &sINIFile, int nRuns, int nSeed)
+            {
+                Strategy::m_bReportHeaderPrinted = false;
+                CrapsSimulation(sINIFile, false, nRuns, nSeed);
+            }));
+    }
+
+    // Play runs for a coordinator instead of running a configuration file
+    if (!sCoordinator.empty())
+    {
+        try
+        {
+            ShowVersion();
+            return (SimulationCluster::Work(sCoordinator, CrapsBatch));
+        }
+        catch (const CrapSimException &e)
+        {
+            std::cerr << "ERROR" << std::endl;
+            std::cerr << e.what() << " " << e.m_sArg << std::endl;
+            std::cerr << "Terminating" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Serve jobs instead of running a configuration file
+    if (!sSocketPath.empty())
+    {
+        try
+        {
+            SimulationServer cServer(sSocketPath, nWorkers, argv[0]);
+            cServer.Serve();
+        }
+        catch (const CrapSimException &e)
+        {
+            std::cerr << "ERROR" << std::endl;
+            std::cerr << e.what() << " " << e.m_sArg << std::endl;
+            std::cerr << "Terminating" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // The configuration file follows the options
+    if (optind >= argc)
+    {
+        ShowUsage(argv[0]);
+        exit (EXIT_FAILURE);
+    }
+
     // Execute the simulation
     try
     {
-        return (CrapsSimulation(argv[1]));
+        // Record a text roll log to a roll tape in place of running
+        if (!sRollLog.empty())
+        {
+            unsigned long long nRuns  = 0;
+            unsigned long long nRolls = 0;
+            RollTapeRecorder::Import(sRollLog, argv[optind], nRuns, nRolls);
+            std::cout << "Recorded " << nRolls << " rolls in " << nRuns << " runs to " << argv[optind] << std::endl;
+            return (0);
+        }
+
+        // Partial results files to merge follow the configuration file
+        std::vector<std::string> vsPartials(argv + optind + 1, argv + argc);
+        if (bMerge && vsPartials.empty())
+        {
+            throw CrapSimException("main No partial results files to merge");
+        }
+
+        return (CrapsSimulation(argv[optind], bOptimize, INT_MIN, INT_MIN, bResume, sShard, bMerge ? vsPartials : std::vector<std::string>(),
+                                sCoordinate, bBenchmark));
     }
     catch (const CrapSimException &e)
     {